@@ -66,6 +66,8 @@ extern int fseek(FILE *stream, long offset, int whence);
 
 extern long ftell(FILE *stream);
 
+extern int rename(const char *oldpath, const char *newpath);
+
 extern void clearerr(FILE *stream);
 extern int ferror(FILE *stream);
 
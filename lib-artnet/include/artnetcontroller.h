@@ -34,6 +34,9 @@
 
 #include "packets.h"
 #include "artnettrigger.h"
+#include "artnettimecode.h"
+
+#include "lightsetrecorder.h"
 
 #include "artnetpolltable.h"
 
@@ -62,6 +65,14 @@ public:
 	void HandleSync(void);
 	void HandleBlackout(void);
 
+	/**
+	 * Frame API, the universes are sent at CommitFrame followed by a single ArtSync.
+	 * Universe() without BeginFrame() opens the frame.
+	 */
+	void BeginFrame(void);
+	void Universe(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength);
+	void CommitFrame(void);
+
 	void SetRunTableCleanup(bool bDoTableCleanup) {
 		m_bDoTableCleanup = bDoTableCleanup;
 	}
@@ -86,6 +97,7 @@ public:
 		} else {
 			m_nMaster = DMX_MAX_VALUE;
 		}
+		UpdateMasterTable();
 	}
 	uint32_t GetMaster(void) {
 		return m_nMaster;
@@ -99,12 +111,40 @@ public:
 		return m_pArtNetTrigger;
 	}
 
+	void SetArtNetTimeCode(ArtNetTimeCode *pArtNetTimeCode) {
+		m_pArtNetTimeCode = pArtNetTimeCode;
+	}
+	ArtNetTimeCode *GetArtNetTimeCode(void) {
+		return m_pArtNetTimeCode;
+	}
+
+	void SetRecorder(LightSetRecorder *pRecorder) {
+		m_pRecorder = pRecorder;
+	}
+	LightSetRecorder *GetRecorder(void) {
+		return m_pRecorder;
+	}
+
 	const uint8_t *GetSoftwareVersion(void);
 
 private:
+	struct TFrameUniverse {
+		struct TArtDmx ArtDmx;	///< Pre-filled template
+		const struct TArtNetPollTableUniverses *pIpAddresses;	///< Cached poll table lookup
+		uint16_t nSize;			///< Bytes to send
+		bool bPending;
+	};
+
+	TFrameUniverse *GetFrameUniverse(uint16_t nUniverse);
+	void UpdateFrameSubscribers(void);
+	bool SendArtDmx(const struct TArtDmx *pArtDmx, uint32_t nSize, const struct TArtNetPollTableUniverses *pIpAddresses);
+	void CopyDmxData(uint8_t *pDestination, const uint8_t *pDmxData, uint32_t nLength);
+	void UpdateMasterTable(void);
 	void HandlePoll(void);
 	void HandlePollReply(void);
 	void HandleTrigger(void);
+	void HandleTimeCode(void);
+	void HandleDmx(void);
 	void ActiveUniversesAdd(uint16_t nUniverse);
 	void ActiveUniversesClear(void);
 
@@ -118,11 +158,23 @@ private:
 	struct TArtDmx *m_pArtDmx;
 	struct TArtSync *m_pArtSync;
 	ArtNetTrigger *m_pArtNetTrigger; // Trigger handler
+	ArtNetTimeCode *m_pArtNetTimeCode; // TimeCode handler
+	LightSetRecorder *m_pRecorder;
 	uint32_t m_nLastPollMillis;
 	bool m_bDoTableCleanup;
 	bool m_bDmxHandled;
 	uint32_t m_nActiveUniverses;
 	uint32_t m_nMaster;
+	uint8_t m_aMasterTable[256];
+	// Frame
+	TFrameUniverse *m_pFrameUniverses;
+	uint32_t m_nFrameUniverses;
+	uint32_t m_nFrameHint;	///< Next expected entry, the universes normally arrive in the same order
+	uint32_t m_nPollTableChanges;
+	bool m_bFrameOpen;
+
+	static constexpr uint32_t FRAME_MAX_UNIVERSES = 128;
+	static constexpr uint32_t ARTDMX_HEADER_SIZE = sizeof(struct TArtDmx) - TArtNetConst::DMX_LENGTH;
 
 public:
 	static ArtNetController *Get(void) {
@@ -36,6 +36,8 @@
 #include "packets.h"
 
 #include "lightset.h"
+#include "lightsetrecorder.h"
+#include "lightsetlatency.h"
 #include "ledblink.h"
 
 #include "artnettimecode.h"
@@ -106,6 +108,34 @@ struct TArtNetNodeState {
 	uint8_t Priority;					///< ArtPoll : Field 6 : The lowest priority of diagnostics message that should be sent.
 };
 
+struct TArtNetNodeStats {
+	uint32_t nParseErrors;				///< Packets without a valid Art-Net header
+	uint32_t nMergeDiscards;			///< ArtDmx discarded, more than two sources
+	uint32_t nSequenceGaps;				///< ArtDmx with a Sequence not following the previous one from the same source
+	uint32_t nRdmDiscards;				///< ArtRdm discarded, the port queue is full or a full discovery is running
+	uint32_t nRdmTimeouts;				///< ArtRdm without RDM response, or expired in the queue
+};
+
+#define ARTNET_RDM_INCREMENTAL_INTERVAL_MILLIS	30000	///< Incremental discovery period, enabled with ArtTodControl AtcIncOn
+
+#define ARTNET_RDM_QUEUE_SIZE		4	///< Pending ArtRdm requests per output port, power of 2
+#define ARTNET_RDM_QUEUE_MASK		(ARTNET_RDM_QUEUE_SIZE - 1)
+
+struct TArtNetRdmRequest {
+	uint32_t nIPAddressFrom;
+	uint32_t nMillis;					///< Received
+	struct TArtRdm ArtRdm;				///< The response is sent back in the same packet
+};
+
+struct TArtNetRdmQueue {
+	struct TArtNetRdmRequest Request[ARTNET_RDM_QUEUE_SIZE];
+	uint32_t nMicros;					///< The outstanding request has been sent
+	uint32_t nCompletedMillis;			///< The previous transaction has completed
+	uint8_t nHead;
+	uint8_t nCount;
+	bool bOutstanding;					///< Waiting for the RDM response of the head request
+};
+
 struct TArtNetNode {
 	uint32_t IPAddressLocal;						///< Local IP Address
 	uint32_t IPAddressBroadcast;					///< The broadcast IP Address
@@ -131,12 +161,15 @@ struct TGenericPort {
 struct TOutputPort {
 	uint8_t data[TArtNetConst::DMX_LENGTH];	///< Data sent
 	uint16_t nLength;					///< Length of sent DMX data
+	struct TLightSetRange tRange;		///< Slots changed since the last LightSet::SetData
 	uint8_t dataA[TArtNetConst::DMX_LENGTH];	///< The data received from Port A
 	uint32_t nMillisA;					///< The latest time of the data received from Port A
 	uint32_t ipA;						///< The IP address for port A
 	uint8_t dataB[TArtNetConst::DMX_LENGTH];	///< The data received from Port B
 	uint32_t nMillisB;					///< The latest time of the data received from Port B
 	uint32_t ipB;						///< The IP address for Port B
+	uint8_t nSequenceA;					///< The latest ArtDmx Sequence received from Port A
+	uint8_t nSequenceB;					///< The latest ArtDmx Sequence received from Port B
 	ArtNetMerge mergeMode;				///< \ref ArtNetMerge
 	bool IsDataPending;					///< ArtDMX received and waiting for ArtSync
 	bool bIsEnabled;					///< Is the port enabled ?
@@ -161,6 +194,16 @@ public:
 
 	void Run(void);
 
+	/**
+	 * Maximum number of packets handled by a single Run() call
+	 */
+	void SetPacketBudget(uint32_t nPacketBudget) {
+		m_nPacketBudget = (nPacketBudget == 0) ? 1 : nPacketBudget;
+	}
+	uint32_t GetPacketBudget(void) const {
+		return m_nPacketBudget;
+	}
+
 	uint8_t GetVersion(void) {
 		return m_nVersion;
 	}
@@ -240,6 +283,17 @@ public:
 	}
 
 	void SendDiag(const char *, TPriorityCodes);
+	void SendDiagStats(void);
+
+	const struct TArtNetNodeStats& GetStats(void) const {
+		return m_Stats;
+	}
+
+#if defined (LIGHTSET_LATENCY)
+	LightSetLatency *GetLatency(void) {
+		return m_pLatency;
+	}
+#endif
 	void SendTimeCode(const struct TArtNetTimeCode *);
 
 	void SetTimeCodeHandler(ArtNetTimeCode *);
@@ -269,6 +323,13 @@ public:
 		return m_pArtNetDmx;
 	}
 
+	void SetRecorder(LightSetRecorder *pRecorder) {
+		m_pRecorder = pRecorder;
+	}
+	LightSetRecorder *GetRecorder(void) {
+		return m_pRecorder;
+	}
+
 	void SetDestinationIp(uint8_t nPortIndex, uint32_t nDestinationIp);
 	uint32_t GetDestinationIp(uint8_t nPortIndex) {
 		if (nPortIndex < ARTNET_NODE_MAX_PORTS_INPUT) {
@@ -289,6 +350,7 @@ private:
 #endif
 
 	void GetType(void);
+	bool ReceivePacket(void);
 
 	void HandlePoll(void);
 	void HandleDmx(void);
@@ -299,21 +361,52 @@ private:
 	void HandleTodRequest(void);
 	void HandleTodControl(void);
 	void HandleRdm(void);
+	void HandleRdmQueue(void);
+	void HandleRdmDiscovery(void);
+	void HandleRdmIncremental(void);
 	void HandleIpProg(void);
 	void HandleDmxIn(void);
 	void HandleTrigger(void);
 
 	uint16_t MakePortAddress(uint16_t, uint8_t nPage = 0);
+	void UpdatePortAddressMap(void);
 
 	bool IsMergedDmxDataChanged(uint8_t, const uint8_t *, uint16_t);
 	void CheckMergeTimeouts(uint8_t);
 	bool IsDmxDataChanged(uint8_t, const uint8_t *, uint16_t);
+	void AddChangedRange(uint32_t nPortIndex, uint32_t nFirst, uint32_t nLast);
+	void CheckSequence(uint8_t& nPrevious, uint8_t nSequence);
+	void SetLightSetData(uint32_t nPortIndex);
 
 	void SendPollRelply(bool);
 	void SendTod(uint8_t nPortId = 0);
+	void SendRdmRequest(uint32_t nPortIndex);
+	void CompleteRdmRequest(uint32_t nPortIndex);
 
 	void SetNetworkDataLossCondition(void);
 
+	/**
+	 * An incremental discovery holding between its transactions leaves the line to DMX and ArtRdm
+	 */
+	bool IsRdmDiscoveryHolding(uint32_t nPortIndex) const {
+		if (((m_nRdmIncrementalRunning & (1U << nPortIndex)) == 0) || ((m_nRdmIncrementalStepping & (1U << nPortIndex)) != 0)) {
+			return false;
+		}
+
+		return m_pArtNetRdm->IsHolding(static_cast<uint8_t>(nPortIndex));
+	}
+
+	/**
+	 * The output is started when the RDM transaction on the line has finished
+	 */
+	bool IsRdmBusy(uint32_t nPortIndex) const {
+		if (((m_nRdmDiscoveryPorts & (1U << nPortIndex)) != 0) && !IsRdmDiscoveryHolding(nPortIndex)) {
+			return true;
+		}
+
+		return (m_pRdmQueue != 0) && (nPortIndex < TArtNetConst::MAX_PORTS) && m_pRdmQueue[nPortIndex].bOutstanding;
+	}
+
 private:
 	uint8_t m_nVersion;
 	uint8_t m_nPages;
@@ -329,9 +422,11 @@ private:
 	ArtNetDmx *m_pArtNetDmx;
 	ArtNetTrigger *m_pArtNetTrigger;
 	ArtNet4Handler *m_pArtNet4Handler;
+	LightSetRecorder *m_pRecorder;
 
 	struct TArtNetNode m_Node;
 	struct TArtNetNodeState m_State;
+	struct TArtNetNodeStats m_Stats;
 
 	struct TArtNetPacket m_ArtNetPacket;
 	struct TArtPollReply m_PollReply;
@@ -340,20 +435,36 @@ private:
 #endif
 	struct TArtTimeCode *m_pTimeCodeData;
 	struct TArtTodData *m_pTodData;
+	struct TArtNetRdmQueue *m_pRdmQueue;
 	struct TArtIpProgReply *m_pIpProgReply;
 
 	struct TOutputPort m_OutputPorts[ARTNET_NODE_MAX_PORTS_OUTPUT];
 	struct TInputPort m_InputPorts[ARTNET_NODE_MAX_PORTS_INPUT];
 
+	uint8_t *m_pPortAddressMap;										///< 15-bit Port-Address -> first enabled output port index
+	uint8_t m_aPortAddressNext[ARTNET_NODE_MAX_PORTS_OUTPUT];		///< Next enabled output port with the same Port-Address
+
 	bool m_bDirectUpdate;
 
 	uint32_t m_nCurrentPacketMillis;
 	uint32_t m_nPreviousPacketMillis;
+	uint32_t m_nPacketBudget;
 
 	TOpCodes m_tOpCodePrevious;
 
+#if defined (LIGHTSET_LATENCY)
+	LightSetLatency *m_pLatency;
+	uint32_t m_nPacketMicros;		///< Hardware::Micros() when the current packet was received
+#endif
+
 	bool m_IsLightSetRunning[ARTNET_NODE_MAX_PORTS_OUTPUT];
 	bool m_IsRdmResponder;
+	uint32_t m_nRdmDiscoveryPorts;	///< Output ports with a discovery started by ArtTodControl AtcFlush
+	uint32_t m_nRdmIncrementalPorts;	///< Output ports with incremental discovery enabled by ArtTodControl AtcIncOn
+	uint32_t m_nRdmIncrementalRunning;	///< Output ports with a running incremental discovery
+	uint32_t m_nRdmIncrementalStepping;	///< Output ports with an incremental discovery transaction, the output is stopped
+	uint32_t m_nRdmIncrementalMillis;	///< The previous incremental discovery has been started
+	uint32_t m_nRdmQueuePorts;		///< Output ports with queued ArtRdm requests
 
 	alignas(uint32_t) char m_aSysName[16];
 	alignas(uint32_t) char m_aDefaultNodeLongName[ARTNET_LONG_NAME_LENGTH];
@@ -39,7 +39,7 @@ enum TArtNetPollInterval {
 };
 
 enum TArtNetPollTableSizes {
-	ARTNET_POLL_TABLE_SIZE_ENRIES = 255,
+	ARTNET_POLL_TABLE_SIZE_ENRIES = 512,
 	ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES = 64,
 	ARTNET_POLL_TABLE_SIZE_UNIVERSES = 512
 };
@@ -51,23 +51,28 @@ struct TArtNetNodeEntryUniverse {
 
 struct TArtNetNodeEntry {
 	uint32_t IPAddress;
+	uint32_t nLastUpdateMillis;
 	uint8_t Mac[ARTNET_MAC_SIZE];
 	uint8_t ShortName[ARTNET_SHORT_NAME_LENGTH];
 	uint8_t LongName[ARTNET_LONG_NAME_LENGTH];
-	uint32_t nUniversesCount;
-	struct TArtNetNodeEntryUniverse Universe[ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES];
+	uint16_t nUniversesCount;
+	uint16_t nUniversesSize;
+	struct TArtNetNodeEntryUniverse *pUniverse;	///< Allocated on demand, grows up to ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES
 };
 
+/**
+ * m_pTableUniverses is sorted by nUniverse, pIpAddresses is sorted by IP address
+ */
 struct TArtNetPollTableUniverses {
 	uint16_t nUniverse;
 	uint16_t nCount;
-	uint32_t *pIpAddresses;
+	uint16_t nSize;
+	uint32_t *pIpAddresses;	///< Allocated on demand, grows up to ARTNET_POLL_TABLE_SIZE_ENRIES
 };
 
 struct TArtNetPollTableClean {
 	uint32_t nTableIndex;
 	uint32_t nUniverseIndex;
-	bool bOffLine;
 };
 
 class ArtNetPollTable {
@@ -84,20 +89,34 @@ public:
 
 	const struct TArtNetPollTableUniverses *GetIpAddress(uint16_t nUniverse);
 
+	/**
+	 * Incremented when a universe or IP address is added or removed,
+	 * a pointer returned by GetIpAddress is valid until then.
+	 */
+	uint32_t GetChanges(void) {
+		return m_nChanges;
+	}
+
 	void Dump(void);
 	void DumpTableUniverses(void);
 
 private:
 	uint16_t MakePortAddress(uint8_t nNetSwitch, uint8_t nSubSwitch, uint8_t nUniverse);
+	bool FindUniverse(uint16_t nUniverse, uint32_t& nEntry);
 	void ProcessUniverse(uint32_t nIpAddress, uint16_t nUniverse);
-	void RemoveIpAddress(uint32_t nEntry, uint32_t nIpAddressIndex);
+	void RemoveIpAddress(uint16_t nUniverse, uint32_t nIpAddress);
+	void RemoveNode(uint32_t nTableIndex);
 
 private:
+	static constexpr uint32_t CLEAN_MAX_CHECKS = 4;	///< Universe slots checked per Clean() call
+	static constexpr uint32_t CLEAN_TIMEOUT_MILLIS = (3 * ARTNET_POLL_INTERVAL_MILLIS) / 2;
+
 	TArtNetNodeEntry *m_pPollTable;
 	uint32_t m_nPollTableEntries;
 	TArtNetPollTableUniverses *m_pTableUniverses;
 	uint32_t m_nTableUniversesEntries;
 	TArtNetPollTableClean m_tTableClean;
+	uint32_t m_nChanges;
 };
 
 #endif /* ARTNETPOLLTABLE_H_ */
@@ -36,10 +36,54 @@ public:
 	virtual ~ArtNetRdm(void) {}
 
 	virtual void Full(uint8_t nPort)=0;
-	virtual uint8_t GetUidCount(uint8_t nPort)=0;
-	virtual void Copy(uint8_t nPort, uint8_t *)=0;
+	virtual uint32_t GetUidCount(uint8_t nPort)=0;
+
+	/**
+	 * Copies at most nMax UIDs, starting at index nFirst, returns the number copied.
+	 * A copy starting at 0 clears the changed flag.
+	 */
+	virtual uint32_t Copy(uint8_t nPort, uint8_t *pTod, uint32_t nFirst, uint32_t nMax)=0;
 
 	virtual const uint8_t *Handler(uint8_t nPort, const uint8_t *)=0;
+
+	/**
+	 * Asynchronous request, GetResponse() is polled until there is a response or time out.
+	 * SendRequest() returns false when no response is expected.
+	 */
+	virtual bool SendRequest(uint8_t nPort, const uint8_t *)=0;
+	virtual const uint8_t *GetResponse(uint8_t nPort)=0;
+
+	/**
+	 * Non-blocking discovery, advanced with Run(). The default is the blocking Full().
+	 * Incremental keeps the TOD and only verifies the known UIDs and searches for new ones.
+	 */
+	virtual void Start(uint8_t nPort, bool bIncremental) {
+		if (!bIncremental) {
+			Full(nPort);
+		}
+	}
+
+	virtual bool IsRunning(__attribute__((unused)) uint8_t nPort) {
+		return false;
+	}
+
+	virtual void Run(void) {
+	}
+
+	/**
+	 * A running incremental discovery can hold before each transaction until Step(),
+	 * the line is then free for DMX and RDM requests.
+	 */
+	virtual bool IsHolding(__attribute__((unused)) uint8_t nPort) {
+		return false;
+	}
+
+	virtual void Step(__attribute__((unused)) uint8_t nPort) {
+	}
+
+	virtual bool IsTodChanged(__attribute__((unused)) uint8_t nPort) {
+		return true;
+	}
 };
 
 #endif /* ARTNETRDM_H_ */
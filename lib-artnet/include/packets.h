@@ -273,7 +273,7 @@ struct TArtTodControl {
 	uint8_t Spare6;			///< Transmit as zero, receivers don’t test.
 	uint8_t Spare7;			///< Transmit as zero, receivers don’t test.
 	uint8_t Net;			///< The top 7 bits of the 15 bit Port-Address of Nodes that must respond to this packet.
-	uint8_t Command;		///< 0x00 AtcNone No action. 0x01 AtcFlush The node flushes its TOD and instigates full discovery.
+	uint8_t Command;		///< 0x00 AtcNone No action. 0x01 AtcFlush The node flushes its TOD and instigates full discovery. 0x03 AtcIncOn Enables incremental discovery. 0x04 AtcIncOff Disables incremental discovery.
 	uint8_t Address;		///< The low byte of the 15 bit Port-Address of the DMX Port that should action this command.
 }PACKED;
 
@@ -462,7 +462,7 @@ struct TArtNetPacket {
 	uint32_t IPAddressFrom;			///<
 	uint32_t IPAddressTo;			///<
 	TOpCodes OpCode;				///<
-	union UArtPacket ArtPacket;		///<
+	union UArtPacket *pArtPacket;	///< Borrowed from the network receive queue, valid until Network::RecvRelease
 };
 
 #endif /* PACKETS_H_ */
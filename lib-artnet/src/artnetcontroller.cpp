@@ -52,11 +52,18 @@ ArtNetController::ArtNetController(void):
 	m_bUnicast(true),
 	m_nHandle(-1),
 	m_pArtNetTrigger(0),
+	m_pArtNetTimeCode(0),
+	m_pRecorder(0),
 	m_nLastPollMillis(0),
 	m_bDoTableCleanup(true),
 	m_bDmxHandled(false),
 	m_nActiveUniverses(0),
-	m_nMaster(DMX_MAX_VALUE)
+	m_nMaster(DMX_MAX_VALUE),
+	m_pFrameUniverses(0),
+	m_nFrameUniverses(0),
+	m_nFrameHint(0),
+	m_nPollTableChanges(0),
+	m_bFrameOpen(false)
 {
 	DEBUG_ENTRY
 
@@ -92,6 +99,7 @@ ArtNetController::ArtNetController(void):
 	m_tArtNetController.Oem[1] = ArtNetConst::OEM_ID[1];
 
 	ActiveUniversesClear();
+	UpdateMasterTable();
 
 	DEBUG_EXIT
 }
@@ -99,6 +107,9 @@ ArtNetController::ArtNetController(void):
 ArtNetController::~ArtNetController(void) {
 	DEBUG_ENTRY
 
+	delete[] m_pFrameUniverses;
+	m_pFrameUniverses = 0;
+
 	delete m_pArtNetPacket;
 	m_pArtNetPacket = 0;
 
@@ -132,6 +143,17 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 
 	ActiveUniversesAdd(nUniverse);
 
+	if (nLength > TArtNetConst::DMX_LENGTH) {
+		nLength = TArtNetConst::DMX_LENGTH;
+	}
+
+	CopyDmxData(m_pArtDmx->Data, pDmxData, nLength);
+
+	// The length must be even
+	if ((nLength & 0x1) != 0) {
+		m_pArtDmx->Data[nLength++] = 0;
+	}
+
 	m_pArtDmx->Physical = nPortIndex;
 	m_pArtDmx->PortAddress = nUniverse;
 	m_pArtDmx->LengthHi = static_cast<uint8_t>((nLength & 0xFF00) >> 8);
@@ -145,48 +167,178 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 		m_pArtDmx->Sequence = 1;
 	}
 
+	if (SendArtDmx(m_pArtDmx, ARTDMX_HEADER_SIZE + nLength, GetIpAddress(nUniverse))) {
+		m_bDmxHandled = true;
+	}
+
+	DEBUG_EXIT
+}
+
+/*
+ * If the number of universe subscribers exceeds 40 for a given universe, the transmitting device may broadcast.
+ */
+bool ArtNetController::SendArtDmx(const struct TArtDmx *pArtDmx, uint32_t nSize, const struct TArtNetPollTableUniverses *pIpAddresses) {
+	if (m_bUnicast) {
+		if (pIpAddresses == 0) {
+			return false;
+		}
+
+		if (pIpAddresses->nCount <= 40) {
+			for (uint32_t nIndex = 0; nIndex < pIpAddresses->nCount; nIndex++) {
+				Network::Get()->SendTo(m_nHandle, pArtDmx, static_cast<uint16_t>(nSize), pIpAddresses->pIpAddresses[nIndex], TArtNetConst::UDP_PORT);
+			}
+
+			return true;
+		}
+	}
+
+	Network::Get()->SendTo(m_nHandle, pArtDmx, static_cast<uint16_t>(nSize), m_tArtNetController.nIPAddressBroadcast, TArtNetConst::UDP_PORT);
+
+	return true;
+}
+
+void ArtNetController::CopyDmxData(uint8_t *pDestination, const uint8_t *pDmxData, uint32_t nLength) {
 	if (__builtin_expect((m_nMaster == DMX_MAX_VALUE), 1)) {
-		memcpy(m_pArtDmx->Data, pDmxData, nLength);
+		memcpy(pDestination, pDmxData, nLength);
 	} else if (m_nMaster == 0) {
-		memset(m_pArtDmx->Data, 0, nLength);
+		memset(pDestination, 0, nLength);
 	} else {
 		for (uint32_t i = 0; i < nLength; i++) {
-			m_pArtDmx->Data[i] = ((m_nMaster * static_cast<uint32_t>(pDmxData[i])) / DMX_MAX_VALUE) & 0xFF;
+			pDestination[i] = m_aMasterTable[pDmxData[i]];
 		}
 	}
+}
 
-	uint32_t nCount = 0;
-	struct TArtNetPollTableUniverses *IpAddresses = const_cast<struct TArtNetPollTableUniverses*>(GetIpAddress(nUniverse));
+void ArtNetController::UpdateMasterTable(void) {
+	for (uint32_t i = 0; i < sizeof(m_aMasterTable); i++) {
+		m_aMasterTable[i] = static_cast<uint8_t>((m_nMaster * i) / DMX_MAX_VALUE);
+	}
+}
 
-	if (m_bUnicast) {
-		if (IpAddresses != 0) {
-			nCount = IpAddresses->nCount;
-		} else {
-			DEBUG_EXIT
-			return;
-		}
+void ArtNetController::BeginFrame(void) {
+	if (__builtin_expect((m_pFrameUniverses == 0), 0)) {
+		m_pFrameUniverses = new TFrameUniverse[FRAME_MAX_UNIVERSES];
+		assert(m_pFrameUniverses != 0);
 	}
 
-	// If the number of universe subscribers exceeds 40 for a given universe, the transmitting device may broadcast.
+	UpdateFrameSubscribers();
 
-	if (m_bUnicast && (nCount <= 40)) {
-		for (uint32_t nIndex = 0; nIndex < nCount; nIndex++) {
-			Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), IpAddresses->pIpAddresses[nIndex], TArtNetConst::UDP_PORT);
-		}
+	m_nFrameHint = 0;
+	m_bFrameOpen = true;
+}
 
-		m_bDmxHandled = true;
+/*
+ * The poll table entries move when a node is added or removed,
+ * the cached lookups are refreshed when the table has changed.
+ */
+void ArtNetController::UpdateFrameSubscribers(void) {
+	if (__builtin_expect((m_nPollTableChanges == GetChanges()), 1)) {
+		return;
+	}
+
+	m_nPollTableChanges = GetChanges();
 
-		DEBUG_EXIT
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		m_pFrameUniverses[i].pIpAddresses = GetIpAddress(m_pFrameUniverses[i].ArtDmx.PortAddress);
+	}
+}
+
+void ArtNetController::Universe(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength) {
+	if (!m_bFrameOpen) {
+		BeginFrame();
+	}
+
+	TFrameUniverse *pFrameUniverse = GetFrameUniverse(nUniverse);
+
+	if (__builtin_expect((pFrameUniverse == 0), 0)) {
+		// The frame table is full
+		HandleDmxOut(nUniverse, pDmxData, nLength);
 		return;
 	}
 
-	if (!m_bUnicast || (nCount > 40)) {
-		Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), m_tArtNetController.nIPAddressBroadcast, TArtNetConst::UDP_PORT);
+	if (nLength > TArtNetConst::DMX_LENGTH) {
+		nLength = TArtNetConst::DMX_LENGTH;
+	}
 
-		m_bDmxHandled = true;
+	struct TArtDmx *pArtDmx = &pFrameUniverse->ArtDmx;
+
+	CopyDmxData(pArtDmx->Data, pDmxData, nLength);
+
+	// The length must be even
+	if ((nLength & 0x1) != 0) {
+		pArtDmx->Data[nLength++] = 0;
 	}
 
-	DEBUG_EXIT
+	pArtDmx->LengthHi = static_cast<uint8_t>((nLength & 0xFF00) >> 8);
+	pArtDmx->Length = static_cast<uint8_t>(nLength & 0xFF);
+
+	pFrameUniverse->nSize = static_cast<uint16_t>(ARTDMX_HEADER_SIZE + nLength);
+	pFrameUniverse->bPending = true;
+}
+
+void ArtNetController::CommitFrame(void) {
+	// The frame can be open across Run() calls, in which the poll table is updated
+	UpdateFrameSubscribers();
+
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		TFrameUniverse *pFrameUniverse = &m_pFrameUniverses[i];
+
+		if (!pFrameUniverse->bPending) {
+			continue;
+		}
+
+		pFrameUniverse->bPending = false;
+
+		// The sequence number is used to ensure that ArtDmx packets are used in the correct order.
+		// This field is incremented in the range 0x01 to 0xff to allow the receiving node to resequence packets.
+		pFrameUniverse->ArtDmx.Sequence++;
+
+		if (pFrameUniverse->ArtDmx.Sequence == 0) {
+			pFrameUniverse->ArtDmx.Sequence = 1;
+		}
+
+		if (SendArtDmx(&pFrameUniverse->ArtDmx, pFrameUniverse->nSize, pFrameUniverse->pIpAddresses)) {
+			m_bDmxHandled = true;
+		}
+	}
+
+	m_bFrameOpen = false;
+
+	HandleSync();
+}
+
+ArtNetController::TFrameUniverse *ArtNetController::GetFrameUniverse(uint16_t nUniverse) {
+	if ((m_nFrameHint < m_nFrameUniverses) && (m_pFrameUniverses[m_nFrameHint].ArtDmx.PortAddress == nUniverse)) {
+		return &m_pFrameUniverses[m_nFrameHint++];
+	}
+
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		if (m_pFrameUniverses[i].ArtDmx.PortAddress == nUniverse) {
+			m_nFrameHint = i + 1;
+			return &m_pFrameUniverses[i];
+		}
+	}
+
+	if (m_nFrameUniverses == FRAME_MAX_UNIVERSES) {
+		return 0;
+	}
+
+	TFrameUniverse *pFrameUniverse = &m_pFrameUniverses[m_nFrameUniverses];
+
+	memset(&pFrameUniverse->ArtDmx, 0, ARTDMX_HEADER_SIZE);
+	memcpy(&pFrameUniverse->ArtDmx, NODE_ID, 8);
+	pFrameUniverse->ArtDmx.OpCode = OP_DMX;
+	pFrameUniverse->ArtDmx.ProtVerLo = TArtNetConst::PROTOCOL_REVISION;
+	pFrameUniverse->ArtDmx.PortAddress = nUniverse;
+	pFrameUniverse->pIpAddresses = GetIpAddress(nUniverse);
+	pFrameUniverse->nSize = 0;
+	pFrameUniverse->bPending = false;
+
+	ActiveUniversesAdd(nUniverse);
+
+	m_nFrameHint = ++m_nFrameUniverses;
+
+	return pFrameUniverse;
 }
 
 void ArtNetController::HandleSync(void) {
@@ -197,6 +349,13 @@ void ArtNetController::HandleSync(void) {
 }
 
 void ArtNetController::HandleBlackout(void) {
+	// An open frame is discarded
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		m_pFrameUniverses[i].bPending = false;
+	}
+
+	m_bFrameOpen = false;
+
 	m_pArtDmx->LengthHi = (512 & 0xFF00) >> 8;
 	m_pArtDmx->Length = (512 & 0xFF);
 
@@ -252,7 +411,7 @@ void ArtNetController::HandleBlackout(void) {
 
 void ArtNetController::HandleTrigger(void) {
 	DEBUG_ENTRY
-	const TArtTrigger *pArtTrigger = &m_pArtNetPacket->ArtPacket.ArtTrigger;
+	const TArtTrigger *pArtTrigger = &m_pArtNetPacket->pArtPacket->ArtTrigger;
 
 	if ((pArtTrigger->OemCodeHi == 0xFF && pArtTrigger->OemCodeLo == 0xFF) || (pArtTrigger->OemCodeHi == m_tArtNetController.Oem[0] && pArtTrigger->OemCodeLo == m_tArtNetController.Oem[1])) {
 		DEBUG_PRINTF("Key=%d, SubKey=%d, Data[0]=%d", pArtTrigger->Key, pArtTrigger->SubKey, pArtTrigger->Data[0]);
@@ -263,6 +422,29 @@ void ArtNetController::HandleTrigger(void) {
 	DEBUG_EXIT
 }
 
+void ArtNetController::HandleTimeCode(void) {
+	const struct TArtTimeCode *pArtTimeCode = &m_pArtNetPacket->pArtPacket->ArtTimeCode;
+
+	m_pArtNetTimeCode->Handler(reinterpret_cast<const struct TArtNetTimeCode*>(&pArtTimeCode->Frames));
+}
+
+void ArtNetController::HandleDmx(void) {
+	const struct TArtDmx *pArtDmx = &m_pArtNetPacket->pArtPacket->ArtDmx;
+
+	// Do not record our own output
+	if (m_pArtNetPacket->IPAddressFrom == Network::Get()->GetIp()) {
+		return;
+	}
+
+	uint32_t nLength = (static_cast<uint32_t>(pArtDmx->LengthHi << 8) & 0xff00) | pArtDmx->Length;
+
+	if (nLength > TArtNetConst::DMX_LENGTH) {
+		nLength = TArtNetConst::DMX_LENGTH;
+	}
+
+	m_pRecorder->Record(pArtDmx->PortAddress, pArtDmx->Data, static_cast<uint16_t>(nLength));
+}
+
 void ArtNetController::HandlePoll(void) {
 	const uint32_t nCurrentMillis = Hardware::Get()->Millis();
 
@@ -298,26 +480,28 @@ void ArtNetController::HandlePollReply(void) {
 	printf("ArtPollReply - %.2d:%.2d:%.2d\n", tm.tm_hour, tm.tm_min, tm.tm_sec);
 #endif
 
-	Add(&m_pArtNetPacket->ArtPacket.ArtPollReply);
+	Add(&m_pArtNetPacket->pArtPacket->ArtPollReply);
 
 	DEBUG_EXIT
 }
 
 void ArtNetController::Run(void) {
-	char *pArtPacket = reinterpret_cast<char*>(&m_pArtNetPacket->ArtPacket);
 	uint16_t nForeignPort;
 
 	if (m_bUnicast) {
 		HandlePoll();
 	}
 
-	const int nBytesReceived = Network::Get()->RecvFrom(m_nHandle, pArtPacket, sizeof(struct TArtNetPacket), &m_pArtNetPacket->IPAddressFrom, &nForeignPort) ;
+	const int nBytesReceived = Network::Get()->RecvBorrow(m_nHandle, reinterpret_cast<void**>(&m_pArtNetPacket->pArtPacket), &m_pArtNetPacket->IPAddressFrom, &nForeignPort) ;
 
-	if (__builtin_expect((nBytesReceived < ARTNET_MIN_HEADER_SIZE), 1)) {
+	if (__builtin_expect((nBytesReceived == 0), 1)) {
 		return;
 	}
 
-	if (memcmp(pArtPacket, "Art-Net\0", 8) != 0) {
+	const char *pArtPacket = reinterpret_cast<const char*>(m_pArtNetPacket->pArtPacket);
+
+	if ((nBytesReceived < ARTNET_MIN_HEADER_SIZE) || (memcmp(pArtPacket, "Art-Net\0", 8) != 0)) {
+		Network::Get()->RecvRelease(m_nHandle);
 		return;
 	}
 
@@ -332,9 +516,21 @@ void ArtNetController::Run(void) {
 			HandleTrigger();
 		}
 		break;
+	case OP_TIMECODE:
+		if (m_pArtNetTimeCode != 0) {
+			HandleTimeCode();
+		}
+		break;
+	case OP_DMX:
+		if (m_pRecorder != 0) {
+			HandleDmx();
+		}
+		break;
 	default:
 		break;
 	}
+
+	Network::Get()->RecvRelease(m_nHandle);
 }
 
 void ArtNetController::ActiveUniversesClear(void) {
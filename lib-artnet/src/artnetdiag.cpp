@@ -28,6 +28,7 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "artnetnode.h"
@@ -37,10 +38,10 @@
 void ArtNetNode::FillDiagData(void) {
 	memset(&m_DiagData, 0, sizeof (struct TArtDiagData));
 
-	memcpy(m_DiagData, NODE_ID, 8);
+	memcpy(m_DiagData.Id, NODE_ID, 8);
 	m_DiagData.OpCode = OP_DIAGDATA;
 	m_DiagData.ProtVerHi = 0;
-	m_DiagData.ProtVerLo = ARTNET_PROTOCOL_REVISION;
+	m_DiagData.ProtVerLo = TArtNetConst::PROTOCOL_REVISION;
 }
 
 void ArtNetNode::SendDiag(const char *text, TPriorityCodes nPriority) {
@@ -54,12 +55,30 @@ void ArtNetNode::SendDiag(const char *text, TPriorityCodes nPriority) {
 
 	m_DiagData.Priority = nPriority;
 
-	strncpy(m_DiagData.Data, text, sizeof m_DiagData.Data - 1);
+	strncpy(reinterpret_cast<char*>(m_DiagData.Data), text, sizeof m_DiagData.Data - 1);
 	m_DiagData.Data[sizeof(m_DiagData.Data) - 1] = '\0';// Just be sure we have a last '\0'
-	m_DiagData.LengthLo = strlen(m_DiagData.Data) + 1;// Text length including the '\0'
+	m_DiagData.LengthLo = static_cast<uint8_t>(strlen(reinterpret_cast<char*>(m_DiagData.Data)) + 1);// Text length including the '\0'
 
 	const uint16_t nSize = sizeof(struct TArtDiagData) - sizeof(m_DiagData.Data) + m_DiagData.LengthLo;
 
-	Network::Get()->SendTo(m_nHandle, &m_DiagData, nSize, m_State.IPAddressDiagSend, ARTNET_UDP_PORT);
+	Network::Get()->SendTo(m_nHandle, &m_DiagData, nSize, m_State.IPAddressDiagSend, TArtNetConst::UDP_PORT);
+}
+
+void ArtNetNode::SendDiagStats(void) {
+	struct TNetworkPortStats tPortStats;
+
+	if (!Network::Get()->GetPortStatsByPort(TArtNetConst::UDP_PORT, tPortStats)) {
+		memset(&tPortStats, 0, sizeof(struct TNetworkPortStats));
+	}
+
+	char aText[128];
+
+	snprintf(aText, sizeof(aText), "rx:%u ovf:%u tx:%u drop:%u unbound:%u parse:%u merge:%u seq:%u",
+			tPortStats.nRx, tPortStats.nRxOverflow,
+			tPortStats.nTx, tPortStats.nTxDropped,
+			Network::Get()->GetRxUnbound(),
+			m_Stats.nParseErrors, m_Stats.nMergeDiscards, m_Stats.nSequenceGaps);
+
+	SendDiag(aText, ARTNET_DP_VOLATILE);
 }
 #endif
@@ -61,7 +61,7 @@ void ArtNetNode::SetIpProgHandler(ArtNetIpProg *pArtNetIpProg) {
 }
 
 void ArtNetNode::HandleIpProg(void) {
-	struct TArtIpProg *packet = &(m_ArtNetPacket.ArtPacket.ArtIpProg);
+	struct TArtIpProg *packet = &(m_ArtNetPacket.pArtPacket->ArtIpProg);
 
 	m_pArtNetIpProg->Handler(reinterpret_cast<const TArtNetIpProg*>(&packet->Command), reinterpret_cast<TArtNetIpProgReply*>(&m_pIpProgReply->ProgIpHi));
 
@@ -37,6 +37,7 @@
 #include "packets.h"
 
 #include "lightset.h"
+#include "lightsetmerge.h"
 
 #include "artnetrdm.h"
 #include "artnettimecode.h"
@@ -71,6 +72,11 @@ static const uint8_t DEVICE_SOFTWARE_VERSION[] = { 1, 45 };
 
 #define PORT_IN_STATUS_DISABLED_MASK	0x08
 
+#define PORT_ADDRESS_MAP_SIZE			(1U << 15)	///< 15 bit Port-Address
+#define PORT_INDEX_NONE					0xFF
+
+#define PACKET_BUDGET_DEFAULT			16	///< Packets per Run()
+
 ArtNetNode *ArtNetNode::s_pThis = 0;
 
 ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
@@ -87,13 +93,23 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 	m_pArtNetDmx(0),
 	m_pArtNetTrigger(0),
 	m_pArtNet4Handler(0),
+	m_pRecorder(0),
 	m_pTimeCodeData(0),
 	m_pTodData(0),
+	m_pRdmQueue(0),
 	m_pIpProgReply(0),
+	m_pPortAddressMap(0),
 	m_bDirectUpdate(false),
 	m_nCurrentPacketMillis(0),
 	m_nPreviousPacketMillis(0),
-	m_IsRdmResponder(false)
+	m_nPacketBudget(PACKET_BUDGET_DEFAULT),
+	m_IsRdmResponder(false),
+	m_nRdmDiscoveryPorts(0),
+	m_nRdmIncrementalPorts(0),
+	m_nRdmIncrementalRunning(0),
+	m_nRdmIncrementalStepping(0),
+	m_nRdmIncrementalMillis(0),
+	m_nRdmQueuePorts(0)
 {
 	assert(Hardware::Get() != 0);
 	assert(Network::Get() != 0);
@@ -106,6 +122,13 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 	m_Node.Status2 = ArtNetStatus2::PORT_ADDRESS_15BIT | (m_nVersion > 3 ? ArtNetStatus2::SACN_ABLE_TO_SWITCH : ArtNetStatus2::SACN_NO_SWITCH);
 
 	memset(&m_State, 0, sizeof (struct TArtNetNodeState));
+	memset(&m_Stats, 0, sizeof (struct TArtNetNodeStats));
+
+#if defined (LIGHTSET_LATENCY)
+	m_pLatency = new LightSetLatency(ARTNET_NODE_MAX_PORTS_OUTPUT);
+	assert(m_pLatency != 0);
+	m_nPacketMicros = 0;
+#endif
 	m_State.reportCode = ARTNET_RCPOWEROK;
 	m_State.status = ARTNET_STANDBY;
 	m_State.nNetworkDataLossTimeoutMillis = NETWORK_DATA_LOSS_TIMEOUT * 1000;
@@ -113,6 +136,7 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 	for (uint32_t i = 0; i < ARTNET_NODE_MAX_PORTS_OUTPUT; i++) {
 		m_IsLightSetRunning[i] = false;
 		memset(&m_OutputPorts[i], 0 , sizeof(struct TOutputPort));
+		m_OutputPorts[i].tRange.nFirst = TArtNetConst::DMX_LENGTH;
 	}
 
 	for (uint32_t i = 0; i < (ARTNET_NODE_MAX_PORTS_INPUT); i++) {
@@ -120,6 +144,11 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 		m_InputPorts[i].nDestinationIp = Network::Get()->GetIp() | ~(Network::Get()->GetNetmask());
 	}
 
+	m_pPortAddressMap = new uint8_t[PORT_ADDRESS_MAP_SIZE];
+	assert(m_pPortAddressMap != 0);
+
+	UpdatePortAddressMap();
+
 	SetShortName(NODE_DEFAULT_SHORT_NAME);
 
 	uint8_t nBoardNameLength;
@@ -143,6 +172,10 @@ ArtNetNode::~ArtNetNode(void) {
 		delete m_pTodData;
 	}
 
+	if (m_pRdmQueue != 0) {
+		delete[] m_pRdmQueue;
+	}
+
 	if (m_pIpProgReply != 0) {
 		delete m_pIpProgReply;
 	}
@@ -150,6 +183,12 @@ ArtNetNode::~ArtNetNode(void) {
 	if (m_pTimeCodeData != 0) {
 		delete m_pTimeCodeData;
 	}
+
+	delete[] m_pPortAddressMap;
+
+#if defined (LIGHTSET_LATENCY)
+	delete m_pLatency;
+#endif
 }
 
 void ArtNetNode::Start(void) {
@@ -238,6 +277,8 @@ int ArtNetNode::SetUniverseSwitch(uint8_t nPortIndex, TArtNetPortDir dir, uint8_
 			}
 		}
 
+		UpdatePortAddressMap();
+
 		return ARTNET_EOK;
 	}
 
@@ -277,6 +318,8 @@ int ArtNetNode::SetUniverseSwitch(uint8_t nPortIndex, TArtNetPortDir dir, uint8_
 		}
 	}
 
+	UpdatePortAddressMap();
+
 	if ((m_pArtNet4Handler != 0) && (m_State.status != ARTNET_ON)) {
 		m_pArtNet4Handler->SetPort(nPortIndex, dir);
 	}
@@ -324,6 +367,8 @@ void ArtNetNode::SetSubnetSwitch(uint8_t nAddress, uint8_t nPage) {
 		m_OutputPorts[i].port.nPortAddress = MakePortAddress(m_OutputPorts[i].port.nPortAddress, (i / TArtNetConst::MAX_PORTS));
 	}
 
+	UpdatePortAddressMap();
+
 	if ((m_pArtNetStore != 0) && (m_State.status == ARTNET_ON)) {
 		if (nPage == 0) {
 			m_pArtNetStore->SaveSubnetSwitch(nAddress);
@@ -348,6 +393,8 @@ void ArtNetNode::SetNetSwitch(uint8_t nAddress, uint8_t nPage) {
 		m_OutputPorts[i].port.nPortAddress = MakePortAddress(m_OutputPorts[i].port.nPortAddress, (i / TArtNetConst::MAX_PORTS));
 	}
 
+	UpdatePortAddressMap();
+
 	if ((m_pArtNetStore != 0) && (m_State.status == ARTNET_ON)) {
 		if (nPage == 0) {
 			m_pArtNetStore->SaveNetSwitch(nAddress);
@@ -388,6 +435,25 @@ uint16_t ArtNetNode::MakePortAddress(uint16_t nCurrentAddress, uint8_t nPage) {
 	return newAddress;
 }
 
+/**
+ * Rebuild the Port-Address -> output port index map.
+ * Ports sharing a Port-Address are chained in ascending port index order.
+ */
+void ArtNetNode::UpdatePortAddressMap(void) {
+	memset(m_pPortAddressMap, PORT_INDEX_NONE, PORT_ADDRESS_MAP_SIZE);
+
+	for (uint32_t i = ARTNET_NODE_MAX_PORTS_OUTPUT; i-- > 0;) {
+		m_aPortAddressNext[i] = PORT_INDEX_NONE;
+
+		if (m_OutputPorts[i].bIsEnabled) {
+			const uint32_t nPortAddress = m_OutputPorts[i].port.nPortAddress & (PORT_ADDRESS_MAP_SIZE - 1);
+
+			m_aPortAddressNext[i] = m_pPortAddressMap[nPortAddress];
+			m_pPortAddressMap[nPortAddress] = static_cast<uint8_t>(i);
+		}
+	}
+}
+
 void ArtNetNode::SetMergeMode(uint8_t nPortIndex, ArtNetMerge tMergeMode) {
 	assert(nPortIndex < (TArtNetConst::MAX_PORTS * TArtNetConst::MAX_PAGES));
 
@@ -617,34 +683,24 @@ void ArtNetNode::SendPollRelply(bool bResponse) {
 }
 
 bool ArtNetNode::IsDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
-	const uint8_t *pSrc = pData;
-	uint8_t *pDst = m_OutputPorts[nPortId].data;
-
 	if (nLength != m_OutputPorts[nPortId].nLength) {
 		m_OutputPorts[nPortId].nLength = nLength;
-
-		for (uint32_t i = 0; i < nLength; i++) {
-			*pDst++ = *pSrc++;
-		}
-
+		LightSetMerge::Copy(m_OutputPorts[nPortId].data, pData, nLength);
+		AddChangedRange(nPortId, 0, TArtNetConst::DMX_LENGTH - 1);
 		return true;
 	}
 
-	for (uint32_t i = 0; i < nLength; i++) {
-		if (*pDst != *pSrc) {
-			isChanged = true;
-		}
-		*pDst++ = *pSrc++;
+	struct TLightSetRange tRange;
+
+	if (LightSetMerge::Copy(m_OutputPorts[nPortId].data, pData, nLength, &tRange)) {
+		AddChangedRange(nPortId, tRange.nFirst, tRange.nLast);
+		return true;
 	}
 
-	return isChanged;
+	return false;
 }
 
 bool ArtNetNode::IsMergedDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
 	if (!m_State.IsMergeMode) {
 		m_State.IsMergeMode = true;
 		m_State.IsChanged = true;
@@ -652,32 +708,63 @@ bool ArtNetNode::IsMergedDmxDataChanged(uint8_t nPortId, const uint8_t *pData, u
 
 	m_OutputPorts[nPortId].port.nStatus |= GO_OUTPUT_IS_MERGING;
 
-
 	if (m_OutputPorts[nPortId].mergeMode == ArtNetMerge::HTP) {
 
 		if (nLength != m_OutputPorts[nPortId].nLength) {
 			m_OutputPorts[nPortId].nLength = nLength;
-			for (uint32_t i = 0; i < nLength; i++) {
-				uint8_t data = std::max(m_OutputPorts[nPortId].dataA[i], m_OutputPorts[nPortId].dataB[i]);
-				m_OutputPorts[nPortId].data[i] = data;
-			}
+			LightSetMerge::Htp(m_OutputPorts[nPortId].data, m_OutputPorts[nPortId].dataA, m_OutputPorts[nPortId].dataB, nLength);
+			AddChangedRange(nPortId, 0, TArtNetConst::DMX_LENGTH - 1);
 			return true;
 		}
 
-		for (uint32_t i = 0; i < nLength; i++) {
-			uint8_t data = std::max(m_OutputPorts[nPortId].dataA[i], m_OutputPorts[nPortId].dataB[i]);
-			if (data != m_OutputPorts[nPortId].data[i]) {
-				m_OutputPorts[nPortId].data[i] = data;
-				isChanged = true;
-			}
+		struct TLightSetRange tRange;
+
+		if (LightSetMerge::Htp(m_OutputPorts[nPortId].data, m_OutputPorts[nPortId].dataA, m_OutputPorts[nPortId].dataB, nLength, &tRange)) {
+			AddChangedRange(nPortId, tRange.nFirst, tRange.nLast);
+			return true;
 		}
 
-		return isChanged;
+		return false;
 	} else {
 		return IsDmxDataChanged(nPortId, pData, nLength);
 	}
 }
 
+/*
+ * The range accumulates while ArtDmx is pending for ArtSync
+ */
+void ArtNetNode::AddChangedRange(uint32_t nPortIndex, uint32_t nFirst, uint32_t nLast) {
+	struct TLightSetRange *pRange = &m_OutputPorts[nPortIndex].tRange;
+
+	if (pRange->nFirst > pRange->nLast) {
+		pRange->nFirst = static_cast<uint16_t>(nFirst);
+		pRange->nLast = static_cast<uint16_t>(nLast);
+		return;
+	}
+
+	if (nFirst < pRange->nFirst) {
+		pRange->nFirst = static_cast<uint16_t>(nFirst);
+	}
+
+	if (nLast > pRange->nLast) {
+		pRange->nLast = static_cast<uint16_t>(nLast);
+	}
+}
+
+void ArtNetNode::SetLightSetData(uint32_t nPortIndex) {
+	struct TLightSetRange *pRange = &m_OutputPorts[nPortIndex].tRange;
+	const uint8_t nPort = static_cast<uint8_t>(nPortIndex);
+
+	if (pRange->nFirst <= pRange->nLast) {
+		m_pLightSet->SetData(nPort, m_OutputPorts[nPortIndex].data, m_OutputPorts[nPortIndex].nLength, *pRange);
+	} else {
+		m_pLightSet->SetData(nPort, m_OutputPorts[nPortIndex].data, m_OutputPorts[nPortIndex].nLength);
+	}
+
+	pRange->nFirst = TArtNetConst::DMX_LENGTH;
+	pRange->nLast = 0;
+}
+
 void ArtNetNode::CheckMergeTimeouts(uint8_t nPortId) {
 	const uint32_t nTimeOutAMillis = m_nCurrentPacketMillis - m_OutputPorts[nPortId].nMillisA;
 
@@ -709,7 +796,7 @@ void ArtNetNode::CheckMergeTimeouts(uint8_t nPortId) {
 }
 
 void ArtNetNode::HandlePoll(void) {
-	const struct TArtPoll *pArtPoll = &(m_ArtNetPacket.ArtPacket.ArtPoll);
+	const struct TArtPoll *pArtPoll = &(m_ArtNetPacket.pArtPacket->ArtPoll);
 
 	if (pArtPoll->TalkToMe & ArtNetTalkToMe::SEND_ARTP_ON_CHANGE) {
 		m_State.SendArtPollReplyOnChange = true;
@@ -748,17 +835,27 @@ void ArtNetNode::HandlePoll(void) {
 	}
 
 	SendPollRelply(true);
+
+#if defined ( ENABLE_SENDDIAG )
+	SendDiagStats();
+#endif
 }
 
 void ArtNetNode::HandleDmx(void) {
-	const struct TArtDmx *pArtDmx = &(m_ArtNetPacket.ArtPacket.ArtDmx);
+	const struct TArtDmx *pArtDmx = &(m_ArtNetPacket.pArtPacket->ArtDmx);
 
 	uint32_t data_length = (static_cast<uint32_t>(pArtDmx->LengthHi << 8) & 0xff00) | pArtDmx->Length;
 	data_length = std::min(data_length, TArtNetConst::DMX_LENGTH);
 
-	for (uint32_t i = 0; i < (TArtNetConst::MAX_PORTS * m_nPages); i++) {
+	if (m_pRecorder != 0) {
+		m_pRecorder->Record(pArtDmx->PortAddress, pArtDmx->Data, static_cast<uint16_t>(data_length));
+	}
+
+	const uint32_t nPortAddress = pArtDmx->PortAddress & (PORT_ADDRESS_MAP_SIZE - 1);
 
-		if (m_OutputPorts[i].bIsEnabled && (m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) && (pArtDmx->PortAddress == m_OutputPorts[i].port.nPortAddress)) {
+	for (uint32_t i = m_pPortAddressMap[nPortAddress]; i != PORT_INDEX_NONE; i = m_aPortAddressNext[i]) {
+
+		if ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) && (pArtDmx->PortAddress == m_OutputPorts[i].port.nPortAddress)) {
 
 			uint32_t ipA = m_OutputPorts[i].ipA;
 			uint32_t ipB = m_OutputPorts[i].ipB;
@@ -767,6 +864,10 @@ void ArtNetNode::HandleDmx(void) {
 
 			m_OutputPorts[i].port.nStatus = m_OutputPorts[i].port.nStatus | GO_DATA_IS_BEING_TRANSMITTED;
 
+#if defined (LIGHTSET_LATENCY)
+			m_pLatency->Add(i, LightSetLatencyStage::DISPATCH, Hardware::Get()->Micros() - m_nPacketMicros);
+#endif
+
 			if (m_State.IsMergeMode) {
 				if (__builtin_expect((!m_State.bDisableMergeTimeout), 1)) {
 					CheckMergeTimeouts(i);
@@ -779,6 +880,7 @@ void ArtNetNode::HandleDmx(void) {
 #endif
 				m_OutputPorts[i].ipA = m_ArtNetPacket.IPAddressFrom;
 				m_OutputPorts[i].nMillisA = m_nCurrentPacketMillis;
+				m_OutputPorts[i].nSequenceA = 0;
 				memcpy(&m_OutputPorts[i].dataA, pArtDmx->Data, data_length);
 				sendNewData = IsDmxDataChanged(i, pArtDmx->Data, data_length);
 			} else if (ipA == m_ArtNetPacket.IPAddressFrom && ipB == 0) {
@@ -801,6 +903,7 @@ void ArtNetNode::HandleDmx(void) {
 #endif
 				m_OutputPorts[i].ipB = m_ArtNetPacket.IPAddressFrom;
 				m_OutputPorts[i].nMillisB = m_nCurrentPacketMillis;
+				m_OutputPorts[i].nSequenceB = 0;
 				memcpy(&m_OutputPorts[i].dataB, pArtDmx->Data, data_length);
 				sendNewData = IsMergedDmxDataChanged(i, m_OutputPorts[i].dataB, data_length);
 			} else if (ipA == 0 && ipB != m_ArtNetPacket.IPAddressFrom) {
@@ -809,6 +912,7 @@ void ArtNetNode::HandleDmx(void) {
 #endif
 				m_OutputPorts[i].ipA = m_ArtNetPacket.IPAddressFrom;
 				m_OutputPorts[i].nMillisA = m_nCurrentPacketMillis;
+				m_OutputPorts[i].nSequenceA = 0;
 				memcpy(&m_OutputPorts[i].dataA, pArtDmx->Data, data_length);
 				sendNewData = IsMergedDmxDataChanged(i, m_OutputPorts[i].dataA, data_length);
 			} else if (ipA == m_ArtNetPacket.IPAddressFrom && ipB != m_ArtNetPacket.IPAddressFrom) {
@@ -834,6 +938,7 @@ void ArtNetNode::HandleDmx(void) {
 #if defined ( ENABLE_SENDDIAG )
 				SendDiag("9. More than two sources, discarding data", ARTNET_DP_LOW);
 #endif
+				m_Stats.nMergeDiscards++;
 				return;
 			} else {
 #if defined ( ENABLE_SENDDIAG )
@@ -842,15 +947,26 @@ void ArtNetNode::HandleDmx(void) {
 				return;
 			}
 
+			if (m_OutputPorts[i].ipA == m_ArtNetPacket.IPAddressFrom) {
+				CheckSequence(m_OutputPorts[i].nSequenceA, pArtDmx->Sequence);
+			} else {
+				CheckSequence(m_OutputPorts[i].nSequenceB, pArtDmx->Sequence);
+			}
+
 			if (sendNewData || m_bDirectUpdate) {
 				if (!m_State.IsSynchronousMode) {
 #if defined ( ENABLE_SENDDIAG )
 					SendDiag("Send new data", ARTNET_DP_LOW);
 #endif
-					m_pLightSet->SetData(i, m_OutputPorts[i].data, m_OutputPorts[i].nLength);
+					SetLightSetData(i);
+#if defined (LIGHTSET_LATENCY)
+					m_pLatency->Add(i, LightSetLatencyStage::OUTPUT, Hardware::Get()->Micros() - m_nPacketMicros);
+#endif
 
 					if(!m_IsLightSetRunning[i]) {
-						m_pLightSet->Start(i);
+						if (!IsRdmBusy(i)) {
+							m_pLightSet->Start(i);
+						}
 						m_State.IsChanged |= (!m_IsLightSetRunning[i]);
 						m_IsLightSetRunning[i] = true;
 					}
@@ -859,6 +975,9 @@ void ArtNetNode::HandleDmx(void) {
 					SendDiag("DMX data pending", ARTNET_DP_LOW);
 #endif
 					m_OutputPorts[i].IsDataPending = sendNewData;
+#if defined (LIGHTSET_LATENCY)
+					m_pLatency->SetPending(i, m_nPacketMicros);
+#endif
 				}
 			} else {
 #if defined ( ENABLE_SENDDIAG )
@@ -871,6 +990,21 @@ void ArtNetNode::HandleDmx(void) {
 	}
 }
 
+/**
+ * A Sequence of 0x00 disables the sequence feature, otherwise it runs from 0x01 to 0xFF and wraps to 0x01.
+ */
+void ArtNetNode::CheckSequence(uint8_t& nPrevious, uint8_t nSequence) {
+	if ((nSequence != 0) && (nPrevious != 0)) {
+		const uint8_t nExpected = (nPrevious == 0xFF) ? 0x01 : static_cast<uint8_t>(nPrevious + 1);
+
+		if (nSequence != nExpected) {
+			m_Stats.nSequenceGaps++;
+		}
+	}
+
+	nPrevious = nSequence;
+}
+
 void ArtNetNode::HandleSync(void) {
 	m_State.IsSynchronousMode = true;
 	m_State.nArtSyncMillis = Hardware::Get()->Millis();
@@ -880,10 +1014,19 @@ void ArtNetNode::HandleSync(void) {
 #if defined ( ENABLE_SENDDIAG )
 			SendDiag("Send pending data", ARTNET_DP_LOW);
 #endif
-			m_pLightSet->SetData(i, m_OutputPorts[i].data, 	m_OutputPorts[i].nLength);
+			SetLightSetData(i);
+#if defined (LIGHTSET_LATENCY)
+			const uint32_t nMicros = Hardware::Get()->Micros();
+			if (m_OutputPorts[i].IsDataPending) {
+				m_pLatency->Add(i, LightSetLatencyStage::OUTPUT, nMicros - m_pLatency->GetPending(i));
+			}
+			m_pLatency->Add(i, LightSetLatencyStage::SYNC, nMicros - m_nPacketMicros);
+#endif
 
 			if(!m_IsLightSetRunning[i]) {
-				m_pLightSet->Start(i);
+				if (!IsRdmBusy(i)) {
+					m_pLightSet->Start(i);
+				}
 				m_IsLightSetRunning[i] = true;
 			}
 
@@ -893,7 +1036,7 @@ void ArtNetNode::HandleSync(void) {
 }
 
 void ArtNetNode::HandleAddress(void) {
-	const struct TArtAddress *pArtAddress = &(m_ArtNetPacket.ArtPacket.ArtAddress);
+	const struct TArtAddress *pArtAddress = &(m_ArtNetPacket.pArtPacket->ArtAddress);
 	uint8_t nPort = 0xFF;
 
 	m_State.reportCode = ARTNET_RCPOWEROK;
@@ -995,8 +1138,9 @@ void ArtNetNode::HandleAddress(void) {
 			m_OutputPorts[nPort].data[i] = 0;
 		}
 		m_OutputPorts[nPort].nLength = TArtNetConst::DMX_LENGTH;
+		AddChangedRange(nPort, 0, TArtNetConst::DMX_LENGTH - 1);
 		if (m_OutputPorts[nPort].tPortProtocol == PORT_ARTNET_ARTNET) {
-			m_pLightSet->SetData(nPort, m_OutputPorts[nPort].data, m_OutputPorts[nPort].nLength);
+			SetLightSetData(nPort);
 		}
 		break;
 
@@ -1005,7 +1149,9 @@ void ArtNetNode::HandleAddress(void) {
 	}
 
 	if ((nPort < TArtNetConst::MAX_PORTS) && (m_OutputPorts[nPort].tPortProtocol == PORT_ARTNET_ARTNET) && !m_IsLightSetRunning[nPort]) {
-		m_pLightSet->Start(nPort);
+		if (!IsRdmBusy(nPort)) {
+			m_pLightSet->Start(nPort);
+		}
 		m_IsLightSetRunning[nPort] = true;
 		m_OutputPorts[nPort].port.nStatus |= GO_DATA_IS_BEING_TRANSMITTED;
 	}
@@ -1035,15 +1181,17 @@ void ArtNetNode::SetNetworkDataLossCondition(void) {
 }
 
 void ArtNetNode::GetType(void) {
-	char *data = reinterpret_cast<char*>(&(m_ArtNetPacket.ArtPacket));
+	const uint8_t *data = reinterpret_cast<const uint8_t*>(m_ArtNetPacket.pArtPacket);
 
 	if (m_ArtNetPacket.length < ARTNET_MIN_HEADER_SIZE) {
 		m_ArtNetPacket.OpCode = OP_NOT_DEFINED;
+		m_Stats.nParseErrors++;
 		return;
 	}
 
 	if ((data[10] != 0) || (data[11] != TArtNetConst::PROTOCOL_REVISION)) {
 		m_ArtNetPacket.OpCode = OP_NOT_DEFINED;
+		m_Stats.nParseErrors++;
 		return;
 	}
 
@@ -1051,55 +1199,26 @@ void ArtNetNode::GetType(void) {
 		m_ArtNetPacket.OpCode = static_cast<TOpCodes>(((data[9] << 8)) + data[8]);
 	} else {
 		m_ArtNetPacket.OpCode = OP_NOT_DEFINED;
+		m_Stats.nParseErrors++;
 	}
 }
 
-void ArtNetNode::Run(void) {
+bool ArtNetNode::ReceivePacket(void) {
 	uint16_t nForeignPort;
 
-	const int nBytesReceived = Network::Get()->RecvFrom(m_nHandle, &(m_ArtNetPacket.ArtPacket), sizeof(m_ArtNetPacket.ArtPacket), &m_ArtNetPacket.IPAddressFrom, &nForeignPort);
+	const int nBytesReceived = Network::Get()->RecvBorrow(m_nHandle, reinterpret_cast<void**>(&m_ArtNetPacket.pArtPacket), &m_ArtNetPacket.IPAddressFrom, &nForeignPort);
 
 	m_nCurrentPacketMillis = Hardware::Get()->Millis();
 
 	if (__builtin_expect((nBytesReceived == 0), 1)) {
-		if ((m_State.nNetworkDataLossTimeoutMillis != 0) && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= m_State.nNetworkDataLossTimeoutMillis)) {
-			SetNetworkDataLossCondition();
-		}
-
-		if (m_State.SendArtPollReplyOnChange) {
-			bool doSend = m_State.IsChanged;
-			if (m_pArtNet4Handler != 0) {
-				doSend |= m_pArtNet4Handler->IsStatusChanged();
-			}
-			if (doSend) {
-				SendPollRelply(false);
-			}
-		}
-
-		if ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= (1 * 1000)) {
-			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
-				LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
-				m_State.bIsReceivingDmx = false;
-			}
-		}
-
-		if (m_pArtNetDmx != 0) {
-			HandleDmxIn();
-
-			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
-				if (m_State.bIsReceivingDmx) {
-					LedBlink::Get()->SetMode(LEDBLINK_MODE_DATA);
-				} else {
-					LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
-				}
-			}
-		}
-
-		return;
+		return false;
 	}
 
 	m_ArtNetPacket.length = nBytesReceived;
 	m_nPreviousPacketMillis = m_nCurrentPacketMillis;
+#if defined (LIGHTSET_LATENCY)
+	m_nPacketMicros = Hardware::Get()->Micros();
+#endif
 
 	GetType();
 
@@ -1167,6 +1286,68 @@ void ArtNetNode::Run(void) {
 		break;
 	}
 
+	Network::Get()->RecvRelease(m_nHandle);
+
+	return true;
+}
+
+void ArtNetNode::Run(void) {
+	uint32_t nPackets = 0;
+
+	// Drain the receive queue first, then do the housekeeping once
+	while ((nPackets < m_nPacketBudget) && ReceivePacket()) {
+		nPackets++;
+	}
+
+	if (__builtin_expect((m_nRdmIncrementalPorts != 0), 0)) {
+		HandleRdmIncremental();
+	}
+
+	if (__builtin_expect((m_nRdmDiscoveryPorts != 0), 0)) {
+		HandleRdmDiscovery();
+	}
+
+	if (__builtin_expect((m_nRdmQueuePorts != 0), 0)) {
+		HandleRdmQueue();
+	}
+
+	if (__builtin_expect((nPackets == 0), 1)) {
+		if ((m_State.nNetworkDataLossTimeoutMillis != 0) && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= m_State.nNetworkDataLossTimeoutMillis)) {
+			SetNetworkDataLossCondition();
+		}
+
+		if (m_State.SendArtPollReplyOnChange) {
+			bool doSend = m_State.IsChanged;
+			if (m_pArtNet4Handler != 0) {
+				doSend |= m_pArtNet4Handler->IsStatusChanged();
+			}
+			if (doSend) {
+				SendPollRelply(false);
+			}
+		}
+
+		if ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= (1 * 1000)) {
+			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
+				LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
+				m_State.bIsReceivingDmx = false;
+			}
+		}
+
+		if (m_pArtNetDmx != 0) {
+			HandleDmxIn();
+
+			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
+				if (m_State.bIsReceivingDmx) {
+					LedBlink::Get()->SetMode(LEDBLINK_MODE_DATA);
+				} else {
+					LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
+				}
+			}
+		}
+
+		return;
+	}
+
 	if (m_pArtNetDmx != 0) {
 		HandleDmxIn();
 	}
@@ -1178,5 +1359,4 @@ void ArtNetNode::Run(void) {
 			LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
 		}
 	}
-
 }
@@ -45,7 +45,8 @@ union uip {
 
 ArtNetPollTable::ArtNetPollTable(void) :
 	m_nPollTableEntries(0),
-	m_nTableUniversesEntries(0)
+	m_nTableUniversesEntries(0),
+	m_nChanges(0)
 {
 	m_pPollTable = new TArtNetNodeEntry[ARTNET_POLL_TABLE_SIZE_ENRIES];
 	assert(m_pPollTable != 0);
@@ -57,28 +58,27 @@ ArtNetPollTable::ArtNetPollTable(void) :
 
 	memset(m_pTableUniverses, 0, sizeof(TArtNetPollTableUniverses[ARTNET_POLL_TABLE_SIZE_UNIVERSES]));
 
-	for (uint32_t nIndex = 0; nIndex < ARTNET_POLL_TABLE_SIZE_UNIVERSES; nIndex++) {
-		m_pTableUniverses[nIndex].pIpAddresses = new uint32_t[ARTNET_POLL_TABLE_SIZE_ENRIES];
-		assert(m_pTableUniverses[nIndex].pIpAddresses != 0);
-	}
-
 	DEBUG_PRINTF("TArtNetNodeEntry[%d] = %u bytes [%u Kb]", ARTNET_POLL_TABLE_SIZE_ENRIES, static_cast<unsigned>(sizeof(TArtNetNodeEntry[ARTNET_POLL_TABLE_SIZE_ENRIES])), static_cast<unsigned>(sizeof(TArtNetNodeEntry[ARTNET_POLL_TABLE_SIZE_ENRIES])) / 1024);
 	DEBUG_PRINTF("TArtNetPollTableUniverses[%d] = %u bytes [%u Kb]", ARTNET_POLL_TABLE_SIZE_UNIVERSES, static_cast<unsigned>(sizeof(TArtNetPollTableUniverses[ARTNET_POLL_TABLE_SIZE_UNIVERSES])), static_cast<unsigned>(sizeof(TArtNetPollTableUniverses[ARTNET_POLL_TABLE_SIZE_UNIVERSES])) / 1024);
 
 	m_tTableClean.nTableIndex = 0;
 	m_tTableClean.nUniverseIndex = 0;
-	m_tTableClean.bOffLine = true;
 }
 
 ArtNetPollTable::~ArtNetPollTable(void) {
-	for (uint32_t nIndex = 0; nIndex < ARTNET_POLL_TABLE_SIZE_UNIVERSES; nIndex++) {
-		delete[] m_pTableUniverses[nIndex].pIpAddresses;
-		m_pTableUniverses[nIndex].pIpAddresses = 0;
+	for (uint32_t nEntry = 0; nEntry < m_nTableUniversesEntries; nEntry++) {
+		delete[] m_pTableUniverses[nEntry].pIpAddresses;
+		m_pTableUniverses[nEntry].pIpAddresses = 0;
 	}
 
 	delete[] m_pTableUniverses;
 	m_pTableUniverses = 0;
 
+	for (uint32_t nIndex = 0; nIndex < m_nPollTableEntries; nIndex++) {
+		delete[] m_pPollTable[nIndex].pUniverse;
+		m_pPollTable[nIndex].pUniverse = 0;
+	}
+
 	delete[] m_pPollTable;
 	m_pPollTable = 0;
 }
@@ -92,43 +92,71 @@ uint16_t ArtNetPollTable::MakePortAddress(uint8_t nNetSwitch, uint8_t nSubSwitch
 	return nPortAddress;
 }
 
-const struct TArtNetPollTableUniverses *ArtNetPollTable::GetIpAddress(uint16_t nUniverse) {
-	if (m_nTableUniversesEntries == 0) {
-		return 0;
-	}
+/**
+ * Binary search in the sorted universe table.
+ * When not found, nEntry is the insertion point.
+ */
+bool ArtNetPollTable::FindUniverse(uint16_t nUniverse, uint32_t& nEntry) {
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_nTableUniversesEntries;
 
-	// FIXME Universe lookup
-	for (uint32_t nEntry = 0; nEntry < m_nTableUniversesEntries; nEntry++) {
-		TArtNetPollTableUniverses *pTableUniverses = &m_pTableUniverses[nEntry];
-		assert(pTableUniverses != 0);
+	while (nLow < nHigh) {
+		const uint32_t nMid = nLow + ((nHigh - nLow) / 2);
+		const uint16_t nMidValue = m_pTableUniverses[nMid].nUniverse;
 
-		if (pTableUniverses->nUniverse == nUniverse) {
-			return &m_pTableUniverses[nEntry];
+		if (nMidValue < nUniverse) {
+			nLow = nMid + 1;
+		} else if (nMidValue > nUniverse) {
+			nHigh = nMid;
+		} else {
+			nEntry = nMid;
+			return true;
 		}
 	}
 
-	return 0;
+	nEntry = nLow;
+	return false;
 }
 
+/**
+ * Binary search in a sorted IP address list.
+ * When not found, nIndex is the insertion point.
+ */
+static bool FindIpAddress(const uint32_t *pIpAddresses, uint32_t nCount, uint32_t nIpAddress, uint32_t& nIndex) {
+	uint32_t nLow = 0;
+	uint32_t nHigh = nCount;
 
-void ArtNetPollTable::RemoveIpAddress(uint32_t nUniverse, uint32_t nIpAddress) {
-	if (m_nTableUniversesEntries == 0) {
-		return;
+	while (nLow < nHigh) {
+		const uint32_t nMid = nLow + ((nHigh - nLow) / 2);
+
+		if (pIpAddresses[nMid] < nIpAddress) {
+			nLow = nMid + 1;
+		} else if (pIpAddresses[nMid] > nIpAddress) {
+			nHigh = nMid;
+		} else {
+			nIndex = nMid;
+			return true;
+		}
 	}
 
-	uint32_t nEntry = 0;
+	nIndex = nLow;
+	return false;
+}
 
-	// FIXME Universe lookup
-	for (nEntry = 0; nEntry < m_nTableUniversesEntries; nEntry++) {
-		TArtNetPollTableUniverses *pTableUniverses = &m_pTableUniverses[nEntry];
-		assert(pTableUniverses != 0);
+const struct TArtNetPollTableUniverses *ArtNetPollTable::GetIpAddress(uint16_t nUniverse) {
+	uint32_t nEntry;
 
-		if (pTableUniverses->nUniverse == nUniverse) {
-			break;
-		}
+	if (FindUniverse(nUniverse, nEntry)) {
+		return &m_pTableUniverses[nEntry];
 	}
 
-	if (nEntry == m_nTableUniversesEntries) {
+	return 0;
+}
+
+void ArtNetPollTable::RemoveIpAddress(uint16_t nUniverse, uint32_t nIpAddress) {
+	uint32_t nEntry;
+
+	if (!FindUniverse(nUniverse, nEntry)) {
 		// Universe not found
 		return;
 	}
@@ -136,99 +164,95 @@ void ArtNetPollTable::RemoveIpAddress(uint32_t nUniverse, uint32_t nIpAddress) {
 	TArtNetPollTableUniverses *pTableUniverses = &m_pTableUniverses[nEntry];
 	assert(pTableUniverses->nCount > 0);
 
-	uint32_t nIpAddressIndex = 0;
+	uint32_t nIpAddressIndex;
 
-	// FIXME IP lookup
-	for (nIpAddressIndex = 0; nIpAddressIndex < pTableUniverses->nCount; nIpAddressIndex++) {
-		if (pTableUniverses->pIpAddresses[nIpAddressIndex] == nIpAddress) {
-			break;
-		}
+	if (!FindIpAddress(pTableUniverses->pIpAddresses, pTableUniverses->nCount, nIpAddress, nIpAddressIndex)) {
+		return;
 	}
 
 	uint32_t *p32 = pTableUniverses->pIpAddresses;
-	int32_t i;
-
-	for (i = static_cast<int32_t>(nIpAddressIndex); i < static_cast<int32_t>(pTableUniverses->nCount) - 1; i++) {
-		p32[i] = p32[i + 1];
-	}
-
-	p32[i] = 0;
+	memmove(&p32[nIpAddressIndex], &p32[nIpAddressIndex + 1], (pTableUniverses->nCount - nIpAddressIndex - 1) * sizeof(uint32_t));
 
 	pTableUniverses->nCount--;
+	m_nChanges++;
 
 	if (pTableUniverses->nCount == 0) {
 		DEBUG_PRINTF("Delete Universe -> m_nTableUniversesEntries=%u, nEntry=%u", m_nTableUniversesEntries, nEntry);
 
-		TArtNetPollTableUniverses *p = m_pTableUniverses;
-
-		for (i = static_cast<int32_t>(nEntry); i < static_cast<int32_t>(m_nTableUniversesEntries) - 1; i++) {
-			p[i].nUniverse = p[i + 1].nUniverse;
-			p[i].nCount = p[i + 1].nCount;
-			p[i].pIpAddresses = p[i + 1].pIpAddresses;
-		}
+		delete[] pTableUniverses->pIpAddresses;
 
-		p[i].nUniverse = 0;
-		p[i].nCount = 0;
+		memmove(&m_pTableUniverses[nEntry], &m_pTableUniverses[nEntry + 1], (m_nTableUniversesEntries - nEntry - 1) * sizeof(TArtNetPollTableUniverses));
 
 		m_nTableUniversesEntries--;
+		memset(&m_pTableUniverses[m_nTableUniversesEntries], 0, sizeof(TArtNetPollTableUniverses));
 	}
 }
 
 void ArtNetPollTable::ProcessUniverse(uint32_t nIpAddress, uint16_t nUniverse) {
 	DEBUG_ENTRY
 
-	if (ARTNET_POLL_TABLE_SIZE_UNIVERSES == m_nTableUniversesEntries) {
-		DEBUG_PUTS("m_pTableUniverses is full");
-		DEBUG_EXIT
-		return;
-	}
+	uint32_t nEntry;
 
-	// FIXME Universe lookup
-	bool bFoundUniverse = false;
-	uint32_t nEntry = 0;
+	if (!FindUniverse(nUniverse, nEntry)) {
+		if (ARTNET_POLL_TABLE_SIZE_UNIVERSES == m_nTableUniversesEntries) {
+			DEBUG_PUTS("m_pTableUniverses is full");
+			DEBUG_EXIT
+			return;
+		}
 
-	for (nEntry = 0; nEntry < m_nTableUniversesEntries; nEntry++) {
-		TArtNetPollTableUniverses *pTableUniverses = &m_pTableUniverses[nEntry];
-		assert(pTableUniverses != 0);
+		// New universe, keep the table sorted
+		memmove(&m_pTableUniverses[nEntry + 1], &m_pTableUniverses[nEntry], (m_nTableUniversesEntries - nEntry) * sizeof(TArtNetPollTableUniverses));
+		memset(&m_pTableUniverses[nEntry], 0, sizeof(TArtNetPollTableUniverses));
 
-		if (pTableUniverses->nUniverse == nUniverse) {
-			bFoundUniverse = true;
-			DEBUG_PRINTF("Universe found %u", nUniverse);
-			break;
-		}
+		m_pTableUniverses[nEntry].nUniverse = nUniverse;
+		m_nTableUniversesEntries++;
+		m_nChanges++;
+		DEBUG_PRINTF("New Universe %d", static_cast<int>(nUniverse));
 	}
 
 	TArtNetPollTableUniverses *pTableUniverses = &m_pTableUniverses[nEntry];
 
-	bool bFoundIp = false;
-	uint32_t nCount = 0;
+	uint32_t nIpAddressIndex;
 
-	if (bFoundUniverse) {
-		// FIXME IP lookup
-		for (nCount = 0; nCount < pTableUniverses->nCount; nCount++) {
-			if (pTableUniverses->pIpAddresses[nCount] == nIpAddress) {
-				bFoundIp = true;
-				DEBUG_PUTS("IP found");
-				break;
-			}
-		}
-	} else {
-		// New universe
-		pTableUniverses->nUniverse = nUniverse;
-		m_nTableUniversesEntries++;
-		DEBUG_PRINTF("New Universe %d", static_cast<int>(nUniverse));
+	if (FindIpAddress(pTableUniverses->pIpAddresses, pTableUniverses->nCount, nIpAddress, nIpAddressIndex)) {
+		DEBUG_PUTS("IP found");
+		DEBUG_EXIT
+		return;
 	}
 
-	if (!bFoundIp) {
-		if (pTableUniverses->nCount < ARTNET_POLL_TABLE_SIZE_ENRIES) {
-			pTableUniverses->pIpAddresses[pTableUniverses->nCount] = nIpAddress;
-			pTableUniverses->nCount++;
-			DEBUG_PUTS("It is a new IP for the Universe");
-		} else {
+	if (pTableUniverses->nCount == pTableUniverses->nSize) {
+		if (pTableUniverses->nSize == ARTNET_POLL_TABLE_SIZE_ENRIES) {
 			DEBUG_PUTS("New IP does not fit");
+			DEBUG_EXIT
+			return;
+		}
+
+		uint32_t nSize = (pTableUniverses->nSize == 0) ? 4 : (2U * pTableUniverses->nSize);
+
+		if (nSize > ARTNET_POLL_TABLE_SIZE_ENRIES) {
+			nSize = ARTNET_POLL_TABLE_SIZE_ENRIES;
+		}
+
+		uint32_t *pIpAddresses = new uint32_t[nSize];
+		assert(pIpAddresses != 0);
+
+		if (pTableUniverses->pIpAddresses != 0) {
+			memcpy(pIpAddresses, pTableUniverses->pIpAddresses, pTableUniverses->nCount * sizeof(uint32_t));
+			delete[] pTableUniverses->pIpAddresses;
 		}
+
+		pTableUniverses->pIpAddresses = pIpAddresses;
+		pTableUniverses->nSize = static_cast<uint16_t>(nSize);
 	}
 
+	uint32_t *p32 = pTableUniverses->pIpAddresses;
+	memmove(&p32[nIpAddressIndex + 1], &p32[nIpAddressIndex], (pTableUniverses->nCount - nIpAddressIndex) * sizeof(uint32_t));
+	p32[nIpAddressIndex] = nIpAddress;
+
+	pTableUniverses->nCount++;
+	m_nChanges++;
+	DEBUG_PUTS("It is a new IP for the Universe");
+
 	DEBUG_EXIT
 }
 
@@ -241,71 +265,64 @@ void ArtNetPollTable::Add(const struct TArtPollReply *ptArtPollReply) {
 
 	const uint32_t nIpSwap = __builtin_bswap32(ip.u32);
 
-	int32_t i;
-	int32_t nLow = 0;
-	int32_t nMid;
-	int32_t nHigh = static_cast<int32_t>(m_nPollTableEntries);
+	uint32_t i = 0;
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_nPollTableEntries;
 
-	while (nLow <= nHigh) {
-		nMid = nLow + ((nHigh - nLow) / 2);
+	while (nLow < nHigh) {
+		const uint32_t nMid = nLow + ((nHigh - nLow) / 2);
 		const uint32_t nMidValue = __builtin_bswap32(m_pPollTable[nMid].IPAddress);
 
 		if (nMidValue < nIpSwap) {
 			nLow = nMid + 1;
 		} else if (nMidValue > nIpSwap) {
-			nHigh = nMid - 1;
+			nHigh = nMid;
 		} else {
 			i = nMid;
 			bFound = true;
-			break;;
+			break;
 		}
 	}
 
 	if (!bFound) {
 		if (m_nPollTableEntries == ARTNET_POLL_TABLE_SIZE_ENRIES) {
 			DEBUG_PUTS("Full");
+			DEBUG_EXIT
 			return;
 		}
 
-		if (m_nPollTableEntries != static_cast<uint32_t>(nHigh)) {
-			DEBUG_PUTS("Move");
-
-			struct TArtNetNodeEntry *pArtNetNodeEntry = m_pPollTable; // TODO
+		i = nLow;
 
-			assert(m_nPollTableEntries >= 1);
-			assert(nLow >= 0);
+		if (i != m_nPollTableEntries) {
+			DEBUG_PUTS("Move");
+			memmove(&m_pPollTable[i + 1], &m_pPollTable[i], (m_nPollTableEntries - i) * sizeof(struct TArtNetNodeEntry));
 
-			for (int32_t i = static_cast<int32_t>(m_nPollTableEntries) - 1;i >= nLow; i--) {
-				const struct TArtNetNodeEntry *pSrc = &pArtNetNodeEntry[i];
-				struct TArtNetNodeEntry *pDst = &pArtNetNodeEntry[i + 1];
-				memcpy(pDst, pSrc, sizeof(struct TArtNetNodeEntry));
+			// Keep the incremental cleanup on the same node
+			if (m_tTableClean.nTableIndex >= i) {
+				m_tTableClean.nTableIndex++;
 			}
-
-			struct TArtNetNodeEntry *pDst = &pArtNetNodeEntry[nLow];
-			memset(pDst, 0, sizeof(struct TArtNetNodeEntry));
-
-			i = nLow;
-		} else {
-			i = static_cast<int32_t>(m_nPollTableEntries);
-			DEBUG_PRINTF("Add -> i=%d", i);
 		}
 
+		memset(&m_pPollTable[i], 0, sizeof(struct TArtNetNodeEntry));
+
 		m_pPollTable[i].IPAddress = ip.u32;
 		m_nPollTableEntries++;
 	}
 
+	TArtNetNodeEntry *pNodeEntry = &m_pPollTable[i];
+
 #ifndef NDEBUG
 	if (ptArtPollReply->BindIndex <= 1) {
-		memcpy(m_pPollTable[i].Mac, ptArtPollReply->MAC, ARTNET_MAC_SIZE);
-
-		const uint8_t *pSrc = ptArtPollReply->ShortName;
-		uint8_t *pDst = m_pPollTable[i].ShortName;
-		memcpy(pDst, pSrc, ARTNET_SHORT_NAME_LENGTH + ARTNET_LONG_NAME_LENGTH);
+		memcpy(pNodeEntry->Mac, ptArtPollReply->MAC, ARTNET_MAC_SIZE);
+		memcpy(pNodeEntry->ShortName, ptArtPollReply->ShortName, ARTNET_SHORT_NAME_LENGTH);
+		memcpy(pNodeEntry->LongName, ptArtPollReply->LongName, ARTNET_LONG_NAME_LENGTH);
 	}
 #endif
 
 	const uint32_t nMillis = Hardware::Get()->Millis();
 
+	pNodeEntry->nLastUpdateMillis = nMillis;
+
 	for (uint32_t nIndex = 0; nIndex < TArtNetConst::MAX_PORTS; nIndex++) {
 		const uint8_t nPortAddress = ptArtPollReply->SwOut[nIndex];
 
@@ -314,87 +331,111 @@ void ArtNetPollTable::Add(const struct TArtPollReply *ptArtPollReply) {
 
 			uint32_t nIndexUniverse;
 
-			for (nIndexUniverse = 0; nIndexUniverse < m_pPollTable[i].nUniversesCount; nIndexUniverse++) {
-				if (m_pPollTable[i].Universe[nIndexUniverse].nUniverse == nUniverse) {
+			for (nIndexUniverse = 0; nIndexUniverse < pNodeEntry->nUniversesCount; nIndexUniverse++) {
+				if (pNodeEntry->pUniverse[nIndexUniverse].nUniverse == nUniverse) {
 					break;
 				}
 			}
 
-			if (nIndexUniverse == m_pPollTable[i].nUniversesCount) {
+			if (nIndexUniverse == pNodeEntry->nUniversesCount) {
 				// Not found
-				if (m_pPollTable[i].nUniversesCount < ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES) {
-					m_pPollTable[i].nUniversesCount++;
-					m_pPollTable[i].Universe[nIndexUniverse].nUniverse = nUniverse;
-					ProcessUniverse(ip.u32, nUniverse);
-				} else {
-					// No room
-					continue;
+				if (pNodeEntry->nUniversesCount == pNodeEntry->nUniversesSize) {
+					if (pNodeEntry->nUniversesSize == ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES) {
+						// No room
+						continue;
+					}
+
+					uint32_t nSize = (pNodeEntry->nUniversesSize == 0) ? TArtNetConst::MAX_PORTS : (2U * pNodeEntry->nUniversesSize);
+
+					if (nSize > ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES) {
+						nSize = ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES;
+					}
+
+					TArtNetNodeEntryUniverse *pUniverse = new TArtNetNodeEntryUniverse[nSize];
+					assert(pUniverse != 0);
+
+					if (pNodeEntry->pUniverse != 0) {
+						memcpy(pUniverse, pNodeEntry->pUniverse, pNodeEntry->nUniversesCount * sizeof(TArtNetNodeEntryUniverse));
+						delete[] pNodeEntry->pUniverse;
+					}
+
+					pNodeEntry->pUniverse = pUniverse;
+					pNodeEntry->nUniversesSize = static_cast<uint16_t>(nSize);
 				}
+
+				pNodeEntry->nUniversesCount++;
+				pNodeEntry->pUniverse[nIndexUniverse].nUniverse = nUniverse;
+				ProcessUniverse(ip.u32, nUniverse);
 			}
 
-			m_pPollTable[i].Universe[nIndexUniverse].nLastUpdateMillis = nMillis;
+			pNodeEntry->pUniverse[nIndexUniverse].nLastUpdateMillis = nMillis;
 		}
 	}
 
 	DEBUG_EXIT;
 }
 
+void ArtNetPollTable::RemoveNode(uint32_t nTableIndex) {
+	DEBUG_PUTS("Node is off-line");
+
+	assert(nTableIndex < m_nPollTableEntries);
+	assert(m_pPollTable[nTableIndex].nUniversesCount == 0);
+
+	delete[] m_pPollTable[nTableIndex].pUniverse;
+
+	memmove(&m_pPollTable[nTableIndex], &m_pPollTable[nTableIndex + 1], (m_nPollTableEntries - nTableIndex - 1) * sizeof(struct TArtNetNodeEntry));
+
+	m_nPollTableEntries--;
+	memset(&m_pPollTable[m_nPollTableEntries], 0, sizeof(struct TArtNetNodeEntry));
+}
+
+/**
+ * Incremental cleanup, at most CLEAN_MAX_CHECKS universe slots are checked per call.
+ * An expired universe is removed from the node and from the universe table.
+ * A node is removed when it has no universes left and has not replied itself.
+ */
 void ArtNetPollTable::Clean(void) {
 	if (m_nPollTableEntries == 0) {
 		return;
 	}
 
-	assert(m_tTableClean.nTableIndex < m_nPollTableEntries);
-	assert(m_tTableClean.nUniverseIndex < ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES);
-
-	if (m_tTableClean.nUniverseIndex == 0) {
-		m_tTableClean.bOffLine = true;
-	}
+	const uint32_t nMillis = Hardware::Get()->Millis();
 
-	struct TArtNetNodeEntryUniverse *pArtNetNodeEntryBind = &m_pPollTable[m_tTableClean.nTableIndex].Universe[m_tTableClean.nUniverseIndex];
+	for (uint32_t nChecks = 0; nChecks < CLEAN_MAX_CHECKS; nChecks++) {
+		if (m_tTableClean.nTableIndex >= m_nPollTableEntries) {
+			m_tTableClean.nTableIndex = 0;
+			m_tTableClean.nUniverseIndex = 0;
 
-	if (pArtNetNodeEntryBind->nLastUpdateMillis != 0) {
-		if ((Hardware::Get()->Millis() - pArtNetNodeEntryBind->nLastUpdateMillis) > (1.5 * ARTNET_POLL_INTERVAL_MILLIS)) {
-			pArtNetNodeEntryBind->nLastUpdateMillis = 0;
-			RemoveIpAddress(pArtNetNodeEntryBind->nUniverse, m_pPollTable[m_tTableClean.nTableIndex].IPAddress);
-		} else {
-			m_tTableClean.bOffLine = false;
+			if (m_nPollTableEntries == 0) {
+				return;
+			}
 		}
-	}
 
-	m_tTableClean.nUniverseIndex++;
+		TArtNetNodeEntry *pNodeEntry = &m_pPollTable[m_tTableClean.nTableIndex];
 
-	if (m_tTableClean.nUniverseIndex == ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES) {
-		if (m_tTableClean.bOffLine) {
-			DEBUG_PUTS("Node is off-line");
+		if (m_tTableClean.nUniverseIndex < pNodeEntry->nUniversesCount) {
+			TArtNetNodeEntryUniverse *pUniverse = &pNodeEntry->pUniverse[m_tTableClean.nUniverseIndex];
 
-			struct TArtNetNodeEntry *pArtNetNodeEntry = m_pPollTable;
-			// Move
-			for (uint32_t i = m_tTableClean.nTableIndex; i < (m_nPollTableEntries - 1); i++) {
-				const struct TArtNetNodeEntry *pSrc = &pArtNetNodeEntry[i + 1];
-				struct TArtNetNodeEntry *pDst = &pArtNetNodeEntry[i];
+			if ((nMillis - pUniverse->nLastUpdateMillis) > CLEAN_TIMEOUT_MILLIS) {
+				RemoveIpAddress(pUniverse->nUniverse, pNodeEntry->IPAddress);
 
-				memcpy(pDst, pSrc, sizeof(struct TArtNetNodeEntry));
+				// Replace with the last one, the slot is checked again
+				pNodeEntry->nUniversesCount--;
+				*pUniverse = pNodeEntry->pUniverse[pNodeEntry->nUniversesCount];
+			} else {
+				m_tTableClean.nUniverseIndex++;
 			}
 
-			m_nPollTableEntries--;
+			continue;
+		}
 
-			struct TArtNetNodeEntry *pDst = &pArtNetNodeEntry[m_nPollTableEntries];
-			pDst->IPAddress = 0;
-			pDst->nUniversesCount = 0;
-			memset(pDst->Universe, 0, sizeof(struct TArtNetNodeEntryUniverse[ARTNET_POLL_TABLE_SIZE_NODE_UNIVERSES]));
-#ifndef NDEBUG
-			memset(pDst->Mac, 0, ARTNET_MAC_SIZE + ARTNET_SHORT_NAME_LENGTH + ARTNET_LONG_NAME_LENGTH);
-#endif
+		if ((pNodeEntry->nUniversesCount == 0) && ((nMillis - pNodeEntry->nLastUpdateMillis) > CLEAN_TIMEOUT_MILLIS)) {
+			RemoveNode(m_tTableClean.nTableIndex);
+		} else {
+			m_tTableClean.nTableIndex++;
 		}
 
 		m_tTableClean.nUniverseIndex = 0;
-		m_tTableClean.bOffLine = true;
-		m_tTableClean.nTableIndex++;
-
-		if (m_tTableClean.nTableIndex >= m_nPollTableEntries) {
-			m_tTableClean.nTableIndex = 0;
-		}
 	}
 }
 
@@ -406,7 +447,7 @@ void ArtNetPollTable::Dump(void) {
 		printf("\t" IPSTR " [" MACSTR "] |%-18s|%-64s|\n", IP2STR(m_pPollTable[i].IPAddress), MAC2STR(m_pPollTable[i].Mac), m_pPollTable[i].ShortName, m_pPollTable[i].LongName);
 
 		for (uint32_t nUniverse = 0; nUniverse < m_pPollTable[i].nUniversesCount; nUniverse++) {
-			struct TArtNetNodeEntryUniverse *pArtNetNodeEntryUniverse = &m_pPollTable[i].Universe[nUniverse];
+			struct TArtNetNodeEntryUniverse *pArtNetNodeEntryUniverse = &m_pPollTable[i].pUniverse[nUniverse];
 			printf("\t %u [%u]\n", pArtNetNodeEntryUniverse->nUniverse, (Hardware::Get()->Millis() - pArtNetNodeEntryUniverse->nLastUpdateMillis) / 1000);
 		}
 		puts("");
@@ -422,7 +463,7 @@ void ArtNetPollTable::DumpTableUniverses(void) {
 		const TArtNetPollTableUniverses *pTableUniverses = &m_pTableUniverses[nEntry];
 		assert(pTableUniverses != 0);
 
-		printf("%3d |%4u | %d ", nEntry, pTableUniverses->nUniverse, pTableUniverses->nCount);
+		printf("%3d |%4u | %d/%d ", nEntry, pTableUniverses->nUniverse, pTableUniverses->nCount, pTableUniverses->nSize);
 
 		const uint32_t *pIpAddresses = pTableUniverses->pIpAddresses;
 		assert(pIpAddresses != 0);
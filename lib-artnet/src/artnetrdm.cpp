@@ -29,6 +29,8 @@
 #include <string.h>
 #include <cassert>
 
+#include "hardware.h"
+
 #include "artnetrdm.h"
 
 #include "artnetnode.h"
@@ -36,8 +38,12 @@
 
 #include "artnetnode_internal.h"
 
+#define RDM_RESPONSE_TIMEOUT_MICROS		20000	///< Outstanding request
+#define RDM_QUEUE_TIMEOUT_MILLIS		1000	///< Queued request, the controller has retried or given up
+#define RDM_DMX_GAP_MILLIS				25		///< A full DMX frame between transactions on the same port
+
 void ArtNetNode::HandleTodControl(void) {
-	const struct TArtTodControl *pArtTodControl =  &(m_ArtNetPacket.ArtPacket.ArtTodControl);
+	const struct TArtTodControl *pArtTodControl =  &(m_ArtNetPacket.pArtPacket->ArtTodControl);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtTodControl->Net << 8)) | static_cast<uint16_t>((pArtTodControl->Address));
 
 	for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
@@ -48,20 +54,142 @@ void ArtNetNode::HandleTodControl(void) {
 			}
 
 			if (pArtTodControl->Command == 0x01) {	// AtcFlush
-				m_pArtNetRdm->Full(i);
+				// Pending requests are for the previous TOD
+				m_pRdmQueue[i].nCount = 0;
+				m_pRdmQueue[i].bOutstanding = false;
+				m_nRdmQueuePorts &= ~(1U << i);
+
+				m_pArtNetRdm->Start(i, false);
+
+				if (m_pArtNetRdm->IsRunning(i)) {
+					// The TOD is sent and the output restarted when the discovery has finished
+					m_nRdmDiscoveryPorts |= (1U << i);
+					m_nRdmIncrementalRunning &= ~(1U << i);
+					m_nRdmIncrementalStepping &= ~(1U << i);
+					continue;
+				}
+			} else if (pArtTodControl->Command == 0x03) {	// AtcIncOn
+				m_nRdmIncrementalPorts |= (1U << i);
+			} else if (pArtTodControl->Command == 0x04) {	// AtcIncOff
+				m_nRdmIncrementalPorts &= ~(1U << i);
 			}
 
 			SendTod(i);
 
+			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder) && !IsRdmBusy(i)) {
+				m_pLightSet->Start(i);
+			}
+		}
+	}
+}
+
+/*
+ * An incremental discovery holds before each transaction. The output is then restarted,
+ * and as with HandleRdmQueue() a full DMX frame goes out before the next transaction.
+ * Queued ArtRdm requests go first.
+ */
+void ArtNetNode::HandleRdmDiscovery(void) {
+	m_pArtNetRdm->Run();
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
+		if ((m_nRdmDiscoveryPorts & (1U << i)) == 0) {
+			continue;
+		}
+
+		if (!m_pArtNetRdm->IsRunning(i)) {
+			m_nRdmDiscoveryPorts &= ~(1U << i);
+
+			// An incremental discovery only reports a changed TOD
+			if (((m_nRdmIncrementalRunning & (1U << i)) == 0) || m_pArtNetRdm->IsTodChanged(i)) {
+				SendTod(i);
+			}
+
+			m_nRdmIncrementalRunning &= ~(1U << i);
+			m_nRdmIncrementalStepping &= ~(1U << i);
+
+			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
+				m_pLightSet->Start(i);
+			}
+			continue;
+		}
+
+		if (((m_nRdmIncrementalRunning & (1U << i)) == 0) || !m_pArtNetRdm->IsHolding(i)) {
+			continue;
+		}
+
+		if ((m_nRdmIncrementalStepping & (1U << i)) != 0) {
+			m_nRdmIncrementalStepping &= ~(1U << i);
+			m_pRdmQueue[i].nCompletedMillis = nMillis;
+
 			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
 				m_pLightSet->Start(i);
 			}
+			continue;
+		}
+
+		if (m_pRdmQueue[i].bOutstanding || (m_pRdmQueue[i].nCount != 0)) {
+			continue;
+		}
+
+		if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
+			if ((nMillis - m_pRdmQueue[i].nCompletedMillis) < RDM_DMX_GAP_MILLIS) {
+				continue;
+			}
+
+			m_pLightSet->Stop(i);
+		}
+
+		m_nRdmIncrementalStepping |= (1U << i);
+		m_pArtNetRdm->Step(i);
+	}
+}
+
+/*
+ * The known UIDs are verified and the new responders are added,
+ * the line is shared with DMX and ArtRdm by HandleRdmDiscovery().
+ */
+void ArtNetNode::HandleRdmIncremental(void) {
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if ((nMillis - m_nRdmIncrementalMillis) < ARTNET_RDM_INCREMENTAL_INTERVAL_MILLIS) {
+		return;
+	}
+
+	m_nRdmIncrementalMillis = nMillis;
+
+	for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
+		if (((m_nRdmIncrementalPorts & (1U << i)) == 0) || ((m_nRdmDiscoveryPorts & (1U << i)) != 0)) {
+			continue;
+		}
+
+		if (m_pRdmQueue[i].bOutstanding) {
+			continue;	// Next period
+		}
+
+		m_pArtNetRdm->Start(i, true);
+
+		if (!m_pArtNetRdm->IsRunning(i)) {
+			continue;
+		}
+
+		m_nRdmDiscoveryPorts |= (1U << i);
+		m_nRdmIncrementalRunning |= (1U << i);
+
+		// Without holding, the discovery has the line until it has finished
+		if (!m_pArtNetRdm->IsHolding(i)) {
+			m_nRdmIncrementalStepping |= (1U << i);
+
+			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
+				m_pLightSet->Stop(i);
+			}
 		}
 	}
 }
 
 void ArtNetNode::HandleTodRequest(void) {
-	const struct TArtTodRequest *pArtTodRequest = &(m_ArtNetPacket.ArtPacket.ArtTodRequest);
+	const struct TArtTodRequest *pArtTodRequest = &(m_ArtNetPacket.pArtPacket->ArtTodRequest);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtTodRequest->Net << 8)) | static_cast<uint16_t>((pArtTodRequest->Address[0]));
 
 	for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
@@ -77,19 +205,31 @@ void ArtNetNode::SendTod(uint8_t nPortId) {
 	m_pTodData->Net = m_Node.NetSwitch[0];
 	m_pTodData->Address = m_OutputPorts[nPortId].port.nDefaultAddress;
 
-	const uint8_t discovered = m_pArtNetRdm->GetUidCount(nPortId);
+	const uint32_t nBlockSize = sizeof(m_pTodData->Tod) / sizeof(m_pTodData->Tod[0]);
+	const uint32_t nTotal = m_pArtNetRdm->GetUidCount(nPortId);
+
+	m_pTodData->UidTotalHi = static_cast<uint8_t>(nTotal >> 8);
+	m_pTodData->UidTotalLo = static_cast<uint8_t>(nTotal);
+	m_pTodData->CommandResponse = 0x00;	// TodFull
+	m_pTodData->Port = static_cast<uint8_t>(1 + nPortId);
 
-	m_pTodData->UidTotalHi = 0;
-	m_pTodData->UidTotalLo = discovered;
-	m_pTodData->BlockCount = 0;
-	m_pTodData->UidCount = discovered;
-	m_pTodData->Port = 1 + nPortId;
+	uint32_t nFirst = 0;
+	uint8_t nBlockCount = 0;
+	uint32_t nCount;
 
-	m_pArtNetRdm->Copy(nPortId, reinterpret_cast<uint8_t*>(m_pTodData->Tod));
+	// When UidTotal exceeds 200, multiple ArtTodData packets are sent
+	do {
+		nCount = m_pArtNetRdm->Copy(nPortId, reinterpret_cast<uint8_t*>(m_pTodData->Tod), nFirst, nBlockSize);
 
-	const size_t nLength = sizeof(struct TArtTodData) - (sizeof m_pTodData->Tod) + (discovered * 6U);
+		m_pTodData->BlockCount = nBlockCount++;
+		m_pTodData->UidCount = static_cast<uint8_t>(nCount);
 
-	Network::Get()->SendTo(m_nHandle, m_pTodData, nLength, m_Node.IPAddressBroadcast, TArtNetConst::UDP_PORT);
+		const size_t nLength = sizeof(struct TArtTodData) - (sizeof m_pTodData->Tod) + (nCount * 6U);
+
+		Network::Get()->SendTo(m_nHandle, m_pTodData, nLength, m_Node.IPAddressBroadcast, TArtNetConst::UDP_PORT);
+
+		nFirst += nCount;
+	} while ((nCount == nBlockSize) && (nFirst < nTotal));
 }
 
 void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
@@ -102,6 +242,11 @@ void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
 		m_pTodData = new TArtTodData;
 		assert(m_pTodData != 0);
 
+		m_pRdmQueue = new TArtNetRdmQueue[TArtNetConst::MAX_PORTS];
+		assert(m_pRdmQueue != 0);
+
+		memset(m_pRdmQueue, 0, sizeof(struct TArtNetRdmQueue) * TArtNetConst::MAX_PORTS);
+
 		if (m_pTodData != 0) {
 			m_Node.Status1 |= STATUS1_RDM_CAPABLE;
 			memset(m_pTodData, 0, sizeof(struct TArtTodData));
@@ -114,42 +259,135 @@ void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
 	}
 }
 
+/*
+ * The request is queued for the port, the transaction is done by HandleRdmQueue()
+ */
 void ArtNetNode::HandleRdm(void) {
-	struct TArtRdm *pArtRdm = &(m_ArtNetPacket.ArtPacket.ArtRdm);
+	const struct TArtRdm *pArtRdm = &(m_ArtNetPacket.pArtPacket->ArtRdm);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtRdm->Net << 8)) | static_cast<uint16_t>((pArtRdm->Address));
 
 	for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
 		if ((portAddress == m_OutputPorts[i].port.nPortAddress) && m_OutputPorts[i].bIsEnabled) {
 
-			if (!m_IsRdmResponder) {
-				if ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_SACN) && (m_pArtNet4Handler != 0)) {
-					const uint8_t nMask = GO_OUTPUT_IS_MERGING | GO_DATA_IS_BEING_TRANSMITTED | GO_OUTPUT_IS_SACN;
-					m_IsLightSetRunning[i] = (m_pArtNet4Handler->GetStatus(i) & nMask) != 0;
-				}
+			if (((m_nRdmDiscoveryPorts & (1U << i)) != 0) && ((m_nRdmIncrementalRunning & (1U << i)) == 0)) {
+				m_Stats.nRdmDiscards++;
+				continue;	// The line is busy with a full discovery
+			}
 
-				if (m_IsLightSetRunning[i]) {
-					m_pLightSet->Stop(i); // Stop DMX if was running
-				}
+			struct TArtNetRdmQueue *pQueue = &m_pRdmQueue[i];
+
+			if (pQueue->nCount == ARTNET_RDM_QUEUE_SIZE) {
+				m_Stats.nRdmDiscards++;
+				continue;
 			}
 
-			const uint8_t *response = const_cast<uint8_t*>(m_pArtNetRdm->Handler(i, pArtRdm->RdmPacket));
+			struct TArtNetRdmRequest *pRequest = &pQueue->Request[(pQueue->nHead + pQueue->nCount) & ARTNET_RDM_QUEUE_MASK];
+
+			pRequest->nIPAddressFrom = m_ArtNetPacket.IPAddressFrom;
+			pRequest->nMillis = m_nCurrentPacketMillis;
+			memcpy(&pRequest->ArtRdm, pArtRdm, sizeof(struct TArtRdm));
+
+			pQueue->nCount++;
+			m_nRdmQueuePorts |= (1U << i);
+		}
+	}
+}
+
+/*
+ * Per port, one outstanding transaction. The output is stopped for the transaction only,
+ * and a full DMX frame goes out before the next request is sent.
+ */
+void ArtNetNode::HandleRdmQueue(void) {
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
+		if ((m_nRdmQueuePorts & (1U << i)) == 0) {
+			continue;
+		}
+
+		if (((m_nRdmDiscoveryPorts & (1U << i)) != 0) && !IsRdmDiscoveryHolding(i)) {
+			continue;
+		}
+
+		struct TArtNetRdmQueue *pQueue = &m_pRdmQueue[i];
+
+		if (pQueue->bOutstanding) {
+			const uint8_t *pResponse = m_pArtNetRdm->GetResponse(i);
+
+			if (pResponse != 0) {
+				struct TArtRdm *pArtRdm = &pQueue->Request[pQueue->nHead].ArtRdm;
 
-			if (response != 0) {
 				pArtRdm->RdmVer = 0x01;
 
-				const uint16_t nMessageLength = response[2] + 1;
-				memcpy(pArtRdm->RdmPacket, &response[1], nMessageLength);
+				const uint16_t nMessageLength = pResponse[2] + 1;
+				memcpy(pArtRdm->RdmPacket, &pResponse[1], nMessageLength);
 
 				const uint16_t nLength = sizeof(struct TArtRdm) - sizeof(pArtRdm->RdmPacket) + nMessageLength;
 
-				Network::Get()->SendTo(m_nHandle, pArtRdm, nLength, m_ArtNetPacket.IPAddressFrom, TArtNetConst::UDP_PORT);
+				Network::Get()->SendTo(m_nHandle, pArtRdm, nLength, pQueue->Request[pQueue->nHead].nIPAddressFrom, TArtNetConst::UDP_PORT);
+			} else if ((Hardware::Get()->Micros() - pQueue->nMicros) < RDM_RESPONSE_TIMEOUT_MICROS) {
+				continue;
 			} else {
-				//printf("\n==> No response <==\n");
+				m_Stats.nRdmTimeouts++;
 			}
 
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Start(i); // Start DMX if was running
-			}
+			CompleteRdmRequest(i);
+			pQueue->nCompletedMillis = nMillis;
+		}
+
+		// The controller has given up on these
+		while ((pQueue->nCount != 0) && ((nMillis - pQueue->Request[pQueue->nHead].nMillis) >= RDM_QUEUE_TIMEOUT_MILLIS)) {
+			pQueue->nHead = (pQueue->nHead + 1) & ARTNET_RDM_QUEUE_MASK;
+			pQueue->nCount--;
+			m_Stats.nRdmTimeouts++;
+		}
+
+		if (pQueue->nCount == 0) {
+			m_nRdmQueuePorts &= ~(1U << i);
+			continue;
+		}
+
+		if (m_IsLightSetRunning[i] && (!m_IsRdmResponder) && ((nMillis - pQueue->nCompletedMillis) < RDM_DMX_GAP_MILLIS)) {
+			continue;
+		}
+
+		SendRdmRequest(i);
+	}
+}
+
+void ArtNetNode::SendRdmRequest(uint32_t nPortIndex) {
+	struct TArtNetRdmQueue *pQueue = &m_pRdmQueue[nPortIndex];
+
+	if (!m_IsRdmResponder) {
+		if ((m_OutputPorts[nPortIndex].tPortProtocol == PORT_ARTNET_SACN) && (m_pArtNet4Handler != 0)) {
+			const uint8_t nMask = GO_OUTPUT_IS_MERGING | GO_DATA_IS_BEING_TRANSMITTED | GO_OUTPUT_IS_SACN;
+			m_IsLightSetRunning[nPortIndex] = (m_pArtNet4Handler->GetStatus(nPortIndex) & nMask) != 0;
+		}
+
+		if (m_IsLightSetRunning[nPortIndex]) {
+			m_pLightSet->Stop(nPortIndex); // Stop DMX if was running
 		}
 	}
+
+	pQueue->bOutstanding = true;
+	pQueue->nMicros = Hardware::Get()->Micros();
+
+	if (!m_pArtNetRdm->SendRequest(static_cast<uint8_t>(nPortIndex), pQueue->Request[pQueue->nHead].ArtRdm.RdmPacket)) {
+		// No response expected
+		CompleteRdmRequest(nPortIndex);
+	}
+}
+
+void ArtNetNode::CompleteRdmRequest(uint32_t nPortIndex) {
+	struct TArtNetRdmQueue *pQueue = &m_pRdmQueue[nPortIndex];
+
+	assert(pQueue->nCount != 0);
+
+	pQueue->nHead = (pQueue->nHead + 1) & ARTNET_RDM_QUEUE_MASK;
+	pQueue->nCount--;
+	pQueue->bOutstanding = false;
+
+	if (m_IsLightSetRunning[nPortIndex] && (!m_IsRdmResponder)) {
+		m_pLightSet->Start(nPortIndex); // Start DMX if was running
+	}
 }
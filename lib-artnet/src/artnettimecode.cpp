@@ -55,7 +55,7 @@ void ArtNetNode::SetTimeCodeHandler(ArtNetTimeCode *pArtNetTimeCode) {
 }
 
 void ArtNetNode::HandleTimeCode(void) {
-	const struct TArtTimeCode *pArtTimeCode = &(m_ArtNetPacket.ArtPacket.ArtTimeCode);
+	const struct TArtTimeCode *pArtTimeCode = &(m_ArtNetPacket.pArtPacket->ArtTimeCode);
 
 	m_pArtNetTimeCode->Handler(reinterpret_cast<const struct TArtNetTimeCode*>(&pArtTimeCode->Frames));
 }
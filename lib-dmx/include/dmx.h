@@ -82,6 +82,7 @@ extern void dmx_init(void);
 
 extern void dmx_set_send_data(const uint8_t *, uint16_t);
 extern void dmx_set_send_data_without_sc(const uint8_t *, uint16_t);
+extern void dmx_set_send_data_range_without_sc(const uint8_t *, uint16_t, uint16_t, uint16_t);
 extern void dmx_clear_data(void);
 extern void dmx_set_port_direction(_dmx_port_direction, bool);
 extern _dmx_port_direction dmx_get_port_direction(void);
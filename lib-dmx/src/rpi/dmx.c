@@ -155,6 +155,21 @@ void dmx_set_send_data_without_sc(const uint8_t *data, uint16_t length) {
 	dmx_set_send_data_length(length + 1);
 }
 
+void dmx_set_send_data_range_without_sc(const uint8_t *data, uint16_t length, uint16_t first, uint16_t last) {
+	if (((uint32_t) length + 1 != dmx_send_data_length) || (first > last) || (last >= length)) {
+		dmx_set_send_data_without_sc(data, length);
+		return;
+	}
+
+	do {
+		dmb();
+	} while (dmx_send_state != IDLE && dmx_send_state != DMXINTER);
+
+	dmx_data[0].data[0] = DMX512_START_CODE;
+
+	memcpy(&dmx_data[0].data[1 + first], &data[first], (size_t) (last - first + 1));
+}
+
 void dmx_clear_data(void) {
 	uint32_t i = sizeof(dmx_data) / sizeof(uint32_t);
 	uint32_t *p = (uint32_t *)dmx_data;
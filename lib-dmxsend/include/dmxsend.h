@@ -40,6 +40,7 @@ public:
 	void Stop(uint8_t nPort);
 
 	void SetData(uint8_t nPort, const uint8_t *, uint16_t);
+	void SetData(uint8_t nPort, const uint8_t *, uint16_t, const struct TLightSetRange &);
 
 	void Print(void);
 
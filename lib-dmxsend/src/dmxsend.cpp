@@ -78,4 +78,12 @@ void DMXSend::SetData(__attribute__((unused)) uint8_t nPortId, const uint8_t *pD
 
 	DEBUG_EXIT
 }
+
+void DMXSend::SetData(__attribute__((unused)) uint8_t nPortId, const uint8_t *pData, uint16_t nLength, const struct TLightSetRange &tRange) {
+	if (__builtin_expect((nLength == 0), 0)) {
+		return;
+	}
+
+	dmx_set_send_data_range_without_sc(pData, nLength, tRange.nFirst, tRange.nLast);
+}
 #endif
@@ -52,6 +52,14 @@ enum {
 	E131_DMX_LENGTH = 512
 };
 
+/**
+ * DMX512 START Code of the Property Values
+ */
+enum TStartCode {
+	E131_START_CODE_DMX			= 0x00,	///< Null START Code, dimmer data
+	E131_START_CODE_PRIORITY	= 0xDD	///< Per-slot priority, 0 is not sourced, 1-200 (ETC proprietary, widely used)
+};
+
 /**
  *
  */
@@ -33,6 +33,9 @@
 #include "e131packets.h"
 
 #include "lightset.h"
+#include "lightsetmergeengine.h"
+#include "lightsetrecorder.h"
+#include "lightsetlatency.h"
 
 // Handlers
 #include "e131dmx.h"
@@ -57,32 +60,26 @@ struct TE131BridgeState {
 	uint32_t SynchronizationTime;
 	uint32_t DiscoveryTime;
 	uint16_t DiscoveryPacketLength;
-	uint16_t nSynchronizationAddressSourceA;
-	uint16_t nSynchronizationAddressSourceB;
 	uint8_t nActiveInputPorts;
 	uint8_t nActiveOutputPorts;
-	uint8_t nPriority;
 };
 
-struct TSource {
-	uint32_t time;
-	uint32_t ip;
-	uint8_t data[E131_DMX_LENGTH];
-	uint8_t cid[E131_CID_LENGTH];
-	uint8_t sequenceNumberData;
+struct TE131BridgeStats {
+	uint32_t nParseErrors;			///< Packets discarded by the root, framing or DMP layer checks
+	uint32_t nMergeDiscards;		///< Data packets discarded, no room for another source
+	uint32_t nSequenceGaps;			///< Data packets with a sequence number not following the previous one from the same source
 };
 
 struct TE131OutputPort {
-	uint8_t data[E131_DMX_LENGTH];
 	uint16_t length;
+	struct TLightSetRange tRange;	///< Slots changed since the last LightSet::SetData
 	uint16_t nUniverse;
 	E131Merge mergeMode;
 	bool IsDataPending;
 	bool bIsEnabled;
 	bool IsTransmitting;
 	bool IsMerging;
-	struct TSource sourceA;
-	struct TSource sourceB;
+	uint16_t aSynchronizationAddress[LIGHTSET_MERGE_MAX_SOURCES];	///< Per merge engine source
 };
 
 struct TE131InputPort {
@@ -166,6 +163,13 @@ public:
 		m_pE131Sync = pE131Sync;
 	}
 
+	void SetRecorder(LightSetRecorder *pRecorder) {
+		m_pRecorder = pRecorder;
+	}
+	LightSetRecorder *GetRecorder(void) {
+		return m_pRecorder;
+	}
+
 	const uint8_t *GetCid(void) {
 		return m_Cid;
 	}
@@ -193,21 +197,42 @@ public:
 
 	void Run(void);
 
+	/**
+	 * Maximum number of packets handled by a single Run() call
+	 */
+	void SetPacketBudget(uint32_t nPacketBudget) {
+		m_nPacketBudget = (nPacketBudget == 0) ? 1 : nPacketBudget;
+	}
+	uint32_t GetPacketBudget(void) const {
+		return m_nPacketBudget;
+	}
+
+	const struct TE131BridgeStats& GetStats(void) const {
+		return m_Stats;
+	}
+
+#if defined (LIGHTSET_LATENCY)
+	LightSetLatency *GetLatency(void) {
+		return m_pLatency;
+	}
+#endif
+
 	void Print(void);
 
 private:
+	bool ReceivePacket(void);
 	bool IsValidRoot(void);
 	bool IsValidDataPacket(void);
 
-	void SetNetworkDataLossCondition(bool bSourceA = true, bool bSourceB = true);
+	void SetNetworkDataLossCondition(void);
+	void SetStreamTerminated(uint32_t nPortIndex, uint32_t nSource);
 
-	void SetSynchronizationAddress(bool bSourceA, bool bSourceB, uint16_t nSynchronizationAddress);
+	void SetSynchronizationAddress(uint32_t nPortIndex, uint32_t nSource, uint16_t nSynchronizationAddress);
+	bool IsSynchronizationAddress(uint16_t nSynchronizationAddress) const;
 
-	void CheckMergeTimeouts(uint8_t nPortIndex);
-	bool IsPriorityTimeOut(uint8_t nPortIndex);
-	bool isIpCidMatch(const struct TSource *);
-	bool IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength);
-	bool IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength);
+	void UpdateMergeState(uint32_t nPortIndex);
+	void AddChangedRange(uint32_t nPortIndex, uint32_t nFirst, uint32_t nLast);
+	void SetLightSetData(uint32_t nPortIndex);
 
 	void HandleDmx(void);
 	void HandleSynchronization(void);
@@ -231,9 +256,17 @@ private:
 
 	uint32_t m_nCurrentPacketMillis;
 	uint32_t m_nPreviousPacketMillis;
+	uint32_t m_nPacketBudget;
+
+#if defined (LIGHTSET_LATENCY)
+	LightSetLatency *m_pLatency;
+	uint32_t m_nPacketMicros;		///< Hardware::Micros() when the current packet was received
+#endif
 
 	struct TE131BridgeState m_State;
+	struct TE131BridgeStats m_Stats;
 	struct TE131OutputPort m_OutputPort[E131_MAX_PORTS];
+	LightSetMergeEngine m_MergeEngine[E131_MAX_PORTS];
 	struct TE131InputPort m_InputPort[E131_MAX_UARTS];
 	struct TE131 m_E131;
 
@@ -248,6 +281,8 @@ private:
 	// Synchronization handler
 	E131Sync *m_pE131Sync;
 
+	LightSetRecorder *m_pRecorder;
+
 public:
 	static E131Bridge* Get(void) {
 		return s_pThis;
@@ -66,6 +66,14 @@ public:
 	void HandleSync(void);
 	void HandleBlackout(void);
 
+	/**
+	 * Frame API, the universes are sent at CommitFrame followed by a single synchronization packet.
+	 * Universe() without BeginFrame() opens the frame.
+	 */
+	void BeginFrame(void);
+	void Universe(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength);
+	void CommitFrame(void);
+
 	void SetSynchronizationAddress(uint16_t nSynchronizationAddress = DEFAULT_SYNCHRONIZATION_ADDRESS) {
 		m_State.SynchronizationPacket.nUniverseNumber = nSynchronizationAddress;
 		m_State.SynchronizationPacket.nIpAddress = UniverseToMulticastIp(nSynchronizationAddress);
@@ -80,6 +88,7 @@ public:
 		} else {
 			m_nMaster = DMX_MAX_VALUE;
 		}
+		UpdateMasterTable();
 	}
 	uint32_t GetMaster(void) {
 		return m_nMaster;
@@ -91,6 +100,20 @@ public:
 	void SetPriority(uint8_t nPriority);
 
 private:
+	struct TFrameUniverse {
+		struct TE131DataPacket E131DataPacket;	///< Pre-filled template
+		uint32_t nIpAddress;
+		uint32_t nSequenceIndex;	///< Index in the sequence numbers table
+		uint16_t nActiveUniverses;	///< nSequenceIndex is valid as long as no universe is inserted
+		uint16_t nLength;
+		bool bPending;
+	};
+
+	TFrameUniverse *GetFrameUniverse(uint16_t nUniverse);
+	void FillFrameUniverse(TFrameUniverse *pFrameUniverse);
+	uint32_t GetSequenceIndex(uint16_t nUniverse) const;	///< Returns nActiveUniverses when not found
+	void CopyDmxData(uint8_t *pDestination, const uint8_t *pDmxData, uint32_t nLength);
+	void UpdateMasterTable(void);
 	uint32_t UniverseToMulticastIp(uint16_t nUniverse) const;
 	void FillDataPacket(void);
 	void FillDiscoveryPacket(void);
@@ -109,6 +132,14 @@ private:
 	uint8_t m_Cid[E131_CID_LENGTH];
 	char m_SourceName[E131_SOURCE_NAME_LENGTH];
 	uint32_t m_nMaster;
+	uint8_t m_aMasterTable[256];
+	// Frame
+	TFrameUniverse *m_pFrameUniverses;
+	uint32_t m_nFrameUniverses;
+	uint32_t m_nFrameHint;	///< Next expected entry, the universes normally arrive in the same order
+	bool m_bFrameOpen;
+
+	static constexpr uint32_t FRAME_MAX_UNIVERSES = 128;
 
 public:
 	static E131Controller* Get(void) {
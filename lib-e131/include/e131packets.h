@@ -162,7 +162,7 @@ struct TE131 {
 	int length;						///<
 	uint32_t IPAddressFrom;			///<
 	uint32_t IPAddressTo;			///<
-	union UE131Packet E131Packet;	///<
+	union UE131Packet *pE131Packet;	///< Borrowed from the network receive queue, valid until Network::RecvRelease
 };
 
 #define ROOT_LAYER_SIZE						sizeof(struct TRootLayer)
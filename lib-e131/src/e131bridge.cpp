@@ -37,6 +37,7 @@
 #include "e117const.h"
 
 #include "lightset.h"
+#include "lightsetmerge.h"
 
 #include "hardware.h"
 #include "network.h"
@@ -45,6 +46,7 @@
 #include "debug.h"
 
 static constexpr uint8_t SOFTWARE_VERSION[] = { 1, 18 };
+static constexpr uint32_t PACKET_BUDGET_DEFAULT = 16;	///< Packets per Run()
 
 E131Bridge *E131Bridge::s_pThis = 0;
 
@@ -55,11 +57,13 @@ E131Bridge::E131Bridge(void) :
 	m_bEnableDataIndicator(true),
 	m_nCurrentPacketMillis(0),
 	m_nPreviousPacketMillis(0),
+	m_nPacketBudget(PACKET_BUDGET_DEFAULT),
 	m_pE131DmxIn(0),
 	m_pE131DataPacket(0),
 	m_pE131DiscoveryPacket(0),
 	m_DiscoveryIpAddress(0),
-	m_pE131Sync(0)
+	m_pE131Sync(0),
+	m_pRecorder(0)
 {
 	assert(Hardware::Get() != 0);
 	assert(Network::Get() != 0);
@@ -70,6 +74,7 @@ E131Bridge::E131Bridge(void) :
 
 	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
 		memset(&m_OutputPort[i], 0, sizeof(struct TE131OutputPort));
+		m_OutputPort[i].tRange.nFirst = E131_DMX_LENGTH;
 		m_OutputPort[i].nUniverse = E131_UNIVERSE_DEFAULT;
 		m_OutputPort[i].mergeMode = E131Merge::HTP;
 	}
@@ -80,7 +85,13 @@ E131Bridge::E131Bridge(void) :
 	}
 
 	memset(&m_State, 0, sizeof(struct TE131BridgeState));
-	m_State.nPriority = E131_PRIORITY_LOWEST;
+	memset(&m_Stats, 0, sizeof(struct TE131BridgeStats));
+
+#if defined (LIGHTSET_LATENCY)
+	m_pLatency = new LightSetLatency(E131_MAX_PORTS);
+	assert(m_pLatency != 0);
+	m_nPacketMicros = 0;
+#endif
 
 	char aSourceName[E131_SOURCE_NAME_LENGTH];
 	uint8_t nLength;
@@ -96,6 +107,10 @@ E131Bridge::E131Bridge(void) :
 
 E131Bridge::~E131Bridge(void) {
 	Stop();
+
+#if defined (LIGHTSET_LATENCY)
+	delete m_pLatency;
+#endif
 }
 
 void E131Bridge::Start(void) {
@@ -174,42 +189,50 @@ uint32_t E131Bridge::UniverseToMulticastIp(uint16_t nUniverse) const {
 	return nMulticastIp;
 }
 
-void E131Bridge::SetSynchronizationAddress(bool bSourceA, bool bSourceB, uint16_t nSynchronizationAddress) {
+void E131Bridge::SetSynchronizationAddress(uint32_t nPortIndex, uint32_t nSource, uint16_t nSynchronizationAddress) {
 	DEBUG_ENTRY
-	DEBUG_PRINTF("bSourceA=%d, bSourceB=%d, nSynchronizationAddress=%d", bSourceA, bSourceB, nSynchronizationAddress);
+	DEBUG_PRINTF("nPortIndex=%u, nSource=%u, nSynchronizationAddress=%d", nPortIndex, nSource, nSynchronizationAddress);
 
-	assert(nSynchronizationAddress != 0);
+	assert(nPortIndex < E131_MAX_PORTS);
+	assert(nSource < LIGHTSET_MERGE_MAX_SOURCES);
 
-	uint16_t *pSynchronizationAddressSource;
+	uint16_t *pSynchronizationAddressSource = &m_OutputPort[nPortIndex].aSynchronizationAddress[nSource];
 
-	if (bSourceA) {
-		pSynchronizationAddressSource = &m_State.nSynchronizationAddressSourceA;
-	} else if (bSourceB) {
-		pSynchronizationAddressSource = &m_State.nSynchronizationAddressSourceB;
-	} else {
+	if (*pSynchronizationAddressSource == nSynchronizationAddress) {
+		DEBUG_PUTS("Already received SynchronizationAddress");
 		DEBUG_EXIT
-		return; // Just make the compiler happy
+		return;
 	}
 
-	if (*pSynchronizationAddressSource == 0) {
-		*pSynchronizationAddressSource = nSynchronizationAddress;
-		DEBUG_PUTS("SynchronizationAddressSource == 0");
-	} else if (*pSynchronizationAddressSource != nSynchronizationAddress) {
+	const uint16_t nPreviousSynchronizationAddress = *pSynchronizationAddressSource;
+	const bool bIsJoined = (nSynchronizationAddress != 0) && IsSynchronizationAddress(nSynchronizationAddress);
+
+	*pSynchronizationAddressSource = nSynchronizationAddress;
+
+	if ((nPreviousSynchronizationAddress != 0) && !IsSynchronizationAddress(nPreviousSynchronizationAddress)) {
 		// E131_MAX_PORTS forces to check all ports
-		LeaveUniverse(E131_MAX_PORTS, *pSynchronizationAddressSource);
-		*pSynchronizationAddressSource = nSynchronizationAddress;
-		DEBUG_PUTS("SynchronizationAddressSource != nSynchronizationAddress");
-	} else {
-		DEBUG_PUTS("Already received SynchronizationAddress");
-		DEBUG_EXIT
-		return;
+		LeaveUniverse(E131_MAX_PORTS, nPreviousSynchronizationAddress);
 	}
 
-	Network::Get()->JoinGroup(m_nHandle, UniverseToMulticastIp(nSynchronizationAddress));
+	if ((nSynchronizationAddress != 0) && !bIsJoined) {
+		Network::Get()->JoinGroup(m_nHandle, UniverseToMulticastIp(nSynchronizationAddress));
+	}
 
 	DEBUG_EXIT
 }
 
+bool E131Bridge::IsSynchronizationAddress(uint16_t nSynchronizationAddress) const {
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		for (uint32_t nSource = 0; nSource < LIGHTSET_MERGE_MAX_SOURCES; nSource++) {
+			if (m_OutputPort[i].aSynchronizationAddress[nSource] == nSynchronizationAddress) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void E131Bridge::LeaveUniverse(uint8_t nPortIndex, uint16_t nUniverse) {
 	DEBUG_ENTRY
 	DEBUG_PRINTF("nPortIndex=%d, nUniverse=%d", nPortIndex, nUniverse);
@@ -313,6 +336,7 @@ void E131Bridge::SetMergeMode(uint8_t nPortIndex, E131Merge tE131Merge) {
 	assert(nPortIndex < E131_MAX_PORTS);
 
 	m_OutputPort[nPortIndex].mergeMode = tE131Merge;
+	m_MergeEngine[nPortIndex].SetMode(tE131Merge == E131Merge::LTP ? LightSetMergeMode::LTP : LightSetMergeMode::HTP);
 }
 
 E131Merge E131Bridge::GetMergeMode(uint8_t nPortIndex) const {
@@ -321,145 +345,84 @@ E131Merge E131Bridge::GetMergeMode(uint8_t nPortIndex) const {
 	return m_OutputPort[nPortIndex].mergeMode;
 }
 
-bool E131Bridge::IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
+void E131Bridge::UpdateMergeState(uint32_t nPortIndex) {
 	assert(nPortIndex < E131_MAX_PORTS);
-	assert(pData != 0);
-
-	bool isChanged = false;
 
-	const uint8_t *pSrc = pData;
-	uint8_t *pDst = m_OutputPort[nPortIndex].data;
+	const bool bIsMerging = (m_MergeEngine[nPortIndex].GetSources() > 1);
 
-	if (nLength != m_OutputPort[nPortIndex].length) {
-		m_OutputPort[nPortIndex].length = nLength;
-		for (unsigned i = 0 ; i < E131_DMX_LENGTH; i++) {
-			*pDst++ = *pSrc++;
-		}
-		return true;
-	}
-
-	for (unsigned i = 0; i < E131_DMX_LENGTH; i++) {
-		if (*pDst != *pSrc) {
-			*pDst = *pSrc;
-			isChanged = true;
-		}
-		pDst++;
-		pSrc++;
+	if (bIsMerging == m_OutputPort[nPortIndex].IsMerging) {
+		return;
 	}
 
-	return isChanged;
-}
-
-bool E131Bridge::IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
-	assert(nPortIndex < E131_MAX_PORTS);
-	assert(pData != 0);
+	m_OutputPort[nPortIndex].IsMerging = bIsMerging;
 
-	bool isChanged = false;
+	bool bIsMergeMode = false;
 
-	if (!m_State.IsMergeMode) {
-		m_State.IsMergeMode = true;
-		m_State.IsChanged = true;
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		bIsMergeMode |= m_OutputPort[i].IsMerging;
 	}
 
-	m_OutputPort[nPortIndex].IsMerging = true;
-
-	if (m_OutputPort[nPortIndex].mergeMode == E131Merge::HTP) {
-
-		if (nLength != m_OutputPort[nPortIndex].length) {
-			m_OutputPort[nPortIndex].length = nLength;
-			for (unsigned i = 0; i < nLength; i++) {
-				uint8_t data = std::max(m_OutputPort[nPortIndex].sourceA.data[i], m_OutputPort[nPortIndex].sourceB.data[i]);
-				m_OutputPort[nPortIndex].data[i] = data;
-			}
-			return true;
-		}
-
-		for (unsigned i = 0; i < nLength; i++) {
-			uint8_t data = std::max(m_OutputPort[nPortIndex].sourceA.data[i], m_OutputPort[nPortIndex].sourceB.data[i]);
-			if (data != m_OutputPort[nPortIndex].data[i]) {
-				m_OutputPort[nPortIndex].data[i] = data;
-				isChanged = true;
-			}
-		}
-
-		return isChanged;
-	} else {
-		return IsDmxDataChanged(nPortIndex, pData, nLength);
+	if (bIsMergeMode != m_State.IsMergeMode) {
+		m_State.IsMergeMode = bIsMergeMode;
+		m_State.IsChanged = true;
 	}
 }
 
-void E131Bridge::CheckMergeTimeouts(uint8_t nPortIndex) {
+/*
+ * The range accumulates while data is pending for synchronization
+ */
+void E131Bridge::AddChangedRange(uint32_t nPortIndex, uint32_t nFirst, uint32_t nLast) {
 	assert(nPortIndex < E131_MAX_PORTS);
 
-	const uint32_t timeOutA = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceA.time;
-
-	if (timeOutA > (E131_MERGE_TIMEOUT_SECONDS * 1000)) {
-		m_OutputPort[nPortIndex].sourceA.ip = 0;
-		memset(m_OutputPort[nPortIndex].sourceA.cid, 0, E131_CID_LENGTH);
-		m_OutputPort[nPortIndex].IsMerging = false;
-	}
-
-	const uint32_t timeOutB = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceB.time;
+	struct TLightSetRange *pRange = &m_OutputPort[nPortIndex].tRange;
 
-	if (timeOutB > (E131_MERGE_TIMEOUT_SECONDS * 1000)) {
-		m_OutputPort[nPortIndex].sourceB.ip = 0;
-		memset(m_OutputPort[nPortIndex].sourceB.cid, 0, E131_CID_LENGTH);
-		m_OutputPort[nPortIndex].IsMerging = false;
+	if (pRange->nFirst > pRange->nLast) {
+		pRange->nFirst = static_cast<uint16_t>(nFirst);
+		pRange->nLast = static_cast<uint16_t>(nLast);
+		return;
 	}
 
-	bool bIsMerging = false;
-
-	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-		bIsMerging |= m_OutputPort[i].IsMerging;
+	if (nFirst < pRange->nFirst) {
+		pRange->nFirst = static_cast<uint16_t>(nFirst);
 	}
 
-	if (!bIsMerging) {
-		m_State.IsChanged = true;
-		m_State.IsMergeMode = false;
+	if (nLast > pRange->nLast) {
+		pRange->nLast = static_cast<uint16_t>(nLast);
 	}
-
 }
 
-bool E131Bridge::IsPriorityTimeOut(uint8_t nPortIndex) {
+void E131Bridge::SetLightSetData(uint32_t nPortIndex) {
 	assert(nPortIndex < E131_MAX_PORTS);
 
-	const uint32_t timeOutA = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceA.time;
-	const uint32_t timeOutB = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceB.time;
+	struct TLightSetRange *pRange = &m_OutputPort[nPortIndex].tRange;
+	const uint8_t nPort = static_cast<uint8_t>(nPortIndex);
 
-	if ( (m_OutputPort[nPortIndex].sourceA.ip != 0) && (m_OutputPort[nPortIndex].sourceB.ip != 0) ) {
-		if ( (timeOutA < (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) || (timeOutB < (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) ) {
-			return false;
-		} else {
-			return true;
-		}
-	} else if ( (m_OutputPort[nPortIndex].sourceA.ip != 0) && (m_OutputPort[nPortIndex].sourceB.ip == 0) ) {
-		if (timeOutA > (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) {
-			return true;
-		}
-	} else if ( (m_OutputPort[nPortIndex].sourceA.ip == 0) && (m_OutputPort[nPortIndex].sourceB.ip != 0) ) {
-		if (timeOutB > (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) {
-			return true;
-		}
+	if (pRange->nFirst <= pRange->nLast) {
+		m_pLightSet->SetData(nPort, m_MergeEngine[nPortIndex].GetData(), m_OutputPort[nPortIndex].length, *pRange);
+	} else {
+		m_pLightSet->SetData(nPort, m_MergeEngine[nPortIndex].GetData(), m_OutputPort[nPortIndex].length);
 	}
 
-	return false;
+	pRange->nFirst = E131_DMX_LENGTH;
+	pRange->nLast = 0;
 }
 
-bool E131Bridge::isIpCidMatch(const struct TSource *source) {
-	if (source->ip != m_E131.IPAddressFrom) {
-		return false;
-	}
+void E131Bridge::HandleDmx(void) {
+	const uint8_t nStartCode = m_E131.pE131Packet->Data.DMPLayer.PropertyValues[0];
 
-	if (memcmp(source->cid, m_E131.E131Packet.Raw.RootLayer.Cid, E131_CID_LENGTH) != 0) {
-		return false;
+	if ((nStartCode != E131_START_CODE_DMX) && (nStartCode != E131_START_CODE_PRIORITY)) {
+		return;
 	}
 
-	return true;
-}
+	const uint8_t *p = &m_E131.pE131Packet->Data.DMPLayer.PropertyValues[1];
+	const uint16_t slots = __builtin_bswap16(m_E131.pE131Packet->Data.DMPLayer.PropertyValueCount) - 1;
+	const uint8_t *pCid = m_E131.pE131Packet->Data.RootLayer.Cid;
+	const uint8_t nSequenceNumber = m_E131.pE131Packet->Data.FrameLayer.SequenceNumber;
+	const uint8_t nPriority = m_E131.pE131Packet->Data.FrameLayer.Priority;
 
-void E131Bridge::HandleDmx(void) {
-	const uint8_t *p = &m_E131.E131Packet.Data.DMPLayer.PropertyValues[1];
-	const uint16_t slots = __builtin_bswap16(m_E131.E131Packet.Data.DMPLayer.PropertyValueCount) - 1;
+	if ((m_pRecorder != 0) && (nStartCode == E131_START_CODE_DMX)) {
+		m_pRecorder->Record(__builtin_bswap16(m_E131.pE131Packet->Data.FrameLayer.Universe), p, slots);
+	}
 
 	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
 		if (!m_OutputPort[i].bIsEnabled) {
@@ -470,34 +433,27 @@ void E131Bridge::HandleDmx(void) {
 		// 8.2 Association of Multicast Addresses and Universe
 		// Note: The identity of the universe shall be determined by the universe number in the
 		// packet and not assumed from the multicast address.
-		if (m_E131.E131Packet.Data.FrameLayer.Universe != __builtin_bswap16(m_OutputPort[i].nUniverse)) {
+		if (m_E131.pE131Packet->Data.FrameLayer.Universe != __builtin_bswap16(m_OutputPort[i].nUniverse)) {
 			continue;
 		}
 
-		struct TSource *pSourceA = &m_OutputPort[i].sourceA;
-		struct TSource *pSourceB = &m_OutputPort[i].sourceB;
-
-		const uint32_t ipA = pSourceA->ip;
-		const uint32_t ipB = pSourceB->ip;
-
-		const bool isSourceA = isIpCidMatch(pSourceA);
-		const bool isSourceB = isIpCidMatch(pSourceB);
+#if defined (LIGHTSET_LATENCY)
+		m_pLatency->Add(i, LightSetLatencyStage::DISPATCH, Hardware::Get()->Micros() - m_nPacketMicros);
+#endif
 
-		bool sendNewData = false;
+		LightSetMergeEngine *pMergeEngine = &m_MergeEngine[i];
+		int32_t nSource = pMergeEngine->Find(m_E131.IPAddressFrom, pCid);
 
 		// 6.9.2 Sequence Numbering
 		// Having first received a packet with sequence number A, a second packet with sequence number B
 		// arrives. If, using signed 8-bit binary arithmetic, B – A is less than or equal to 0, but greater than -20 then
 		// the packet containing sequence number B shall be deemed out of sequence and discarded
-		if (isSourceA) {
-			const int8_t diff = (m_E131.E131Packet.Data.FrameLayer.SequenceNumber - pSourceA->sequenceNumberData);
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			if ((diff <= 0) && (diff > -20)) {
-				continue;
+		if (nSource >= 0) {
+			const int8_t diff = static_cast<int8_t>(nSequenceNumber - pMergeEngine->GetSequenceNumber(static_cast<uint32_t>(nSource)));
+			pMergeEngine->SetSequenceNumber(static_cast<uint32_t>(nSource), nSequenceNumber);
+			if (diff != 1) {
+				m_Stats.nSequenceGaps++;
 			}
-		} else if (isSourceB) {
-			const int8_t diff = (m_E131.E131Packet.Data.FrameLayer.SequenceNumber - pSourceB->sequenceNumberData);
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
 			if ((diff <= 0) && (diff > -20)) {
 				continue;
 			}
@@ -505,126 +461,73 @@ void E131Bridge::HandleDmx(void) {
 
 		// This bit, when set to 1, indicates that the data in this packet is intended for use in visualization or media
 		// server preview applications and shall not be used to generate live output.
-		if ((m_E131.E131Packet.Data.FrameLayer.Options & E131_OPTIONS_MASK_PREVIEW_DATA) != 0) {
+		if ((m_E131.pE131Packet->Data.FrameLayer.Options & E131_OPTIONS_MASK_PREVIEW_DATA) != 0) {
 			continue;
 		}
 
 		// Upon receipt of a packet containing this bit set to a value of 1, receiver shall enter network data loss condition.
 		// Any property values in these packets shall be ignored.
-		if ((m_E131.E131Packet.Data.FrameLayer.Options & E131_OPTIONS_MASK_STREAM_TERMINATED) != 0) {
-			if (isSourceA || isSourceB) {
-				SetNetworkDataLossCondition(isSourceA, isSourceB);
+		if ((m_E131.pE131Packet->Data.FrameLayer.Options & E131_OPTIONS_MASK_STREAM_TERMINATED) != 0) {
+			if (nSource >= 0) {
+				SetStreamTerminated(i, static_cast<uint32_t>(nSource));
 			}
 			continue;
 		}
 
-		if (m_State.IsMergeMode) {
-			if (__builtin_expect((!m_State.bDisableMergeTimeout), 1)) {
-				CheckMergeTimeouts(i);
+		bool sendNewData = false;
+		struct TLightSetRange tRange;
+
+		if (__builtin_expect((!m_State.bDisableMergeTimeout), 1)) {
+			if (pMergeEngine->Expire(m_nCurrentPacketMillis, E131_MERGE_TIMEOUT_SECONDS * 1000, tRange)) {
+				AddChangedRange(i, tRange.nFirst, tRange.nLast);
+				sendNewData = true;
 			}
 		}
 
-		if (m_E131.E131Packet.Data.FrameLayer.Priority < m_State.nPriority ){
-			if (!IsPriorityTimeOut(i)) {
+		if (nSource < 0) {
+			nSource = pMergeEngine->Add(m_E131.IPAddressFrom, pCid, nPriority, m_nCurrentPacketMillis);
+
+			if (nSource < 0) {
+				DEBUG_PUTS("No room for source, discarding data");
+				m_Stats.nMergeDiscards++;
 				continue;
 			}
-			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
-		} else if (m_E131.E131Packet.Data.FrameLayer.Priority > m_State.nPriority) {
-			m_OutputPort[i].sourceA.ip = 0;
-			m_OutputPort[i].sourceB.ip = 0;
-			m_State.IsMergeMode = false;
-			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
-		}
-
-		if ((ipA == 0) && (ipB == 0)) {
-			//printf("1. First package from Source\n");
-			pSourceA->ip = m_E131.IPAddressFrom;
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			memcpy(pSourceA->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsDmxDataChanged(i, p, slots);
-
-		} else if (isSourceA && (ipB == 0)) {
-			//printf("2. Continue package from SourceA\n");
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsDmxDataChanged(i, p, slots);
-
-		} else if ((ipA == 0) && isSourceB) {
-			//printf("3. Continue package from SourceB\n");
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceB->time = m_nCurrentPacketMillis;
-			memcpy(pSourceB->data, p, slots);
-			sendNewData = IsDmxDataChanged(i, p, slots);
-
-		} else if (!isSourceA && (ipB == 0)) {
-			//printf("4. New ip, start merging\n");
-			pSourceB->ip = m_E131.IPAddressFrom;
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			memcpy(pSourceB->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
-			pSourceB->time = m_nCurrentPacketMillis;
-			memcpy(pSourceB->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceB->data, slots);
-
-		} else if ((ipA == 0) && !isSourceB) {
-			//printf("5. New ip, start merging\n");
-			pSourceA->ip = m_E131.IPAddressFrom;
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			memcpy(pSourceA->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceA->data, slots);
-
-		} else if (isSourceA && !isSourceB) {
-			//printf("6. Continue merging\n");
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceA->data, slots);
-
-		} else if (!isSourceA && isSourceB) {
-			//printf("7. Continue merging\n");
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceB->time = m_nCurrentPacketMillis;
-			memcpy(pSourceB->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceB->data, slots);
-
-		} else if (isSourceA && isSourceB) {
-			printf("8. Source matches both buffers, this shouldn't be happening!\n");
-			assert(0);
-			return;
 
-		} else if (!isSourceA && !isSourceB) {
-			printf("9. More than two sources, discarding data\n");
-			assert(0);
-			return;
+			pMergeEngine->SetSequenceNumber(static_cast<uint32_t>(nSource), nSequenceNumber);
+			SetSynchronizationAddress(i, static_cast<uint32_t>(nSource), 0);
+		}
+
+		bool bIsChanged;
 
+		if (nStartCode == E131_START_CODE_DMX) {
+			bIsChanged = pMergeEngine->SetData(static_cast<uint32_t>(nSource), nPriority, p, slots, m_nCurrentPacketMillis, tRange);
 		} else {
-			printf("0. No cases matched, this shouldn't happen!\n");
-			assert(0);
-			return;
+			bIsChanged = pMergeEngine->SetSlotPriority(static_cast<uint32_t>(nSource), p, slots, m_nCurrentPacketMillis, tRange);
 		}
 
+		if (bIsChanged) {
+			AddChangedRange(i, tRange.nFirst, tRange.nLast);
+			sendNewData = true;
+		}
+
+		m_OutputPort[i].length = pMergeEngine->GetLength();
+
+		UpdateMergeState(i);
+
 		// This bit indicates whether to lock or revert to an unsynchronized state when synchronization is lost
 		// (See Section 11 on Universe Synchronization and 11.1 for discussion on synchronization states).
 		// When set to 0, components that had been operating in a synchronized state shall not update with any
 		// new packets until synchronization resumes. When set to 1, once synchronization has been lost,
 		// components that had been operating in a synchronized state need not wait for a new
 		// E1.31 Synchronization Packet in order to update to the next E1.31 Data Packet.
-		if ((m_E131.E131Packet.Data.FrameLayer.Options & E131_OPTIONS_MASK_FORCE_SYNCHRONIZATION) == 0) {
+		if ((m_E131.pE131Packet->Data.FrameLayer.Options & E131_OPTIONS_MASK_FORCE_SYNCHRONIZATION) == 0) {
 			// 6.3.3.1 Synchronization Address Usage in an E1.31 Synchronization Packet
 			// An E1.31 Synchronization Packet is sent to synchronize the E1.31 data on a specific universe number.
 			// A Synchronization Address of 0 is thus meaningless, and shall not be transmitted.
 			// Receivers shall ignore E1.31 Synchronization Packets containing a Synchronization Address of 0.
-			if (m_E131.E131Packet.Data.FrameLayer.SynchronizationAddress != 0) {
+			if (m_E131.pE131Packet->Data.FrameLayer.SynchronizationAddress != 0) {
 				if (!m_State.IsForcedSynchronized) {
-					if (!(isSourceA || isSourceB)) {
-						SetSynchronizationAddress((pSourceA->ip != 0), (pSourceB->ip != 0), __builtin_bswap16(m_E131.E131Packet.Data.FrameLayer.SynchronizationAddress));
-					} else {
-						SetSynchronizationAddress(isSourceA, isSourceB, __builtin_bswap16(m_E131.E131Packet.Data.FrameLayer.SynchronizationAddress));
-					}
+					SetSynchronizationAddress(i, static_cast<uint32_t>(nSource), __builtin_bswap16(m_E131.pE131Packet->Data.FrameLayer.SynchronizationAddress));
 					m_State.IsForcedSynchronized = true;
 					m_State.IsSynchronized = true;
 				}
@@ -636,7 +539,10 @@ void E131Bridge::HandleDmx(void) {
 		if (sendNewData || m_bDirectUpdate) {
 			if ((!m_State.IsSynchronized) || (m_State.bDisableSynchronize)) {
 
-				m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
+				SetLightSetData(i);
+#if defined (LIGHTSET_LATENCY)
+				m_pLatency->Add(i, LightSetLatencyStage::OUTPUT, Hardware::Get()->Micros() - m_nPacketMicros);
+#endif
 
 				if (!m_OutputPort[i].IsTransmitting) {
 					m_pLightSet->Start(i);
@@ -645,6 +551,9 @@ void E131Bridge::HandleDmx(void) {
 				}
 			} else {
 				m_OutputPort[i].IsDataPending = sendNewData;
+#if defined (LIGHTSET_LATENCY)
+				m_pLatency->SetPending(i, m_nPacketMicros);
+#endif
 			}
 
 		}
@@ -661,9 +570,9 @@ void E131Bridge::HandleSynchronization(void) {
 	// NOTE: There is no multicast addresses (To Ip) available
 	// We just check if SynchronizationAddress is published by a Source
 
-	const uint16_t nSynchronizationAddress = __builtin_bswap16(m_E131.E131Packet.Synchronization.FrameLayer.UniverseNumber);
+	const uint16_t nSynchronizationAddress = __builtin_bswap16(m_E131.pE131Packet->Synchronization.FrameLayer.UniverseNumber);
 
-	if ((nSynchronizationAddress != m_State.nSynchronizationAddressSourceA) && (nSynchronizationAddress != m_State.nSynchronizationAddressSourceB)) {
+	if ((nSynchronizationAddress == 0) || !IsSynchronizationAddress(nSynchronizationAddress)) {
 		LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
 		DEBUG_PUTS("");
 		return;
@@ -674,7 +583,14 @@ void E131Bridge::HandleSynchronization(void) {
 	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
 		if ((m_OutputPort[i].IsDataPending) || (m_OutputPort[i].bIsEnabled && m_bDirectUpdate)){
 
-			m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
+			SetLightSetData(i);
+#if defined (LIGHTSET_LATENCY)
+			const uint32_t nMicros = Hardware::Get()->Micros();
+			if (m_OutputPort[i].IsDataPending) {
+				m_pLatency->Add(i, LightSetLatencyStage::OUTPUT, nMicros - m_pLatency->GetPending(i));
+			}
+			m_pLatency->Add(i, LightSetLatencyStage::SYNC, nMicros - m_nPacketMicros);
+#endif
 
 			if (!m_OutputPort[i].IsTransmitting) {
 				m_pLightSet->Start(i);
@@ -690,61 +606,71 @@ void E131Bridge::HandleSynchronization(void) {
 	}
 }
 
-void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
+void E131Bridge::SetNetworkDataLossCondition(void) {
 	DEBUG_ENTRY
-	DEBUG_PRINTF("%d %d", bSourceA, bSourceB);
 
 	m_State.IsChanged = true;
+	m_State.IsNetworkDataLoss = true;
+	m_State.IsMergeMode = false;
+	m_State.IsSynchronized = false;
+	m_State.IsForcedSynchronized = false;
 
-	if (bSourceA && bSourceB) {
-		m_State.IsNetworkDataLoss = true;
-		m_State.IsMergeMode = false;
-		m_State.IsSynchronized = false;
-		m_State.IsForcedSynchronized = false;
-		m_State.nPriority = E131_PRIORITY_LOWEST;
-
-		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-			if (m_OutputPort[i].IsTransmitting) {
-				m_pLightSet->Stop(i);
-				m_OutputPort[i].sourceA.ip = 0;
-				memset(m_OutputPort[i].sourceA.cid, 0, E131_CID_LENGTH);
-				m_OutputPort[i].sourceB.ip = 0;
-				memset(m_OutputPort[i].sourceB.cid, 0, E131_CID_LENGTH);
-				m_OutputPort[i].length = 0;
-				m_OutputPort[i].IsDataPending = false;
-				m_OutputPort[i].IsTransmitting = false;
-				m_OutputPort[i].IsMerging = false;
-			}
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_OutputPort[i].IsTransmitting) {
+			m_pLightSet->Stop(i);
+			m_MergeEngine[i].Clear();
+			m_OutputPort[i].length = 0;
+			m_OutputPort[i].IsDataPending = false;
+			m_OutputPort[i].IsTransmitting = false;
+			m_OutputPort[i].IsMerging = false;
 		}
+	}
 
-	} else {
-		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-			if (m_OutputPort[i].IsTransmitting) {
+	LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
+	m_State.bIsReceivingDmx = false;
 
-				if ((bSourceA) && (m_OutputPort[i].sourceA.ip != 0)) {
-					m_OutputPort[i].sourceA.ip = 0;
-					memset(m_OutputPort[i].sourceA.cid, 0, E131_CID_LENGTH);
-					m_OutputPort[i].IsMerging = false;
-				}
+	DEBUG_EXIT
+}
 
-				if ((bSourceB) && (m_OutputPort[i].sourceB.ip != 0)) {
-					m_OutputPort[i].sourceB.ip = 0;
-					memset(m_OutputPort[i].sourceB.cid, 0, E131_CID_LENGTH);
-					m_OutputPort[i].IsMerging = false;
-				}
+/*
+ * The source has stopped, the output is merged from the remaining sources.
+ * Without remaining sources the port enters the network data loss condition.
+ */
+void E131Bridge::SetStreamTerminated(uint32_t nPortIndex, uint32_t nSource) {
+	DEBUG_ENTRY
+	DEBUG_PRINTF("nPortIndex=%u, nSource=%u", nPortIndex, nSource);
 
-				if (!m_State.IsMergeMode) {
-					m_pLightSet->Stop(i);
-					m_OutputPort[i].length = 0;
-					m_OutputPort[i].IsDataPending = false;
-					m_OutputPort[i].IsTransmitting = false;
-				}
-			}
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	struct TLightSetRange tRange;
+	const bool bIsChanged = m_MergeEngine[nPortIndex].Remove(nSource, tRange);
+
+	SetSynchronizationAddress(nPortIndex, nSource, 0);
+	UpdateMergeState(nPortIndex);
+
+	m_State.IsChanged = true;
+
+	if (m_MergeEngine[nPortIndex].GetSources() == 0) {
+		if (m_OutputPort[nPortIndex].IsTransmitting) {
+			m_pLightSet->Stop(nPortIndex);
+			m_OutputPort[nPortIndex].IsTransmitting = false;
 		}
-	}
 
-	LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
-	m_State.bIsReceivingDmx = false;
+		m_OutputPort[nPortIndex].length = 0;
+		m_OutputPort[nPortIndex].IsDataPending = false;
+
+		LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
+		m_State.bIsReceivingDmx = false;
+	} else if (bIsChanged && m_OutputPort[nPortIndex].IsTransmitting) {
+		AddChangedRange(nPortIndex, tRange.nFirst, tRange.nLast);
+		m_OutputPort[nPortIndex].length = m_MergeEngine[nPortIndex].GetLength();
+
+		if ((!m_State.IsSynchronized) || (m_State.bDisableSynchronize)) {
+			SetLightSetData(nPortIndex);
+		} else {
+			m_OutputPort[nPortIndex].IsDataPending = true;
+		}
+	}
 
 	DEBUG_EXIT
 }
@@ -771,15 +697,13 @@ bool E131Bridge::IsStatusChanged(void) {
 void E131Bridge::Clear(uint8_t nPortIndex) {
 	assert(nPortIndex < E131_MAX_PORTS);
 
-	uint8_t *pDst = m_OutputPort[nPortIndex].data;
-
-	for (uint32_t i = 0; i < E131_DMX_LENGTH; i++) {
-		*pDst++ = 0;
-	}
+	m_MergeEngine[nPortIndex].Clear();
+	UpdateMergeState(nPortIndex);
 
 	m_OutputPort[nPortIndex].length = E131_DMX_LENGTH;
 
-	m_pLightSet->SetData(nPortIndex, m_OutputPort[nPortIndex].data, m_OutputPort[nPortIndex].length);
+	AddChangedRange(nPortIndex, 0, E131_DMX_LENGTH - 1);
+	SetLightSetData(nPortIndex);
 
 	if (m_OutputPort[nPortIndex].bIsEnabled && !m_OutputPort[nPortIndex].IsTransmitting) {
 		m_pLightSet->Start(nPortIndex);
@@ -792,12 +716,12 @@ void E131Bridge::Clear(uint8_t nPortIndex) {
 bool E131Bridge::IsValidRoot(void) {
 	// 5 E1.31 use of the ACN Root Layer Protocol
 	// Receivers shall discard the packet if the ACN Packet Identifier is not valid.
-	if (memcmp(m_E131.E131Packet.Raw.RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH) != 0) {
+	if (memcmp(m_E131.pE131Packet->Raw.RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH) != 0) {
 		return false;
 	}
 	
-	if (m_E131.E131Packet.Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_DATA)
-			 && (m_E131.E131Packet.Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_EXTENDED)) ) {
+	if (m_E131.pE131Packet->Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_DATA)
+			 && (m_E131.pE131Packet->Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_EXTENDED)) ) {
 		return false;
 	}
 
@@ -809,39 +733,91 @@ bool E131Bridge::IsValidDataPacket(void) {
 
 	// The DMP Layer's Vector shall be set to 0x02, which indicates a DMP Set Property message by
 	// transmitters. Receivers shall discard the packet if the received value is not 0x02.
-	if (m_E131.E131Packet.Data.DMPLayer.Vector != E131_VECTOR_DMP_SET_PROPERTY) {
+	if (m_E131.pE131Packet->Data.DMPLayer.Vector != E131_VECTOR_DMP_SET_PROPERTY) {
 		return false;
 	}
 
 	// Transmitters shall set the DMP Layer's Address Type and Data Type to 0xa1. Receivers shall discard the
 	// packet if the received value is not 0xa1.
-	if (m_E131.E131Packet.Data.DMPLayer.Type != 0xa1) {
+	if (m_E131.pE131Packet->Data.DMPLayer.Type != 0xa1) {
 		return false;
 	}
 
 	// Transmitters shall set the DMP Layer's First Property Address to 0x0000. Receivers shall discard the
 	// packet if the received value is not 0x0000.
-	if (m_E131.E131Packet.Data.DMPLayer.FirstAddressProperty != __builtin_bswap16(0x0000)) {
+	if (m_E131.pE131Packet->Data.DMPLayer.FirstAddressProperty != __builtin_bswap16(0x0000)) {
 		return false;
 	}
 
 	// Transmitters shall set the DMP Layer's Address Increment to 0x0001. Receivers shall discard the packet if
 	// the received value is not 0x0001.
-	if (m_E131.E131Packet.Data.DMPLayer.AddressIncrement != __builtin_bswap16(0x0001)) {
+	if (m_E131.pE131Packet->Data.DMPLayer.AddressIncrement != __builtin_bswap16(0x0001)) {
 		return false;
 	}
 
 	return true;
 }
 
-void E131Bridge::Run(void) {
+bool E131Bridge::ReceivePacket(void) {
 	uint16_t nForeignPort;
 
-	const uint16_t nBytesReceived = Network::Get()->RecvFrom(m_nHandle, &m_E131.E131Packet, sizeof(m_E131.E131Packet), &m_E131.IPAddressFrom, &nForeignPort) ;
+	const uint16_t nBytesReceived = Network::Get()->RecvBorrow(m_nHandle, reinterpret_cast<void**>(&m_E131.pE131Packet), &m_E131.IPAddressFrom, &nForeignPort) ;
 
 	m_nCurrentPacketMillis = Hardware::Get()->Millis();
 
 	if (__builtin_expect((nBytesReceived == 0), 1)) {
+		return false;
+	}
+
+	if (__builtin_expect((!IsValidRoot()), 0)) {
+		m_Stats.nParseErrors++;
+		Network::Get()->RecvRelease(m_nHandle);
+		return true;
+	}
+
+	m_State.IsNetworkDataLoss = false;
+	m_nPreviousPacketMillis = m_nCurrentPacketMillis;
+#if defined (LIGHTSET_LATENCY)
+	m_nPacketMicros = Hardware::Get()->Micros();
+#endif
+
+	if (m_State.IsSynchronized && !m_State.IsForcedSynchronized) {
+		if ((m_nCurrentPacketMillis - m_State.SynchronizationTime) >= (E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000)) {
+			m_State.IsSynchronized = false;
+		}
+	}
+
+	const uint32_t nRootVector = __builtin_bswap32(m_E131.pE131Packet->Raw.RootLayer.Vector);
+
+	if (nRootVector == E131_VECTOR_ROOT_DATA) {
+		if (IsValidDataPacket()) {
+			HandleDmx();
+		} else {
+			m_Stats.nParseErrors++;
+		}
+	} else if (nRootVector == E131_VECTOR_ROOT_EXTENDED) {
+		const uint32_t nFramingVector = __builtin_bswap32(m_E131.pE131Packet->Raw.FrameLayer.Vector);
+			if (nFramingVector == E131_VECTOR_EXTENDED_SYNCHRONIZATION) {
+			HandleSynchronization();
+		}
+	} else {
+		DEBUG_PRINTF("Not supported Root Vector : 0x%x", nRootVector);
+	}
+
+	Network::Get()->RecvRelease(m_nHandle);
+
+	return true;
+}
+
+void E131Bridge::Run(void) {
+	uint32_t nPackets = 0;
+
+	// Drain the receive queue first, then do the housekeeping once
+	while ((nPackets < m_nPacketBudget) && ReceivePacket()) {
+		nPackets++;
+	}
+
+	if (__builtin_expect((nPackets == 0), 1)) {
 		if (m_State.nActiveOutputPorts != 0) {
 			if (!m_State.bDisableNetworkDataLossTimeout && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= (E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000))) {
 				if (!m_State.IsNetworkDataLoss) {
@@ -876,34 +852,6 @@ void E131Bridge::Run(void) {
 		return;
 	}
 
-	if (__builtin_expect((!IsValidRoot()), 0)) {
-		return;
-	}
-
-	m_State.IsNetworkDataLoss = false;
-	m_nPreviousPacketMillis = m_nCurrentPacketMillis;
-
-	if (m_State.IsSynchronized && !m_State.IsForcedSynchronized) {
-		if ((m_nCurrentPacketMillis - m_State.SynchronizationTime) >= (E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000)) {
-			m_State.IsSynchronized = false;
-		}
-	}
-
-	const uint32_t nRootVector = __builtin_bswap32(m_E131.E131Packet.Raw.RootLayer.Vector);
-
-	if (nRootVector == E131_VECTOR_ROOT_DATA) {
-		if (IsValidDataPacket()) {
-			HandleDmx();
-		}
-	} else if (nRootVector == E131_VECTOR_ROOT_EXTENDED) {
-		const uint32_t nFramingVector = __builtin_bswap32(m_E131.E131Packet.Raw.FrameLayer.Vector);
-			if (nFramingVector == E131_VECTOR_EXTENDED_SYNCHRONIZATION) {
-			HandleSynchronization();
-		}
-	} else {
-		DEBUG_PRINTF("Not supported Root Vector : 0x%x", nRootVector);
-	}
-
 	if (m_pE131DmxIn != 0) {
 		HandleDmxIn();
 		SendDiscoveryPacket();
@@ -62,7 +62,11 @@ E131Controller::E131Controller(void):
 	m_pE131DiscoveryPacket(0),
 	m_pE131SynchronizationPacket(0),
 	m_DiscoveryIpAddress(0),
-	m_nMaster(DMX_MAX_VALUE)
+	m_nMaster(DMX_MAX_VALUE),
+	m_pFrameUniverses(0),
+	m_nFrameUniverses(0),
+	m_nFrameHint(0),
+	m_bFrameOpen(false)
 {
 	DEBUG_ENTRY
 
@@ -85,6 +89,7 @@ E131Controller::E131Controller(void):
 	}
 
 	SetSynchronizationAddress();
+	UpdateMasterTable();
 
 	struct in_addr addr;
 	static_cast<void>(inet_aton("239.255.0.0", &addr));
@@ -113,6 +118,9 @@ E131Controller::~E131Controller(void) {
 
 	Network::Get()->End(E131_DEFAULT_PORT);
 
+	delete[] m_pFrameUniverses;
+	m_pFrameUniverses = 0;
+
 	if (m_pE131SynchronizationPacket != 0) {
 		delete m_pE131SynchronizationPacket;
 	}
@@ -135,6 +143,10 @@ void E131Controller::Start(void) {
 	FillDiscoveryPacket();
 	FillSynchronizationPacket();
 
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		FillFrameUniverse(&m_pFrameUniverses[i]);
+	}
+
 	m_State.bIsRunning = true;
 
 	DEBUG_EXIT
@@ -221,19 +233,180 @@ void E131Controller::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData, u
 	// Data Layer
 	m_pE131DataPacket->DMPLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_LAYER_LENGTH(1U + nLength)));
 
+	CopyDmxData(&m_pE131DataPacket->DMPLayer.PropertyValues[1], pDmxData, nLength);
+
+	m_pE131DataPacket->DMPLayer.PropertyValueCount = __builtin_bswap16(1 + nLength);
+
+	Network::Get()->SendTo(m_nHandle, m_pE131DataPacket, DATA_PACKET_SIZE(1U + nLength), nIp, E131_DEFAULT_PORT);
+}
+
+void E131Controller::CopyDmxData(uint8_t *pDestination, const uint8_t *pDmxData, uint32_t nLength) {
 	if (__builtin_expect((m_nMaster == DMX_MAX_VALUE), 1)) {
-		memcpy(&m_pE131DataPacket->DMPLayer.PropertyValues[1], pDmxData, nLength);
+		memcpy(pDestination, pDmxData, nLength);
 	} else if (m_nMaster == 0) {
-		memset(&m_pE131DataPacket->DMPLayer.PropertyValues[1], 0, nLength);
+		memset(pDestination, 0, nLength);
 	} else {
 		for (uint32_t i = 0; i < nLength; i++) {
-			m_pE131DataPacket->DMPLayer.PropertyValues[1 + i] = (m_nMaster * static_cast<uint32_t>(pDmxData[i])) / DMX_MAX_VALUE;
+			pDestination[i] = m_aMasterTable[pDmxData[i]];
 		}
 	}
+}
 
-	m_pE131DataPacket->DMPLayer.PropertyValueCount = __builtin_bswap16(1 + nLength);
+void E131Controller::UpdateMasterTable(void) {
+	for (uint32_t i = 0; i < sizeof(m_aMasterTable); i++) {
+		m_aMasterTable[i] = static_cast<uint8_t>((m_nMaster * i) / DMX_MAX_VALUE);
+	}
+}
 
-	Network::Get()->SendTo(m_nHandle, m_pE131DataPacket, DATA_PACKET_SIZE(1U + nLength), nIp, E131_DEFAULT_PORT);
+void E131Controller::BeginFrame(void) {
+	if (__builtin_expect((m_pFrameUniverses == 0), 0)) {
+		m_pFrameUniverses = new TFrameUniverse[FRAME_MAX_UNIVERSES];
+		assert(m_pFrameUniverses != 0);
+	}
+
+	m_nFrameHint = 0;
+	m_bFrameOpen = true;
+}
+
+void E131Controller::Universe(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength) {
+	if (!m_bFrameOpen) {
+		BeginFrame();
+	}
+
+	TFrameUniverse *pFrameUniverse = GetFrameUniverse(nUniverse);
+
+	if (__builtin_expect((pFrameUniverse == 0), 0)) {
+		// The frame table is full
+		HandleDmxOut(nUniverse, pDmxData, nLength);
+		return;
+	}
+
+	if (nLength > E131_DMX_LENGTH) {
+		nLength = E131_DMX_LENGTH;
+	}
+
+	TE131DataPacket *pE131DataPacket = &pFrameUniverse->E131DataPacket;
+
+	CopyDmxData(&pE131DataPacket->DMPLayer.PropertyValues[1], pDmxData, nLength);
+
+	if (nLength != pFrameUniverse->nLength) {
+		pFrameUniverse->nLength = nLength;
+
+		pE131DataPacket->RootLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_ROOT_LAYER_LENGTH(1U + nLength)));
+		pE131DataPacket->FrameLayer.FLagsLength = __builtin_bswap16((0x07 << 12) | (DATA_FRAME_LAYER_LENGTH(1U + nLength)));
+		pE131DataPacket->DMPLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_LAYER_LENGTH(1U + nLength)));
+		pE131DataPacket->DMPLayer.PropertyValueCount = __builtin_bswap16(static_cast<uint16_t>(1U + nLength));
+	}
+
+	pFrameUniverse->bPending = true;
+}
+
+void E131Controller::CommitFrame(void) {
+	bool bSent = false;
+
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		TFrameUniverse *pFrameUniverse = &m_pFrameUniverses[i];
+
+		if (!pFrameUniverse->bPending) {
+			continue;
+		}
+
+		pFrameUniverse->bPending = false;
+
+		if (pFrameUniverse->nActiveUniverses != m_State.nActiveUniverses) {
+			pFrameUniverse->nSequenceIndex = GetSequenceIndex(__builtin_bswap16(pFrameUniverse->E131DataPacket.FrameLayer.Universe));
+			pFrameUniverse->nActiveUniverses = m_State.nActiveUniverses;
+		}
+
+		assert(pFrameUniverse->nSequenceIndex < m_State.nActiveUniverses);
+
+		pFrameUniverse->E131DataPacket.FrameLayer.SequenceNumber = ++s_SequenceNumbers[pFrameUniverse->nSequenceIndex].nSequenceNumber;
+
+		Network::Get()->SendTo(m_nHandle, &pFrameUniverse->E131DataPacket, DATA_PACKET_SIZE(1U + pFrameUniverse->nLength), pFrameUniverse->nIpAddress, E131_DEFAULT_PORT);
+
+		bSent = true;
+	}
+
+	m_bFrameOpen = false;
+
+	if (bSent) {
+		HandleSync();
+	}
+}
+
+E131Controller::TFrameUniverse *E131Controller::GetFrameUniverse(uint16_t nUniverse) {
+	const uint16_t nUniverseNetwork = __builtin_bswap16(nUniverse);
+
+	if ((m_nFrameHint < m_nFrameUniverses) && (m_pFrameUniverses[m_nFrameHint].E131DataPacket.FrameLayer.Universe == nUniverseNetwork)) {
+		return &m_pFrameUniverses[m_nFrameHint++];
+	}
+
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		if (m_pFrameUniverses[i].E131DataPacket.FrameLayer.Universe == nUniverseNetwork) {
+			m_nFrameHint = i + 1;
+			return &m_pFrameUniverses[i];
+		}
+	}
+
+	if (m_nFrameUniverses == FRAME_MAX_UNIVERSES) {
+		return 0;
+	}
+
+	TFrameUniverse *pFrameUniverse = &m_pFrameUniverses[m_nFrameUniverses];
+
+	// Registers the universe for the discovery and the blackout
+	static_cast<void>(GetSequenceNumber(nUniverse, pFrameUniverse->nIpAddress));
+
+	const uint32_t nSequenceIndex = GetSequenceIndex(nUniverse);
+
+	if (__builtin_expect((nSequenceIndex == m_State.nActiveUniverses), 0)) {
+		// s_SequenceNumbers is full, the universe is sent with HandleDmxOut
+		return 0;
+	}
+
+	pFrameUniverse->E131DataPacket.FrameLayer.Universe = nUniverseNetwork;
+	pFrameUniverse->nSequenceIndex = nSequenceIndex;
+	pFrameUniverse->nActiveUniverses = m_State.nActiveUniverses;
+	pFrameUniverse->bPending = false;
+
+	FillFrameUniverse(pFrameUniverse);
+
+	m_nFrameHint = ++m_nFrameUniverses;
+
+	return pFrameUniverse;
+}
+
+/*
+ * Copies the headers from the data packet, the lengths are set with the first data
+ */
+void E131Controller::FillFrameUniverse(TFrameUniverse *pFrameUniverse) {
+	const uint16_t nUniverseNetwork = pFrameUniverse->E131DataPacket.FrameLayer.Universe;
+
+	memcpy(&pFrameUniverse->E131DataPacket, m_pE131DataPacket, DATA_PACKET_SIZE(1));
+
+	pFrameUniverse->E131DataPacket.FrameLayer.Universe = nUniverseNetwork;
+	pFrameUniverse->nLength = E131_DMX_LENGTH + 1;	// Forces the lengths to be set
+}
+
+uint32_t E131Controller::GetSequenceIndex(uint16_t nUniverse) const {
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_State.nActiveUniverses;
+
+	while (nLow < nHigh) {
+		const uint32_t nMid = nLow + ((nHigh - nLow) / 2);
+
+		if (s_SequenceNumbers[nMid].nUniverse < nUniverse) {
+			nLow = nMid + 1;
+		} else {
+			nHigh = nMid;
+		}
+	}
+
+	if ((nLow < m_State.nActiveUniverses) && (s_SequenceNumbers[nLow].nUniverse == nUniverse)) {
+		return nLow;
+	}
+
+	return m_State.nActiveUniverses;
 }
 
 void E131Controller::HandleSync(void) {
@@ -244,6 +417,13 @@ void E131Controller::HandleSync(void) {
 }
 
 void E131Controller::HandleBlackout(void) {
+	// An open frame is discarded
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		m_pFrameUniverses[i].bPending = false;
+	}
+
+	m_bFrameOpen = false;
+
 	// Root Layer (See Section 5)
 	m_pE131DataPacket->RootLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_ROOT_LAYER_LENGTH(513)));
 
@@ -298,8 +478,17 @@ void E131Controller::SetSourceName(const char *pSourceName) {
 #endif
 }
 
-void E131Controller::SetPriority(uint8_t nPriority) { //TODO SetPriority
+/*
+ * The data packet and the frame universe templates are filled at Start() and when a universe is added
+ */
+void E131Controller::SetPriority(uint8_t nPriority) {
 	m_State.nPriority = nPriority;
+
+	m_pE131DataPacket->FrameLayer.Priority = nPriority;
+
+	for (uint32_t i = 0; i < m_nFrameUniverses; i++) {
+		m_pFrameUniverses[i].E131DataPacket.FrameLayer.Priority = nPriority;
+	}
 }
 
 void E131Controller::SendDiscoveryPacket(void) {
@@ -326,12 +515,11 @@ uint8_t E131Controller::GetSequenceNumber(uint16_t nUniverse, uint32_t &nMultica
 	assert(sizeof(struct TSequenceNumbers) == sizeof(uint64_t));
 
 	int32_t nLow = 0;
-	int32_t nMid = 0;
-	int32_t nHigh = m_State.nActiveUniverses;
+	int32_t nHigh = static_cast<int32_t>(m_State.nActiveUniverses) - 1;
 
 	while (nLow <= nHigh) {
 
-		nMid = nLow + ((nHigh - nLow) / 2);
+		const int32_t nMid = nLow + ((nHigh - nLow) / 2);
 
 		const uint32_t nMidValue = s_SequenceNumbers[nMid].nUniverse;
 
@@ -347,30 +535,26 @@ uint8_t E131Controller::GetSequenceNumber(uint16_t nUniverse, uint32_t &nMultica
 		}
 	}
 
-	DEBUG_PRINTF("nActiveUniverses=%u -> %u : nLow=%d, nMid=%d, nHigh=%d", m_State.nActiveUniverses, nUniverse, nLow, nMid, nHigh);
-
-	if ((nHigh != -1) && (m_State.nActiveUniverses != static_cast<uint32_t>(nHigh))) {
-		uint64_t *p64 = reinterpret_cast<uint64_t *>(s_SequenceNumbers);
+	DEBUG_PRINTF("nActiveUniverses=%u -> %u : nLow=%d, nHigh=%d", m_State.nActiveUniverses, nUniverse, nLow, nHigh);
 
-		for (int32_t i = m_State.nActiveUniverses - 1; i >= nLow; i--) {
-			p64[i + 1] = p64[i];
-		}
-
-		s_SequenceNumbers[nLow].nIpAddress = UniverseToMulticastIp(nUniverse);
-		s_SequenceNumbers[nLow].nUniverse = nUniverse;
-		s_SequenceNumbers[nLow].nSequenceNumber = 0;
+	if (m_State.nActiveUniverses == (sizeof(s_SequenceNumbers) / sizeof(s_SequenceNumbers[0]))) {
+		DEBUG_PUTS("s_SequenceNumbers is full");
+		nMulticastIpAddress = UniverseToMulticastIp(nUniverse);
+		return 0;
+	}
 
-		nMulticastIpAddress = s_SequenceNumbers[nLow].nIpAddress;
+	// nLow is the insertion point, the table stays sorted
+	uint64_t *p64 = reinterpret_cast<uint64_t *>(s_SequenceNumbers);
 
-		DEBUG_PRINTF(">m< nUniverse=%u, nLow=%d", nUniverse, nLow);
-	} else {
-		s_SequenceNumbers[nMid].nIpAddress = UniverseToMulticastIp(nUniverse);
-		s_SequenceNumbers[nMid].nUniverse = nUniverse;
+	for (int32_t i = static_cast<int32_t>(m_State.nActiveUniverses) - 1; i >= nLow; i--) {
+		p64[i + 1] = p64[i];
+	}
 
-		nMulticastIpAddress = s_SequenceNumbers[nMid].nIpAddress;
+	s_SequenceNumbers[nLow].nIpAddress = UniverseToMulticastIp(nUniverse);
+	s_SequenceNumbers[nLow].nUniverse = nUniverse;
+	s_SequenceNumbers[nLow].nSequenceNumber = 0;
 
-		DEBUG_PRINTF(">a< nUniverse=%u, nMid=%d", nUniverse, nMid);
-	}
+	nMulticastIpAddress = s_SequenceNumbers[nLow].nIpAddress;
 
 	m_State.nActiveUniverses++;
 
@@ -41,6 +41,15 @@ struct ip_info {
     struct ip_addr gw;
 };
 
+struct udp_stats {
+	uint32_t rx;			/* Datagrams queued for the application */
+	uint32_t tx;			/* Datagrams sent or queued for ARP resolution */
+	uint32_t rx_overflow;	/* Datagrams dropped, receive queue full */
+	uint32_t rx_errors;		/* Datagrams dropped, no payload */
+	uint32_t tx_dropped;	/* Datagrams dropped, ARP pending queue full */
+	uint16_t port;			/* 0 when the index is not bound */
+};
+
 #define IP_BROADCAST	((uint32_t) 0xFFFFFFFF)
 #define HOST_NAME_MAX 	64	/* including a terminating null byte. */
 
@@ -62,7 +71,11 @@ extern void net_dhcp_release(void);
 extern int udp_bind(uint16_t);
 extern int udp_unbind(uint16_t);
 extern uint16_t udp_recv(uint8_t, uint8_t *, uint16_t, uint32_t *, uint16_t *);
+extern uint16_t udp_recv_borrow(uint8_t, uint8_t **, uint32_t *, uint16_t *);
+extern void udp_recv_release(uint8_t);
 extern int udp_send(uint8_t, const uint8_t *, uint16_t, uint32_t, uint16_t);
+extern bool udp_get_stats(uint8_t, struct udp_stats *);
+extern uint32_t udp_get_unbound(void);
 //
 extern int igmp_join(uint32_t);
 extern int igmp_leave(uint32_t);
@@ -37,7 +37,7 @@
 #endif
 
 extern void arp_cache_init(void);
-extern void arp_cache_update(uint8_t *, uint32_t);
+extern void arp_cache_update(const uint8_t *, uint32_t);
 
 extern void emac_eth_send(void *, int);
 
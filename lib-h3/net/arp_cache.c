@@ -2,7 +2,7 @@
  * @file arp_cache.c
  *
  */
-/* Copyright (C) 2018-2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2018-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 
@@ -35,13 +36,58 @@
 #endif
 
 extern void arp_send_request(uint32_t ip);
-extern void net_handle(void);
+extern void emac_eth_send(void *, int);
 
-#define MAX_RECORDS	32
+/*
+ * The cache is a hash table with chained records. When the table is full,
+ * the least recently used record is replaced.
+ * All timing is in ticks of arp_cache_timer, which runs every 100 msec.
+ */
+
+#if !defined (ARP_RECORDS)
+ #define ARP_RECORDS		64		// Must always be a power of 2, at most 255
+#endif
+#if (ARP_RECORDS & (ARP_RECORDS - 1)) != 0
+ #error ARP_RECORDS must be a power of 2
+#endif
+#define ARP_HASH_MASK		(ARP_RECORDS - 1)
+#define ARP_INDEX_NONE		0xFF
+
+#if !defined (ARP_QUEUE_ENTRIES)
+ #define ARP_QUEUE_ENTRIES	4		///< Frames waiting for an ARP reply
+#endif
+
+#define RETRY_TICKS			5		///< 0.5 seconds between requests
+#define MAX_RETRIES			3
+#define REFRESH_TICKS		3000	///< 5 minutes, a used record is refreshed
+#define QUEUE_TIMEOUT_TICKS	(RETRY_TICKS * (MAX_RETRIES + 1))
+
+#ifndef NDEBUG
+ #define DUMP_TICKS			100		///< 10 seconds
+#endif
+
+typedef enum arp_state {
+	ARP_STATE_FREE = 0,
+	ARP_STATE_PENDING,		///< Request sent, no MAC Address yet
+	ARP_STATE_VALID,
+	ARP_STATE_REFRESHING	///< Valid, request sent to confirm the MAC Address
+} _arp_state;
 
 struct t_arp_record {
 	uint32_t ip;
+	uint32_t ticks_update;		///< Last request sent or reply received
+	uint32_t ticks_used;		///< LRU
 	uint8_t mac_address[ETH_ADDR_LEN];
+	uint8_t state;
+	uint8_t retries;
+	uint8_t next;				///< Hash chain
+} ALIGNED;
+
+struct t_arp_queue_entry {
+	uint8_t frame[sizeof(struct t_udp)];
+	uint32_t ip;
+	uint32_t ticks;
+	uint16_t size;
 } ALIGNED;
 
 typedef union pcast32 {
@@ -49,53 +95,185 @@ typedef union pcast32 {
 		uint8_t u8[4];
 } _pcast32;
 
-static struct t_arp_record s_arp_records[MAX_RECORDS] ALIGNED;
-static uint16_t s_entry_current;
+static struct t_arp_record s_arp_records[ARP_RECORDS] ALIGNED;
+static uint8_t s_hash_heads[ARP_RECORDS];
+static struct t_arp_queue_entry s_arp_queue[ARP_QUEUE_ENTRIES] ALIGNED;
+static uint32_t s_arp_queue_count;
+static uint32_t s_ticks;
 static uint8_t s_multicast_mac[ETH_ADDR_LEN] = {0x01, 0x00, 0x5E}; // Fixed part
 
-#ifndef NDEBUG
- #define TICKER_COUNT 100	///< 10 seconds
- static volatile uint32_t s_ticker ;
-#endif
+static uint32_t hash(uint32_t ip) {
+	// The host part is in the most significant byte
+	const uint32_t h = ip ^ (ip >> 16);
+	return (h ^ (h >> 8) ^ (h >> 24)) & ARP_HASH_MASK;
+}
 
-void arp_cache_init(void) {
-	uint16_t i;
+static struct t_arp_record *find(uint32_t ip) {
+	uint8_t i = s_hash_heads[hash(ip)];
+
+	while (i != ARP_INDEX_NONE) {
+		if (s_arp_records[i].ip == ip) {
+			return &s_arp_records[i];
+		}
+		i = s_arp_records[i].next;
+	}
+
+	return 0;
+}
+
+static void unlink_record(uint8_t index) {
+	uint8_t *p = &s_hash_heads[hash(s_arp_records[index].ip)];
+
+	while (*p != index) {
+		assert(*p != ARP_INDEX_NONE);
+		p = &s_arp_records[*p].next;
+	}
+
+	*p = s_arp_records[index].next;
+}
+
+static void queue_drop(uint32_t ip) {
+	uint32_t i = 0;
+
+	while (i < s_arp_queue_count) {
+		if (s_arp_queue[i].ip == ip) {
+			DEBUG_PRINTF("Drop " IPSTR, IP2STR(ip));
+			s_arp_queue_count--;
+			if (i != s_arp_queue_count) {
+				memcpy(&s_arp_queue[i], &s_arp_queue[s_arp_queue_count], sizeof(struct t_arp_queue_entry));
+			}
+		} else {
+			i++;
+		}
+	}
+}
+
+static void record_free(struct t_arp_record *p_record) {
+	const uint8_t index = (uint8_t) (p_record - s_arp_records);
+
+	if (p_record->state == ARP_STATE_PENDING) {
+		queue_drop(p_record->ip);
+	}
+
+	unlink_record(index);
+
+	p_record->ip = 0;
+	p_record->state = ARP_STATE_FREE;
+}
+
+/*
+ * A free record, else the least recently used one.
+ * Pending records are only replaced when there is nothing else.
+ */
+static struct t_arp_record *record_new(uint32_t ip) {
+	struct t_arp_record *p_lru = 0;
+	struct t_arp_record *p_lru_pending = 0;
+	uint32_t i;
+
+	for (i = 0; i < ARP_RECORDS; i++) {
+		struct t_arp_record *p = &s_arp_records[i];
+
+		if (p->state == ARP_STATE_FREE) {
+			p_lru = p;
+			break;
+		}
+
+		if (p->state == ARP_STATE_PENDING) {
+			if ((p_lru_pending == 0) || ((int32_t) (p->ticks_used - p_lru_pending->ticks_used) < 0)) {
+				p_lru_pending = p;
+			}
+		} else if ((p_lru == 0) || ((int32_t) (p->ticks_used - p_lru->ticks_used) < 0)) {
+			p_lru = p;
+		}
+	}
+
+	if (p_lru == 0) {
+		p_lru = p_lru_pending;
+	}
+
+	assert(p_lru != 0);
+
+	if (p_lru->state != ARP_STATE_FREE) {
+		DEBUG_PRINTF("Replace " IPSTR, IP2STR(p_lru->ip));
+		record_free(p_lru);
+	}
+
+	const uint32_t h = hash(ip);
 
-	s_entry_current = 0;
+	p_lru->ip = ip;
+	p_lru->ticks_update = s_ticks;
+	p_lru->ticks_used = s_ticks;
+	p_lru->retries = 0;
+	p_lru->next = s_hash_heads[h];
+	s_hash_heads[h] = (uint8_t) (p_lru - s_arp_records);
 
-	for (i = 0; i < MAX_RECORDS; i++) {
+	return p_lru;
+}
+
+static void queue_flush(const struct t_arp_record *p_record) {
+	uint32_t i = 0;
+
+	while (i < s_arp_queue_count) {
+		struct t_arp_queue_entry *p_entry = &s_arp_queue[i];
+
+		if (p_entry->ip == p_record->ip) {
+			struct ether_packet *p_ether = (struct ether_packet *) p_entry->frame;
+			memcpy(p_ether->dst, p_record->mac_address, ETH_ADDR_LEN);
+
+			emac_eth_send((void *) p_entry->frame, (int) p_entry->size);
+
+			s_arp_queue_count--;
+			if (i != s_arp_queue_count) {
+				memcpy(p_entry, &s_arp_queue[s_arp_queue_count], sizeof(struct t_arp_queue_entry));
+			}
+		} else {
+			i++;
+		}
+	}
+}
+
+void arp_cache_init(void) {
+	uint32_t i;
+
+	for (i = 0; i < ARP_RECORDS; i++) {
 		s_arp_records[i].ip = 0;
+		s_arp_records[i].state = ARP_STATE_FREE;
+		s_arp_records[i].next = ARP_INDEX_NONE;
 		memset(s_arp_records[i].mac_address, 0, ETH_ADDR_LEN);
+		s_hash_heads[i] = ARP_INDEX_NONE;
 	}
 
-#ifndef NDEBUG
-	s_ticker = TICKER_COUNT;
-#endif
+	s_arp_queue_count = 0;
+	s_ticks = 0;
 }
 
-void arp_cache_update(uint8_t *mac_address, uint32_t ip) {
+void arp_cache_update(const uint8_t *mac_address, uint32_t ip) {
 	DEBUG2_ENTRY
-	uint16_t i;
 
-	if (s_entry_current == MAX_RECORDS) {
-		assert(0);
-		return;
-	}
+	struct t_arp_record *p_record = find(ip);
 
-	for (i = 0; i < s_entry_current; i++) {
-		if (s_arp_records[i].ip == ip) {
-			return;
-		}
+	if (p_record == 0) {
+		p_record = record_new(ip);
 	}
 
-	memcpy(s_arp_records[s_entry_current].mac_address, mac_address, ETH_ADDR_LEN);
-	s_arp_records[s_entry_current].ip = ip;
+	memcpy(p_record->mac_address, mac_address, ETH_ADDR_LEN);
+
+	const bool is_pending = (p_record->state == ARP_STATE_PENDING);
 
-	s_entry_current++;
+	p_record->state = ARP_STATE_VALID;
+	p_record->ticks_update = s_ticks;
+	p_record->retries = 0;
+
+	if (is_pending) {
+		queue_flush(p_record);
+	}
 
 	DEBUG2_EXIT
 }
 
+/*
+ * Non-blocking, returns ip when the MAC Address is known, else 0
+ */
 uint32_t arp_cache_lookup(uint32_t ip, uint8_t *mac_address) {
 	DEBUG2_ENTRY
 
@@ -112,67 +290,126 @@ uint32_t arp_cache_lookup(uint32_t ip, uint8_t *mac_address) {
 		return ip;
 	}
 
-	DEBUG_PRINTF(IPSTR " " MACSTR, IP2STR(ip), MAC2STR(mac_address));
+	struct t_arp_record *p_record = find(ip);
 
-	uint16_t i;
+	if ((p_record != 0) && (p_record->state >= ARP_STATE_VALID)) {
+		p_record->ticks_used = s_ticks;
+		memcpy(mac_address, p_record->mac_address, ETH_ADDR_LEN);
+		DEBUG2_EXIT
+		return ip;
+	}
 
-	for (i = 0; i < MAX_RECORDS; i++) {
-		if (s_arp_records[i].ip == ip) {
-			memcpy(mac_address, s_arp_records[i].mac_address, ETH_ADDR_LEN);
-			return ip;
-		}
+	DEBUG2_EXIT
+	return 0;
+}
 
-		if (s_arp_records[i].ip == 0) {
-			break;
-		}
+/*
+ * The frame starts with the Ethernet header, the destination MAC Address is filled in here.
+ * When the MAC Address is not known yet, the frame is queued and sent with the ARP reply.
+ * Returns 0 when the frame is sent or queued, -1 when it is dropped.
+ */
+int arp_cache_send(void *frame, uint32_t size, uint32_t ip) {
+	struct ether_packet *p_ether = (struct ether_packet *) frame;
+
+	if (__builtin_expect((arp_cache_lookup(ip, p_ether->dst) == ip), 1)) {
+		emac_eth_send(frame, (int) size);
+		return 0;
 	}
 
-	uint16_t current_entry = s_entry_current;
-	int32_t timeout;
-	int8_t retries = 3;
+	struct t_arp_record *p_record = find(ip);
 
-	while (retries--) {
+	if (p_record == 0) {
+		p_record = record_new(ip);
+		p_record->state = ARP_STATE_PENDING;
 		arp_send_request(ip);
+	}
 
-		timeout = 0xFFFF;
-
-		while ((timeout-- > 0) && (current_entry == s_entry_current)) {
-			net_handle();
-		}
+	if ((s_arp_queue_count == ARP_QUEUE_ENTRIES) || (size > sizeof(s_arp_queue[0].frame))) {
+		DEBUG_PUTS("ARP queue full");
+		return -1;
+	}
 
-		if (current_entry != s_entry_current) {
-			memcpy(mac_address, s_arp_records[current_entry].mac_address, ETH_ADDR_LEN);
-			DEBUG_PRINTF("timeout=%x", timeout);
-			return ip;
-		}
+	struct t_arp_queue_entry *p_entry = &s_arp_queue[s_arp_queue_count++];
 
-		DEBUG_PRINTF("i=%d, timeout=%d, current_entry=%d, s_entry_current=%d", i, timeout, current_entry, s_entry_current);
-	}
+	memcpy(p_entry->frame, frame, size);
+	p_entry->ip = ip;
+	p_entry->size = (uint16_t) size;
+	p_entry->ticks = s_ticks;
 
-	DEBUG2_EXIT
 	return 0;
 }
 
 void arp_cache_dump(void) {
 #ifndef NDEBUG
-	uint16_t i;
+	uint32_t i;
 
-	printf("ARP Cache size=%d\n", s_entry_current);
+	printf("ARP Cache ticks=%u, queued=%u\n", (unsigned) s_ticks, (unsigned) s_arp_queue_count);
 
-	for (i = 0; i < s_entry_current; i++) {
-		printf("%02d " IPSTR " " MACSTR "\n", i, IP2STR(s_arp_records[i].ip),MAC2STR(s_arp_records[i].mac_address));
+	for (i = 0; i < ARP_RECORDS; i++) {
+		if (s_arp_records[i].state != ARP_STATE_FREE) {
+			printf("%02d " IPSTR " " MACSTR " %d %u\n", (int) i, IP2STR(s_arp_records[i].ip), MAC2STR(s_arp_records[i].mac_address), (int) s_arp_records[i].state, (unsigned) (s_ticks - s_arp_records[i].ticks_update));
+		}
 	}
 #endif
 }
 
-#ifndef NDEBUG
+/*
+ * Called every 100 msec. Pending requests are retried, used records are
+ * refreshed, records which are not confirmed or not used are freed.
+ */
 void arp_cache_timer(void) {
-	s_ticker--;
+	uint32_t i;
+
+	s_ticks++;
+
+	for (i = 0; i < ARP_RECORDS; i++) {
+		struct t_arp_record *p_record = &s_arp_records[i];
+		const uint32_t ticks = s_ticks - p_record->ticks_update;
+
+		switch (p_record->state) {
+		case ARP_STATE_PENDING:
+		case ARP_STATE_REFRESHING:
+			if (ticks >= RETRY_TICKS) {
+				if (p_record->retries == MAX_RETRIES) {
+					DEBUG_PRINTF("Timeout " IPSTR, IP2STR(p_record->ip));
+					record_free(p_record);
+				} else {
+					p_record->retries++;
+					p_record->ticks_update = s_ticks;
+					arp_send_request(p_record->ip);
+				}
+			}
+			break;
+		case ARP_STATE_VALID:
+			if (ticks >= REFRESH_TICKS) {
+				if ((s_ticks - p_record->ticks_used) < REFRESH_TICKS) {
+					p_record->state = ARP_STATE_REFRESHING;
+					p_record->retries = 0;
+					p_record->ticks_update = s_ticks;
+					arp_send_request(p_record->ip);
+				} else {
+					record_free(p_record);
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	i = 0;
 
-	if (s_ticker == 0) {
-		s_ticker = TICKER_COUNT;
+	while (i < s_arp_queue_count) {
+		if ((s_ticks - s_arp_queue[i].ticks) > QUEUE_TIMEOUT_TICKS) {
+			queue_drop(s_arp_queue[i].ip);
+		} else {
+			i++;
+		}
+	}
+
+#ifndef NDEBUG
+	if ((s_ticks % DUMP_TICKS) == 0) {
 		arp_cache_dump();
 	}
-}
 #endif
-
+}
@@ -39,6 +39,7 @@ extern void net_timers_init(void);
 extern void net_timers_run(void);
 
 extern void arp_init(const uint8_t *, const struct ip_info  *);
+extern void arp_cache_init(void);
 extern void arp_handle(struct t_arp *);
 
 extern void ip_init(const uint8_t *, const struct ip_info  *);
@@ -61,6 +62,9 @@ static bool s_is_dhcp = false;
 void net_init(const uint8_t *mac_address, struct ip_info *p_ip_info, const uint8_t *hostname, bool *use_dhcp, bool *is_zeroconf_used) {
 	uint32_t i;
 
+	// The DHCP client and rfc3927 send and receive ARP before arp_init()
+	arp_cache_init();
+
 	net_set_hostname((char *)hostname);
 	net_timers_init();
 	ip_init(mac_address, p_ip_info);
@@ -28,9 +28,7 @@
 #include "h3.h"
 
 extern void igmp_timer(void);
-#ifndef NDEBUG
- extern void arp_cache_timer(void);
-#endif
+extern void arp_cache_timer(void);
 
 static volatile uint32_t s_ticker;
 
@@ -46,8 +44,6 @@ void net_timers_run(void) {
 	if (__builtin_expect((micros_now >= s_ticker), 0)) {
 		s_ticker = micros_now + INTERVAL_US;
 		igmp_timer();
-#ifndef NDEBUG
 		arp_cache_timer();
-#endif
 	}
 }
@@ -34,6 +34,8 @@
 #include "h3.h"
 
 extern uint32_t arp_cache_lookup(uint32_t, uint8_t *);
+extern void arp_send_request(uint32_t);
+extern void net_handle(void);
 
 /*
  * https://tools.ietf.org/html/rfc3927
@@ -52,6 +54,29 @@ static const _pcast32 s_ip_end   __attribute__ ((aligned (4))) = { .u8 = { 169,
 static uint8_t s_mac_address[6] __attribute__ ((aligned (4)));
 static uint8_t s_mac_address_arp_reply[6] __attribute__ ((aligned (4)));
 
+/*
+ * Blocking, only used while there is no IP address yet
+ */
+static bool is_ip_in_use(uint32_t ip) {
+	int8_t retries = 3;
+
+	while (retries--) {
+		arp_send_request(ip);
+
+		int32_t timeout = 0xFFFF;
+
+		while (timeout-- > 0) {
+			net_handle();
+
+			if (arp_cache_lookup(ip, s_mac_address_arp_reply) == ip) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void rfc3927_init(const uint8_t *mac_address) {
 	memcpy(s_mac_address, mac_address, ETH_ADDR_LEN);
 }
@@ -70,7 +95,7 @@ bool rfc3927(struct ip_info *p_ip_info) {
 	do  {
 		DEBUG_PRINTF(IPSTR, IP2STR(ip));
 
-		if (0 == arp_cache_lookup(ip, s_mac_address_arp_reply)) {
+		if (!is_ip_in_use(ip)) {
 			p_ip_info->ip.addr = ip;
 			p_ip_info->gw.addr = ip;
 			p_ip_info->netmask.addr = 0x0000FFFF;
@@ -50,11 +50,17 @@ extern int console_error(const char *);
 #endif
 
 extern void emac_eth_send(void *, int);
-extern uint32_t arp_cache_lookup(uint32_t, uint8_t *);
+extern int arp_cache_send(void *, uint32_t, uint32_t);
 extern uint16_t net_chksum(void *, uint32_t);
 
 #define MAX_PORTS_ALLOWED	16
-#define MAX_ENTRIES			(1 << 2) // Must always be a power of 2
+#if !defined (UDP_QUEUE_ENTRIES)
+ #define UDP_QUEUE_ENTRIES	4
+#endif
+#define MAX_ENTRIES			(UDP_QUEUE_ENTRIES) // Must always be a power of 2
+#if (MAX_ENTRIES & (MAX_ENTRIES - 1)) != 0
+ #error UDP_QUEUE_ENTRIES must be a power of 2
+#endif
 #define MAX_ENTRIES_MASK	(MAX_ENTRIES - 1)
 
 struct queue_entry {
@@ -77,6 +83,8 @@ typedef union pcast32 {
 
 static uint32_t s_ports_allowed[MAX_PORTS_ALLOWED];
 static struct queue s_recv_queue[MAX_PORTS_ALLOWED] ALIGNED;
+static struct udp_stats s_stats[MAX_PORTS_ALLOWED];
+static uint32_t s_unbound;
 static struct t_udp s_send_packet ALIGNED;
 static uint16_t s_id ALIGNED;
 static uint32_t broadcast_mask;
@@ -98,6 +106,8 @@ void udp_init(const uint8_t *mac_address, const struct ip_info  *p_ip_info) {
 		s_recv_queue[i].queue_tail = 0;
 	}
 
+	memset(s_stats, 0, sizeof(s_stats));
+	s_unbound = 0;
 	s_id = 0;
 
 	// Ethernet
@@ -132,6 +142,7 @@ void udp_handle(struct t_udp *p_udp) {
 			&& (dest_port != NTP_PORT_SERVER)
 			&& (dest_port < 1024)) { // There is no support for other UDP defined services
 		DEBUG_PRINTF("Not supported -> " IPSTR ":%d", p_udp->ip4.src[0],p_udp->ip4.src[1],p_udp->ip4.src[2],p_udp->ip4.src[3], dest_port);
+		s_unbound++;
 		return;
 	}
 
@@ -143,13 +154,30 @@ void udp_handle(struct t_udp *p_udp) {
 
 	if (__builtin_expect ((port_index == MAX_PORTS_ALLOWED), 0)) {
 		DEBUG_PRINTF(IPSTR ":%d", p_udp->ip4.src[0],p_udp->ip4.src[1],p_udp->ip4.src[2],p_udp->ip4.src[3], dest_port);
+		s_unbound++;
 		return;
 	}
 
-	const uint32_t entry = s_recv_queue[port_index].queue_tail;
-	struct queue_entry *p_queue_entry = &s_recv_queue[port_index].entries[entry];
+	const uint16_t udp_length = __builtin_bswap16(p_udp->udp.len);
 
-	const uint32_t data_length = __builtin_bswap16(p_udp->udp.len) - UDP_HEADER_SIZE;
+	if (__builtin_expect((udp_length <= UDP_HEADER_SIZE), 0)) {
+		// An empty entry would be returned as 0 by udp_recv_borrow, and never be released
+		s_stats[port_index].rx_errors++;
+		return;
+	}
+
+	struct queue *p_queue = &s_recv_queue[port_index];
+
+	if (__builtin_expect(((p_queue->queue_head - p_queue->queue_tail) == MAX_ENTRIES), 0)) {
+		// Queue is full. Never overwrite an entry, it could be borrowed by udp_recv_borrow.
+		DEBUG_PRINTF("Queue full -> %d", dest_port);
+		s_stats[port_index].rx_overflow++;
+		return;
+	}
+
+	struct queue_entry *p_queue_entry = &p_queue->entries[p_queue->queue_head & MAX_ENTRIES_MASK];
+
+	const uint32_t data_length = udp_length - UDP_HEADER_SIZE;
 
 	// debug_dump(p_udp->udp.data, data_length);
 
@@ -162,7 +190,8 @@ void udp_handle(struct t_udp *p_udp) {
 	p_queue_entry->from_port = __builtin_bswap16(p_udp->udp.source_port);
 	p_queue_entry->size = i;
 
-	s_recv_queue[port_index].queue_head = (s_recv_queue[port_index].queue_head + 1) & MAX_ENTRIES_MASK;
+	p_queue->queue_head++;
+	s_stats[port_index].rx++;
 }
 
 // -->
@@ -188,6 +217,7 @@ int udp_bind(uint16_t local_port) {
 	}
 
 	s_ports_allowed[i] = local_port;
+	memset(&s_stats[i], 0, sizeof(struct udp_stats));
 
 	DEBUG_PRINTF("i=%d, local_port=%d", i, local_port);
 
@@ -217,7 +247,7 @@ uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip
 		return 0;
 	}
 
-	const uint8_t entry = s_recv_queue[idx].queue_tail;
+	const uint32_t entry = s_recv_queue[idx].queue_tail & MAX_ENTRIES_MASK;
 	struct queue_entry *p_queue_entry = &s_recv_queue[idx].entries[entry];
 
 	const uint16_t i = MIN(size, p_queue_entry->size);
@@ -227,17 +257,47 @@ uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip
 	*from_ip = p_queue_entry->from_ip;
 	*from_port = p_queue_entry->from_port;
 
-	s_recv_queue[idx].queue_tail = (s_recv_queue[idx].queue_tail + 1) & MAX_ENTRIES_MASK;
+	s_recv_queue[idx].queue_tail++;
 
 	DEBUG_PRINTF("[%d] %d[%d]: %d " IPSTR, H3_TIMER->AVS_CNT0, idx, s_ports_allowed[idx], i, IP2STR(*from_ip));
 
 	return i;
 }
 
+/*
+ * Zero-copy receive. The returned frame stays in the queue until udp_recv_release.
+ */
+uint16_t udp_recv_borrow(uint8_t idx, uint8_t **packet, uint32_t *from_ip, uint16_t *from_port) {
+	assert(idx < MAX_PORTS_ALLOWED);
+
+	if (s_recv_queue[idx].queue_head == s_recv_queue[idx].queue_tail) {
+		return 0;
+	}
+
+	const uint32_t entry = s_recv_queue[idx].queue_tail & MAX_ENTRIES_MASK;
+	struct queue_entry *p_queue_entry = &s_recv_queue[idx].entries[entry];
+
+	*packet = p_queue_entry->data;
+	*from_ip = p_queue_entry->from_ip;
+	*from_port = p_queue_entry->from_port;
+
+	DEBUG_PRINTF("[%d] %d[%d]: %d " IPSTR, H3_TIMER->AVS_CNT0, idx, s_ports_allowed[idx], p_queue_entry->size, IP2STR(*from_ip));
+
+	return p_queue_entry->size;
+}
+
+void udp_recv_release(uint8_t idx) {
+	assert(idx < MAX_PORTS_ALLOWED);
+	assert(s_recv_queue[idx].queue_head != s_recv_queue[idx].queue_tail);
+
+	s_recv_queue[idx].queue_tail++;
+}
+
 int udp_send(uint8_t idx, const uint8_t *packet, uint16_t size, uint32_t to_ip, uint16_t remote_port) {
 	assert(idx < MAX_PORTS_ALLOWED);
 
 	_pcast32 dst;
+	bool is_unicast = false;
 
 	if (__builtin_expect ((s_ports_allowed[idx] == 0), 0)) {
 		DEBUG_PUTS("ports_allowed[idx] == 0");
@@ -254,13 +314,10 @@ int udp_send(uint8_t idx, const uint8_t *packet, uint16_t size, uint32_t to_ip,
 		dst.u32 = to_ip;
 		memcpy(s_send_packet.ip4.dst, dst.u8, IPv4_ADDR_LEN);
 	} else {
-		if (to_ip == arp_cache_lookup(to_ip, s_send_packet.ether.dst)) {
-			dst.u32 = to_ip;
-			memcpy(s_send_packet.ip4.dst, dst.u8, IPv4_ADDR_LEN);
-		} else {
-			DEBUG_PUTS("ARP lookup failed");
-			return -2;
-		}
+		// The destination MAC Address is resolved by arp_cache_send
+		dst.u32 = to_ip;
+		memcpy(s_send_packet.ip4.dst, dst.u8, IPv4_ADDR_LEN);
+		is_unicast = true;
 	}
 
 	//IPv4
@@ -278,11 +335,39 @@ int udp_send(uint8_t idx, const uint8_t *packet, uint16_t size, uint32_t to_ip,
 
 	// debug_dump( &s_send_packet, size + UDP_PACKET_HEADERS_SIZE);
 
-	emac_eth_send((void *) &s_send_packet, (int) (size + UDP_PACKET_HEADERS_SIZE));
-
 	s_id++;
 
+	if (is_unicast) {
+		// Does not wait for an ARP reply
+		if (arp_cache_send((void *) &s_send_packet, (uint32_t) (size + UDP_PACKET_HEADERS_SIZE), to_ip) != 0) {
+			DEBUG_PUTS("ARP queue full");
+			s_stats[idx].tx_dropped++;
+			return -2;
+		}
+
+		s_stats[idx].tx++;
+		return 0;
+	}
+
+	emac_eth_send((void *) &s_send_packet, (int) (size + UDP_PACKET_HEADERS_SIZE));
+	s_stats[idx].tx++;
+
 	return 0;
 }
 
+bool udp_get_stats(uint8_t idx, struct udp_stats *p_stats) {
+	if (idx >= MAX_PORTS_ALLOWED) {
+		return false;
+	}
+
+	memcpy(p_stats, &s_stats[idx], sizeof(struct udp_stats));
+	p_stats->port = (uint16_t) s_ports_allowed[idx];
+
+	return true;
+}
+
+uint32_t udp_get_unbound(void) {
+	return s_unbound;
+}
+
 // <---
@@ -78,6 +78,19 @@ public:
 	uint32_t Micros(void);
 	uint32_t Millis(void);
 
+	/**
+	 * Replay: Micros() and Millis() return the time set with SetVirtualMicros() instead of the system time
+	 */
+	void SetVirtualClock(bool bVirtualClock) {
+		m_bVirtualClock = bVirtualClock;
+	}
+	bool IsVirtualClock(void) const {
+		return m_bVirtualClock;
+	}
+	void SetVirtualMicros(uint64_t nMicros) {
+		m_nVirtualMicros = nMicros;
+	}
+
 	bool IsWatchdog(void) { return false;}
 	void WatchdogInit(void) { } // Not implemented
 	void WatchdogFeed(void) { } // Not implemented
@@ -104,6 +117,8 @@ private:
 
 private:
 	RebootHandler *m_pRebootHandler = 0;
+	bool m_bVirtualClock = false;
+	uint64_t m_nVirtualMicros = 0;
 	enum TBoardType {
 		BOARD_TYPE_LINUX,
 		BOARD_TYPE_CYGWIN,
@@ -269,6 +269,32 @@ int unlink(__attribute__((unused)) const char *pathname) {
 #endif
 }
 
+/*
+ * FatFs does not replace an existing file
+ */
+int rename(__attribute__((unused)) const char *oldpath, __attribute__((unused)) const char *newpath) {
+#if !defined (SD_WRITE_SUPPORT)
+	errno = ENOSYS;
+	return -1;
+#else
+	s_fresult = f_unlink(newpath);
+
+	if ((s_fresult != FR_OK) && (s_fresult != FR_NO_FILE)) {
+		errno = fatfs_to_errno(s_fresult);
+		return -1;
+	}
+
+	s_fresult = f_rename(oldpath, newpath);
+	errno = fatfs_to_errno(s_fresult);
+
+	if (s_fresult == FR_OK) {
+		return 0;
+	}
+
+	return -1;
+#endif
+}
+
 #if !defined (SD_WRITE_SUPPORT)
 #else
 static DIR s_dir;
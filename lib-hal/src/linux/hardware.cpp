@@ -415,12 +415,20 @@ bool Hardware::ExecCmd(const char *pCmd, char *Result, int nResultSize) {
 }
 
 uint32_t Hardware::Micros(void) {
+	if (__builtin_expect((m_bVirtualClock), 0)) {
+		return static_cast<uint32_t>(m_nVirtualMicros);
+	}
+
 	struct timeval tv;
 	gettimeofday(&tv, NULL);
 	return (tv.tv_sec * 1000000) + tv.tv_usec;
 }
 
 uint32_t Hardware::Millis(void) {
+	if (__builtin_expect((m_bVirtualClock), 0)) {
+		return static_cast<uint32_t>(m_nVirtualMicros / 1000);
+	}
+
 	struct timeval tv;
 	gettimeofday(&tv, NULL);
 
@@ -37,6 +37,11 @@ struct TLightSetSlotInfo {
 	uint16_t nCategory;
 };
 
+struct TLightSetRange {
+	uint16_t nFirst;	///< First changed slot (0 based)
+	uint16_t nLast;		///< Last changed slot (inclusive), the range is empty when nFirst > nLast
+};
+
 enum TLightSetDmx {
 	DMX_ADDRESS_INVALID = 0xFFFF,
 	DMX_START_ADDRESS_DEFAULT = 1,
@@ -60,6 +65,11 @@ public:
 	virtual void Stop(uint8_t nPort)= 0;
 
 	virtual void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength)= 0;
+	/**
+	 * Only the slots in tRange have changed since the previous SetData for nPort.
+	 * The default falls back to a full update.
+	 */
+	virtual void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength, const struct TLightSetRange &tRange);
 
 	virtual void Print(void);
 
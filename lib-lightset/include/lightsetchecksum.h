@@ -0,0 +1,91 @@
+/**
+ * @file lightsetchecksum.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETCHECKSUM_H_
+#define LIGHTSETCHECKSUM_H_
+
+#include <stdint.h>
+
+#include "lightset.h"
+
+#define LIGHTSET_CHECKSUM_PORTS	8
+
+struct TLightSetChecksumPort {
+	uint32_t nFrames;
+	uint32_t nLastHash;	///< Hash of the last frame
+	uint32_t nHash;		///< Hash over all the frames, in order
+	uint16_t nLastLength;
+	bool bStarted;
+};
+
+/**
+ * Records a FNV-1a hash of every SetData, for replay and regression tests.
+ * GetHash() also covers the Start/Stop events and the order of the ports.
+ */
+class LightSetChecksum: public LightSet {
+public:
+	LightSetChecksum(void);
+	~LightSetChecksum(void);
+
+	void Start(uint8_t nPort);
+	void Stop(uint8_t nPort);
+
+	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength);
+
+	void Print(void);
+
+	const struct TLightSetChecksumPort *GetPort(uint8_t nPort) const {
+		return nPort < LIGHTSET_CHECKSUM_PORTS ? &m_aPorts[nPort] : 0;
+	}
+
+	uint32_t GetFrames(void) const {
+		return m_nFrames;
+	}
+
+	uint32_t GetHash(void) const {
+		return m_nHash;
+	}
+
+	static uint32_t Hash(const uint8_t *pData, uint32_t nLength, uint32_t nHash = FNV_OFFSET_BASIS) {
+		for (uint32_t i = 0; i < nLength; i++) {
+			nHash = (nHash ^ pData[i]) * FNV_PRIME;
+		}
+
+		return nHash;
+	}
+
+private:
+	void Event(uint8_t nEvent, uint8_t nPort, uint16_t nLength, uint32_t nFrameHash);
+
+private:
+	static constexpr uint32_t FNV_OFFSET_BASIS = 0x811C9DC5;
+	static constexpr uint32_t FNV_PRIME = 0x01000193;
+
+	struct TLightSetChecksumPort m_aPorts[LIGHTSET_CHECKSUM_PORTS];
+	uint32_t m_nFrames;
+	uint32_t m_nHash;
+};
+
+#endif /* LIGHTSETCHECKSUM_H_ */
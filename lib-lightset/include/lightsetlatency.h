@@ -0,0 +1,113 @@
+/**
+ * @file lightsetlatency.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETLATENCY_H_
+#define LIGHTSETLATENCY_H_
+
+#include <stdint.h>
+
+/**
+ * Buckets are log2 of the latency in microseconds, the last bucket also counts everything above.
+ */
+#define LIGHTSET_LATENCY_BUCKETS	21
+
+enum class LightSetLatencyStage {
+	DISPATCH,	///< Packet received -> protocol handler matched the output port
+	OUTPUT,		///< Packet received -> LightSet::SetData returned, including the wait for a sync
+	SYNC,		///< Sync packet received -> LightSet::SetData returned
+	LAST
+};
+
+struct TLightSetLatencyHistogram {
+	uint32_t aBuckets[LIGHTSET_LATENCY_BUCKETS];	///< aBuckets[n] counts [2^n, 2^(n+1)) us, aBuckets[0] also counts 0
+	uint32_t nCount;
+	uint32_t nMaxMicros;
+};
+
+/**
+ * Per output port latency histograms, compiled in with LIGHTSET_LATENCY.
+ * All timestamps are Hardware::Micros().
+ */
+class LightSetLatency {
+public:
+	LightSetLatency(uint32_t nPorts);
+	~LightSetLatency(void);
+
+	void Add(uint32_t nPortIndex, LightSetLatencyStage tStage, uint32_t nMicros) {
+		if (nPortIndex >= m_nPorts) {
+			return;
+		}
+
+		struct TLightSetLatencyHistogram *pHistogram = &m_pHistograms[nPortIndex * static_cast<uint32_t>(LightSetLatencyStage::LAST) + static_cast<uint32_t>(tStage)];
+
+		pHistogram->aBuckets[GetBucket(nMicros)]++;
+		pHistogram->nCount++;
+
+		if (nMicros > pHistogram->nMaxMicros) {
+			pHistogram->nMaxMicros = nMicros;
+		}
+	}
+
+	/**
+	 * Remembers when the data now pending for nPortIndex was received, used for the OUTPUT stage on the next sync
+	 */
+	void SetPending(uint32_t nPortIndex, uint32_t nReceivedMicros) {
+		if (nPortIndex < m_nPorts) {
+			m_pPendingMicros[nPortIndex] = nReceivedMicros;
+		}
+	}
+	uint32_t GetPending(uint32_t nPortIndex) const {
+		return nPortIndex < m_nPorts ? m_pPendingMicros[nPortIndex] : 0;
+	}
+
+	const struct TLightSetLatencyHistogram& GetHistogram(uint32_t nPortIndex, LightSetLatencyStage tStage) const {
+		return m_pHistograms[nPortIndex * static_cast<uint32_t>(LightSetLatencyStage::LAST) + static_cast<uint32_t>(tStage)];
+	}
+
+	uint32_t GetPorts(void) const {
+		return m_nPorts;
+	}
+
+	void Reset(void);
+
+	static uint32_t GetBucket(uint32_t nMicros) {
+		if (nMicros == 0) {
+			return 0;
+		}
+
+		const uint32_t nBucket = 31 - static_cast<uint32_t>(__builtin_clz(nMicros));
+
+		return nBucket < LIGHTSET_LATENCY_BUCKETS ? nBucket : (LIGHTSET_LATENCY_BUCKETS - 1);
+	}
+
+	static const char *GetStageName(LightSetLatencyStage tStage);
+
+private:
+	uint32_t m_nPorts;
+	struct TLightSetLatencyHistogram *m_pHistograms;
+	uint32_t *m_pPendingMicros;
+};
+
+#endif /* LIGHTSETLATENCY_H_ */
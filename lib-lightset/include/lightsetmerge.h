@@ -0,0 +1,44 @@
+/**
+ * @file lightsetmerge.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETMERGE_H_
+#define LIGHTSETMERGE_H_
+
+#include <stdint.h>
+
+#include "lightset.h"
+
+/**
+ * Word wide (NEON, SSE2 or native word) DMX compare-and-copy and HTP merge.
+ * All functions return true when at least one slot in pDst has changed.
+ * The optional pRange is then set to the first and last changed slot.
+ */
+class LightSetMerge {
+public:
+	static bool Copy(uint8_t *pDst, const uint8_t *pSrc, uint32_t nLength, struct TLightSetRange *pRange = 0);
+	static bool Htp(uint8_t *pDst, const uint8_t *pSrcA, const uint8_t *pSrcB, uint32_t nLength, struct TLightSetRange *pRange = 0);
+};
+
+#endif /* LIGHTSETMERGE_H_ */
@@ -0,0 +1,148 @@
+/**
+ * @file lightsetmergeengine.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETMERGEENGINE_H_
+#define LIGHTSETMERGEENGINE_H_
+
+#include <stdint.h>
+
+#include "lightset.h"
+
+#ifndef LIGHTSET_MERGE_MAX_SOURCES
+# define LIGHTSET_MERGE_MAX_SOURCES	4
+#endif
+
+#define LIGHTSET_MERGE_SOURCE_ID_LENGTH	16
+
+enum class LightSetMergeMode {
+	HTP,	///< Highest Takes Precedence
+	LTP		///< Latest Takes Precedence, per slot the source that changed it last
+};
+
+struct TLightSetMergeSource {
+	uint32_t nIpAddress;
+	uint32_t nMillis;								///< Last update
+	uint8_t aId[LIGHTSET_MERGE_SOURCE_ID_LENGTH];	///< E1.31 CID, all zero when not used
+	uint16_t nLength;
+	uint8_t nPriority;								///< Universe priority
+	uint8_t nSequenceNumber;
+	bool bIsActive;
+	bool bSlotPriority;								///< aSlotPriority is valid
+	uint8_t aData[DMX_UNIVERSE_SIZE];
+	uint8_t aSlotPriority[DMX_UNIVERSE_SIZE];		///< 0 is "not sourced", 1-200
+};
+
+/**
+ * Merges up to LIGHTSET_MERGE_MAX_SOURCES sources into one output universe.
+ *
+ * Per slot only the sources with the highest priority are merged. The priority
+ * of a slot is the per-slot priority (E1.31 start code 0xDD) when the source
+ * has sent one, else the universe priority of the source.
+ *
+ * An update recomputes only the slots the source has changed. All functions
+ * returning bool return true when the output has changed, tRange is then set
+ * to the changed output slots.
+ */
+class LightSetMergeEngine {
+public:
+	LightSetMergeEngine(void);
+	~LightSetMergeEngine(void);
+
+	void SetMode(LightSetMergeMode tMode) {
+		m_tMode = tMode;
+	}
+	LightSetMergeMode GetMode(void) const {
+		return m_tMode;
+	}
+
+	/**
+	 * @return The source index, -1 when not found
+	 */
+	int32_t Find(uint32_t nIpAddress, const uint8_t *pId = 0) const;
+	/**
+	 * When the pool is full, the source with the lowest universe priority is
+	 * replaced if nPriority is higher.
+	 * @return The source index, -1 when there is no room
+	 */
+	int32_t Add(uint32_t nIpAddress, const uint8_t *pId, uint8_t nPriority, uint32_t nMillis);
+	bool Remove(uint32_t nSource, struct TLightSetRange &tRange);
+	/**
+	 * Removes all sources without an update for more than nTimeoutMillis
+	 */
+	bool Expire(uint32_t nMillis, uint32_t nTimeoutMillis, struct TLightSetRange &tRange);
+
+	bool SetData(uint32_t nSource, uint8_t nPriority, const uint8_t *pData, uint16_t nLength, uint32_t nMillis, struct TLightSetRange &tRange);
+	bool SetSlotPriority(uint32_t nSource, const uint8_t *pPriority, uint16_t nLength, uint32_t nMillis, struct TLightSetRange &tRange);
+
+	/**
+	 * Removes all sources and zeroes the output
+	 */
+	void Clear(void);
+
+	void SetSequenceNumber(uint32_t nSource, uint8_t nSequenceNumber) {
+		m_pSources[nSource].nSequenceNumber = nSequenceNumber;
+	}
+	uint8_t GetSequenceNumber(uint32_t nSource) const {
+		return m_pSources[nSource].nSequenceNumber;
+	}
+
+	const uint8_t *GetData(void) const {
+		return m_aData;
+	}
+	uint16_t GetLength(void) const {
+		return m_nLength;
+	}
+	uint32_t GetSources(void) const {
+		return m_nSources;
+	}
+
+private:
+	uint8_t GetPriority(const struct TLightSetMergeSource *pSource, uint32_t nSlot) const {
+		if (pSource->bSlotPriority) {
+			return pSource->aSlotPriority[nSlot];
+		}
+		// Universe priority 0 still contributes
+		return pSource->nPriority == 0 ? 1 : pSource->nPriority;
+	}
+	bool IsContributing(uint32_t nSource, uint32_t nSlot, uint8_t nPriority) const {
+		return (nSource < LIGHTSET_MERGE_MAX_SOURCES) && m_pSources[nSource].bIsActive && (nSlot < m_pSources[nSource].nLength) && (GetPriority(&m_pSources[nSource], nSlot) == nPriority);
+	}
+	bool MergeSlot(uint32_t nSlot, uint32_t nTakeSource);
+	bool MergeRange(uint32_t nFirst, uint32_t nLast, uint32_t nTakeSource, struct TLightSetRange &tRange);
+	bool MergeAll(uint32_t nTakeSource, struct TLightSetRange &tRange);
+	bool UpdateLength(void);
+
+private:
+	static constexpr uint8_t SOURCE_NONE = 0xFF;
+
+	LightSetMergeMode m_tMode;
+	struct TLightSetMergeSource *m_pSources;
+	uint32_t m_nSources;
+	uint16_t m_nLength;
+	uint8_t m_aData[DMX_UNIVERSE_SIZE];
+	uint8_t m_aOwner[DMX_UNIVERSE_SIZE];	///< LTP
+};
+
+#endif /* LIGHTSETMERGEENGINE_H_ */
@@ -37,6 +37,10 @@ LightSet::LightSet(void) : m_pLightSetDisplay(0) {
 LightSet::~LightSet(void) {
 }
 
+void LightSet::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength, __attribute__((unused)) const struct TLightSetRange &tRange) {
+	SetData(nPort, pData, nLength);
+}
+
 void LightSet::Print(void) {
 	// override
 }
@@ -72,6 +72,14 @@ void LightSetChain::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nSize)
 	}
 }
 
+void LightSetChain::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nSize, const struct TLightSetRange &tRange) {
+	assert(pData != 0);
+
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->SetData(nPort, pData, nSize, tRange);
+	}
+}
+
 void LightSetChain::Print(void) {
 	for (unsigned i = 0; i < m_nSize; i++) {
 		m_pTable[i].pLightSet->Print();
@@ -0,0 +1,116 @@
+/**
+ * @file lightsetchecksum.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "lightsetchecksum.h"
+
+#include "debug.h"
+
+LightSetChecksum::LightSetChecksum(void) : m_nFrames(0), m_nHash(FNV_OFFSET_BASIS) {
+	DEBUG_ENTRY
+
+	memset(m_aPorts, 0, sizeof(m_aPorts));
+
+	for (uint32_t i = 0; i < LIGHTSET_CHECKSUM_PORTS; i++) {
+		m_aPorts[i].nHash = FNV_OFFSET_BASIS;
+	}
+
+	DEBUG_EXIT
+}
+
+LightSetChecksum::~LightSetChecksum(void) {
+	DEBUG_ENTRY
+
+	DEBUG_EXIT
+}
+
+void LightSetChecksum::Event(uint8_t nEvent, uint8_t nPort, uint16_t nLength, uint32_t nFrameHash) {
+	const uint8_t aEvent[] = { nEvent, nPort,
+			static_cast<uint8_t>(nLength >> 8), static_cast<uint8_t>(nLength),
+			static_cast<uint8_t>(nFrameHash >> 24), static_cast<uint8_t>(nFrameHash >> 16),
+			static_cast<uint8_t>(nFrameHash >> 8), static_cast<uint8_t>(nFrameHash) };
+
+	m_nHash = Hash(aEvent, sizeof(aEvent), m_nHash);
+}
+
+void LightSetChecksum::Start(uint8_t nPort) {
+	DEBUG_PRINTF("nPort=%u", nPort);
+
+	if (nPort < LIGHTSET_CHECKSUM_PORTS) {
+		m_aPorts[nPort].bStarted = true;
+	}
+
+	Event('S', nPort, 0, 0);
+}
+
+void LightSetChecksum::Stop(uint8_t nPort) {
+	DEBUG_PRINTF("nPort=%u", nPort);
+
+	if (nPort < LIGHTSET_CHECKSUM_PORTS) {
+		m_aPorts[nPort].bStarted = false;
+	}
+
+	Event('s', nPort, 0, 0);
+}
+
+void LightSetChecksum::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength) {
+	assert(pData != 0);
+	assert(nPort < LIGHTSET_CHECKSUM_PORTS);
+
+	const uint32_t nFrameHash = Hash(pData, nLength);
+
+	if (nPort < LIGHTSET_CHECKSUM_PORTS) {
+		struct TLightSetChecksumPort *pPort = &m_aPorts[nPort];
+
+		pPort->nFrames++;
+		pPort->nLastHash = nFrameHash;
+		pPort->nLastLength = nLength;
+
+		const uint8_t aFrameHash[] = { static_cast<uint8_t>(nFrameHash >> 24), static_cast<uint8_t>(nFrameHash >> 16),
+				static_cast<uint8_t>(nFrameHash >> 8), static_cast<uint8_t>(nFrameHash) };
+
+		pPort->nHash = Hash(aFrameHash, sizeof(aFrameHash), pPort->nHash);
+	}
+
+	m_nFrames++;
+
+	Event('D', nPort, nLength, nFrameHash);
+}
+
+void LightSetChecksum::Print(void) {
+	for (uint32_t i = 0; i < LIGHTSET_CHECKSUM_PORTS; i++) {
+		const struct TLightSetChecksumPort *pPort = &m_aPorts[i];
+
+		if (pPort->nFrames != 0) {
+			printf(" Port %u: frames=%u, last=%.8x (%u slots), hash=%.8x%s\n", i, pPort->nFrames, pPort->nLastHash, pPort->nLastLength, pPort->nHash, pPort->bStarted ? "" : ", stopped");
+		}
+	}
+
+	printf(" Frames=%u, hash=%.8x\n", m_nFrames, m_nHash);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file lightsetlatency.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "lightsetlatency.h"
+
+static constexpr char s_aStageNames[static_cast<uint32_t>(LightSetLatencyStage::LAST)][9] = { "dispatch", "output", "sync" };
+
+LightSetLatency::LightSetLatency(uint32_t nPorts) : m_nPorts(nPorts) {
+	m_pHistograms = new struct TLightSetLatencyHistogram[m_nPorts * static_cast<uint32_t>(LightSetLatencyStage::LAST)];
+	assert(m_pHistograms != 0);
+
+	m_pPendingMicros = new uint32_t[m_nPorts];
+	assert(m_pPendingMicros != 0);
+
+	Reset();
+}
+
+LightSetLatency::~LightSetLatency(void) {
+	delete[] m_pPendingMicros;
+	m_pPendingMicros = 0;
+
+	delete[] m_pHistograms;
+	m_pHistograms = 0;
+}
+
+void LightSetLatency::Reset(void) {
+	memset(m_pHistograms, 0, m_nPorts * static_cast<uint32_t>(LightSetLatencyStage::LAST) * sizeof(struct TLightSetLatencyHistogram));
+	memset(m_pPendingMicros, 0, m_nPorts * sizeof(uint32_t));
+}
+
+const char *LightSetLatency::GetStageName(LightSetLatencyStage tStage) {
+	assert(tStage < LightSetLatencyStage::LAST);
+
+	return s_aStageNames[static_cast<uint32_t>(tStage)];
+}
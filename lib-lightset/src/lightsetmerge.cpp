@@ -0,0 +1,193 @@
+/**
+ * @file lightsetmerge.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+# include <arm_neon.h>
+# define MERGE_NEON
+#elif defined (__SSE2__)
+# include <emmintrin.h>
+# define MERGE_SSE2
+#endif
+
+#include "lightsetmerge.h"
+#include "lightset.h"
+
+#if defined (MERGE_NEON) || defined (MERGE_SSE2)
+# define BLOCK_SIZE		16
+#else
+# if (__SIZEOF_POINTER__ == 8)
+typedef uint64_t word_t;
+# else
+typedef uint32_t word_t;
+# endif
+# define BLOCK_SIZE		sizeof(word_t)
+#endif
+
+#define SLOT_NONE		0xFFFFFFFF
+
+/*
+ * Only called for a block that is known to differ
+ */
+static void UpdateRange(const uint8_t *pOld, const uint8_t *pNew, uint32_t nOffset, uint32_t nSize, uint32_t &nFirst, uint32_t &nLast) {
+	if (nFirst == SLOT_NONE) {
+		uint32_t i = 0;
+		while (pOld[i] == pNew[i]) {
+			i++;
+		}
+		nFirst = nOffset + i;
+	}
+
+	uint32_t i = nSize - 1;
+	while (pOld[i] == pNew[i]) {
+		i--;
+	}
+	nLast = nOffset + i;
+}
+
+static bool SetRange(struct TLightSetRange *pRange, uint32_t nFirst, uint32_t nLast) {
+	if (nFirst == SLOT_NONE) {
+		return false;
+	}
+
+	if (pRange != 0) {
+		pRange->nFirst = static_cast<uint16_t>(nFirst);
+		pRange->nLast = static_cast<uint16_t>(nLast);
+	}
+
+	return true;
+}
+
+#if defined (MERGE_NEON)
+static inline bool IsNotEqual(uint8x16_t a, uint8x16_t b) {
+	const uint64x2_t x = vreinterpretq_u64_u8(veorq_u8(a, b));
+	return vget_lane_u64(vorr_u64(vget_low_u64(x), vget_high_u64(x)), 0) != 0;
+}
+#endif
+
+bool LightSetMerge::Copy(uint8_t *pDst, const uint8_t *pSrc, uint32_t nLength, struct TLightSetRange *pRange) {
+	assert(pDst != 0);
+	assert(pSrc != 0);
+
+	uint32_t nFirst = SLOT_NONE;
+	uint32_t nLast = 0;
+	uint32_t i = 0;
+
+	for (; (i + BLOCK_SIZE) <= nLength; i += BLOCK_SIZE) {
+#if defined (MERGE_NEON)
+		const uint8x16_t s = vld1q_u8(&pSrc[i]);
+		if (IsNotEqual(s, vld1q_u8(&pDst[i]))) {
+			UpdateRange(&pDst[i], &pSrc[i], i, BLOCK_SIZE, nFirst, nLast);
+			vst1q_u8(&pDst[i], s);
+		}
+#elif defined (MERGE_SSE2)
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&pSrc[i]));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&pDst[i]));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(s, d)) != 0xFFFF) {
+			UpdateRange(&pDst[i], &pSrc[i], i, BLOCK_SIZE, nFirst, nLast);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&pDst[i]), s);
+		}
+#else
+		word_t s, d;
+		memcpy(&s, &pSrc[i], sizeof(word_t));
+		memcpy(&d, &pDst[i], sizeof(word_t));
+		if (s != d) {
+			UpdateRange(&pDst[i], &pSrc[i], i, BLOCK_SIZE, nFirst, nLast);
+			memcpy(&pDst[i], &s, sizeof(word_t));
+		}
+#endif
+	}
+
+	for (; i < nLength; i++) {
+		if (pDst[i] != pSrc[i]) {
+			if (nFirst == SLOT_NONE) {
+				nFirst = i;
+			}
+			nLast = i;
+			pDst[i] = pSrc[i];
+		}
+	}
+
+	return SetRange(pRange, nFirst, nLast);
+}
+
+bool LightSetMerge::Htp(uint8_t *pDst, const uint8_t *pSrcA, const uint8_t *pSrcB, uint32_t nLength, struct TLightSetRange *pRange) {
+	assert(pDst != 0);
+	assert(pSrcA != 0);
+	assert(pSrcB != 0);
+
+	uint32_t nFirst = SLOT_NONE;
+	uint32_t nLast = 0;
+	uint32_t i = 0;
+
+	for (; (i + BLOCK_SIZE) <= nLength; i += BLOCK_SIZE) {
+		uint8_t aMax[BLOCK_SIZE] __attribute__((aligned(16)));
+#if defined (MERGE_NEON)
+		const uint8x16_t m = vmaxq_u8(vld1q_u8(&pSrcA[i]), vld1q_u8(&pSrcB[i]));
+		if (IsNotEqual(m, vld1q_u8(&pDst[i]))) {
+			vst1q_u8(aMax, m);
+			UpdateRange(&pDst[i], aMax, i, BLOCK_SIZE, nFirst, nLast);
+			vst1q_u8(&pDst[i], m);
+		}
+#elif defined (MERGE_SSE2)
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&pSrcA[i]));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&pSrcB[i]));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&pDst[i]));
+		const __m128i m = _mm_max_epu8(a, b);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(m, d)) != 0xFFFF) {
+			_mm_store_si128(reinterpret_cast<__m128i *>(aMax), m);
+			UpdateRange(&pDst[i], aMax, i, BLOCK_SIZE, nFirst, nLast);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&pDst[i]), m);
+		}
+#else
+		for (uint32_t j = 0; j < BLOCK_SIZE; j++) {
+			aMax[j] = pSrcA[i + j] > pSrcB[i + j] ? pSrcA[i + j] : pSrcB[i + j];
+		}
+		word_t m, d;
+		memcpy(&m, aMax, sizeof(word_t));
+		memcpy(&d, &pDst[i], sizeof(word_t));
+		if (m != d) {
+			UpdateRange(&pDst[i], aMax, i, BLOCK_SIZE, nFirst, nLast);
+			memcpy(&pDst[i], &m, sizeof(word_t));
+		}
+#endif
+	}
+
+	for (; i < nLength; i++) {
+		const uint8_t nMax = pSrcA[i] > pSrcB[i] ? pSrcA[i] : pSrcB[i];
+		if (pDst[i] != nMax) {
+			if (nFirst == SLOT_NONE) {
+				nFirst = i;
+			}
+			nLast = i;
+			pDst[i] = nMax;
+		}
+	}
+
+	return SetRange(pRange, nFirst, nLast);
+}
@@ -0,0 +1,407 @@
+/**
+ * @file lightsetmergeengine.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "lightsetmergeengine.h"
+#include "lightsetmerge.h"
+#include "lightset.h"
+
+#include "debug.h"
+
+static constexpr uint8_t s_NullId[LIGHTSET_MERGE_SOURCE_ID_LENGTH] = { 0 };
+
+LightSetMergeEngine::LightSetMergeEngine(void) :
+	m_tMode(LightSetMergeMode::HTP),
+	m_nSources(0),
+	m_nLength(0)
+{
+	m_pSources = new struct TLightSetMergeSource[LIGHTSET_MERGE_MAX_SOURCES];
+	assert(m_pSources != 0);
+
+	Clear();
+}
+
+LightSetMergeEngine::~LightSetMergeEngine(void) {
+	delete[] m_pSources;
+	m_pSources = 0;
+}
+
+void LightSetMergeEngine::Clear(void) {
+	memset(m_pSources, 0, sizeof(struct TLightSetMergeSource[LIGHTSET_MERGE_MAX_SOURCES]));
+	memset(m_aData, 0, sizeof(m_aData));
+	memset(m_aOwner, SOURCE_NONE, sizeof(m_aOwner));
+
+	m_nSources = 0;
+	m_nLength = 0;
+}
+
+int32_t LightSetMergeEngine::Find(uint32_t nIpAddress, const uint8_t *pId) const {
+	if (pId == 0) {
+		pId = s_NullId;
+	}
+
+	for (uint32_t i = 0; i < LIGHTSET_MERGE_MAX_SOURCES; i++) {
+		const struct TLightSetMergeSource *pSource = &m_pSources[i];
+
+		if (pSource->bIsActive && (pSource->nIpAddress == nIpAddress) && (memcmp(pSource->aId, pId, LIGHTSET_MERGE_SOURCE_ID_LENGTH) == 0)) {
+			return static_cast<int32_t>(i);
+		}
+	}
+
+	return -1;
+}
+
+int32_t LightSetMergeEngine::Add(uint32_t nIpAddress, const uint8_t *pId, uint8_t nPriority, uint32_t nMillis) {
+	uint32_t nSource = LIGHTSET_MERGE_MAX_SOURCES;
+
+	if (m_nSources < LIGHTSET_MERGE_MAX_SOURCES) {
+		for (nSource = 0; nSource < LIGHTSET_MERGE_MAX_SOURCES; nSource++) {
+			if (!m_pSources[nSource].bIsActive) {
+				break;
+			}
+		}
+	} else {
+		uint8_t nLowest = nPriority;
+
+		for (uint32_t i = 0; i < LIGHTSET_MERGE_MAX_SOURCES; i++) {
+			if (m_pSources[i].nPriority < nLowest) {
+				nLowest = m_pSources[i].nPriority;
+				nSource = i;
+			}
+		}
+
+		if (nSource == LIGHTSET_MERGE_MAX_SOURCES) {
+			DEBUG_PUTS("No room for source");
+			return -1;
+		}
+
+		// The output is recomputed with the first SetData of the new source
+		DEBUG_PRINTF("Replacing source %u", nSource);
+		m_nSources--;
+	}
+
+	assert(nSource < LIGHTSET_MERGE_MAX_SOURCES);
+
+	struct TLightSetMergeSource *pSource = &m_pSources[nSource];
+
+	memset(pSource, 0, sizeof(struct TLightSetMergeSource));
+	memcpy(pSource->aId, pId == 0 ? s_NullId : pId, LIGHTSET_MERGE_SOURCE_ID_LENGTH);
+	pSource->nIpAddress = nIpAddress;
+	pSource->nMillis = nMillis;
+	pSource->nPriority = nPriority;
+	pSource->bIsActive = true;
+
+	m_nSources++;
+
+	return static_cast<int32_t>(nSource);
+}
+
+bool LightSetMergeEngine::Remove(uint32_t nSource, struct TLightSetRange &tRange) {
+	assert(nSource < LIGHTSET_MERGE_MAX_SOURCES);
+
+	if (!m_pSources[nSource].bIsActive) {
+		return false;
+	}
+
+	m_pSources[nSource].bIsActive = false;
+	m_nSources--;
+
+	return MergeAll(SOURCE_NONE, tRange);
+}
+
+bool LightSetMergeEngine::Expire(uint32_t nMillis, uint32_t nTimeoutMillis, struct TLightSetRange &tRange) {
+	bool bIsExpired = false;
+
+	for (uint32_t i = 0; i < LIGHTSET_MERGE_MAX_SOURCES; i++) {
+		struct TLightSetMergeSource *pSource = &m_pSources[i];
+
+		if (pSource->bIsActive && ((nMillis - pSource->nMillis) > nTimeoutMillis)) {
+			DEBUG_PRINTF("Source %u expired", i);
+			pSource->bIsActive = false;
+			m_nSources--;
+			bIsExpired = true;
+		}
+	}
+
+	if (!bIsExpired) {
+		return false;
+	}
+
+	return MergeAll(SOURCE_NONE, tRange);
+}
+
+bool LightSetMergeEngine::SetData(uint32_t nSource, uint8_t nPriority, const uint8_t *pData, uint16_t nLength, uint32_t nMillis, struct TLightSetRange &tRange) {
+	assert(nSource < LIGHTSET_MERGE_MAX_SOURCES);
+	assert(m_pSources[nSource].bIsActive);
+	assert(pData != 0);
+
+	struct TLightSetMergeSource *pSource = &m_pSources[nSource];
+
+	if (nLength > DMX_UNIVERSE_SIZE) {
+		nLength = DMX_UNIVERSE_SIZE;
+	}
+
+	pSource->nMillis = nMillis;
+
+	// Single source, the output is the source
+	if ((m_nSources == 1) && !pSource->bSlotPriority && (pSource->nLength != 0)) {
+		pSource->nPriority = nPriority;
+		memcpy(pSource->aData, pData, nLength);
+
+		if (m_tMode == LightSetMergeMode::LTP) {
+			memset(m_aOwner, static_cast<int>(nSource), nLength);
+		}
+
+		if (nLength != pSource->nLength) {
+			pSource->nLength = nLength;
+			UpdateLength();
+			LightSetMerge::Copy(m_aData, pData, nLength);
+			memset(&m_aData[nLength], 0, DMX_UNIVERSE_SIZE - nLength);
+			tRange.nFirst = 0;
+			tRange.nLast = DMX_UNIVERSE_SIZE - 1;
+			return true;
+		}
+
+		return LightSetMerge::Copy(m_aData, pData, nLength, &tRange);
+	}
+
+	const bool bIsNew = (pSource->nLength == 0);
+	bool bMergeAll = bIsNew;
+
+	if (pSource->nPriority != nPriority) {
+		pSource->nPriority = nPriority;
+		bMergeAll |= !pSource->bSlotPriority;
+	}
+
+	if (pSource->nLength != nLength) {
+		if (nLength < pSource->nLength) {
+			memset(&pSource->aData[nLength], 0, pSource->nLength - nLength);
+		}
+		pSource->nLength = nLength;
+		bMergeAll = true;
+	}
+
+	if (bMergeAll) {
+		memcpy(pSource->aData, pData, nLength);
+		// A new source is the latest for all its slots
+		return MergeAll(bIsNew ? nSource : SOURCE_NONE, tRange);
+	}
+
+	if (m_tMode == LightSetMergeMode::LTP) {
+		// Only the slots with a new value are taken over
+		uint32_t nFirst = DMX_UNIVERSE_SIZE;
+		uint32_t nLast = 0;
+
+		for (uint32_t i = 0; i < nLength; i++) {
+			if (pSource->aData[i] != pData[i]) {
+				pSource->aData[i] = pData[i];
+
+				if (MergeSlot(i, nSource)) {
+					if (nFirst == DMX_UNIVERSE_SIZE) {
+						nFirst = i;
+					}
+					nLast = i;
+				}
+			}
+		}
+
+		tRange.nFirst = static_cast<uint16_t>(nFirst);
+		tRange.nLast = static_cast<uint16_t>(nLast);
+
+		return (nFirst != DMX_UNIVERSE_SIZE);
+	}
+
+	struct TLightSetRange tSource;
+
+	if (!LightSetMerge::Copy(pSource->aData, pData, nLength, &tSource)) {
+		return false;
+	}
+
+	return MergeRange(tSource.nFirst, tSource.nLast, SOURCE_NONE, tRange);
+}
+
+bool LightSetMergeEngine::SetSlotPriority(uint32_t nSource, const uint8_t *pPriority, uint16_t nLength, uint32_t nMillis, struct TLightSetRange &tRange) {
+	assert(nSource < LIGHTSET_MERGE_MAX_SOURCES);
+	assert(m_pSources[nSource].bIsActive);
+	assert(pPriority != 0);
+
+	struct TLightSetMergeSource *pSource = &m_pSources[nSource];
+
+	if (nLength > DMX_UNIVERSE_SIZE) {
+		nLength = DMX_UNIVERSE_SIZE;
+	}
+
+	pSource->nMillis = nMillis;
+
+	// Slots beyond nLength are not sourced
+	if (!pSource->bSlotPriority) {
+		memcpy(pSource->aSlotPriority, pPriority, nLength);
+		memset(&pSource->aSlotPriority[nLength], 0, DMX_UNIVERSE_SIZE - nLength);
+		pSource->bSlotPriority = true;
+		return MergeAll(SOURCE_NONE, tRange);
+	}
+
+	struct TLightSetRange tSource;
+	bool bIsChanged = LightSetMerge::Copy(pSource->aSlotPriority, pPriority, nLength, &tSource);
+
+	if (!bIsChanged) {
+		tSource.nFirst = DMX_UNIVERSE_SIZE;
+		tSource.nLast = 0;
+	}
+
+	for (uint32_t i = nLength; i < DMX_UNIVERSE_SIZE; i++) {
+		if (pSource->aSlotPriority[i] != 0) {
+			pSource->aSlotPriority[i] = 0;
+			if (i < tSource.nFirst) {
+				tSource.nFirst = static_cast<uint16_t>(i);
+			}
+			tSource.nLast = static_cast<uint16_t>(i);
+			bIsChanged = true;
+		}
+	}
+
+	if (!bIsChanged) {
+		return false;
+	}
+
+	return MergeRange(tSource.nFirst, tSource.nLast, SOURCE_NONE, tRange);
+}
+
+/*
+ * Returns true when the output slot has changed.
+ * For LTP, nTakeSource becomes the owner of the slot when it has the highest priority.
+ */
+bool LightSetMergeEngine::MergeSlot(uint32_t nSlot, uint32_t nTakeSource) {
+	uint8_t nTop = 0;
+	uint8_t nValue = 0;
+	uint32_t nLatest = SOURCE_NONE;
+
+	for (uint32_t i = 0; i < LIGHTSET_MERGE_MAX_SOURCES; i++) {
+		const struct TLightSetMergeSource *pSource = &m_pSources[i];
+
+		if (!pSource->bIsActive || (nSlot >= pSource->nLength)) {
+			continue;
+		}
+
+		const uint8_t nPriority = GetPriority(pSource, nSlot);
+
+		if (nPriority == 0) {
+			continue;
+		}
+
+		if (nPriority > nTop) {
+			nTop = nPriority;
+			nValue = pSource->aData[nSlot];
+			nLatest = i;
+		} else if (nPriority == nTop) {
+			if (pSource->aData[nSlot] > nValue) {
+				nValue = pSource->aData[nSlot];
+			}
+			if (static_cast<int32_t>(pSource->nMillis - m_pSources[nLatest].nMillis) > 0) {
+				nLatest = i;
+			}
+		}
+	}
+
+	if (m_tMode == LightSetMergeMode::LTP) {
+		uint32_t nOwner = m_aOwner[nSlot];
+
+		if (nTop == 0) {
+			nOwner = SOURCE_NONE;
+		} else if (IsContributing(nTakeSource, nSlot, nTop)) {
+			nOwner = nTakeSource;
+		} else if (!IsContributing(nOwner, nSlot, nTop)) {
+			nOwner = nLatest;
+		}
+
+		m_aOwner[nSlot] = static_cast<uint8_t>(nOwner);
+		nValue = (nOwner == SOURCE_NONE) ? 0 : m_pSources[nOwner].aData[nSlot];
+	}
+
+	if (m_aData[nSlot] != nValue) {
+		m_aData[nSlot] = nValue;
+		return true;
+	}
+
+	return false;
+}
+
+bool LightSetMergeEngine::MergeRange(uint32_t nFirst, uint32_t nLast, uint32_t nTakeSource, struct TLightSetRange &tRange) {
+	uint32_t nChangedFirst = DMX_UNIVERSE_SIZE;
+	uint32_t nChangedLast = 0;
+
+	for (uint32_t i = nFirst; i <= nLast; i++) {
+		if (MergeSlot(i, nTakeSource)) {
+			if (nChangedFirst == DMX_UNIVERSE_SIZE) {
+				nChangedFirst = i;
+			}
+			nChangedLast = i;
+		}
+	}
+
+	tRange.nFirst = static_cast<uint16_t>(nChangedFirst);
+	tRange.nLast = static_cast<uint16_t>(nChangedLast);
+
+	return (nChangedFirst != DMX_UNIVERSE_SIZE);
+}
+
+/*
+ * A changed output length is reported as a full range
+ */
+bool LightSetMergeEngine::MergeAll(uint32_t nTakeSource, struct TLightSetRange &tRange) {
+	const uint16_t nPreviousLength = m_nLength;
+	const bool bIsLengthChanged = UpdateLength();
+	const uint32_t nLength = (m_nLength > nPreviousLength) ? m_nLength : nPreviousLength;
+
+	const bool bIsChanged = (nLength != 0) && MergeRange(0, nLength - 1U, nTakeSource, tRange);
+
+	if (bIsLengthChanged) {
+		tRange.nFirst = 0;
+		tRange.nLast = DMX_UNIVERSE_SIZE - 1;
+		return true;
+	}
+
+	return bIsChanged;
+}
+
+bool LightSetMergeEngine::UpdateLength(void) {
+	uint16_t nLength = 0;
+
+	for (uint32_t i = 0; i < LIGHTSET_MERGE_MAX_SOURCES; i++) {
+		if (m_pSources[i].bIsActive && (m_pSources[i].nLength > nLength)) {
+			nLength = m_pSources[i].nLength;
+		}
+	}
+
+	if (nLength != m_nLength) {
+		m_nLength = nLength;
+		return true;
+	}
+
+	return false;
+}
@@ -55,6 +55,15 @@ enum class DhcpClientStatus {
 	FAILED
 };
 
+struct TNetworkPortStats {
+	uint32_t nRx;			///< Datagrams received
+	uint32_t nTx;			///< Datagrams sent
+	uint32_t nRxOverflow;	///< Datagrams dropped, receive queue full
+	uint32_t nRxErrors;		///< Datagrams dropped, no payload
+	uint32_t nTxDropped;	///< Datagrams dropped, not sent
+	uint16_t nPort;			///< 0 when the index is not bound
+};
+
 class NetworkDisplay {
 public:
 	virtual ~NetworkDisplay(void) {
@@ -97,8 +106,26 @@ public:
 	virtual void LeaveGroup(int32_t nHandle, uint32_t nIp)=0;
 
 	virtual uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort)=0;
+	/**
+	 * Zero-copy receive. *ppBuffer points to the received frame, which is valid until RecvRelease(nHandle).
+	 * When 0 is returned, there is nothing to release.
+	 */
+	virtual uint16_t RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort)=0;
+	virtual void RecvRelease(int32_t nHandle)=0;
 	virtual void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort)=0;
 
+	/**
+	 * Per bound port counters. nIndex runs from 0 until false is returned.
+	 */
+	virtual bool GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats);
+	/**
+	 * Datagrams dropped because no port was bound.
+	 */
+	virtual uint32_t GetRxUnbound(void) {
+		return 0;
+	}
+	bool GetPortStatsByPort(uint16_t nPort, struct TNetworkPortStats& tPortStats);
+
 	virtual void SetIp(uint32_t nIp)=0;
 	virtual void SetNetmask(uint32_t nNetmask)=0;
 	virtual bool SetZeroconf(void)=0;
@@ -56,6 +56,11 @@ public:
 	uint16_t RecvFrom(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) void *pBuffer, __attribute__((unused)) uint16_t nLength, __attribute__((unused)) uint32_t *pFromIp, __attribute__((unused)) uint16_t *pFromPort) {
 		return 0;
 	}
+	uint16_t RecvBorrow(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) void **ppBuffer, __attribute__((unused)) uint32_t *pFromIp, __attribute__((unused)) uint16_t *pFromPort) {
+		return 0;
+	}
+	void RecvRelease(__attribute__((unused)) int32_t nHandle) {
+	}
 	void SendTo(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) const void *pBuffer, __attribute__((unused)) uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) {
 	}
 
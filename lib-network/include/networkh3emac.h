@@ -34,6 +34,7 @@
 
 extern "C" {
 	void net_handle(void);
+	uint32_t udp_get_unbound(void);
 }
 
 class NetworkH3emac: public Network {
@@ -54,8 +55,15 @@ public:
 	void LeaveGroup(int32_t nHandle, uint32_t nIp);
 
 	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort);
+	uint16_t RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort);
+	void RecvRelease(int32_t nHandle);
 	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
 
+	bool GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats);
+	uint32_t GetRxUnbound(void) {
+		return udp_get_unbound();
+	}
+
 	void SetIp(uint32_t nIp);
 	void SetNetmask(uint32_t nNetmask);
 	void SetHostName(const char *pHostName);
@@ -58,9 +58,34 @@ public:
 	void LeaveGroup(int32_t nHandle, uint32_t nIp);
 
 	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort);
+	uint16_t RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort);
+	void RecvRelease(int32_t nHandle);
 	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
 
+	bool GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats);
+
+	/**
+	 * Batched mode (Linux only), must be set after Init and before the first Begin.
+	 * Received datagrams are read with recvmmsg into a ring per handle and sends are queued for sendmmsg.
+	 * All bound handles are multiplexed through a single epoll wait in Run(), which must be called from the main loop.
+	 */
+	void SetBatchMode(bool bBatchMode = true, uint32_t nWaitMillis = 1);
+	bool GetBatchMode(void) const {
+		return m_bBatchMode;
+	}
+
+	void Run(void);
+
 private:
+	// Batched mode
+	void BatchBegin(uint32_t nIndex, int nSocket);
+	void BatchEnd(uint32_t nIndex, int nSocket);
+	uint16_t BatchRecvBorrow(uint32_t nIndex, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort);
+	void BatchRecvRelease(uint32_t nIndex);
+	void BatchSendTo(uint32_t nIndex, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
+	void BatchFlush(uint32_t nIndex);
+	void BatchWaitWritable(uint32_t nIndex, bool bWait);
+
 	uint32_t GetDefaultGateway(void);
 	bool IsDhclient(const char *pIfName);
 	int IfGetByAddress(const char *pIp, char *pName, size_t nLength);
@@ -68,6 +93,11 @@ private:
 #if defined(__APPLE__)
 	bool OSxGetMacaddress(const char *pIfName, uint8_t *pMacAddress);
 #endif
+
+private:
+	bool m_bBatchMode = false;
+	int m_nEpollFd = -1;
+	int m_nWaitMillis = 1;
 };
 
 #endif /* NETWORKLINUX_H_ */
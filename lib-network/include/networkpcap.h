@@ -0,0 +1,141 @@
+/**
+ * @file networkpcap.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORKPCAP_H_
+#define NETWORKPCAP_H_
+
+#include <stdint.h>
+
+#include "network.h"
+
+struct TPcapPacket {
+	uint64_t nMicros;	///< Capture time, relative to the first packet
+	uint32_t nOffset;	///< UDP payload offset in the capture
+	uint32_t nFromIp;
+	uint16_t nFromPort;
+	uint16_t nToPort;
+	uint16_t nLength;	///< UDP payload length
+};
+
+/**
+ * Serves the IPv4 UDP datagrams of a pcap capture, no sockets are used.
+ * Run() makes the next datagram pending, RecvBorrow() returns it on the handle bound to its destination port.
+ */
+class NetworkPcap: public Network {
+public:
+	NetworkPcap(void);
+	~NetworkPcap(void);
+
+	/**
+	 * Loads and indexes a pcap file (Ethernet, VLAN, Linux cooked, loopback or raw IP link layer)
+	 */
+	bool Open(const char *pFileName);
+
+	/**
+	 * false (default): as fast as possible, Hardware::Millis() follows the capture time.
+	 * true: the datagrams are served at the recorded timing.
+	 */
+	void SetRealTime(bool bRealTime);
+
+	/**
+	 * @return false when the capture has been replayed
+	 */
+	bool Run(void);
+
+	int32_t Begin(uint16_t nPort);
+	int32_t End(uint16_t nPort);
+
+	void MacAddressCopyTo(uint8_t *pMacAddress);
+
+	void JoinGroup(int32_t nHandle, uint32_t nIp);
+	void LeaveGroup(int32_t nHandle, uint32_t nIp);
+
+	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort);
+	uint16_t RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort);
+	void RecvRelease(int32_t nHandle);
+	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
+
+	bool GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats);
+	uint32_t GetRxUnbound(void) {
+		return m_nUnbound;
+	}
+
+	void SetIp(uint32_t nIp);
+	void SetNetmask(uint32_t nNetmask);
+	bool SetZeroconf(void) {
+		return false;
+	}
+	bool EnableDhcp(void) {
+		return false;
+	}
+
+	uint32_t GetPackets(void) const {
+		return m_nPackets;
+	}
+	const struct TPcapPacket *GetPacket(uint32_t nIndex) const {
+		return nIndex < m_nPackets ? &m_pPackets[nIndex] : 0;
+	}
+	const uint8_t *GetPayload(const struct TPcapPacket *pPacket) const {
+		return &m_pCapture[pPacket->nOffset];
+	}
+
+	/**
+	 * Records that are not IPv4 UDP, or are fragments
+	 */
+	uint32_t GetSkipped(void) const {
+		return m_nSkipped;
+	}
+	uint32_t GetServed(void) const {
+		return m_nServed;
+	}
+	uint64_t GetDurationMicros(void) const {
+		return m_nPackets == 0 ? 0 : m_pPackets[m_nPackets - 1].nMicros;
+	}
+
+private:
+	static constexpr uint32_t MAX_PORTS = 8;
+
+	bool Index(uint32_t nLinkType, bool bSwapped, bool bNanos);
+	int32_t PortToHandle(uint16_t nPort) const;
+	void WaitUntil(uint64_t nMicros);
+
+private:
+	uint8_t *m_pCapture;
+	uint32_t m_nCaptureSize;
+	struct TPcapPacket *m_pPackets;
+	uint32_t m_nPackets;
+	uint32_t m_nSkipped;
+	uint32_t m_nNext;
+	uint32_t m_nCurrent;
+	uint32_t m_nServed;
+	uint32_t m_nUnbound;
+	bool m_bPending;
+	bool m_bRealTime;
+	uint64_t m_nStartMicros;
+	uint16_t m_aPorts[MAX_PORTS];
+	struct TNetworkPortStats m_aPortStats[MAX_PORTS];
+};
+
+#endif /* NETWORKPCAP_H_ */
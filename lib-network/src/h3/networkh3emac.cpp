@@ -200,10 +200,35 @@ uint16_t NetworkH3emac::RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLengt
 	return udp_recv(nHandle, reinterpret_cast<uint8_t*>(pBuffer), nLength, from_ip, from_port);
 }
 
+uint16_t NetworkH3emac::RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *from_ip, uint16_t *from_port) {
+	return udp_recv_borrow(nHandle, reinterpret_cast<uint8_t**>(ppBuffer), from_ip, from_port);
+}
+
+void NetworkH3emac::RecvRelease(int32_t nHandle) {
+	udp_recv_release(nHandle);
+}
+
 void NetworkH3emac::SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t to_ip, uint16_t remote_port) {
 	udp_send(nHandle, reinterpret_cast<const uint8_t*>(pBuffer), nLength, to_ip, remote_port);
 }
 
+bool NetworkH3emac::GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats) {
+	struct udp_stats stats;
+
+	if (!udp_get_stats(static_cast<uint8_t>(nIndex), &stats)) {
+		return false;
+	}
+
+	tPortStats.nRx = stats.rx;
+	tPortStats.nTx = stats.tx;
+	tPortStats.nRxOverflow = stats.rx_overflow;
+	tPortStats.nRxErrors = stats.rx_errors;
+	tPortStats.nTxDropped = stats.tx_dropped;
+	tPortStats.nPort = stats.port;
+
+	return true;
+}
+
 void NetworkH3emac::SetDefaultIp(void) {
 	DEBUG_ENTRY
 
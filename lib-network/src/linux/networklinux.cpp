@@ -33,7 +33,12 @@
 #include <net/if.h>
 #include <ifaddrs.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <cassert>
+#if defined (__linux__)
+# include <sys/epoll.h>
+# include <sys/socket.h>
+#endif
 
 #include "networklinux.h"
 
@@ -48,10 +53,26 @@ namespace max {
 	static constexpr auto PORTS_ALLOWED = 16;
 	static constexpr auto ENTRIES = (1 << 2); // Must always be a power of 2
 	static constexpr auto ENTRIES_MASK __attribute__((unused)) = (ENTRIES - 1);
+	static constexpr auto FRAME_BUFFER_SIZE = 1600;
 }
 
 static int s_ports_allowed[max::PORTS_ALLOWED];
 static int snHandles[max::PORTS_ALLOWED];
+static uint8_t s_RecvBuffer[max::PORTS_ALLOWED][max::FRAME_BUFFER_SIZE] __attribute__ ((aligned (4)));
+static struct TNetworkPortStats s_PortStats[max::PORTS_ALLOWED];
+
+static uint32_t HandleToIndex(int32_t nHandle) {
+	uint32_t i;
+
+	for (i = 0; i < max::PORTS_ALLOWED; i++) {
+		if (snHandles[i] == nHandle) {
+			break;
+		}
+	}
+
+	assert(i < max::PORTS_ALLOWED);
+	return i;
+}
 
 /**
  * END
@@ -184,13 +205,15 @@ int32_t NetworkLinux::Begin(uint16_t nPort) {
 		exit(EXIT_FAILURE);
 	}
 
-	struct timeval recv_timeout;
-	recv_timeout.tv_sec = 0;
-	recv_timeout.tv_usec = 10;
+	if (!m_bBatchMode) {
+		struct timeval recv_timeout;
+		recv_timeout.tv_sec = 0;
+		recv_timeout.tv_usec = 10;
 
-	if (setsockopt(nSocket, SOL_SOCKET, SO_RCVTIMEO, static_cast<void*>(&recv_timeout), sizeof(recv_timeout)) == -1) {
-		perror("setsockopt(SO_RCVTIMEO)");
-		exit(EXIT_FAILURE);
+		if (setsockopt(nSocket, SOL_SOCKET, SO_RCVTIMEO, static_cast<void*>(&recv_timeout), sizeof(recv_timeout)) == -1) {
+			perror("setsockopt(SO_RCVTIMEO)");
+			exit(EXIT_FAILURE);
+		}
 	}
 
     memset(&si_me, 0, sizeof(si_me));
@@ -209,6 +232,7 @@ int32_t NetworkLinux::Begin(uint16_t nPort) {
  * BEGIN - needed H3 code compatibility
  */
 	s_ports_allowed[i] = nPort;
+	memset(&s_PortStats[i], 0, sizeof(struct TNetworkPortStats));
 
 	for (uint32_t i = 0; i < max::PORTS_ALLOWED; i++) {
 		DEBUG_PRINTF("s_ports_allowed[%2u]=%4u", i, s_ports_allowed[i]);
@@ -219,6 +243,10 @@ int32_t NetworkLinux::Begin(uint16_t nPort) {
 
 	snHandles[i] = nSocket;
 
+	if (m_bBatchMode) {
+		BatchBegin(static_cast<uint32_t>(i), nSocket);
+	}
+
 	return nSocket;
 }
 
@@ -244,6 +272,9 @@ int32_t NetworkLinux::End(uint16_t nPort) {
 	for (i = 0; i < max::PORTS_ALLOWED; i++) {
 		if (s_ports_allowed[i] == nPort) {
 			s_ports_allowed[i] = 0;
+			if (m_bBatchMode) {
+				BatchEnd(i, snHandles[i]);
+			}
 			printf("close");
 			if (close(snHandles[i]) == -1) {
 				perror("unbind");
@@ -341,6 +372,24 @@ uint16_t NetworkLinux::RecvFrom(int32_t nHandle, void *pPacket, uint16_t nSize,
 	assert(pFromIp != NULL);
 	assert(pFromPort != NULL);
 
+	if (m_bBatchMode) {
+		const uint32_t nIndex = HandleToIndex(nHandle);
+		void *pBuffer;
+
+		const uint16_t nBytesReceived = BatchRecvBorrow(nIndex, &pBuffer, pFromIp, pFromPort);
+
+		if (nBytesReceived == 0) {
+			return 0;
+		}
+
+		const uint16_t nBytes = nBytesReceived < nSize ? nBytesReceived : nSize;
+
+		memcpy(pPacket, pBuffer, nBytes);
+		BatchRecvRelease(nIndex);
+
+		return nBytes;
+	}
+
 	int recv_len;
 	struct sockaddr_in si_other;
 	socklen_t slen = sizeof(si_other);
@@ -356,9 +405,37 @@ uint16_t NetworkLinux::RecvFrom(int32_t nHandle, void *pPacket, uint16_t nSize,
 	*pFromIp = si_other.sin_addr.s_addr;
 	*pFromPort = ntohs(si_other.sin_port);
 
+	s_PortStats[HandleToIndex(nHandle)].nRx++;
+
 	return recv_len;
 }
 
+uint16_t NetworkLinux::RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) {
+	assert(ppBuffer != NULL);
+
+	const uint32_t i = HandleToIndex(nHandle);
+
+	if (i == max::PORTS_ALLOWED) {
+		return 0;
+	}
+
+	if (m_bBatchMode) {
+		return BatchRecvBorrow(i, ppBuffer, pFromIp, pFromPort);
+	}
+
+	*ppBuffer = s_RecvBuffer[i];
+
+	return RecvFrom(nHandle, s_RecvBuffer[i], max::FRAME_BUFFER_SIZE, pFromIp, pFromPort);
+}
+
+void NetworkLinux::RecvRelease(int32_t nHandle) {
+	if (m_bBatchMode) {
+		BatchRecvRelease(HandleToIndex(nHandle));
+	}
+
+	// Otherwise the frame buffer is owned by NetworkLinux, nothing to release
+}
+
 void NetworkLinux::SendTo(int32_t nHandle, const void *pPacket, uint16_t nSize, uint32_t nToIp, uint16_t nRemotePort) {
 	struct sockaddr_in si_other;
 	socklen_t slen = sizeof(si_other);
@@ -369,13 +446,33 @@ void NetworkLinux::SendTo(int32_t nHandle, const void *pPacket, uint16_t nSize,
 	printf("network_sendto(%p, %d, %s, %d)\n", pPacket, nSize, inet_ntoa(in), nRemotePort);
 #endif
 
+	if (m_bBatchMode) {
+		BatchSendTo(HandleToIndex(nHandle), pPacket, nSize, nToIp, nRemotePort);
+		return;
+	}
+
     si_other.sin_family = AF_INET;
 	si_other.sin_addr.s_addr = nToIp;
 	si_other.sin_port = htons(nRemotePort);
 
 	if (sendto(nHandle, pPacket, nSize, 0, reinterpret_cast<struct sockaddr*>(&si_other), slen) == -1) {
 		perror("sendto");
+		s_PortStats[HandleToIndex(nHandle)].nTxDropped++;
+		return;
 	}
+
+	s_PortStats[HandleToIndex(nHandle)].nTx++;
+}
+
+bool NetworkLinux::GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats) {
+	if (nIndex >= max::PORTS_ALLOWED) {
+		return false;
+	}
+
+	tPortStats = s_PortStats[nIndex];
+	tPortStats.nPort = static_cast<uint16_t>(s_ports_allowed[nIndex]);
+
+	return true;
 }
 
 #if defined(__linux__)
@@ -522,3 +619,343 @@ void NetworkLinux::SetHostName(const char *pHostName) {
 	m_aHostName[NETWORK_HOSTNAME_SIZE - 1] = '\0';
 
 }
+
+/**
+ * Batched mode
+ */
+
+#if defined (__linux__)
+namespace batch {
+	static constexpr uint32_t MESSAGES = 32;	///< Datagrams per recvmmsg / sendmmsg call
+}
+
+struct TBatchMessages {
+	uint8_t aBuffer[batch::MESSAGES][max::FRAME_BUFFER_SIZE] __attribute__ ((aligned (4)));
+	struct mmsghdr aMsgs[batch::MESSAGES];
+	struct iovec aIovecs[batch::MESSAGES];
+	struct sockaddr_in aAddr[batch::MESSAGES];
+	uint32_t nCount;	///< Rx: datagrams received by the last recvmmsg, Tx: datagrams queued
+	uint32_t nNext;		///< Rx: next datagram to hand out, Tx: first datagram not sent yet
+	bool bIsReadable;	///< Rx: reported by epoll and not drained yet
+	bool bIsWaiting;	///< Tx: the unsent datagrams wait for EPOLLOUT
+};
+
+static TBatchMessages *s_pBatchRx[max::PORTS_ALLOWED];
+static TBatchMessages *s_pBatchTx[max::PORTS_ALLOWED];
+
+static void batch_messages_init(TBatchMessages *pMessages) {
+	for (uint32_t i = 0; i < batch::MESSAGES; i++) {
+		pMessages->aIovecs[i].iov_base = pMessages->aBuffer[i];
+		pMessages->aIovecs[i].iov_len = max::FRAME_BUFFER_SIZE;
+		memset(&pMessages->aMsgs[i], 0, sizeof(struct mmsghdr));
+		pMessages->aMsgs[i].msg_hdr.msg_iov = &pMessages->aIovecs[i];
+		pMessages->aMsgs[i].msg_hdr.msg_iovlen = 1;
+		pMessages->aMsgs[i].msg_hdr.msg_name = &pMessages->aAddr[i];
+		pMessages->aMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+	}
+
+	pMessages->nCount = 0;
+	pMessages->nNext = 0;
+	pMessages->bIsReadable = false;
+	pMessages->bIsWaiting = false;
+}
+
+/*
+ * Moves the unsent datagrams to the start of the queue
+ */
+static void batch_messages_compact(TBatchMessages *pMessages) {
+	const uint32_t nNext = pMessages->nNext;
+
+	for (uint32_t i = nNext; i < pMessages->nCount; i++) {
+		memcpy(pMessages->aBuffer[i - nNext], pMessages->aBuffer[i], pMessages->aIovecs[i].iov_len);
+		pMessages->aIovecs[i - nNext].iov_len = pMessages->aIovecs[i].iov_len;
+		pMessages->aAddr[i - nNext] = pMessages->aAddr[i];
+	}
+
+	pMessages->nCount -= nNext;
+	pMessages->nNext = 0;
+}
+
+void NetworkLinux::SetBatchMode(bool bBatchMode, uint32_t nWaitMillis) {
+	assert(snHandles[0] == -1);	// Before the first Begin
+
+	m_bBatchMode = bBatchMode;
+	m_nWaitMillis = static_cast<int>(nWaitMillis);
+
+	if (m_bBatchMode && (m_nEpollFd == -1)) {
+		if ((m_nEpollFd = epoll_create1(0)) == -1) {
+			perror("epoll_create1");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+void NetworkLinux::BatchBegin(uint32_t nIndex, int nSocket) {
+	const int nFlags = fcntl(nSocket, F_GETFL, 0);
+
+	if ((nFlags == -1) || (fcntl(nSocket, F_SETFL, nFlags | O_NONBLOCK) == -1)) {
+		perror("fcntl(O_NONBLOCK)");
+		exit(EXIT_FAILURE);
+	}
+
+	s_pBatchRx[nIndex] = new TBatchMessages;
+	assert(s_pBatchRx[nIndex] != 0);
+	batch_messages_init(s_pBatchRx[nIndex]);
+
+	s_pBatchTx[nIndex] = new TBatchMessages;
+	assert(s_pBatchTx[nIndex] != 0);
+	batch_messages_init(s_pBatchTx[nIndex]);
+
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u32 = nIndex;
+
+	if (epoll_ctl(m_nEpollFd, EPOLL_CTL_ADD, nSocket, &event) == -1) {
+		perror("epoll_ctl(EPOLL_CTL_ADD)");
+		exit(EXIT_FAILURE);
+	}
+}
+
+void NetworkLinux::BatchEnd(uint32_t nIndex, int nSocket) {
+	BatchFlush(nIndex);
+
+	// Not waiting for the socket to become writable
+	s_PortStats[nIndex].nTxDropped += s_pBatchTx[nIndex]->nCount - s_pBatchTx[nIndex]->nNext;
+
+	if (epoll_ctl(m_nEpollFd, EPOLL_CTL_DEL, nSocket, NULL) == -1) {
+		perror("epoll_ctl(EPOLL_CTL_DEL)");
+	}
+
+	delete s_pBatchRx[nIndex];
+	s_pBatchRx[nIndex] = 0;
+
+	delete s_pBatchTx[nIndex];
+	s_pBatchTx[nIndex] = 0;
+}
+
+uint16_t NetworkLinux::BatchRecvBorrow(uint32_t nIndex, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) {
+	if (nIndex >= max::PORTS_ALLOWED) {
+		return 0;
+	}
+
+	TBatchMessages *pRx = s_pBatchRx[nIndex];
+	assert(pRx != 0);
+
+	// An empty datagram would be returned as 0, which is nothing pending for the caller
+	while ((pRx->nNext != pRx->nCount) && (pRx->aMsgs[pRx->nNext].msg_len == 0)) {
+		pRx->nNext++;
+		s_PortStats[nIndex].nRxErrors++;
+	}
+
+	if (pRx->nNext == pRx->nCount) {
+		return 0;
+	}
+
+	const uint32_t nNext = pRx->nNext;
+
+	*ppBuffer = pRx->aBuffer[nNext];
+	*pFromIp = pRx->aAddr[nNext].sin_addr.s_addr;
+	*pFromPort = ntohs(pRx->aAddr[nNext].sin_port);
+
+	return static_cast<uint16_t>(pRx->aMsgs[nNext].msg_len);
+}
+
+void NetworkLinux::BatchRecvRelease(uint32_t nIndex) {
+	if (nIndex >= max::PORTS_ALLOWED) {
+		return;
+	}
+
+	TBatchMessages *pRx = s_pBatchRx[nIndex];
+	assert(pRx != 0);
+	assert(pRx->nNext < pRx->nCount);
+
+	pRx->nNext++;
+	s_PortStats[nIndex].nRx++;
+}
+
+void NetworkLinux::BatchSendTo(uint32_t nIndex, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort) {
+	if (nIndex >= max::PORTS_ALLOWED) {
+		return;
+	}
+
+	TBatchMessages *pTx = s_pBatchTx[nIndex];
+	assert(pTx != 0);
+
+	if (pTx->nCount == batch::MESSAGES) {
+		BatchFlush(nIndex);
+
+		if (pTx->nCount == batch::MESSAGES) {
+			if (pTx->nNext == 0) {
+				s_PortStats[nIndex].nTxDropped++;
+				return;
+			}
+
+			batch_messages_compact(pTx);
+		}
+	}
+
+	const uint32_t nCount = pTx->nCount;
+	const uint16_t nBytes = nLength < max::FRAME_BUFFER_SIZE ? nLength : max::FRAME_BUFFER_SIZE;
+
+	memcpy(pTx->aBuffer[nCount], pBuffer, nBytes);
+	pTx->aIovecs[nCount].iov_len = nBytes;
+
+	pTx->aAddr[nCount].sin_family = AF_INET;
+	pTx->aAddr[nCount].sin_addr.s_addr = nToIp;
+	pTx->aAddr[nCount].sin_port = htons(nRemotePort);
+
+	pTx->nCount++;
+}
+
+/*
+ * Does not wait, the datagrams not sent are kept and sent by Run() when the socket is writable again
+ */
+void NetworkLinux::BatchFlush(uint32_t nIndex) {
+	TBatchMessages *pTx = s_pBatchTx[nIndex];
+	assert(pTx != 0);
+
+	while (pTx->nNext < pTx->nCount) {
+		const int nResult = sendmmsg(snHandles[nIndex], &pTx->aMsgs[pTx->nNext], pTx->nCount - pTx->nNext, 0);
+
+		if (nResult == -1) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+				BatchWaitWritable(nIndex, true);
+				return;
+			}
+
+			perror("sendmmsg");
+			s_PortStats[nIndex].nTxDropped += pTx->nCount - pTx->nNext;
+			break;
+		}
+
+		s_PortStats[nIndex].nTx += static_cast<uint32_t>(nResult);
+		pTx->nNext += static_cast<uint32_t>(nResult);
+	}
+
+	pTx->nCount = 0;
+	pTx->nNext = 0;
+
+	BatchWaitWritable(nIndex, false);
+}
+
+void NetworkLinux::BatchWaitWritable(uint32_t nIndex, bool bWait) {
+	TBatchMessages *pTx = s_pBatchTx[nIndex];
+
+	if (pTx->bIsWaiting == bWait) {
+		return;
+	}
+
+	struct epoll_event event;
+	event.events = bWait ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+	event.data.u32 = nIndex;
+
+	if (epoll_ctl(m_nEpollFd, EPOLL_CTL_MOD, snHandles[nIndex], &event) == -1) {
+		perror("epoll_ctl(EPOLL_CTL_MOD)");
+		return;
+	}
+
+	pTx->bIsWaiting = bWait;
+}
+
+void NetworkLinux::Run(void) {
+	if (!m_bBatchMode) {
+		return;
+	}
+
+	bool bIsPending = false;
+
+	for (uint32_t i = 0; i < max::PORTS_ALLOWED; i++) {
+		if (s_pBatchTx[i] != 0) {
+			// A full socket buffer is reported by EPOLLOUT
+			if ((s_pBatchTx[i]->nCount != 0) && !s_pBatchTx[i]->bIsWaiting) {
+				BatchFlush(i);
+			}
+
+			bIsPending |= (s_pBatchRx[i]->nNext != s_pBatchRx[i]->nCount);
+		}
+	}
+
+	struct epoll_event events[max::PORTS_ALLOWED];
+
+	// Do not block the main loop while datagrams are still waiting to be handed out
+	const int nEvents = epoll_wait(m_nEpollFd, events, max::PORTS_ALLOWED, bIsPending ? 0 : m_nWaitMillis);
+
+	if (nEvents == -1) {
+		if (errno != EINTR) {
+			perror("epoll_wait");
+		}
+		return;
+	}
+
+	for (int i = 0; i < nEvents; i++) {
+		const uint32_t nIndex = events[i].data.u32;
+
+		if ((events[i].events & EPOLLOUT) != 0) {
+			BatchFlush(nIndex);
+		}
+
+		if ((events[i].events & EPOLLIN) != 0) {
+			s_pBatchRx[nIndex]->bIsReadable = true;
+		}
+	}
+
+	for (uint32_t i = 0; i < max::PORTS_ALLOWED; i++) {
+		TBatchMessages *pRx = s_pBatchRx[i];
+
+		// Only refill a drained ring, a datagram could still be borrowed
+		if ((pRx == 0) || !pRx->bIsReadable || (pRx->nNext != pRx->nCount)) {
+			continue;
+		}
+
+		for (uint32_t j = 0; j < batch::MESSAGES; j++) {
+			pRx->aMsgs[j].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+		}
+
+		const int nReceived = recvmmsg(snHandles[i], pRx->aMsgs, batch::MESSAGES, MSG_DONTWAIT, NULL);
+
+		pRx->nNext = 0;
+
+		if (nReceived == -1) {
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+				perror("recvmmsg");
+			}
+			pRx->nCount = 0;
+			pRx->bIsReadable = false;
+			continue;
+		}
+
+		pRx->nCount = static_cast<uint32_t>(nReceived);
+		// A full batch means there could be more, epoll (level-triggered) reports it again otherwise
+		pRx->bIsReadable = (pRx->nCount == batch::MESSAGES);
+	}
+}
+#else
+void NetworkLinux::SetBatchMode(__attribute__((unused)) bool bBatchMode, __attribute__((unused)) uint32_t nWaitMillis) {
+	puts("Batched mode is not supported");
+}
+
+void NetworkLinux::Run(void) {
+}
+
+void NetworkLinux::BatchBegin(__attribute__((unused)) uint32_t nIndex, __attribute__((unused)) int nSocket) {
+}
+
+void NetworkLinux::BatchEnd(__attribute__((unused)) uint32_t nIndex, __attribute__((unused)) int nSocket) {
+}
+
+uint16_t NetworkLinux::BatchRecvBorrow(__attribute__((unused)) uint32_t nIndex, __attribute__((unused)) void **ppBuffer, __attribute__((unused)) uint32_t *pFromIp, __attribute__((unused)) uint16_t *pFromPort) {
+	return 0;
+}
+
+void NetworkLinux::BatchRecvRelease(__attribute__((unused)) uint32_t nIndex) {
+}
+
+void NetworkLinux::BatchSendTo(__attribute__((unused)) uint32_t nIndex, __attribute__((unused)) const void *pBuffer, __attribute__((unused)) uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) {
+}
+
+void NetworkLinux::BatchFlush(__attribute__((unused)) uint32_t nIndex) {
+}
+
+void NetworkLinux::BatchWaitWritable(__attribute__((unused)) uint32_t nIndex, __attribute__((unused)) bool bWait) {
+}
+#endif
@@ -0,0 +1,506 @@
+/**
+ * @file networkpcap.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <cassert>
+
+#include "networkpcap.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+namespace pcap {
+	static constexpr uint32_t MAGIC_MICROS = 0xA1B2C3D4;
+	static constexpr uint32_t MAGIC_NANOS = 0xA1B23C4D;
+	static constexpr uint32_t GLOBAL_HEADER_SIZE = 24;
+	static constexpr uint32_t RECORD_HEADER_SIZE = 16;
+	static constexpr uint64_t VIRTUAL_EPOCH_MICROS = 1000000;	///< Hardware::Millis() is not 0 at the first packet
+}
+
+namespace linktype {
+	static constexpr uint32_t NULL_LOOPBACK = 0;
+	static constexpr uint32_t ETHERNET = 1;
+	static constexpr uint32_t RAW_BSD = 12;
+	static constexpr uint32_t RAW_OPENBSD = 14;
+	static constexpr uint32_t RAW = 101;
+	static constexpr uint32_t LOOP = 108;
+	static constexpr uint32_t LINUX_SLL = 113;
+	static constexpr uint32_t LINUX_SLL2 = 276;
+}
+
+static uint32_t read32(const uint8_t *p, bool bSwapped) {
+	uint32_t n;
+	memcpy(&n, p, 4);
+	return bSwapped ? __builtin_bswap32(n) : n;
+}
+
+static uint16_t read16be(const uint8_t *p) {
+	return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static uint64_t monotonic_micros(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + static_cast<uint64_t>(ts.tv_nsec / 1000);
+}
+
+/**
+ * @return offset of the IPv4 header in the frame, -1 when the frame does not carry IPv4
+ */
+static int32_t ipv4_offset(uint32_t nLinkType, const uint8_t *pFrame, uint32_t nLength) {
+	switch (nLinkType) {
+	case linktype::NULL_LOOPBACK:
+	case linktype::LOOP:
+		// AF_INET is 2, in the byte order of the capturing host (NULL) or network order (LOOP)
+		if ((nLength >= 4) && ((read32(pFrame, false) == 2) || (read32(pFrame, true) == 2))) {
+			return 4;
+		}
+		return -1;
+	case linktype::ETHERNET: {
+		uint32_t nOffset = 12;
+
+		while (nLength >= nOffset + 2) {
+			const uint16_t nEtherType = read16be(&pFrame[nOffset]);
+
+			if ((nEtherType == 0x8100) || (nEtherType == 0x88A8)) {	// 802.1Q, 802.1ad
+				nOffset += 4;
+				continue;
+			}
+
+			return nEtherType == 0x0800 ? static_cast<int32_t>(nOffset + 2) : -1;
+		}
+		return -1;
+	}
+	case linktype::RAW_BSD:
+	case linktype::RAW_OPENBSD:
+	case linktype::RAW:
+		return 0;
+	case linktype::LINUX_SLL:
+		return ((nLength >= 16) && (read16be(&pFrame[14]) == 0x0800)) ? 16 : -1;
+	case linktype::LINUX_SLL2:
+		return ((nLength >= 20) && (read16be(&pFrame[0]) == 0x0800)) ? 20 : -1;
+	default:
+		break;
+	}
+
+	return -1;
+}
+
+NetworkPcap::NetworkPcap(void) :
+	m_pCapture(0),
+	m_nCaptureSize(0),
+	m_pPackets(0),
+	m_nPackets(0),
+	m_nSkipped(0),
+	m_nNext(0),
+	m_nCurrent(0),
+	m_nServed(0),
+	m_nUnbound(0),
+	m_bPending(false),
+	m_bRealTime(false),
+	m_nStartMicros(0)
+{
+	DEBUG_ENTRY
+
+	memset(m_aPorts, 0, sizeof(m_aPorts));
+	memset(m_aPortStats, 0, sizeof(m_aPortStats));
+
+	strncpy(m_aIfName, "pcap", sizeof(m_aIfName) - 1);
+	m_nLocalIp = 0x0100000A;	// 10.0.0.1
+	m_nNetmask = 0x000000FF;	// 255.0.0.0
+
+	DEBUG_EXIT
+}
+
+NetworkPcap::~NetworkPcap(void) {
+	DEBUG_ENTRY
+
+	if (Hardware::Get() != 0) {
+		Hardware::Get()->SetVirtualClock(false);
+	}
+
+	delete[] m_pPackets;
+	m_pPackets = 0;
+
+	delete[] m_pCapture;
+	m_pCapture = 0;
+
+	DEBUG_EXIT
+}
+
+bool NetworkPcap::Open(const char *pFileName) {
+	DEBUG_ENTRY
+	assert(pFileName != 0);
+	assert(m_pCapture == 0);
+
+	FILE *pFile = fopen(pFileName, "rb");
+
+	if (pFile == 0) {
+		perror(pFileName);
+		DEBUG_EXIT
+		return false;
+	}
+
+	fseek(pFile, 0L, SEEK_END);
+	const long nSize = ftell(pFile);
+	fseek(pFile, 0L, SEEK_SET);
+
+	if ((nSize < static_cast<long>(pcap::GLOBAL_HEADER_SIZE)) || (nSize > 0x7FFFFFFF)) {
+		fprintf(stderr, "%s: not a pcap file\n", pFileName);
+		fclose(pFile);
+		DEBUG_EXIT
+		return false;
+	}
+
+	m_nCaptureSize = static_cast<uint32_t>(nSize);
+	m_pCapture = new uint8_t[m_nCaptureSize];
+	assert(m_pCapture != 0);
+
+	const size_t nRead = fread(m_pCapture, 1, m_nCaptureSize, pFile);
+	fclose(pFile);
+
+	if (nRead != m_nCaptureSize) {
+		perror(pFileName);
+		DEBUG_EXIT
+		return false;
+	}
+
+	const uint32_t nMagic = read32(m_pCapture, false);
+	bool bSwapped;
+	bool bNanos;
+
+	if ((nMagic == pcap::MAGIC_MICROS) || (nMagic == pcap::MAGIC_NANOS)) {
+		bSwapped = false;
+		bNanos = (nMagic == pcap::MAGIC_NANOS);
+	} else if ((nMagic == __builtin_bswap32(pcap::MAGIC_MICROS)) || (nMagic == __builtin_bswap32(pcap::MAGIC_NANOS))) {
+		bSwapped = true;
+		bNanos = (nMagic == __builtin_bswap32(pcap::MAGIC_NANOS));
+	} else {
+		fprintf(stderr, "%s: not a pcap file (pcapng is not supported)\n", pFileName);
+		DEBUG_EXIT
+		return false;
+	}
+
+	const uint32_t nLinkType = read32(&m_pCapture[20], bSwapped) & 0x0FFFFFFF;
+
+	if (!Index(nLinkType, bSwapped, bNanos)) {
+		fprintf(stderr, "%s: link type %u is not supported\n", pFileName, nLinkType);
+		DEBUG_EXIT
+		return false;
+	}
+
+	Hardware::Get()->SetVirtualClock(!m_bRealTime);
+	Hardware::Get()->SetVirtualMicros(pcap::VIRTUAL_EPOCH_MICROS);
+
+	DEBUG_PRINTF("m_nPackets=%u, m_nSkipped=%u", m_nPackets, m_nSkipped);
+	DEBUG_EXIT
+	return true;
+}
+
+bool NetworkPcap::Index(uint32_t nLinkType, bool bSwapped, bool bNanos) {
+	switch (nLinkType) {
+	case linktype::NULL_LOOPBACK:
+	case linktype::ETHERNET:
+	case linktype::RAW_BSD:
+	case linktype::RAW_OPENBSD:
+	case linktype::RAW:
+	case linktype::LOOP:
+	case linktype::LINUX_SLL:
+	case linktype::LINUX_SLL2:
+		break;
+	default:
+		return false;
+	}
+
+	// First pass counts the records
+	uint32_t nRecords = 0;
+
+	for (uint32_t nOffset = pcap::GLOBAL_HEADER_SIZE; nOffset + pcap::RECORD_HEADER_SIZE <= m_nCaptureSize;) {
+		const uint32_t nCaptured = read32(&m_pCapture[nOffset + 8], bSwapped);
+
+		if (nCaptured > m_nCaptureSize - nOffset - pcap::RECORD_HEADER_SIZE) {
+			break;	// Truncated
+		}
+
+		nOffset += pcap::RECORD_HEADER_SIZE + nCaptured;
+		nRecords++;
+	}
+
+	m_pPackets = new struct TPcapPacket[nRecords == 0 ? 1 : nRecords];
+	assert(m_pPackets != 0);
+
+	uint64_t nFirstMicros = 0;
+	uint64_t nPreviousMicros = 0;
+	uint32_t nOffset = pcap::GLOBAL_HEADER_SIZE;
+
+	for (uint32_t nRecord = 0; nRecord < nRecords; nRecord++) {
+		const uint8_t *pRecord = &m_pCapture[nOffset];
+		const uint32_t nCaptured = read32(&pRecord[8], bSwapped);
+		const uint8_t *pFrame = &pRecord[pcap::RECORD_HEADER_SIZE];
+
+		nOffset += pcap::RECORD_HEADER_SIZE + nCaptured;
+
+		const int32_t nIpOffset = ipv4_offset(nLinkType, pFrame, nCaptured);
+
+		if ((nIpOffset < 0) || (nCaptured < static_cast<uint32_t>(nIpOffset) + 20)) {
+			m_nSkipped++;
+			continue;
+		}
+
+		const uint8_t *pIp = &pFrame[nIpOffset];
+		const uint32_t nIpHeaderLength = static_cast<uint32_t>(pIp[0] & 0x0F) * 4;
+		const uint32_t nIpLength = nCaptured - static_cast<uint32_t>(nIpOffset);
+
+		// IPv4, UDP, not a fragment
+		if (((pIp[0] >> 4) != 4) || (nIpHeaderLength < 20) || (pIp[9] != 17) || ((read16be(&pIp[6]) & 0x3FFF) != 0) || (nIpLength < nIpHeaderLength + 8)) {
+			m_nSkipped++;
+			continue;
+		}
+
+		const uint8_t *pUdp = &pIp[nIpHeaderLength];
+		const uint32_t nUdpLength = read16be(&pUdp[4]);
+
+		if (nUdpLength < 8) {
+			m_nSkipped++;
+			continue;
+		}
+
+		uint32_t nPayloadLength = nUdpLength - 8;
+
+		if (nPayloadLength > nIpLength - nIpHeaderLength - 8) {
+			nPayloadLength = nIpLength - nIpHeaderLength - 8;	// Snap length
+		}
+
+		const uint32_t nFraction = read32(&pRecord[4], bSwapped);
+		uint64_t nMicros = static_cast<uint64_t>(read32(pRecord, bSwapped)) * 1000000 + (bNanos ? nFraction / 1000 : nFraction);
+
+		if (m_nPackets == 0) {
+			nFirstMicros = nMicros;
+		}
+
+		nMicros = nMicros < nFirstMicros ? 0 : nMicros - nFirstMicros;
+
+		if (nMicros < nPreviousMicros) {
+			nMicros = nPreviousMicros;	// Reordered capture
+		}
+
+		nPreviousMicros = nMicros;
+
+		struct TPcapPacket *pPacket = &m_pPackets[m_nPackets++];
+
+		pPacket->nMicros = nMicros;
+		pPacket->nOffset = static_cast<uint32_t>(&pUdp[8] - m_pCapture);
+		memcpy(&pPacket->nFromIp, &pIp[12], 4);
+		pPacket->nFromPort = read16be(&pUdp[0]);
+		pPacket->nToPort = read16be(&pUdp[2]);
+		pPacket->nLength = static_cast<uint16_t>(nPayloadLength);
+	}
+
+	return true;
+}
+
+void NetworkPcap::SetRealTime(bool bRealTime) {
+	m_bRealTime = bRealTime;
+
+	if (Hardware::Get() != 0) {
+		Hardware::Get()->SetVirtualClock(!bRealTime);
+	}
+}
+
+void NetworkPcap::WaitUntil(uint64_t nMicros) {
+	if (m_nStartMicros == 0) {
+		m_nStartMicros = monotonic_micros();
+	}
+
+	const uint64_t nDue = m_nStartMicros + nMicros;
+	uint64_t nNow;
+
+	while ((nNow = monotonic_micros()) < nDue) {
+		const uint64_t nWait = nDue - nNow;
+		struct timespec ts;
+		ts.tv_sec = static_cast<time_t>(nWait / 1000000);
+		ts.tv_nsec = static_cast<long>((nWait % 1000000) * 1000);
+		nanosleep(&ts, 0);
+	}
+}
+
+bool NetworkPcap::Run(void) {
+	// A datagram that was not received is lost, as with a socket that is not read
+	m_bPending = false;
+
+	while (m_nNext < m_nPackets) {
+		const struct TPcapPacket *pPacket = &m_pPackets[m_nNext++];
+		const int32_t nHandle = PortToHandle(pPacket->nToPort);
+
+		if (nHandle < 0) {
+			m_nUnbound++;
+			continue;
+		}
+
+		if (m_bRealTime) {
+			WaitUntil(pPacket->nMicros);
+		} else {
+			Hardware::Get()->SetVirtualMicros(pcap::VIRTUAL_EPOCH_MICROS + pPacket->nMicros);
+		}
+
+		m_aPortStats[nHandle].nRx++;
+		m_nCurrent = m_nNext - 1;
+		m_bPending = true;
+
+		return true;
+	}
+
+	return false;
+}
+
+int32_t NetworkPcap::PortToHandle(uint16_t nPort) const {
+	for (uint32_t i = 0; i < MAX_PORTS; i++) {
+		if (m_aPorts[i] == nPort) {
+			return static_cast<int32_t>(i);
+		}
+	}
+
+	return -1;
+}
+
+int32_t NetworkPcap::Begin(uint16_t nPort) {
+	DEBUG_PRINTF("nPort=%u", nPort);
+	assert(nPort != 0);
+
+	int32_t nHandle = PortToHandle(nPort);
+
+	if (nHandle >= 0) {
+		return nHandle;
+	}
+
+	nHandle = PortToHandle(0);
+
+	if (nHandle < 0) {
+		fprintf(stderr, "NetworkPcap: no free port for %u\n", nPort);
+		return -1;
+	}
+
+	m_aPorts[nHandle] = nPort;
+	memset(&m_aPortStats[nHandle], 0, sizeof(struct TNetworkPortStats));
+	m_aPortStats[nHandle].nPort = nPort;
+
+	return nHandle;
+}
+
+int32_t NetworkPcap::End(uint16_t nPort) {
+	const int32_t nHandle = PortToHandle(nPort);
+
+	if (nHandle < 0) {
+		return -1;
+	}
+
+	m_aPorts[nHandle] = 0;
+
+	return 0;
+}
+
+void NetworkPcap::MacAddressCopyTo(uint8_t *pMacAddress) {
+	memset(pMacAddress, 0, NETWORK_MAC_SIZE);
+}
+
+void NetworkPcap::JoinGroup(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nIp) {
+	// The capture has the multicast traffic already
+}
+
+void NetworkPcap::LeaveGroup(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nIp) {
+}
+
+uint16_t NetworkPcap::RecvBorrow(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) {
+	assert(ppBuffer != 0);
+
+	if (!m_bPending || (nHandle < 0) || (nHandle >= static_cast<int32_t>(MAX_PORTS))) {
+		return 0;
+	}
+
+	const struct TPcapPacket *pPacket = &m_pPackets[m_nCurrent];
+
+	if (pPacket->nToPort != m_aPorts[nHandle]) {
+		return 0;
+	}
+
+	m_bPending = false;
+	m_nServed++;
+
+	*ppBuffer = &m_pCapture[pPacket->nOffset];
+	*pFromIp = pPacket->nFromIp;
+	*pFromPort = pPacket->nFromPort;
+
+	return pPacket->nLength;
+}
+
+void NetworkPcap::RecvRelease(__attribute__((unused)) int32_t nHandle) {
+}
+
+uint16_t NetworkPcap::RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort) {
+	void *pPayload;
+	const uint16_t nBytes = RecvBorrow(nHandle, &pPayload, pFromIp, pFromPort);
+
+	if (nBytes == 0) {
+		return 0;
+	}
+
+	const uint16_t nCopy = nBytes < nLength ? nBytes : nLength;
+	memcpy(pBuffer, pPayload, nCopy);
+
+	return nCopy;
+}
+
+void NetworkPcap::SendTo(int32_t nHandle, __attribute__((unused)) const void *pBuffer, __attribute__((unused)) uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) {
+	if ((nHandle >= 0) && (nHandle < static_cast<int32_t>(MAX_PORTS))) {
+		m_aPortStats[nHandle].nTx++;
+	}
+}
+
+bool NetworkPcap::GetPortStats(uint32_t nIndex, struct TNetworkPortStats& tPortStats) {
+	for (uint32_t i = 0; i < MAX_PORTS; i++) {
+		if (m_aPorts[i] == 0) {
+			continue;
+		}
+
+		if (nIndex-- == 0) {
+			tPortStats = m_aPortStats[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void NetworkPcap::SetIp(uint32_t nIp) {
+	m_nLocalIp = nIp;
+}
+
+void NetworkPcap::SetNetmask(uint32_t nNetmask) {
+	m_nNetmask = nNetmask;
+}
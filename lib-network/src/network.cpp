@@ -164,3 +164,17 @@ void Network::SetDomainName(const char *pDomainName) {
 	DEBUG_PUTS(m_aDomainName);
 	DEBUG_EXIT
 }
+
+bool Network::GetPortStats(__attribute__((unused)) uint32_t nIndex, __attribute__((unused)) struct TNetworkPortStats& tPortStats) {
+	return false;
+}
+
+bool Network::GetPortStatsByPort(uint16_t nPort, struct TNetworkPortStats& tPortStats) {
+	for (uint32_t nIndex = 0; GetPortStats(nIndex, tPortStats); nIndex++) {
+		if (tPortStats.nPort == nPort) {
+			return true;
+		}
+	}
+
+	return false;
+}
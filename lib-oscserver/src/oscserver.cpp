@@ -35,6 +35,7 @@
 #include "oscblob.h"
 
 #include "lightset.h"
+#include "lightsetmerge.h"
 #include "network.h"
 
 #include "hardware.h"
@@ -244,26 +245,9 @@ int OscServer::GetChannel(const char* p) {
 bool OscServer::IsDmxDataChanged(const uint8_t* pData, uint16_t nStartChannel, uint16_t nLength) {
 	assert(pData != 0);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
+	assert((nStartChannel - 1U + nLength) <= DMX_UNIVERSE_SIZE);
 
-	bool isChanged = false;
-
-	const uint8_t *src = pData;
-	uint8_t *dst = &m_pData[--nStartChannel];
-
-	uint16_t nEnd = nStartChannel + nLength;
-
-	assert(nEnd <= DMX_UNIVERSE_SIZE);
-
-	for (uint32_t i = nStartChannel; i < nEnd; i++) {
-		if (*dst != *src) {
-			*dst = *src;
-			isChanged = true;
-		}
-		dst++;
-		src++;
-	}
-
-	return isChanged;
+	return LightSetMerge::Copy(&m_pData[nStartChannel - 1], pData, nLength);
 }
 
 int OscServer::Run(void) {
@@ -31,6 +31,8 @@
 #include "rdmmessage.h"
 #include "rdmqueuedmessage.h"
 
+#define RDM_HANDLER_SUPPORTED_PARAMETERS_MAX	32	///< PIDs with bIncludeInSupportedParams
+
 class RDMHandler {
 public:
 	RDMHandler(bool bRDM = true);
@@ -51,9 +53,19 @@ private:
 		const bool bRDMNet;
 	} TPidDefinition;
 
+	/**
+	 * The tables are sorted on nPid, checked at compile time
+	 */
 	static const TPidDefinition PID_DEFINITIONS[];
 	static const TPidDefinition PID_DEFINITIONS_SUB_DEVICES[];
 
+	static constexpr bool IsSorted(const TPidDefinition *pTable, uint32_t nEntries) {
+		return (nEntries < 2) || ((pTable[0].nPid < pTable[1].nPid) && IsSorted(&pTable[1], nEntries - 1));
+	}
+
+	static const TPidDefinition *FindPid(const TPidDefinition *pTable, uint32_t nEntries, uint16_t nPid);
+	static uint32_t CreateSupportedParameters(const TPidDefinition *pTable, uint32_t nEntries, uint8_t *pParamData);
+
 	// Get
 	void GetQueuedMessage(uint16_t nSubDevice);
 	void GetSupportedParameters(uint16_t nSubDevice);
@@ -129,6 +141,10 @@ private:
 
 private:
 	bool m_bIsRDM;
+	uint8_t m_nSupportedParametersLength;
+	uint8_t m_nSupportedParametersSubDevicesLength;
+	uint8_t m_aSupportedParameters[2 * RDM_HANDLER_SUPPORTED_PARAMETERS_MAX];				///< SUPPORTED_PARAMETERS response, root device
+	uint8_t m_aSupportedParametersSubDevices[2 * RDM_HANDLER_SUPPORTED_PARAMETERS_MAX];	///< SUPPORTED_PARAMETERS response, sub-devices
 	RDMQueuedMessage m_RDMQueuedMessage;
 	bool m_IsMuted;
 	uint8_t *m_pRdmDataIn;
@@ -54,17 +54,6 @@ enum TPowerState {
 	POWER_STATE_NORMAL = 0xFF,		///< Normal Operating Mode.
 };
 
-RDMHandler::RDMHandler(bool bIsRdm):
-	m_bIsRDM(bIsRdm),
-	m_IsMuted(false),
-	m_pRdmDataIn(0),
-	m_pRdmDataOut(0)
-{
-}
-
-RDMHandler::~RDMHandler(void) {
-}
-
 void RDMHandler::HandleString(const char *pString, uint32_t nLength) {
 	struct TRdmMessage *RdmMessage = reinterpret_cast<struct TRdmMessage*>(m_pRdmDataOut);
 
@@ -144,7 +133,7 @@ void RDMHandler::RespondMessageNack(uint16_t nReason) {
 	CreateRespondMessage(E120_RESPONSE_TYPE_NACK_REASON, nReason);
 }
 
-const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS[] {
+constexpr RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS[] {
 //  {E120_QUEUED_MESSAGE,              	&RDMHandler::GetQueuedMessage,           	0,                   				1, true , false},
 	{E120_SUPPORTED_PARAMETERS,        	&RDMHandler::GetSupportedParameters,      	0,             						0, false, true , false},
 	{E120_DEVICE_INFO,                	&RDMHandler::GetDeviceInfo,               	0,                					0, false, true , true },
@@ -168,26 +157,26 @@ const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS[] {
 	{E120_RECORD_SENSORS,			   	0,											&RDMHandler::SetRecordSensors,	 	0, true , true , false},
 	{E120_DEVICE_HOURS,                	&RDMHandler::GetDeviceHours,    	      	&RDMHandler::SetDeviceHours,       	0, true , true , false},
 	{E120_REAL_TIME_CLOCK,		       	&RDMHandler::GetRealTimeClock,  			&RDMHandler::SetRealTimeClock,    	0, true , true , false},
-	{E120_IDENTIFY_DEVICE,		       	&RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,    	0, false, true , true },
-	{E120_RESET_DEVICE,			    	0,                                			&RDMHandler::SetResetDevice,       	0, true , true , true },
-	{E120_POWER_STATE,					&RDMHandler::GetPowerState,					&RDMHandler::SetPowerState,			0, true , true , false},
-	{E137_1_IDENTIFY_MODE,			   	&RDMHandler::GetIdentifyMode,				&RDMHandler::SetIdentifyMode,		0, true , true , false},
 	{E137_2_LIST_INTERFACES,			&RDMHandler::GetInterfaceList,				0,									0, false, false, true },
 	{E137_2_INTERFACE_LABEL,			&RDMHandler::GetInterfaceName,				0,									4, false, false, true },
 	{E137_2_INTERFACE_HARDWARE_ADDRESS_TYPE1,&RDMHandler::GetHardwareAddress,		0,									4, false, false, true },
 	{E137_2_IPV4_DHCP_MODE,				&RDMHandler::GetDHCPMode,					&RDMHandler::SetDHCPMode,			4, false, false, true },
 	{E137_2_IPV4_ZEROCONF_MODE,			&RDMHandler::GetZeroconf,					&RDMHandler::SetZeroconf,			4, false, false, true },
 	{E137_2_IPV4_CURRENT_ADDRESS,		&RDMHandler::GetAddressNetmask,				0,									4, false, false, true },
-	{E137_2_INTERFACE_RENEW_DHCP, 		0,											&RDMHandler::RenewDhcp,				4, false, false, true },
 	{E137_2_IPV4_STATIC_ADDRESS,		&RDMHandler::GetStaticAddress,				&RDMHandler::SetStaticAddress,		4, false, false, true },
+	{E137_2_INTERFACE_RENEW_DHCP, 		0,											&RDMHandler::RenewDhcp,				4, false, false, true },
 	{E137_2_INTERFACE_APPLY_CONFIGURATION,0,										&RDMHandler::ApplyConfiguration,	4, false, false, true },
-	{E137_2_DNS_IPV4_NAME_SERVER,		&RDMHandler::GetNameServers,				0,									1, false, false, true },
 	{E137_2_IPV4_DEFAULT_ROUTE,			&RDMHandler::GetDefaultRoute,				&RDMHandler::SetDefaultRoute,		4, false, false, true },
+	{E137_2_DNS_IPV4_NAME_SERVER,		&RDMHandler::GetNameServers,				0,									1, false, false, true },
 	{E137_2_DNS_HOSTNAME,               &RDMHandler::GetHostName,                   &RDMHandler::SetHostName,           0, false, false, true },
-	{E137_2_DNS_DOMAIN_NAME,			&RDMHandler::GetDomainName,					&RDMHandler::SetDomainName,			0, false, false, true }
+	{E137_2_DNS_DOMAIN_NAME,			&RDMHandler::GetDomainName,					&RDMHandler::SetDomainName,			0, false, false, true },
+	{E120_IDENTIFY_DEVICE,		       	&RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,    	0, false, true , true },
+	{E120_RESET_DEVICE,			    	0,                                			&RDMHandler::SetResetDevice,       	0, true , true , true },
+	{E120_POWER_STATE,					&RDMHandler::GetPowerState,					&RDMHandler::SetPowerState,			0, true , true , false},
+	{E137_1_IDENTIFY_MODE,			   	&RDMHandler::GetIdentifyMode,				&RDMHandler::SetIdentifyMode,		0, true , true , false}
 };
 
-const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
+constexpr RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
 	{E120_SUPPORTED_PARAMETERS,        &RDMHandler::GetSupportedParameters,			0,                       			0, true, true ,  false},
 	{E120_DEVICE_INFO,                 &RDMHandler::GetDeviceInfo,					0,                        			0, true, true ,  false},
 	{E120_PRODUCT_DETAIL_ID_LIST, 	   &RDMHandler::GetProductDetailIdList,			0,						 			0, true, true ,  false},
@@ -198,6 +187,56 @@ const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
 	{E120_IDENTIFY_DEVICE,		       &RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,		0, true, true ,  false}
 };
 
+RDMHandler::RDMHandler(bool bIsRdm):
+	m_bIsRDM(bIsRdm),
+	m_IsMuted(false),
+	m_pRdmDataIn(0),
+	m_pRdmDataOut(0)
+{
+	static_assert(IsSorted(PID_DEFINITIONS, sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0])), "PID_DEFINITIONS must be sorted on nPid");
+	static_assert(IsSorted(PID_DEFINITIONS_SUB_DEVICES, sizeof(PID_DEFINITIONS_SUB_DEVICES) / sizeof(PID_DEFINITIONS_SUB_DEVICES[0])), "PID_DEFINITIONS_SUB_DEVICES must be sorted on nPid");
+
+	// The tables are constant, so is the SUPPORTED_PARAMETERS response
+	m_nSupportedParametersLength = static_cast<uint8_t>(CreateSupportedParameters(PID_DEFINITIONS, sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]), m_aSupportedParameters));
+	m_nSupportedParametersSubDevicesLength = static_cast<uint8_t>(CreateSupportedParameters(PID_DEFINITIONS_SUB_DEVICES, sizeof(PID_DEFINITIONS_SUB_DEVICES) / sizeof(PID_DEFINITIONS_SUB_DEVICES[0]), m_aSupportedParametersSubDevices));
+}
+
+RDMHandler::~RDMHandler(void) {
+}
+
+const RDMHandler::TPidDefinition *RDMHandler::FindPid(const TPidDefinition *pTable, uint32_t nEntries, uint16_t nPid) {
+	uint32_t nLow = 0;
+	uint32_t nHigh = nEntries;
+
+	while (nLow < nHigh) {
+		const uint32_t nMiddle = (nLow + nHigh) / 2;
+
+		if (pTable[nMiddle].nPid < nPid) {
+			nLow = nMiddle + 1;
+		} else if (pTable[nMiddle].nPid > nPid) {
+			nHigh = nMiddle;
+		} else {
+			return &pTable[nMiddle];
+		}
+	}
+
+	return 0;
+}
+
+uint32_t RDMHandler::CreateSupportedParameters(const TPidDefinition *pTable, uint32_t nEntries, uint8_t *pParamData) {
+	uint32_t nLength = 0;
+
+	for (uint32_t i = 0; i < nEntries; i++) {
+		if (pTable[i].bIncludeInSupportedParams) {
+			assert(nLength < (2 * RDM_HANDLER_SUPPORTED_PARAMETERS_MAX));
+			pParamData[nLength++] = static_cast<uint8_t>(pTable[i].nPid >> 8);
+			pParamData[nLength++] = static_cast<uint8_t>(pTable[i].nPid);
+		}
+	}
+
+	return nLength;
+}
+
 /**
  * @param pRdmDataIn RDM with no Start Code
  * @param pRdmDataOut RDM with the Start Code or it is Discover Message
@@ -337,10 +376,6 @@ void RDMHandler::HandleData(const uint8_t *pRdmDataIn, uint8_t *pRdmDataOut) {
 void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nParamId, uint8_t nParamDataLength, uint16_t nSubDevice) {
 	DEBUG1_ENTRY
 
-	TPidDefinition const *pid_handler = 0;
-	bool bRDM;
-	bool bRDMNet;
-
 	if (nCommandClass != E120_GET_COMMAND && nCommandClass != E120_SET_COMMAND) {
 		RespondMessageNack(E120_NR_UNSUPPORTED_COMMAND_CLASS);
 		return;
@@ -353,13 +388,7 @@ void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nPa
 		return;
 	}
 
-	for (uint32_t i = 0; i < sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]); ++i) {
-		if (PID_DEFINITIONS[i].nPid == nParamId) {
-			pid_handler = &PID_DEFINITIONS[i];
-			bRDM = PID_DEFINITIONS[i].bRDM;
-			bRDMNet = PID_DEFINITIONS[i].bRDMNet;
-		}
-	}
+	TPidDefinition const *pid_handler = FindPid(PID_DEFINITIONS, sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]), nParamId);
 
 	if (!pid_handler) {
 		RespondMessageNack(E120_NR_UNKNOWN_PID);
@@ -368,13 +397,13 @@ void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nPa
 	}
 
 	if (m_bIsRDM) {
-		if (!bRDM) {
+		if (!pid_handler->bRDM) {
 			RespondMessageNack(E120_NR_UNKNOWN_PID);
 			DEBUG1_EXIT
 			return;
 		}
 	} else {
-		if (!bRDMNet) {
+		if (!pid_handler->bRDMNet) {
 			RespondMessageNack(E120_NR_UNKNOWN_PID);
 			DEBUG1_EXIT
 			return;
@@ -425,36 +454,14 @@ void RDMHandler::GetQueuedMessage(__attribute__((unused)) uint16_t nSubDevice) {
 }
 
 void RDMHandler::GetSupportedParameters(uint16_t nSubDevice) {
-	uint8_t nSupportedParams = 0;
-	TPidDefinition *pPidDefinitions;
-	uint32_t nTableSize = 0;
+	struct TRdmMessage *pRdmDataOut = reinterpret_cast<struct TRdmMessage*>(m_pRdmDataOut);
 
 	if (nSubDevice != 0) {
-		pPidDefinitions = const_cast<TPidDefinition*>(&PID_DEFINITIONS_SUB_DEVICES[0]);
-		nTableSize = sizeof(PID_DEFINITIONS_SUB_DEVICES) / sizeof(PID_DEFINITIONS_SUB_DEVICES[0]);
+		pRdmDataOut->param_data_length = m_nSupportedParametersSubDevicesLength;
+		memcpy(pRdmDataOut->param_data, m_aSupportedParametersSubDevices, m_nSupportedParametersSubDevicesLength);
 	} else {
-		pPidDefinitions = const_cast<TPidDefinition*>(&PID_DEFINITIONS[0]);
-		nTableSize = sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]);
-	}
-
-	for (uint32_t i = 0; i < nTableSize; i++) {
-		if (pPidDefinitions[i].bIncludeInSupportedParams) {
-			nSupportedParams++;
-		}
-	}
-
-	struct TRdmMessage *pRdmDataOut = reinterpret_cast<struct TRdmMessage*>(m_pRdmDataOut);
-
-	pRdmDataOut->param_data_length = (2 * nSupportedParams);
-
-	uint32_t j = 0;
-
-	for (uint32_t i = 0; i < nTableSize; i++) {
-		if (pPidDefinitions[i].bIncludeInSupportedParams) {
-			pRdmDataOut->param_data[j + j] = (pPidDefinitions[i].nPid >> 8);
-			pRdmDataOut->param_data[j + j + 1] = pPidDefinitions[i].nPid;
-			j++;
-		}
+		pRdmDataOut->param_data_length = m_nSupportedParametersLength;
+		memcpy(pRdmDataOut->param_data, m_aSupportedParameters, m_nSupportedParametersLength);
 	}
 
 	RespondMessageAck();
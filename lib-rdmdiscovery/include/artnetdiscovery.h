@@ -20,10 +20,23 @@ public:
 	void Print(void);
 
 	void Full(uint8_t nPort = 0);
-	uint8_t GetUidCount(uint8_t nPort = 0);
-	void Copy(uint8_t nPort, uint8_t *pTod);
+	uint32_t GetUidCount(uint8_t nPort = 0);
+
+	void Start(uint8_t nPort, bool bIncremental = false);
+	bool IsRunning(uint8_t nPort);
+	bool IsHolding(uint8_t nPort);
+	void Step(uint8_t nPort);
+	void Run(void);
+
+	bool IsRunning(void);	///< Any port
+
+	uint32_t Copy(uint8_t nPort, uint8_t *pTod, uint32_t nFirst, uint32_t nMax);
+	bool IsTodChanged(uint8_t nPort);
 	const uint8_t *Handler(uint8_t nPort, const uint8_t *pRdmData);
 
+	bool SendRequest(uint8_t nPort, const uint8_t *pRdmData);
+	const uint8_t *GetResponse(uint8_t nPort);
+
 	void DumpTod(uint8_t nPort = 0);
 
 private:
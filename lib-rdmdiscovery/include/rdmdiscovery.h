@@ -33,6 +33,25 @@
 #include "rdmmessage.h"
 #include "rdmtod.h"
 
+#define RDM_DISCOVERY_STACK_SIZE	49		///< Binary search over the 48-bit UID space
+
+enum TRdmDiscoveryState {
+	RDM_DISCOVERY_STATE_IDLE,
+	RDM_DISCOVERY_STATE_UNMUTE,				///< Send DISC_UN_MUTE to all
+	RDM_DISCOVERY_STATE_UNMUTE_WAIT,
+	RDM_DISCOVERY_STATE_BRANCH,				///< Take the next UID range from the stack
+	RDM_DISCOVERY_STATE_BRANCH_WAIT,		///< Waiting for the DISC_UNIQUE_BRANCH response
+	RDM_DISCOVERY_STATE_MUTE_WAIT,			///< Waiting for the DISC_MUTE response
+	RDM_DISCOVERY_STATE_VERIFY,				///< Incremental, mute the next known UID
+	RDM_DISCOVERY_STATE_VERIFY_WAIT,
+	RDM_DISCOVERY_STATE_FINISHED
+};
+
+struct TRdmDiscoveryRange {
+	uint64_t nLower;
+	uint64_t nUpper;
+};
+
 class RDMDiscovery: public RDMTod {
 public:
 	RDMDiscovery(uint8_t nPort = 0);
@@ -41,11 +60,41 @@ public:
 	void SetUid(const uint8_t *);
 	const uint8_t *GetUid(void);
 
+	/**
+	 * Blocking, runs the state machine until the discovery has finished
+	 */
 	void Full(void);
 
+	/**
+	 * Non-blocking, each Run() does at most one transaction on the line.
+	 * Incremental keeps the TOD, the known UIDs are verified with DISC_MUTE
+	 * and only new responders are searched for. An incremental discovery holds
+	 * before each transaction until Step(), the line can be used in between.
+	 */
+	void Start(bool bIncremental = false);
+	bool Run(void);
+
+	bool IsRunning(void) const {
+		return (m_tState != RDM_DISCOVERY_STATE_IDLE) && (m_tState != RDM_DISCOVERY_STATE_FINISHED);
+	}
+
+	bool IsHolding(void) const {
+		return m_bIncremental && !m_bStep && IsTransactionStart();
+	}
+
+	void Step(void) {
+		m_bStep = true;
+	}
+
 private:
-	bool FindDevices(uint64_t, uint64_t);
-	bool QuickFind(const uint8_t *);
+	bool IsTransactionStart(void) const {
+		return (m_tState == RDM_DISCOVERY_STATE_UNMUTE) || (m_tState == RDM_DISCOVERY_STATE_VERIFY) || (m_tState == RDM_DISCOVERY_STATE_BRANCH);
+	}
+	void Push(uint64_t nLower, uint64_t nUpper);
+	void Split(void);
+	void Mute(const uint8_t *pUid);
+	bool IsMuteResponse(const uint8_t *pResponse, const uint8_t *pUid);
+	void Drain(void);
 
 	bool IsValidDiscoveryResponse(const uint8_t *, uint8_t *);
 
@@ -60,6 +109,17 @@ private:
 	RDMMessage m_UnMute;
 	RDMMessage m_Mute;
 	RDMMessage m_DiscUniqueBranch;
+	TRdmDiscoveryState m_tState;
+	uint32_t m_nUnMuteCount;
+	uint32_t m_nMicros;										///< Start of the current wait
+	struct TRdmDiscoveryRange m_tRange;						///< The range being examined
+	struct TRdmDiscoveryRange m_aStack[RDM_DISCOVERY_STACK_SIZE];
+	uint32_t m_nStackTop;
+	uint8_t m_MuteUid[RDM_UID_SIZE];						///< Destination of the pending DISC_MUTE
+	bool m_bQuickFind;										///< The pending DISC_MUTE is for a decoded DISC_UNIQUE_BRANCH response
+	bool m_bIncremental;
+	bool m_bStep;											///< Incremental, the next transaction can start
+	uint32_t m_nVerifyIndex;								///< Next known UID to verify
 };
 
 #endif /* RDMDISCOVERY_H_ */
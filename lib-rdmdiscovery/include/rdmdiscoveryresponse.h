@@ -0,0 +1,56 @@
+/**
+ * @file rdmdiscoveryresponse.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RDMDISCOVERYRESPONSE_H_
+#define RDMDISCOVERYRESPONSE_H_
+
+#include <stdint.h>
+
+class RDMDiscoveryResponse {
+public:
+	/**
+	 * DISC_UNIQUE_BRANCH response: 7 bytes preamble, separator, the encoded UID and checksum
+	 * @return false when the checksum does not match, pUid is then not valid
+	 */
+	static bool Decode(const uint8_t *pResponse, uint8_t *pUid) {
+		if (pResponse[0] != 0xFE) {
+			return false;
+		}
+
+		uint16_t nChecksum = 6 * 0xFF;
+
+		for (uint32_t i = 0; i < 6; i++) {
+			pUid[i] = pResponse[8 + (i * 2)] & pResponse[9 + (i * 2)];
+			nChecksum = static_cast<uint16_t>(nChecksum + pUid[i]);
+		}
+
+		const uint8_t nChecksumHigh = pResponse[20] & pResponse[21];
+		const uint8_t nChecksumLow = pResponse[22] & pResponse[23];
+
+		return ((nChecksum >> 8) == nChecksumHigh) && ((nChecksum & 0xFF) == nChecksumLow);
+	}
+};
+
+#endif /* RDMDISCOVERYRESPONSE_H_ */
@@ -30,12 +30,11 @@
 
 #include "rdm.h"
 
-#define TOD_TABLE_SIZE	200
-
-struct TRdmTod {
-	uint8_t uid[RDM_UID_SIZE];
-};
+#define TOD_TABLE_SIZE	400		///< Two ArtTodData blocks
 
+/**
+ * The UIDs are kept sorted as 48-bit integers, lookup is a binary search
+ */
 class RDMTod {
 public:
 	 RDMTod(void);
@@ -43,17 +42,35 @@ public:
 
 	 void Reset(void);
 	 bool AddUid(const uint8_t *pUid);
-	 uint8_t GetUidCount(void) const;
+	 uint32_t GetUidCount(void) const;
+	 bool GetUid(uint32_t nIndex, uint8_t *pUid) const;
+
 	 void Copy(uint8_t *pTable);
+	 uint32_t Copy(uint8_t *pTable, uint32_t nFirst, uint32_t nMax);
 
 	 bool Delete(const uint8_t *pUid);
-	 bool Exist(const uint8_t *pUid);
+	 bool Exist(const uint8_t *pUid) const;
+
+	 /**
+	  * UIDs added or deleted since the first block was copied
+	  */
+	 bool IsChanged(void) const {
+		 return m_bChanged;
+	 }
 
 	 void Dump(void);
-	 void Dump(uint8_t nCount);
+	 void Dump(uint32_t nCount);
+
+private:
+	 uint32_t LowerBound(uint64_t nUid) const;
+
+	 static uint64_t ToUint64(const uint8_t *pUid);
+	 static void FromUint64(uint64_t nUid, uint8_t *pUid);
+
 private:
-	 uint8_t m_nEntries;
-	 TRdmTod *m_pTable;
+	 uint32_t m_nEntries;
+	 uint64_t *m_pTable;
+	 bool m_bChanged;
 };
 
 #endif /* RDMTOD_H_ */
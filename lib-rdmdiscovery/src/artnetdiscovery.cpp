@@ -76,7 +76,52 @@ void ArtNetRdmController::Full(uint8_t nPort) {
 	m_Discovery[nPort]->Full();
 }
 
-uint8_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
+void ArtNetRdmController::Start(uint8_t nPort, bool bIncremental) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	DEBUG_PRINTF("nPort=%d, bIncremental=%d", nPort, bIncremental);
+
+	m_Discovery[nPort]->Start(bIncremental);
+}
+
+bool ArtNetRdmController::IsRunning(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Discovery[nPort]->IsRunning();
+}
+
+bool ArtNetRdmController::IsHolding(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Discovery[nPort]->IsHolding();
+}
+
+void ArtNetRdmController::Step(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	m_Discovery[nPort]->Step();
+}
+
+bool ArtNetRdmController::IsRunning(void) {
+	for (uint32_t i = 0; i < DMX_MAX_UARTS; i++) {
+		if (m_Discovery[i]->IsRunning()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * The ports are independent lines, each Run() advances all running discoveries by one step
+ */
+void ArtNetRdmController::Run(void) {
+	for (uint32_t i = 0; i < DMX_MAX_UARTS; i++) {
+		m_Discovery[i]->Run();
+	}
+}
+
+uint32_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
 	assert(nPort < DMX_MAX_UARTS);
 
 	DEBUG_PRINTF("nPort=%d", nPort);
@@ -84,12 +129,18 @@ uint8_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
 	return m_Discovery[nPort]->GetUidCount();
 }
 
-void ArtNetRdmController::Copy(uint8_t nPort, uint8_t *pTod) {
+uint32_t ArtNetRdmController::Copy(uint8_t nPort, uint8_t *pTod, uint32_t nFirst, uint32_t nMax) {
 	assert(nPort < DMX_MAX_UARTS);
 
-	DEBUG_PRINTF("nPort=%d", nPort);
+	DEBUG_PRINTF("nPort=%d, nFirst=%u", nPort, nFirst);
 
-	m_Discovery[nPort]->Copy(pTod);
+	return m_Discovery[nPort]->Copy(pTod, nFirst, nMax);
+}
+
+bool ArtNetRdmController::IsTodChanged(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Discovery[nPort]->IsChanged();
 }
 
 void ArtNetRdmController::DumpTod(uint8_t nPort) {
@@ -103,10 +154,25 @@ void ArtNetRdmController::DumpTod(uint8_t nPort) {
 const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmData) {
 	assert(nPort < DMX_MAX_UARTS);
 
-	if (pRdmData == 0) {
+	if (!SendRequest(nPort, pRdmData)) {
 		return 0;
 	}
 
+	const uint8_t *pResponse = RDMMessage::ReceiveTimeOut(nPort, 20000);
+
+#ifndef NDEBUG
+	RDMMessage::Print(pResponse);
+#endif
+	return pResponse;
+}
+
+bool ArtNetRdmController::SendRequest(uint8_t nPort, const uint8_t *pRdmData) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	if ((pRdmData == 0) || (m_Discovery[nPort]->IsRunning() && !m_Discovery[nPort]->IsHolding())) {
+		return false;
+	}
+
 	Hardware::Get()->WatchdogFeed();
 
 	while (0 != RDMMessage::Receive(nPort)) {
@@ -124,10 +190,18 @@ const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmDa
 
 	RDMMessage::SendRaw(nPort, pRdmCommand, pRdmMessageNoSc->message_length + 2);
 
-	const uint8_t *pResponse = RDMMessage::ReceiveTimeOut(nPort, 20000);
+	return true;
+}
+
+const uint8_t *ArtNetRdmController::GetResponse(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	const uint8_t *pResponse = RDMMessage::Receive(nPort);
 
 #ifndef NDEBUG
-	RDMMessage::Print(pResponse);
+	if (pResponse != 0) {
+		RDMMessage::Print(pResponse);
+	}
 #endif
 	return pResponse;
 }
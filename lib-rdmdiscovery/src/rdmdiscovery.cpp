@@ -28,16 +28,16 @@
 #ifndef NDEBUG
 #include <stdio.h>
 #endif
+#include <cassert>
 
 #include "rdm.h"
 #include "rdm_e120.h"
 #include "rdmdiscovery.h"
+#include "rdmdiscoveryresponse.h"
 
 #include "hardware.h"
 
-extern "C" {
- void udelay(uint32_t us);
-}
+#include "debug.h"
 
 static uint8_t pdl[2][RDM_UID_SIZE];
 
@@ -48,9 +48,22 @@ typedef union cast {
 
 static _cast uuid_cast;
 
-#define RECEIVE_TIME_OUT (2800*100) //TODO #define
-
-RDMDiscovery::RDMDiscovery(uint8_t nPort) : m_nPort(nPort) {
+#define RECEIVE_TIME_OUT		5000			///< 7.5 Discovery response starts within 2.8ms, plus the response itself
+#define UNMUTE_COUNT			3
+#define UNMUTE_DELAY			100000			///< Micros between the DISC_UN_MUTE broadcasts
+#define UID_UPPER_BOUND			0xfffffffffffe	///< All UIDs except the broadcast
+
+RDMDiscovery::RDMDiscovery(uint8_t nPort) :
+	m_nPort(nPort),
+	m_tState(RDM_DISCOVERY_STATE_IDLE),
+	m_nUnMuteCount(0),
+	m_nMicros(0),
+	m_nStackTop(0),
+	m_bQuickFind(false),
+	m_bIncremental(false),
+	m_bStep(false),
+	m_nVerifyIndex(0)
+{
 	m_UnMute.SetDstUid(UID_ALL);
 	m_UnMute.SetCc(E120_DISCOVERY_COMMAND);
 	m_UnMute.SetPid(E120_DISC_UN_MUTE);
@@ -61,6 +74,9 @@ RDMDiscovery::RDMDiscovery(uint8_t nPort) : m_nPort(nPort) {
 	m_DiscUniqueBranch.SetDstUid(UID_ALL);
 	m_DiscUniqueBranch.SetCc(E120_DISCOVERY_COMMAND);
 	m_DiscUniqueBranch.SetPid(E120_DISC_UNIQUE_BRANCH);
+
+	m_tRange.nLower = 0;
+	m_tRange.nUpper = 0;
 }
 
 RDMDiscovery::~RDMDiscovery(void) {
@@ -79,96 +95,227 @@ const uint8_t *RDMDiscovery::GetUid(void) {
 }
 
 void RDMDiscovery::Full(void) {
-	Reset();
+	Start();
 
-	m_UnMute.Send(m_nPort);
-	m_UnMute.ReceiveTimeOut(m_nPort, 2800);
+	while (Run()) {
+		Hardware::Get()->WatchdogFeed();
+	}
 
-	Hardware::Get()->WatchdogFeed();
-	udelay(100000);
+	Dump();
+}
 
-	m_UnMute.Send(m_nPort);
-	m_UnMute.ReceiveTimeOut(m_nPort, 2800);
+void RDMDiscovery::Start(bool bIncremental) {
+	if (!bIncremental) {
+		Reset();
+	}
 
-	Hardware::Get()->WatchdogFeed();
-	udelay(100000);
+	m_bIncremental = bIncremental;
+	m_bStep = false;
+	m_nVerifyIndex = 0;
+	m_nUnMuteCount = bIncremental ? (UNMUTE_COUNT - 1) : 0;
+	m_nStackTop = 0;
+	m_tState = RDM_DISCOVERY_STATE_UNMUTE;
+}
 
-	m_UnMute.Send(m_nPort);
+/*
+ * Depth first binary search. A range on the stack is resolved with a single
+ * DISC_UNIQUE_BRANCH: no response means no responders, a valid response is muted
+ * (quick find) and the range is examined again, a collision splits the range.
+ */
+bool RDMDiscovery::Run(void) {
+	const uint8_t *pResponse;
+	uint8_t uid[RDM_UID_SIZE];
+	const uint32_t nElapsed = Hardware::Get()->Micros() - m_nMicros;
 
-	const struct TRdmMessage *pResponse = reinterpret_cast<const struct TRdmMessage*>(m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT));
+	if (m_bIncremental && IsTransactionStart()) {
+		if (!m_bStep) {
+			return true;
+		}
 
-	if (pResponse != 0) {
-		FindDevices(ConvertUid(pResponse->source_uid), ConvertUid(pResponse->source_uid));
+		m_bStep = false;
 	}
 
-	FindDevices(0x000000000000, 0xfffffffffffe);
+	switch (m_tState) {
+	case RDM_DISCOVERY_STATE_UNMUTE:
+		Drain();
+		m_UnMute.Send(m_nPort);
+		m_nUnMuteCount++;
+		m_nMicros = Hardware::Get()->Micros();
+		m_tState = RDM_DISCOVERY_STATE_UNMUTE_WAIT;
+		break;
+	case RDM_DISCOVERY_STATE_UNMUTE_WAIT:
+		if (nElapsed < (m_bIncremental ? RECEIVE_TIME_OUT : UNMUTE_DELAY)) {
+			break;
+		}
 
-	Dump();
-}
+		if (m_nUnMuteCount < UNMUTE_COUNT) {
+			m_tState = RDM_DISCOVERY_STATE_UNMUTE;
+			break;
+		}
 
-bool RDMDiscovery::FindDevices(uint64_t LowerBound, uint64_t UpperBound) {
-	struct TRdmMessage *pRdmMessage;
-	uint8_t uid[RDM_UID_SIZE];
-	bool bDeviceFound = false;
-	uint64_t MidPosition;
+		if (m_bIncremental) {
+			m_tState = RDM_DISCOVERY_STATE_VERIFY;
+			break;
+		}
 
-	Hardware::Get()->WatchdogFeed();
+		Push(0, UID_UPPER_BOUND);
+		m_tState = RDM_DISCOVERY_STATE_BRANCH;
+		break;
+	case RDM_DISCOVERY_STATE_VERIFY:
+		if (RDMTod::GetUid(m_nVerifyIndex, uid)) {
+			Drain();
+			Mute(uid);
+			m_tState = RDM_DISCOVERY_STATE_VERIFY_WAIT;
+			break;
+		}
 
-#ifndef NDEBUG
-	printf("FindDevices : ");
-	PrintUid(LowerBound);
-	printf(" - ");
-	PrintUid(UpperBound);
-	printf("\n");
-#endif
+		// The known UIDs are muted now, only new responders answer the search
+		Push(0, UID_UPPER_BOUND);
+		m_tState = RDM_DISCOVERY_STATE_BRANCH;
+		break;
+	case RDM_DISCOVERY_STATE_VERIFY_WAIT:
+		pResponse = Rdm::Receive(m_nPort);
+
+		if ((pResponse == 0) && (nElapsed < RECEIVE_TIME_OUT)) {
+			break;
+		}
+
+		if ((pResponse != 0) && IsMuteResponse(pResponse, m_MuteUid)) {
+			m_nVerifyIndex++;
+		} else {
+			Delete(m_MuteUid);
+		}
 
-	if (LowerBound == UpperBound) {
-		memcpy(uid, ConvertUid(LowerBound), RDM_UID_SIZE);
+		m_tState = RDM_DISCOVERY_STATE_VERIFY;
+		break;
+	case RDM_DISCOVERY_STATE_BRANCH:
+		if (m_nStackTop == 0) {
+			m_tState = RDM_DISCOVERY_STATE_FINISHED;
 
-		m_Mute.SetDstUid(uid);
-		m_Mute.Send(m_nPort);
+			DEBUG_PRINTF("nPort=%d, found %u", m_nPort, GetUidCount());
+			break;
+		}
 
-		pRdmMessage = reinterpret_cast<struct TRdmMessage*>(const_cast<uint8_t*>(m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT)));
+		m_tRange = m_aStack[--m_nStackTop];
 
-		if (pRdmMessage != 0) {
-			if ((pRdmMessage->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(uid, pRdmMessage->source_uid, RDM_UID_SIZE) == 0)) {
-				AddUid(uid);
-			}
-		} else {
-			return true;
+#ifndef NDEBUG
+		printf("FindDevices : ");
+		PrintUid(m_tRange.nLower);
+		printf(" - ");
+		PrintUid(m_tRange.nUpper);
+		printf("\n");
+#endif
+
+		Drain();
+
+		if (m_tRange.nLower == m_tRange.nUpper) {
+			m_bQuickFind = false;
+			Mute(ConvertUid(m_tRange.nLower));
+			break;
 		}
-	} else {
-		memcpy(pdl[0], ConvertUid(LowerBound), RDM_UID_SIZE);
-		memcpy(pdl[1], ConvertUid(UpperBound), RDM_UID_SIZE);
+
+		memcpy(pdl[0], ConvertUid(m_tRange.nLower), RDM_UID_SIZE);
+		memcpy(pdl[1], ConvertUid(m_tRange.nUpper), RDM_UID_SIZE);
 
 		m_DiscUniqueBranch.SetPd(reinterpret_cast<const uint8_t*>(pdl), 2 * RDM_UID_SIZE);
 		m_DiscUniqueBranch.Send(m_nPort);
 
-		pRdmMessage = reinterpret_cast<struct TRdmMessage*>(const_cast<uint8_t*>(m_DiscUniqueBranch.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT)));
+		m_nMicros = Hardware::Get()->Micros();
+		m_tState = RDM_DISCOVERY_STATE_BRANCH_WAIT;
+		break;
+	case RDM_DISCOVERY_STATE_BRANCH_WAIT:
+		pResponse = Rdm::Receive(m_nPort);
 
-		if (pRdmMessage != 0) {
-			bDeviceFound = true;
+		if (pResponse == 0) {
+			if (nElapsed >= RECEIVE_TIME_OUT) {
+				// No responders in this range
+				m_tState = RDM_DISCOVERY_STATE_BRANCH;
+			}
+			break;
+		}
+
+		if (IsValidDiscoveryResponse(pResponse, uid)) {
+			const uint64_t nUid = ConvertUid(uid);
 
-			if (IsValidDiscoveryResponse(reinterpret_cast<const uint8_t*>(pRdmMessage), uid)) {
-				bDeviceFound = QuickFind(uid);
+			if ((nUid >= m_tRange.nLower) && (nUid <= m_tRange.nUpper) && !Exist(uid)) {
+#ifndef NDEBUG
+				printf("QuickFind : ");
+				PrintUid(uid);
+				printf("\n");
+#endif
+				m_bQuickFind = true;
+				Mute(uid);
+				break;
 			}
+		}
 
-			if (bDeviceFound) {
-				MidPosition = ((LowerBound & (0x0000800000000000 - 1)) + (UpperBound & (0x0000800000000000 - 1))) / 2
-						+ (UpperBound & (0x0000800000000000) ? 0x0000400000000000 : 0 )
-						+ (LowerBound & (0x0000800000000000) ? 0x0000400000000000 : 0 );
+		Split();
+		m_tState = RDM_DISCOVERY_STATE_BRANCH;
+		break;
+	case RDM_DISCOVERY_STATE_MUTE_WAIT:
+		pResponse = Rdm::Receive(m_nPort);
 
-				bDeviceFound = FindDevices(LowerBound, MidPosition);
-				bDeviceFound |= FindDevices(MidPosition + 1, UpperBound);
+		if ((pResponse == 0) && (nElapsed < RECEIVE_TIME_OUT)) {
+			break;
+		}
+
+		if ((pResponse != 0) && IsMuteResponse(pResponse, m_MuteUid)) {
+			AddUid(m_MuteUid);
 
-				if (bDeviceFound) {
-					return true;
-				}
+			if (m_bQuickFind) {
+				// Examine the range again, for the responders not muted yet
+				Push(m_tRange.nLower, m_tRange.nUpper);
 			}
+		} else if (m_bQuickFind) {
+			Split();
 		}
+
+		m_tState = RDM_DISCOVERY_STATE_BRANCH;
+		break;
+	default:
+		return false;
+		break;
 	}
 
-	return false;
+	return true;
+}
+
+void RDMDiscovery::Push(uint64_t nLower, uint64_t nUpper) {
+	assert(m_nStackTop < RDM_DISCOVERY_STACK_SIZE);
+
+	m_aStack[m_nStackTop].nLower = nLower;
+	m_aStack[m_nStackTop].nUpper = nUpper;
+	m_nStackTop++;
+}
+
+void RDMDiscovery::Split(void) {
+	const uint64_t nMid = m_tRange.nLower + ((m_tRange.nUpper - m_tRange.nLower) / 2);
+
+	// The lower half is on top, so it is examined first
+	Push(nMid + 1, m_tRange.nUpper);
+	Push(m_tRange.nLower, nMid);
+}
+
+void RDMDiscovery::Mute(const uint8_t *pUid) {
+	memcpy(m_MuteUid, pUid, RDM_UID_SIZE);
+
+	m_Mute.SetDstUid(m_MuteUid);
+	m_Mute.Send(m_nPort);
+
+	m_nMicros = Hardware::Get()->Micros();
+	m_tState = RDM_DISCOVERY_STATE_MUTE_WAIT;
+}
+
+bool RDMDiscovery::IsMuteResponse(const uint8_t *pResponse, const uint8_t *pUid) {
+	const struct TRdmMessage *pRdmMessage = reinterpret_cast<const struct TRdmMessage*>(pResponse);
+
+	return (pRdmMessage->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(pUid, pRdmMessage->source_uid, RDM_UID_SIZE) == 0);
+}
+
+void RDMDiscovery::Drain(void) {
+	while (0 != Rdm::Receive(m_nPort)) {
+		// Discard late responses
+	}
 }
 
 const uint8_t *RDMDiscovery::ConvertUid(uint64_t uid) {
@@ -194,79 +341,16 @@ void RDMDiscovery::PrintUid(__attribute__((unused)) const uint8_t *uid) {
 }
 
 bool RDMDiscovery::IsValidDiscoveryResponse(const uint8_t *response, uint8_t *uid) {
-	uint8_t checksum[2];
-	uint16_t rdm_checksum = 6 * 0xFF;
-	bool bIsValid = false;
-
-	if (response[0] == 0xFE) {
-		uid[0] = response[8] & response[9];
-		uid[1] = response[10] & response[11];
-
-		uid[2] = response[12] & response[13];
-		uid[3] = response[14] & response[15];
-		uid[4] = response[16] & response[17];
-		uid[5] = response[18] & response[19];
-
-		checksum[0] = response[22] & response[23];
-		checksum[1] = response[20] & response[21];
-
-		for (unsigned i = 0; i < 6; i++) {
-			rdm_checksum += uid[i];
-		}
-
-		if (((rdm_checksum >> 8) == checksum[1]) && ((rdm_checksum & 0xFF) == checksum[0])) {
-			bIsValid = true;
-		}
+	const bool bIsValid = RDMDiscoveryResponse::Decode(response, uid);
 
 #ifndef NDEBUG
+	if (response[0] == 0xFE) {
 		PrintUid(uid);
-		printf(", checksum %.2x%.2x -> %.4x {%c}\n", checksum[1], checksum[0], rdm_checksum, bIsValid ? 'Y' : 'N');
-#endif
-
+		printf(" {%c}\n", bIsValid ? 'Y' : 'N');
 	} else {
-#ifndef NDEBUG
 		printf("Not a valid response [%.2x]\n", response[0]);
-#endif
 	}
-
-	return bIsValid;
-}
-
-bool RDMDiscovery::QuickFind(const uint8_t *uid) {
-	uint8_t r_uid[RDM_UID_SIZE];
-
-	Hardware::Get()->WatchdogFeed();
-
-#ifndef NDEBUG
-	printf("QuickFind : ");
-	PrintUid(uid);
-	printf("\n");
 #endif
 
-	m_Mute.SetDstUid(uid);
-	m_Mute.Send(m_nPort);
-
-	uint8_t *pResponse = const_cast<uint8_t*>(m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT));
-
-	if (pResponse != 0) {
-		struct TRdmMessage *pRdmMessage = reinterpret_cast<struct TRdmMessage*>(pResponse);
-
-		if ((pRdmMessage->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(uid, pRdmMessage->source_uid, RDM_UID_SIZE) == 0)) {
-			AddUid(uid);
-		}
-	}
-
-	Hardware::Get()->WatchdogFeed();
-
-	m_DiscUniqueBranch.Send(m_nPort);
-
-	pResponse = const_cast<uint8_t *>(m_DiscUniqueBranch.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT));
-
-	if ((pResponse != 0) && (IsValidDiscoveryResponse(pResponse, r_uid))) {
-		QuickFind(r_uid);
-	} else {
-		return true;
-	}
-
-	return false;
+	return bIsValid;
 }
@@ -28,19 +28,13 @@
 #ifndef NDEBUG
  #include <stdio.h>
 #endif
+#include <cassert>
 
 #include "rdmtod.h"
 
-#ifndef ALIGNED
- #define ALIGNED __attribute__ ((aligned (4)))
-#endif
-
-RDMTod::RDMTod(void) : m_nEntries(0) {
-	m_pTable = new TRdmTod[TOD_TABLE_SIZE];
-
-	for (uint32_t i = 0 ; i < TOD_TABLE_SIZE; i++) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
-	}
+RDMTod::RDMTod(void) : m_nEntries(0), m_bChanged(false) {
+	m_pTable = new uint64_t[TOD_TABLE_SIZE];
+	assert(m_pTable != 0);
 }
 
 RDMTod::~RDMTod(void) {
@@ -48,28 +42,73 @@ RDMTod::~RDMTod(void) {
 	delete[] m_pTable;
 }
 
-uint8_t RDMTod::GetUidCount(void) const {
-	return m_nEntries;
+uint64_t RDMTod::ToUint64(const uint8_t *pUid) {
+	uint64_t nUid = 0;
+
+	for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+		nUid = (nUid << 8) | pUid[i];
+	}
+
+	return nUid;
+}
+
+void RDMTod::FromUint64(uint64_t nUid, uint8_t *pUid) {
+	for (uint32_t i = RDM_UID_SIZE; i-- > 0;) {
+		pUid[i] = static_cast<uint8_t>(nUid);
+		nUid >>= 8;
+	}
 }
 
-bool RDMTod::Exist(const uint8_t *pUid) {
-	for (uint32_t i = 0 ; i < m_nEntries; i++) {
-		if (memcmp(&m_pTable[i], pUid, RDM_UID_SIZE) == 0) {
-			return true;
+/*
+ * The index of the first entry not less than nUid
+ */
+uint32_t RDMTod::LowerBound(uint64_t nUid) const {
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_nEntries;
+
+	while (nLow < nHigh) {
+		const uint32_t nMid = (nLow + nHigh) / 2;
+
+		if (m_pTable[nMid] < nUid) {
+			nLow = nMid + 1;
+		} else {
+			nHigh = nMid;
 		}
 	}
 
-	return false;
+	return nLow;
+}
+
+uint32_t RDMTod::GetUidCount(void) const {
+	return m_nEntries;
 }
 
-void RDMTod::Dump(__attribute__((unused)) uint8_t nCount) {
+bool RDMTod::GetUid(uint32_t nIndex, uint8_t *pUid) const {
+	if (nIndex >= m_nEntries) {
+		return false;
+	}
+
+	FromUint64(m_pTable[nIndex], pUid);
+	return true;
+}
+
+bool RDMTod::Exist(const uint8_t *pUid) const {
+	const uint64_t nUid = ToUint64(pUid);
+	const uint32_t nIndex = LowerBound(nUid);
+
+	return (nIndex < m_nEntries) && (m_pTable[nIndex] == nUid);
+}
+
+void RDMTod::Dump(__attribute__((unused)) uint32_t nCount) {
 #ifndef NDEBUG
-	if (nCount > TOD_TABLE_SIZE) {
-		nCount = TOD_TABLE_SIZE;
+	if (nCount > m_nEntries) {
+		nCount = m_nEntries;
 	}
 
 	for (uint32_t i = 0 ; i < nCount; i++) {
-		printf("%.2x%.2x:%.2x%.2x%.2x%.2x\n", m_pTable[i].uid[0], m_pTable[i].uid[1], m_pTable[i].uid[2], m_pTable[i].uid[3], m_pTable[i].uid[4], m_pTable[i].uid[5]);
+		uint8_t uid[RDM_UID_SIZE];
+		FromUint64(m_pTable[i], uid);
+		printf("%.2x%.2x:%.2x%.2x%.2x%.2x\n", uid[0], uid[1], uid[2], uid[3], uid[4], uid[5]);
 	}
 #endif
 }
@@ -85,56 +124,62 @@ bool RDMTod::AddUid(const uint8_t *pUid) {
 		return false;
 	}
 
-	if (Exist(pUid)) {
+	const uint64_t nUid = ToUint64(pUid);
+	const uint32_t nIndex = LowerBound(nUid);
+
+	if ((nIndex < m_nEntries) && (m_pTable[nIndex] == nUid)) {
 		return false;
 	}
 
-	memcpy(&m_pTable[m_nEntries++], pUid, RDM_UID_SIZE);
+	memmove(&m_pTable[nIndex + 1], &m_pTable[nIndex], (m_nEntries - nIndex) * sizeof(uint64_t));
+	m_pTable[nIndex] = nUid;
+	m_nEntries++;
+	m_bChanged = true;
 
 	return true;
 }
 
 bool RDMTod::Delete(const uint8_t *pUid) {
-	bool found = false;
-	uint32_t i;
+	const uint64_t nUid = ToUint64(pUid);
+	const uint32_t nIndex = LowerBound(nUid);
 
-	for (i = 0 ; i < m_nEntries; i++) {
-		if (memcmp(&m_pTable[i], pUid, RDM_UID_SIZE) == 0) {
-			found = true;
-			break;
-		}
-	}
-
-	if (!found) {
+	if ((nIndex == m_nEntries) || (m_pTable[nIndex] != nUid)) {
 		return false;
 	}
 
-	if (i == TOD_TABLE_SIZE - 1) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
-	} else {
-		for (; i < m_nEntries; i++) {
-			memcpy(&m_pTable[i], &m_pTable[i + 1], RDM_UID_SIZE);
-		}
-	}
-
 	m_nEntries--;
+	memmove(&m_pTable[nIndex], &m_pTable[nIndex + 1], (m_nEntries - nIndex) * sizeof(uint64_t));
+	m_bChanged = true;
 
 	return true;
 }
 
 void RDMTod::Copy(uint8_t *pTable) {
-	const uint8_t *pSrc = reinterpret_cast<const uint8_t*>(m_pTable);
-	uint8_t *pDst = pTable;
+	Copy(pTable, 0, m_nEntries);
+}
 
-	for (uint32_t i = 0; i < (m_nEntries * RDM_UID_SIZE); i++) {
-		*pDst++ = *pSrc++;
+/*
+ * One ArtTodData block, the UIDs in network byte order
+ */
+uint32_t RDMTod::Copy(uint8_t *pTable, uint32_t nFirst, uint32_t nMax) {
+	if (nFirst == 0) {
+		m_bChanged = false;
 	}
-}
 
-void RDMTod::Reset(void) {
-	for (uint32_t i = 0 ; i < m_nEntries; i++) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
+	if (nFirst >= m_nEntries) {
+		return 0;
+	}
+
+	const uint32_t nCount = (m_nEntries - nFirst) < nMax ? (m_nEntries - nFirst) : nMax;
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		FromUint64(m_pTable[nFirst + i], &pTable[i * RDM_UID_SIZE]);
 	}
 
+	return nCount;
+}
+
+void RDMTod::Reset(void) {
+	m_bChanged = (m_nEntries != 0);
 	m_nEntries = 0;
 }
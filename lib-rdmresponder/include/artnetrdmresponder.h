@@ -43,12 +43,17 @@ public:
 	~ArtNetRdmResponder(void);
 
 	void Full(uint8_t nPort);
-	uint8_t GetUidCount(uint8_t nPort);
-	void Copy(uint8_t nPort, uint8_t *);
+	uint32_t GetUidCount(uint8_t nPort);
+	uint32_t Copy(uint8_t nPort, uint8_t *pTod, uint32_t nFirst, uint32_t nMax);
+	bool IsTodChanged(uint8_t nPort);
 	const uint8_t *Handler(uint8_t nPort, const uint8_t *);
 
+	bool SendRequest(uint8_t nPort, const uint8_t *);
+	const uint8_t *GetResponse(uint8_t nPort);
+
 private:
 	struct TRdmMessage *m_pRdmCommand;
+	const uint8_t *m_pResponse;
 	RDMHandler *m_RDMHandler;
 };
 
@@ -42,6 +42,7 @@
 ArtNetRdmResponder::ArtNetRdmResponder(RDMPersonality *pRDMPersonality, LightSet *pLightSet) :
 	RDMDeviceResponder(pRDMPersonality, pLightSet, false),
 	m_pRdmCommand(0),
+	m_pResponse(0),
 	m_RDMHandler(0)
 {
 	DEBUG_ENTRY
@@ -71,12 +72,21 @@ void ArtNetRdmResponder::Full(__attribute__((unused)) uint8_t nPort) {
 	// We are a Responder - no code needed
 }
 
-uint8_t ArtNetRdmResponder::GetUidCount(__attribute__((unused)) uint8_t nPort) {
+uint32_t ArtNetRdmResponder::GetUidCount(__attribute__((unused)) uint8_t nPort) {
 	return 1; // We are a Responder
 }
 
-void ArtNetRdmResponder::Copy(__attribute__((unused)) uint8_t nPort, unsigned char *tod) {
-	memcpy(tod, RDMDeviceResponder::GetUID(), RDM_UID_SIZE);
+uint32_t ArtNetRdmResponder::Copy(__attribute__((unused)) uint8_t nPort, uint8_t *pTod, uint32_t nFirst, uint32_t nMax) {
+	if ((nFirst != 0) || (nMax == 0)) {
+		return 0;
+	}
+
+	memcpy(pTod, RDMDeviceResponder::GetUID(), RDM_UID_SIZE);
+	return 1;
+}
+
+bool ArtNetRdmResponder::IsTodChanged(__attribute__((unused)) uint8_t nPort) {
+	return false; // The UID does not change
 }
 
 const uint8_t *ArtNetRdmResponder::Handler(__attribute__((unused)) uint8_t nPort, const uint8_t *pRdmDataNoSC) {
@@ -105,3 +115,17 @@ const uint8_t *ArtNetRdmResponder::Handler(__attribute__((unused)) uint8_t nPort
 	DEBUG_EXIT
 	return reinterpret_cast<const uint8_t*>(m_pRdmCommand);
 }
+
+/*
+ * The response is available right away, it is returned by the next GetResponse()
+ */
+bool ArtNetRdmResponder::SendRequest(uint8_t nPort, const uint8_t *pRdmDataNoSC) {
+	m_pResponse = Handler(nPort, pRdmDataNoSC);
+	return (m_pResponse != 0);
+}
+
+const uint8_t *ArtNetRdmResponder::GetResponse(__attribute__((unused)) uint8_t nPort) {
+	const uint8_t *pResponse = m_pResponse;
+	m_pResponse = 0;
+	return pResponse;
+}
@@ -31,6 +31,7 @@
 #include "dmxreceiver.h"
 
 #include "rdmresponder.h"
+#include "rdmsensors.h"
 
 #include "lightset.h"
 
@@ -107,6 +108,8 @@ int RDMResponder::Run(void) {
 	const uint8_t *pRdmDataIn = Rdm::Receive(0);
 
 	if (pRdmDataIn == 0) {
+		// The sensors are sampled outside the RDM response window
+		RDMSensors::Get()->Run();
 		return RDM_RESPONDER_NO_DATA;
 	}
 
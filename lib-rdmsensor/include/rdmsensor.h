@@ -97,7 +97,13 @@ public:
 	const struct TRDMSensorDefintion* GetDefintion(void) {
 		return &m_tRDMSensorDefintion;
 	}
-	const struct TRDMSensorValues* GetValues(void);
+	/**
+	 * The values are cached, only Sample() reads the sensor
+	 */
+	const struct TRDMSensorValues* GetValues(void) {
+		return &m_tRDMSensorValues;
+	}
+	void Sample(void);
 	void SetValues(void);
 	void Record(void);
 
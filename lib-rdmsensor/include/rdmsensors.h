@@ -44,6 +44,17 @@ public:
 	void SetValues(uint8_t nSensor);
 	void SetRecord(uint8_t nSensor);
 
+	/**
+	 * Called from the main loop, samples at most one sensor per call.
+	 * Each sensor is sampled once per interval, the reads are spread evenly.
+	 */
+	void Run(void);
+
+	void SetSampleInterval(uint32_t nSampleIntervalMillis);
+	uint32_t GetSampleInterval(void) const {
+		return m_nSampleIntervalMillis;
+	}
+
 public:
     static void staticCallbackFunction(void *p, const char *s);
 
@@ -57,6 +68,11 @@ private:
 private:
 	RDMSensor **m_pRDMSensor;
 	uint8_t m_nCount;
+	uint8_t m_nSampleNext;
+	bool m_bSampling;							///< Run() is called, the cached values are up to date
+	uint32_t m_nSampleIntervalMillis;
+	uint32_t m_nSampleSlotMillis;				///< Interval divided over the sensors
+	uint32_t m_nSampleMillis;
 
 	static RDMSensors *s_pThis;
 };
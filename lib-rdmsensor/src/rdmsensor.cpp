@@ -64,7 +64,7 @@ void RDMSensor::SetDescription(const char *pDescription) {
 	m_tRDMSensorDefintion.len = i;
 }
 
-const struct TRDMSensorValues* RDMSensor::GetValues(void) {
+void RDMSensor::Sample(void) {
 	DEBUG1_ENTRY
 
 	const int16_t value = this->GetValue();
@@ -74,16 +74,13 @@ const struct TRDMSensorValues* RDMSensor::GetValues(void) {
 	m_tRDMSensorValues.highest_detected = std::max(m_tRDMSensorValues.highest_detected, value);
 
 	DEBUG1_EXIT
-
-	return &m_tRDMSensorValues;
 }
 
 void RDMSensor::SetValues(void) {
 	DEBUG1_ENTRY
 
-	const int16_t value = this->GetValue();
+	const int16_t value = m_tRDMSensorValues.present;
 
-	m_tRDMSensorValues.present = value;
 	m_tRDMSensorValues.lowest_detected = value;
 	m_tRDMSensorValues.highest_detected = value;
 	m_tRDMSensorValues.recorded = value;
@@ -94,12 +91,7 @@ void RDMSensor::SetValues(void) {
 void RDMSensor::Record(void) {
 	DEBUG1_ENTRY
 
-	const int16_t value = this->GetValue();
-
-	m_tRDMSensorValues.present = value;
-	m_tRDMSensorValues.recorded = value;
-	m_tRDMSensorValues.lowest_detected = std::min(m_tRDMSensorValues.lowest_detected, value);
-	m_tRDMSensorValues.highest_detected = std::max(m_tRDMSensorValues.highest_detected, value);
+	m_tRDMSensorValues.recorded = m_tRDMSensorValues.present;
 
 	DEBUG1_EXIT
 }
@@ -29,6 +29,8 @@
 
 #include "rdmsensors.h"
 
+#include "hardware.h"
+
 #include "readconfigfile.h"
 #include "sscan.h"
 
@@ -64,13 +66,23 @@
  #include "sensorsi7021temperature.h"
 
  static const char SENSORS_PARAMS_FILE_NAME[] __attribute__ ((aligned (4))) = "sensors.txt";
+ static const char SENSORS_SAMPLE_INTERVAL[] __attribute__ ((aligned (4))) = "sample_interval";
 #endif
 
-#define RDM_SENSORS_MAX		32
+#define RDM_SENSORS_MAX							32
+#define RDM_SENSORS_SAMPLE_INTERVAL_MILLIS		1000	///< Default, each sensor is sampled once per second
 
 RDMSensors *RDMSensors::s_pThis = 0;
 
-RDMSensors::RDMSensors(void): m_pRDMSensor(0), m_nCount(0) {
+RDMSensors::RDMSensors(void):
+	m_pRDMSensor(0),
+	m_nCount(0),
+	m_nSampleNext(0),
+	m_bSampling(false),
+	m_nSampleIntervalMillis(RDM_SENSORS_SAMPLE_INTERVAL_MILLIS),
+	m_nSampleSlotMillis(RDM_SENSORS_SAMPLE_INTERVAL_MILLIS),
+	m_nSampleMillis(0)
+{
 	DEBUG_ENTRY
 
 	assert(s_pThis == 0);
@@ -111,10 +123,50 @@ void RDMSensors::Init(void) {
 	}
 #endif
 
-	DEBUG_PRINTF("Sensors added: %d", static_cast<int>(m_nCount));
+	// The cache is valid before the first Run()
+	for (uint32_t i = 0; i < m_nCount; i++) {
+		m_pRDMSensor[i]->Sample();
+		m_pRDMSensor[i]->SetValues();
+	}
+
+	SetSampleInterval(m_nSampleIntervalMillis);
+
+	DEBUG_PRINTF("Sensors added: %d, sample interval: %u", static_cast<int>(m_nCount), m_nSampleIntervalMillis);
 	DEBUG_EXIT
 }
 
+void RDMSensors::SetSampleInterval(uint32_t nSampleIntervalMillis) {
+	m_nSampleIntervalMillis = nSampleIntervalMillis;
+
+	if (m_nCount != 0) {
+		m_nSampleSlotMillis = m_nSampleIntervalMillis / m_nCount;
+	} else {
+		m_nSampleSlotMillis = m_nSampleIntervalMillis;
+	}
+}
+
+void RDMSensors::Run(void) {
+	if (__builtin_expect((m_nCount == 0), 0)) {
+		return;
+	}
+
+	m_bSampling = true;
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if ((nMillis - m_nSampleMillis) < m_nSampleSlotMillis) {
+		return;
+	}
+
+	m_nSampleMillis = nMillis;
+
+	m_pRDMSensor[m_nSampleNext]->Sample();
+
+	if (++m_nSampleNext == m_nCount) {
+		m_nSampleNext = 0;
+	}
+}
+
 bool RDMSensors::Add(RDMSensor *pRDMSensor) {
 	if (m_nCount == RDM_SENSORS_MAX) {
 		return false;
@@ -148,6 +200,12 @@ const struct TRDMSensorValues* RDMSensors::GetValues(uint8_t nSensor) {
 	assert(nSensor < m_nCount);
 
 	assert(m_pRDMSensor[nSensor] != 0);
+
+	if (!m_bSampling) {
+		// There is no main loop sampling, read the sensor now
+		m_pRDMSensor[nSensor]->Sample();
+	}
+
 	return m_pRDMSensor[nSensor]->GetValues();
 }
 
@@ -187,6 +245,15 @@ void RDMSensors::callbackFunction(__attribute__((unused)) const char *pLine) {
 	uint8_t nI2cAddress = 0;
 	uint8_t nI2cChannel = 0; // TODO Replace with I2C name
 
+	uint32_t nValue32;
+
+	if (Sscan::Uint32(pLine, SENSORS_SAMPLE_INTERVAL, &nValue32) == SSCAN_OK) {
+		if (nValue32 != 0) {
+			m_nSampleIntervalMillis = nValue32;
+		}
+		return;
+	}
+
 	memset(aSensorName, 0, sizeof(aSensorName));
 
 	nReturnCode = Sscan::I2c(pLine, aSensorName, &nLength, &nI2cAddress, &nI2cChannel);
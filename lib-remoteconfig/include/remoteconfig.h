@@ -176,6 +176,11 @@ private:
 	void HandleList(void);
 	void HandleUptime(void);
 	void HandleVersion(void);
+	void HandleStats(void);
+#if defined (LIGHTSET_LATENCY)
+	void HandleLatencyGet(void);
+	void HandleLatencySet(void);
+#endif
 
 	void HandleGet(void);
 	void HandleGetRconfigTxt(uint32_t& nSize);
@@ -45,6 +45,7 @@
 #include "networkparams.h"
 
 #if defined (ARTNET_NODE)
+ #include "artnetnode.h"
  /* artnet.txt */
  #include "artnetparams.h"
  #include "storeartnet.h"
@@ -52,6 +53,7 @@
  #include "storeartnet4.h"
 #endif
 #if defined (E131_BRIDGE)
+ #include "e131bridge.h"
  /* e131.txt */
  #include "e131params.h"
  #include "storee131.h"
@@ -151,6 +153,17 @@ static constexpr auto REQUEST_UPTIME_LENGTH = sizeof(sRequestUptime) - 1;
 static constexpr char sRequestVersion[] = "?version#";
 static constexpr auto REQUEST_VERSION_LENGTH = sizeof(sRequestVersion) - 1;
 
+static constexpr char sRequestStats[] = "?stats#";
+static constexpr auto REQUEST_STATS_LENGTH = sizeof(sRequestStats) - 1;
+
+#if defined (LIGHTSET_LATENCY)
+static constexpr char sRequestLatency[] = "?latency#";
+static constexpr auto REQUEST_LATENCY_LENGTH = sizeof(sRequestLatency) - 1;
+
+static constexpr char sSetLatency[] = "!latency#";
+static constexpr auto SET_LATENCY_LENGTH = sizeof(sSetLatency) - 1;
+#endif
+
 static constexpr char sRequestStore[] = "?store#";
 static constexpr auto REQUEST_STORE_LENGTH = sizeof(sRequestStore) - 1;
 
@@ -295,6 +308,12 @@ void RemoteConfig::Run(void) {
 			HandleVersion();
 		} else if (memcmp(m_pUdpBuffer, sRequestList, REQUEST_FILES_LENGTH) == 0) {
 			HandleList();
+		} else if (memcmp(m_pUdpBuffer, sRequestStats, REQUEST_STATS_LENGTH) == 0) {
+			HandleStats();
+#if defined (LIGHTSET_LATENCY)
+		} else if ((m_nBytesReceived == REQUEST_LATENCY_LENGTH) && (memcmp(m_pUdpBuffer, sRequestLatency, REQUEST_LATENCY_LENGTH) == 0)) {
+			HandleLatencyGet();
+#endif
 		} else if ((m_nBytesReceived > REQUEST_GET_LENGTH) && (memcmp(m_pUdpBuffer, sRequestGet, REQUEST_GET_LENGTH) == 0)) {
 			HandleGet();
 		} else if ((m_nBytesReceived > REQUEST_STORE_LENGTH) && (memcmp(m_pUdpBuffer, sRequestStore, REQUEST_STORE_LENGTH) == 0)) {
@@ -321,6 +340,11 @@ void RemoteConfig::Run(void) {
 			} else if ((m_nBytesReceived == SET_TFTP_LENGTH + 1) && (memcmp(m_pUdpBuffer, sSetTFTP, SET_TFTP_LENGTH) == 0)) {
 				DEBUG_PUTS(sSetTFTP);
 				HandleTftpSet();
+#if defined (LIGHTSET_LATENCY)
+			} else if ((m_nBytesReceived == SET_LATENCY_LENGTH + 1) && (memcmp(m_pUdpBuffer, sSetLatency, SET_LATENCY_LENGTH) == 0)) {
+				DEBUG_PUTS(sSetLatency);
+				HandleLatencySet();
+#endif
 			} else if ((m_nBytesReceived > SET_STORE_LENGTH) && (memcmp(m_pUdpBuffer, sSetStore, SET_STORE_LENGTH) == 0)) {
 				DEBUG_PUTS(sSetStore);
 				m_tRemoteConfigHandleMode = REMOTE_CONFIG_HANDLE_MODE_BIN;
@@ -391,6 +415,138 @@ void RemoteConfig::HandleList(void) {
 	DEBUG_EXIT
 }
 
+void RemoteConfig::HandleStats(void) {
+	DEBUG_ENTRY
+
+	int nLength = 0;
+	struct TNetworkPortStats tPortStats;
+
+	for (uint32_t nIndex = 0; Network::Get()->GetPortStats(nIndex, tPortStats); nIndex++) {
+		if (tPortStats.nPort == 0) {
+			continue;
+		}
+
+		// Leave room for the protocol counters
+		if (nLength > (UDP::BUFFER_SIZE - 256)) {
+			break;
+		}
+
+		nLength += snprintf(&m_pUdpBuffer[nLength], UDP::BUFFER_SIZE - static_cast<uint32_t>(nLength), "udp:%u rx:%u ovf:%u err:%u tx:%u drop:%u\n",
+				tPortStats.nPort, tPortStats.nRx, tPortStats.nRxOverflow, tPortStats.nRxErrors,
+				tPortStats.nTx, tPortStats.nTxDropped);
+	}
+
+	nLength += snprintf(&m_pUdpBuffer[nLength], UDP::BUFFER_SIZE - static_cast<uint32_t>(nLength), "unbound:%u\n", Network::Get()->GetRxUnbound());
+
+#if defined (ARTNET_NODE)
+	if (ArtNetNode::Get() != 0) {
+		const struct TArtNetNodeStats& tStats = ArtNetNode::Get()->GetStats();
+		nLength += snprintf(&m_pUdpBuffer[nLength], UDP::BUFFER_SIZE - static_cast<uint32_t>(nLength), "artnet parse:%u merge:%u seq:%u rdmdrop:%u rdmtimeout:%u\n",
+				tStats.nParseErrors, tStats.nMergeDiscards, tStats.nSequenceGaps, tStats.nRdmDiscards, tStats.nRdmTimeouts);
+	}
+#endif
+#if defined (E131_BRIDGE)
+	if (E131Bridge::Get() != 0) {
+		const struct TE131BridgeStats& tStats = E131Bridge::Get()->GetStats();
+		nLength += snprintf(&m_pUdpBuffer[nLength], UDP::BUFFER_SIZE - static_cast<uint32_t>(nLength), "e131 parse:%u merge:%u seq:%u\n",
+				tStats.nParseErrors, tStats.nMergeDiscards, tStats.nSequenceGaps);
+	}
+#endif
+
+	Network::Get()->SendTo(m_nHandle, m_pUdpBuffer, static_cast<uint16_t>(nLength), m_nIPAddressFrom, UDP::PORT);
+
+	DEBUG_EXIT
+}
+
+#if defined (LIGHTSET_LATENCY)
+/**
+ * One line per port and stage with samples: <protocol> <port> <stage> n:<count> max:<us> followed by the
+ * log2 bucket counts up to the highest non-empty bucket.
+ */
+static int latency_print(char *pBuffer, int nSize, const char *pProtocol, const LightSetLatency *pLatency) {
+	int nLength = 0;
+
+	for (uint32_t nPortIndex = 0; nPortIndex < pLatency->GetPorts(); nPortIndex++) {
+		for (uint32_t nStage = 0; nStage < static_cast<uint32_t>(LightSetLatencyStage::LAST); nStage++) {
+			const LightSetLatencyStage tStage = static_cast<LightSetLatencyStage>(nStage);
+			const struct TLightSetLatencyHistogram& tHistogram = pLatency->GetHistogram(nPortIndex, tStage);
+
+			if (tHistogram.nCount == 0) {
+				continue;
+			}
+
+			// Worst case line length
+			if ((nSize - nLength) < (32 + 11 * LIGHTSET_LATENCY_BUCKETS)) {
+				return nLength;
+			}
+
+			nLength += snprintf(&pBuffer[nLength], static_cast<size_t>(nSize - nLength), "%s %u %s n:%u max:%u", pProtocol,
+					nPortIndex, LightSetLatency::GetStageName(tStage),
+					tHistogram.nCount, tHistogram.nMaxMicros);
+
+			uint32_t nLast = LIGHTSET_LATENCY_BUCKETS - 1;
+
+			while ((nLast > 0) && (tHistogram.aBuckets[nLast] == 0)) {
+				nLast--;
+			}
+
+			for (uint32_t i = 0; i <= nLast; i++) {
+				nLength += snprintf(&pBuffer[nLength], static_cast<size_t>(nSize - nLength), "%c%u", i == 0 ? ' ' : ',', tHistogram.aBuckets[i]);
+			}
+
+			pBuffer[nLength++] = '\n';
+		}
+	}
+
+	return nLength;
+}
+
+void RemoteConfig::HandleLatencyGet(void) {
+	DEBUG_ENTRY
+
+	int nLength = 0;
+
+#if defined (ARTNET_NODE)
+	if (ArtNetNode::Get() != 0) {
+		nLength += latency_print(&m_pUdpBuffer[nLength], UDP::BUFFER_SIZE - nLength, "artnet", ArtNetNode::Get()->GetLatency());
+	}
+#endif
+#if defined (E131_BRIDGE)
+	if (E131Bridge::Get() != 0) {
+		nLength += latency_print(&m_pUdpBuffer[nLength], UDP::BUFFER_SIZE - nLength, "e131", E131Bridge::Get()->GetLatency());
+	}
+#endif
+
+	if (nLength == 0) {
+		nLength = snprintf(m_pUdpBuffer, UDP::BUFFER_SIZE, "latency:none\n");
+	}
+
+	Network::Get()->SendTo(m_nHandle, m_pUdpBuffer, static_cast<uint16_t>(nLength), m_nIPAddressFrom, UDP::PORT);
+
+	DEBUG_EXIT
+}
+
+void RemoteConfig::HandleLatencySet(void) {
+	DEBUG_ENTRY
+
+	// "!latency#0" resets all histograms
+	if (m_pUdpBuffer[SET_LATENCY_LENGTH] == '0') {
+#if defined (ARTNET_NODE)
+		if (ArtNetNode::Get() != 0) {
+			ArtNetNode::Get()->GetLatency()->Reset();
+		}
+#endif
+#if defined (E131_BRIDGE)
+		if (E131Bridge::Get() != 0) {
+			E131Bridge::Get()->GetLatency()->Reset();
+		}
+#endif
+	}
+
+	DEBUG_EXIT
+}
+#endif
+
 void RemoteConfig::HandleDisplaySet() {
 	DEBUG_ENTRY
 
@@ -0,0 +1,101 @@
+/**
+ * @file binaryshowfile.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BINARYSHOWFILE_H_
+#define BINARYSHOWFILE_H_
+
+#include <stdint.h>
+
+#include "showfile.h"
+#include "showfilebinary.h"
+#include "showfileindex.h"
+
+class BinaryShowFile: public ShowFile {
+public:
+	BinaryShowFile(void);
+	~BinaryShowFile(void);
+
+	void ShowFileStart(void);
+	void ShowFileStop(void);
+	void ShowFileResume(void);
+	void ShowFileRun(void);
+	void ShowFilePrint(void);
+	void ShowFileTimeCode(uint32_t nMillis);
+	ShowFileFormats ShowFileFormat(void) {
+		return ShowFileFormats::BINARY;
+	}
+
+private:
+	enum class BinaryState {
+		IDLE,
+		TIME_WAITING,
+		SEEKING,
+		FAILED
+	};
+
+	struct TUniverse {
+		uint16_t nUniverse;
+		uint16_t nLength;	///< 0 is not in use
+		uint8_t data[ShowFileBinary::DMX_MAX_LENGTH];
+	};
+
+	TUniverse *GetUniverse(uint16_t nUniverse);
+	bool Rewind(void);
+	bool ReadAhead(uint32_t nChunk);
+	bool Ensure(uint32_t nBytes);
+	void OutputFrame(bool bOutput = true);
+	bool LoadIndex(void);
+	bool Seek(uint32_t nMillis);
+	void CatchUp(void);
+
+private:
+	static constexpr uint32_t READ_AHEAD_SIZE = (32 * 1024);
+	static constexpr uint32_t READ_AHEAD_CHUNK = 4096;
+	static constexpr uint32_t MAX_UNIVERSES = ShowFileBinary::MAX_UNIVERSES;	///< Delta frames and chase only
+	static constexpr uint32_t CATCH_UP_FRAMES = 32;	///< Frames replayed without output per ShowFileRun() after a seek
+	static constexpr uint32_t CHASE_TOLERANCE_MILLIS = 100;	///< A larger difference with the timecode is a jump
+	static constexpr uint32_t CHASE_TIMEOUT_MILLIS = 250;	///< Playback holds when the timecode stops
+
+	BinaryState m_tState = BinaryState::IDLE;
+	TShowFileBinaryFrame m_tFrame;
+	uint32_t m_nStartMillis = 0;
+	uint32_t m_nStopMillis = 0;
+	uint32_t m_nFrames = 0;
+	uint32_t m_nFramesLate = 0;
+	uint32_t m_nHead = 0;		///< Read offset in m_pBuffer
+	uint32_t m_nTail = 0;		///< End of the valid data in m_pBuffer
+	bool m_bEndOfFile = false;
+	bool m_bTrackUniverses = false;	///< Delta frames or chase
+	uint8_t *m_pBuffer;
+	TUniverse *m_pUniverses;
+	// Chase
+	ShowFileIndex *m_pIndex = 0;
+	uint8_t m_nIndexShowFileNumber = ShowFileFile::MAX_NUMBER + 1;
+	bool m_bTimeCode = false;		///< Locked to the timecode
+	uint32_t m_nTimeCodeMillis = 0;	///< Local time of the last timecode received
+	uint32_t m_nSeeks = 0;
+};
+
+#endif /* BINARYSHOWFILE_H_ */
@@ -50,6 +50,12 @@ public:
 	void ShowFilePrint(void) {
 		puts("OlaShowFile");
 	}
+	void ShowFileTimeCode(__attribute__((unused)) uint32_t nMillis) {
+		// The OLA text format has relative delays only, no chase
+	}
+	ShowFileFormats ShowFileFormat(void) {
+		return ShowFileFormats::OLA;
+	}
 
 private:
 	enum class OlaState {
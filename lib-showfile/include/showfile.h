@@ -31,18 +31,21 @@
 #include "showfileprotocolhandler.h"
 #include "showfiledisplay.h"
 #include "showfiletftp.h"
+#include "showfilerecorder.h"
 
 enum class ShowFileStatus {
 	IDLE,
 	RUNNING,
 	STOPPED,
 	ENDED,
+	RECORDING,
 	UNDEFINED
 };
 
 enum class ShowFileFormats {
 	OLA,
 	DUMMY,
+	BINARY,
 	UNDEFINED
 };
 
@@ -54,6 +57,8 @@ enum class ShowFileProtocols {
 
 #define SHOWFILE_PREFIX	"show"
 #define SHOWFILE_SUFFIX	".txt"
+#define SHOWFILE_INDEX_SUFFIX	".idx"
+#define SHOWFILE_RECORD_SUFFIX	".rec"
 
 struct ShowFileFile {
 	static constexpr auto NAME_LENGTH = sizeof(SHOWFILE_PREFIX "NN" SHOWFILE_SUFFIX) - 1;
@@ -68,6 +73,7 @@ public:
 	void Start(void);
 	void Stop(void);
 	void Resume(void);
+	void Record(void);
 	void Run(void);
 	void Print(void);
 
@@ -99,6 +105,15 @@ public:
 		return m_bDoLoop;
 	}
 
+	void SetChase(bool bChase) {
+		m_bChase = bChase;
+	}
+	bool GetChase(void) {
+		return m_bChase;
+	}
+
+	void TimeCode(uint32_t nMillis);
+
 	void BlackOut(void);
 
 	void SetMaster(uint32_t nMaster) {
@@ -130,21 +145,30 @@ public:
 	static const char *GetFormat(ShowFileFormats tFormat);
 	static bool CheckShowFileName(const char *pShowFileName, uint8_t& nShowFileNumber);
 	static bool ShowFileNameCopyTo(char *pShowFileName, uint32_t nLength, uint8_t nShowFileNumber);
+	static bool IndexFileNameCopyTo(char *pIndexFileName, uint32_t nLength, uint8_t nShowFileNumber);
+	static bool RecordFileNameCopyTo(char *pRecordFileName, uint32_t nLength, uint8_t nShowFileNumber);
+	static uint32_t TimeCodeToMillis(uint8_t nHours, uint8_t nMinutes, uint8_t nSeconds, uint8_t nFrames, uint8_t nType);
 
 	static ShowFile* Get(void) {
 		return s_pThis;
 	}
 
+private:
+	void StopRecording(void);
+
 protected:
 	virtual void ShowFileStart(void)=0;
 	virtual void ShowFileStop(void)=0;
 	virtual void ShowFileResume(void)=0;
 	virtual void ShowFileRun(void)=0;
 	virtual void ShowFilePrint(void)=0;
+	virtual void ShowFileTimeCode(uint32_t nMillis)=0;
+	virtual ShowFileFormats ShowFileFormat(void)=0;
 
 protected:
 	uint8_t m_nShowFileNumber = ShowFileFile::MAX_NUMBER + 1;
 	bool m_bDoLoop = false;
+	bool m_bChase = false;	///< Playback follows the incoming timecode
 	FILE *m_pShowFile = 0;
 	ShowFileProtocolHandler *m_pShowFileProtocolHandler = 0;
 	ShowFileDisplay *m_pShowFileDisplay = 0;
@@ -154,6 +178,7 @@ private:
 	char m_aShowFileName[ShowFileFile::NAME_LENGTH + 1]; // Including '\0'
 	bool m_bEnableTFTP = false;
 	ShowFileTFTP *m_pShowFileTFTP = 0;
+	ShowFileRecorder *m_pShowFileRecorder = 0;
 
 	static ShowFile *s_pThis;
 };
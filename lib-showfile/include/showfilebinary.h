@@ -0,0 +1,94 @@
+/**
+ * @file showfilebinary.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SHOWFILEBINARY_H_
+#define SHOWFILEBINARY_H_
+
+#include <stdint.h>
+
+/*
+ * Binary showfile, all fields are little endian
+ *
+ * TShowFileBinaryHeader
+ * { TShowFileBinaryFrame { TShowFileBinaryUniverse, DMX data[nLength] } * nUniverses } * frames
+ *
+ * With FLAG_DELTA a universe block can have LENGTH_DELTA set in nLength. The block then holds
+ * runs against the previous data of the same universe, see ShowFileDelta.
+ *
+ * A frame with FRAME_KEY set holds the full data of every universe played so far,
+ * playback can start at such a frame without reading the frames before it.
+ *
+ * Only the first MAX_UNIVERSES universes are delta encoded and part of the key frames,
+ * the blocks of any further universe always hold the full data.
+ *
+ * The keyframe index is stored alongside the showfile (showNN.idx) :
+ * TShowFileIndexHeader { TShowFileIndexEntry } * nEntries, sorted on nMillis
+ */
+
+#define SHOWFILE_BINARY_MAGIC	"SHOW"
+#define SHOWFILE_INDEX_MAGIC	"SIDX"
+
+struct ShowFileBinary {
+	static constexpr auto MAGIC_LENGTH = sizeof(SHOWFILE_BINARY_MAGIC) - 1;
+	static constexpr uint8_t VERSION = 1;
+	static constexpr uint32_t DMX_MAX_LENGTH = 512;
+	static constexpr uint32_t MAX_UNIVERSES = 64;	///< Tracked for the delta encoding and the key frames
+	static constexpr uint32_t KEYFRAME_INTERVAL_MILLIS = 5000;	///< Bounds the frames replayed after a seek
+	static constexpr uint8_t FLAG_DELTA = (1U << 0);
+	static constexpr uint16_t LENGTH_DELTA = 0x8000;
+	static constexpr uint16_t FRAME_KEY = (1U << 0);
+};
+
+struct TShowFileBinaryHeader {
+	char aMagic[4];
+	uint8_t nVersion;
+	uint8_t nFlags;
+	uint8_t aReserved[2];
+} __attribute__((packed));
+
+struct TShowFileBinaryFrame {
+	uint32_t nMillis;		///< Absolute timestamp, relative to the start of the show
+	uint16_t nUniverses;	///< Number of universe blocks following
+	uint16_t nFlags;		///< ShowFileBinary::FRAME_KEY
+	uint32_t nSize;			///< Size in bytes of all universe blocks following
+} __attribute__((packed));
+
+struct TShowFileBinaryUniverse {
+	uint16_t nUniverse;
+	uint16_t nLength;		///< Number of DMX data bytes following, or the delta size when LENGTH_DELTA is set
+} __attribute__((packed));
+
+struct TShowFileIndexHeader {
+	char aMagic[4];
+	uint32_t nShowFileSize;	///< The index is rebuilt when the showfile size does not match
+	uint32_t nEntries;
+} __attribute__((packed));
+
+struct TShowFileIndexEntry {
+	uint32_t nMillis;
+	uint32_t nOffset;		///< File offset of the key frame header
+} __attribute__((packed));
+
+#endif /* SHOWFILEBINARY_H_ */
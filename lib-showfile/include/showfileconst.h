@@ -30,7 +30,7 @@
 
 class ShowFileConst {
 public:
-	static constexpr auto SHOWFILECONST_FORMAT_NAME_LENGTH = 6;	///< Includes '\0'
+	static constexpr auto SHOWFILECONST_FORMAT_NAME_LENGTH = 7;	///< Includes '\0'
 	static const char FORMAT[static_cast<int>(ShowFileFormats::UNDEFINED)][SHOWFILECONST_FORMAT_NAME_LENGTH];
 
 	static const char STATUS[static_cast<int>(ShowFileStatus::UNDEFINED)][12];
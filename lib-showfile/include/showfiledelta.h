@@ -0,0 +1,47 @@
+/**
+ * @file showfiledelta.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SHOWFILEDELTA_H_
+#define SHOWFILEDELTA_H_
+
+#include <stdint.h>
+
+/**
+ * Run-length delta of a DMX frame against the previous frame of the same universe.
+ * A delta is a sequence of runs { uint16_t nSkip; uint16_t nCount; uint8_t data[nCount] },
+ * nSkip unchanged slots are followed by nCount changed slots.
+ */
+class ShowFileDelta {
+public:
+	/**
+	 * @return the delta size, 0 when nothing changed or the delta would not be smaller than nMaxSize
+	 */
+	static uint32_t Encode(uint8_t *pDelta, uint32_t nMaxSize, const uint8_t *pPrevious, const uint8_t *pData, uint32_t nLength);
+	static bool Decode(uint8_t *pData, uint32_t nLength, const uint8_t *pDelta, uint32_t nDeltaSize);
+
+	static constexpr uint32_t RUN_HEADER_SIZE = 4;
+};
+
+#endif /* SHOWFILEDELTA_H_ */
@@ -0,0 +1,68 @@
+/**
+ * @file showfileindex.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SHOWFILEINDEX_H_
+#define SHOWFILEINDEX_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "showfilebinary.h"
+
+/**
+ * Keyframe index of a binary showfile, a timecode jump is a binary search
+ * followed by a single fseek.
+ */
+class ShowFileIndex {
+public:
+	ShowFileIndex(void);
+	~ShowFileIndex(void);
+
+	bool Build(FILE *pShowFile);
+	bool Load(FILE *pIndexFile, uint32_t nShowFileSize);
+	bool Save(FILE *pIndexFile);
+
+	const TShowFileIndexEntry *Find(uint32_t nMillis) const;
+
+	uint32_t GetEntries(void) const {
+		return m_nEntries;
+	}
+
+	uint32_t GetShowFileSize(void) const {
+		return m_nShowFileSize;
+	}
+
+	static bool GetFileSize(FILE *pFile, uint32_t& nSize);
+
+private:
+	static constexpr uint32_t MAX_ENTRIES = 4096;
+	static constexpr uint32_t INTERVAL_MILLIS = 1000;	///< Minimum time between entries
+
+	TShowFileIndexEntry *m_pEntries;
+	uint32_t m_nEntries = 0;
+	uint32_t m_nShowFileSize = 0;
+};
+
+#endif /* SHOWFILEINDEX_H_ */
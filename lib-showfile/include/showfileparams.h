@@ -47,6 +47,7 @@ struct ShowFileOptions {
 	static constexpr auto AUTO_START = (1U << 0);
 	static constexpr auto LOOP = (1U << 1);
 	static constexpr auto DISABLE_SYNC = (1U << 2);
+	static constexpr auto CHASE = (1U << 3);
 };
 
 struct ShowFileParamsMask {
@@ -38,6 +38,7 @@ public:
 	static  const char OPTION_AUTO_START[];
 	static  const char OPTION_LOOP[];
 	static  const char OPTION_DISABLE_SYNC[];
+	static  const char OPTION_CHASE[];
 
 	static  const char PROTOCOL[];
 	static  const char SACN_SYNC_UNIVERSE[];
@@ -34,13 +34,15 @@
 
 #include "artnetcontroller.h"
 #include "artnettrigger.h"
+#include "artnettimecode.h"
 
 #include "showfileprotocolhandler.h"
 
-class ShowFileProtocolArtNet: public ShowFileProtocolHandler, public ArtNetTrigger {
+class ShowFileProtocolArtNet: public ShowFileProtocolHandler, public ArtNetTrigger, public ArtNetTimeCode {
 public:
 	ShowFileProtocolArtNet(void) {
 		m_ArtNetController.SetArtNetTrigger(this);
+		m_ArtNetController.SetArtNetTimeCode(this);
 	}
 
 	~ShowFileProtocolArtNet(void) {
@@ -56,11 +58,11 @@ public:
 	}
 
 	void DmxOut(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength) {
-		m_ArtNetController.HandleDmxOut(nUniverse, pDmxData, nLength);
+		m_ArtNetController.Universe(nUniverse, pDmxData, nLength);
 	}
 
 	void DmxSync(void) {
-		m_ArtNetController.HandleSync();
+		m_ArtNetController.CommitFrame();
 	}
 
 	void DmxBlackout(void) {
@@ -83,6 +85,11 @@ public:
 		return !m_ArtNetController.GetSynchronization();
 	}
 
+	bool SetRecorder(LightSetRecorder *pRecorder) {
+		m_ArtNetController.SetRecorder(pRecorder);
+		return true;
+	}
+
 	void Print(void) {
 		puts("ShowFileProtocolArtNet");
 		m_ArtNetController.Print();
@@ -91,6 +98,9 @@ public:
 	// ArtNetTrigger
 	void Handler(const struct TArtNetTrigger *ptArtNetTrigger);
 
+	// ArtNetTimeCode
+	void Handler(const struct TArtNetTimeCode *ptArtNetTimeCode);
+
 private:
 	ArtNetController m_ArtNetController;
 };
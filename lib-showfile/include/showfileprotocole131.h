@@ -54,11 +54,11 @@ public:
 	}
 
 	void DmxOut(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength) {
-		m_E131Controller.HandleDmxOut(nUniverse, pDmxData, nLength);
+		m_E131Controller.Universe(nUniverse, pDmxData, nLength);
 	}
 
 	void DmxSync(void) {
-		m_E131Controller.HandleSync();
+		m_E131Controller.CommitFrame();
 	}
 
 	void DmxBlackout(void) {
@@ -79,6 +79,11 @@ public:
 		return (m_E131Controller.GetSynchronizationAddress() == 0);
 	}
 
+	// The E1.31 controller does not join the universe multicast groups
+	bool SetRecorder(__attribute__((unused)) LightSetRecorder *pRecorder) {
+		return false;
+	}
+
 	void Print(void) {
 		puts("ShowFileProtocolE131");
 		m_E131Controller.Print();
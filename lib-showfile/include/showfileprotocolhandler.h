@@ -28,13 +28,15 @@
 
 #include <stdint.h>
 
+#include "lightsetrecorder.h"
+
 class ShowFileProtocolHandler {
 public:
 	virtual ~ShowFileProtocolHandler(void) {
 	}
 
 	virtual void DmxOut(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength)=0;
-	virtual void DmxSync(void)=0;
+	virtual void DmxSync(void)=0;	///< Ends the frame, the universes from DmxOut are sent together
 	virtual void DmxBlackout(void)=0;
 	virtual void DmxMaster(uint32_t nMaster)=0;
 
@@ -46,6 +48,11 @@ public:
 
 	virtual bool IsSyncDisabled(void)=0;
 
+	/**
+	 * @return false when the protocol does not receive DMX data
+	 */
+	virtual bool SetRecorder(LightSetRecorder *pRecorder)=0;
+
 	virtual void Print(void)=0;
 };
 
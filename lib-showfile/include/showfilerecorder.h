@@ -0,0 +1,91 @@
+/**
+ * @file showfilerecorder.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SHOWFILERECORDER_H_
+#define SHOWFILERECORDER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "lightsetrecorder.h"
+
+#include "showfilebinary.h"
+
+/**
+ * Records the received universes into a binary showfile with delta frames.
+ * Record() only writes into the RAM staging buffer, Run() flushes it in large blocks.
+ */
+class ShowFileRecorder: public LightSetRecorder {
+public:
+	ShowFileRecorder(void);
+	~ShowFileRecorder(void);
+
+	bool Start(FILE *pFile);
+	void Stop(void);
+	void Run(void);
+
+	void Record(uint16_t nUniverse, const uint8_t *pData, uint16_t nLength);
+
+	void Print(void);
+
+private:
+	struct TUniverse {
+		uint16_t nUniverse;
+		uint16_t nLength;	///< 0 is not in use
+		uint8_t data[ShowFileBinary::DMX_MAX_LENGTH];
+	};
+
+	TUniverse *GetUniverse(uint16_t nUniverse);
+	uint32_t GetKeyFrameSize(void) const;
+	void AddKeyFrame(void);
+	void CloseFrame(void);
+	bool Flush(void);
+
+private:
+	static constexpr uint32_t MAX_UNIVERSES = ShowFileBinary::MAX_UNIVERSES;
+	static constexpr uint32_t STAGING_SIZE = (64 * 1024);
+	static constexpr uint32_t FLUSH_SIZE = (16 * 1024);
+	static constexpr uint32_t FRAME_NONE = 0xFFFFFFFF;
+	static constexpr uint32_t KEYFRAME_INTERVAL_MILLIS = ShowFileBinary::KEYFRAME_INTERVAL_MILLIS;
+
+	FILE *m_pFile = 0;
+	TUniverse *m_pUniverses;
+	uint8_t *m_pStaging;
+	uint32_t m_nStaged = 0;
+	uint32_t m_nFrameOffset = FRAME_NONE;	///< Offset of the open frame header in m_pStaging
+	TShowFileBinaryFrame m_tFrame;
+	uint32_t m_nStartMillis = 0;
+	uint32_t m_nKeyFrameMillis = 0;
+	// Statistics
+	uint32_t m_nKeyFrames = 0;
+	uint32_t m_nRecorded = 0;
+	uint32_t m_nUnchanged = 0;
+	uint32_t m_nDropped = 0;	///< The staging buffer was full
+	uint32_t m_nUntracked = 0;	///< Recorded as full blocks, no room in m_pUniverses
+	uint32_t m_nBytesWritten = 0;
+	bool m_bWriteError = false;
+};
+
+#endif /* SHOWFILERECORDER_H_ */
@@ -0,0 +1,507 @@
+/**
+ * @file binaryshowfile.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "binaryshowfile.h"
+#include "showfile.h"
+#include "showfilebinary.h"
+#include "showfiledelta.h"
+#include "showfileindex.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+BinaryShowFile::BinaryShowFile(void) {
+	DEBUG1_ENTRY
+
+	m_pBuffer = new uint8_t[READ_AHEAD_SIZE];
+	assert(m_pBuffer != 0);
+
+	m_pUniverses = new TUniverse[MAX_UNIVERSES];
+	assert(m_pUniverses != 0);
+
+	memset(&m_tFrame, 0, sizeof(struct TShowFileBinaryFrame));
+
+	DEBUG1_EXIT
+}
+
+BinaryShowFile::~BinaryShowFile(void) {
+	DEBUG1_ENTRY
+
+	delete m_pIndex;
+	m_pIndex = 0;
+
+	delete[] m_pUniverses;
+	m_pUniverses = 0;
+
+	delete[] m_pBuffer;
+	m_pBuffer = 0;
+
+	DEBUG1_EXIT
+}
+
+void BinaryShowFile::ShowFileStart(void) {
+	DEBUG1_ENTRY
+
+	m_nFrames = 0;
+	m_nFramesLate = 0;
+	m_bTimeCode = false;
+
+	// Building a missing index takes a scan of the file, do not wait for the first timecode
+	if (m_bChase && !LoadIndex()) {
+		DEBUG_PUTS("No index");
+	}
+
+	m_tState = Rewind() ? BinaryState::IDLE : BinaryState::FAILED;
+
+	DEBUG1_EXIT
+}
+
+void BinaryShowFile::ShowFileStop(void) {
+	DEBUG1_ENTRY
+
+	m_nStopMillis = Hardware::Get()->Millis();
+
+	DEBUG1_EXIT
+}
+
+void BinaryShowFile::ShowFileResume(void) {
+	DEBUG1_ENTRY
+
+	// The timestamps are absolute, skip the time we were stopped
+	m_nStartMillis += (Hardware::Get()->Millis() - m_nStopMillis);
+
+	DEBUG1_EXIT
+}
+
+void BinaryShowFile::ShowFileRun(void) {
+	if (m_tState == BinaryState::FAILED) {
+		SetShowFileStatus(ShowFileStatus::ENDED);
+		return;
+	}
+
+	if (m_bChase && (!m_bTimeCode || ((Hardware::Get()->Millis() - m_nTimeCodeMillis) > CHASE_TIMEOUT_MILLIS))) {
+		return;
+	}
+
+	if (m_tState == BinaryState::SEEKING) {
+		CatchUp();
+		return;
+	}
+
+	if (m_tState == BinaryState::IDLE) {
+		if (!Ensure(sizeof(struct TShowFileBinaryFrame))) {
+			if (m_bChase) {
+				// Hold at the end, the timecode can still jump back
+				return;
+			}
+			if (m_bDoLoop && Rewind()) {
+				return;
+			}
+			SetShowFileStatus(ShowFileStatus::ENDED);
+			return;
+		}
+
+		memcpy(&m_tFrame, &m_pBuffer[m_nHead], sizeof(struct TShowFileBinaryFrame));
+		m_nHead += static_cast<uint32_t>(sizeof(struct TShowFileBinaryFrame));
+
+		if (m_tFrame.nSize > READ_AHEAD_SIZE) {
+			DEBUG_PRINTF("nSize=%u", m_tFrame.nSize);
+			m_tState = BinaryState::FAILED;
+			return;
+		}
+
+		m_tState = BinaryState::TIME_WAITING;
+	}
+
+	if ((Hardware::Get()->Millis() - m_nStartMillis) < m_tFrame.nMillis) {
+		// Use the idle time for reading ahead
+		ReadAhead(READ_AHEAD_CHUNK);
+		return;
+	}
+
+	if (!Ensure(m_tFrame.nSize)) {
+		m_tState = BinaryState::FAILED;
+		return;
+	}
+
+	OutputFrame();
+
+	m_tState = BinaryState::IDLE;
+}
+
+void BinaryShowFile::ShowFilePrint(void) {
+	puts("BinaryShowFile");
+	printf(" Frames : %u (late %u)\n", m_nFrames, m_nFramesLate);
+
+	if (m_pIndex != 0) {
+		printf(" Index  : %u entries, %u seeks\n", m_pIndex->GetEntries(), m_nSeeks);
+	}
+}
+
+/*
+ * Chase, a difference larger than the tolerance is handled as a jump
+ */
+void BinaryShowFile::ShowFileTimeCode(uint32_t nMillis) {
+	if (m_tState == BinaryState::FAILED) {
+		return;
+	}
+
+	const uint32_t nNow = Hardware::Get()->Millis();
+	const uint32_t nShowMillis = nNow - m_nStartMillis;
+	const uint32_t nDifference = (nShowMillis > nMillis) ? (nShowMillis - nMillis) : (nMillis - nShowMillis);
+
+	m_nTimeCodeMillis = nNow;
+
+	if (m_bTimeCode && (nDifference <= CHASE_TOLERANCE_MILLIS)) {
+		// Locked, follow the timecode clock
+		m_nStartMillis = nNow - nMillis;
+		return;
+	}
+
+	DEBUG_PRINTF("nShowMillis=%u, nMillis=%u", nShowMillis, nMillis);
+
+	if (Seek(nMillis)) {
+		m_bTimeCode = true;
+	} else {
+		m_tState = BinaryState::FAILED;
+	}
+}
+
+void BinaryShowFile::OutputFrame(bool bOutput) {
+	const uint8_t *pBlock = &m_pBuffer[m_nHead];
+	const uint8_t *pEnd = pBlock + m_tFrame.nSize;
+
+	for (uint32_t i = 0; i < m_tFrame.nUniverses; i++) {
+		struct TShowFileBinaryUniverse tUniverse;
+
+		if ((pBlock + sizeof(struct TShowFileBinaryUniverse)) > pEnd) {
+			break;
+		}
+
+		memcpy(&tUniverse, pBlock, sizeof(struct TShowFileBinaryUniverse));
+		pBlock += sizeof(struct TShowFileBinaryUniverse);
+
+		const bool bIsDelta = ((tUniverse.nLength & ShowFileBinary::LENGTH_DELTA) != 0);
+		const uint16_t nSize = tUniverse.nLength & static_cast<uint16_t>(~ShowFileBinary::LENGTH_DELTA);
+
+		if ((nSize > ShowFileBinary::DMX_MAX_LENGTH) || ((pBlock + nSize) > pEnd)) {
+			break;
+		}
+
+		if (!m_bTrackUniverses) {
+			if (nSize != 0) {
+				m_pShowFileProtocolHandler->DmxOut(tUniverse.nUniverse, pBlock, nSize);
+			}
+		} else {
+			TUniverse *pUniverse = GetUniverse(tUniverse.nUniverse);
+
+			if (pUniverse != 0) {
+				if (!bIsDelta) {
+					memcpy(pUniverse->data, pBlock, nSize);
+					pUniverse->nLength = nSize;
+				} else if ((pUniverse->nLength == 0) || !ShowFileDelta::Decode(pUniverse->data, pUniverse->nLength, pBlock, nSize)) {
+					pUniverse = 0;
+				}
+			}
+
+			if ((pUniverse == 0) && !bIsDelta && (nSize != 0)) {
+				// Not tracked, the table is full. Also output when catching up, there is no state to output afterwards
+				m_pShowFileProtocolHandler->DmxOut(tUniverse.nUniverse, pBlock, nSize);
+			} else if (bOutput && (pUniverse != 0) && (pUniverse->nLength != 0)) {
+				m_pShowFileProtocolHandler->DmxOut(tUniverse.nUniverse, pUniverse->data, pUniverse->nLength);
+			}
+		}
+
+		pBlock += nSize;
+	}
+
+	m_nHead += m_tFrame.nSize;
+
+	if (!bOutput) {
+		return;
+	}
+
+	if (m_tFrame.nUniverses != 0) {
+		m_pShowFileProtocolHandler->DmxSync();
+	}
+
+	if ((Hardware::Get()->Millis() - m_nStartMillis) > m_tFrame.nMillis) {
+		m_nFramesLate++;
+	}
+
+	m_nFrames++;
+}
+
+BinaryShowFile::TUniverse *BinaryShowFile::GetUniverse(uint16_t nUniverse) {
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		if (m_pUniverses[i].nLength == 0) {
+			m_pUniverses[i].nUniverse = nUniverse;
+			return &m_pUniverses[i];
+		}
+
+		if (m_pUniverses[i].nUniverse == nUniverse) {
+			return &m_pUniverses[i];
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Positions the read-ahead buffer at the first frame and restarts the show time
+ */
+bool BinaryShowFile::Rewind(void) {
+	m_nHead = 0;
+	m_nTail = 0;
+	m_bEndOfFile = false;
+
+	if ((m_pShowFile == 0) || (fseek(m_pShowFile, 0L, SEEK_SET) != 0)) {
+		return false;
+	}
+
+	if (!Ensure(sizeof(struct TShowFileBinaryHeader))) {
+		return false;
+	}
+
+	struct TShowFileBinaryHeader tHeader;
+	memcpy(&tHeader, m_pBuffer, sizeof(struct TShowFileBinaryHeader));
+	m_nHead = static_cast<uint32_t>(sizeof(struct TShowFileBinaryHeader));
+
+	if ((memcmp(tHeader.aMagic, SHOWFILE_BINARY_MAGIC, ShowFileBinary::MAGIC_LENGTH) != 0) || (tHeader.nVersion != ShowFileBinary::VERSION)) {
+		DEBUG_PUTS("Not a binary showfile");
+		return false;
+	}
+
+	m_bTrackUniverses = ((tHeader.nFlags & ShowFileBinary::FLAG_DELTA) != 0);
+
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		m_pUniverses[i].nLength = 0;
+	}
+
+	m_tState = BinaryState::IDLE;
+	m_nStartMillis = Hardware::Get()->Millis();
+
+	return true;
+}
+
+/*
+ * The index is loaded from showNN.idx, or built and saved when missing or stale
+ */
+bool BinaryShowFile::LoadIndex(void) {
+	DEBUG1_ENTRY
+
+	uint32_t nShowFileSize;
+
+	if ((m_pShowFile == 0) || !ShowFileIndex::GetFileSize(m_pShowFile, nShowFileSize)) {
+		DEBUG1_EXIT
+		return false;
+	}
+
+	if (m_pIndex == 0) {
+		m_pIndex = new ShowFileIndex;
+		assert(m_pIndex != 0);
+	} else if ((m_nIndexShowFileNumber == m_nShowFileNumber) && (m_pIndex->GetShowFileSize() == nShowFileSize)) {
+		DEBUG1_EXIT
+		return true;
+	}
+
+	char aIndexFileName[ShowFileFile::NAME_LENGTH + 1];
+
+	if (!ShowFile::IndexFileNameCopyTo(aIndexFileName, sizeof(aIndexFileName), m_nShowFileNumber)) {
+		DEBUG1_EXIT
+		return false;
+	}
+
+	bool bLoaded = false;
+	FILE *pIndexFile = fopen(aIndexFileName, "r");
+
+	if (pIndexFile != 0) {
+		bLoaded = m_pIndex->Load(pIndexFile, nShowFileSize);
+		fclose(pIndexFile);
+	}
+
+	if (!bLoaded) {
+		if (!m_pIndex->Build(m_pShowFile)) {
+			DEBUG1_EXIT
+			return false;
+		}
+
+		pIndexFile = fopen(aIndexFileName, "w+");
+
+		if (pIndexFile != 0) {
+			if (!m_pIndex->Save(pIndexFile)) {
+				DEBUG_PUTS("Saving index failed");
+			}
+			fclose(pIndexFile);
+		} else {
+			perror(aIndexFileName);
+		}
+	}
+
+	m_nIndexShowFileNumber = m_nShowFileNumber;
+
+	DEBUG1_EXIT
+	return true;
+}
+
+/*
+ * Positions at the last key frame at or before nMillis, the frames up to the show time
+ * are then replayed without output by CatchUp().
+ */
+bool BinaryShowFile::Seek(uint32_t nMillis) {
+	if ((m_pIndex == 0) || (m_nIndexShowFileNumber != m_nShowFileNumber)) {
+		LoadIndex();
+	}
+
+	const TShowFileIndexEntry *pEntry = (m_pIndex != 0) ? m_pIndex->Find(nMillis) : 0;
+	const uint32_t nOffset = (pEntry != 0) ? pEntry->nOffset : static_cast<uint32_t>(sizeof(struct TShowFileBinaryHeader));
+
+	m_nHead = 0;
+	m_nTail = 0;
+	m_bEndOfFile = false;
+
+	if ((m_pShowFile == 0) || (fseek(m_pShowFile, static_cast<long>(nOffset), SEEK_SET) != 0)) {
+		return false;
+	}
+
+	m_bTrackUniverses = true;
+
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		m_pUniverses[i].nLength = 0;
+	}
+
+	m_tState = BinaryState::SEEKING;
+	m_nStartMillis = Hardware::Get()->Millis() - nMillis;
+	m_nSeeks++;
+
+	return true;
+}
+
+/*
+ * At most CATCH_UP_FRAMES frames per call, the show time runs on meanwhile.
+ * When caught up, the state of all universes is output at once.
+ */
+void BinaryShowFile::CatchUp(void) {
+	const uint32_t nShowMillis = Hardware::Get()->Millis() - m_nStartMillis;
+
+	for (uint32_t nFrames = 0; nFrames < CATCH_UP_FRAMES; nFrames++) {
+		if (!Ensure(sizeof(struct TShowFileBinaryFrame))) {
+			m_tState = BinaryState::IDLE;
+			break;
+		}
+
+		memcpy(&m_tFrame, &m_pBuffer[m_nHead], sizeof(struct TShowFileBinaryFrame));
+		m_nHead += static_cast<uint32_t>(sizeof(struct TShowFileBinaryFrame));
+
+		if (m_tFrame.nSize > READ_AHEAD_SIZE) {
+			m_tState = BinaryState::FAILED;
+			return;
+		}
+
+		if (m_tFrame.nMillis > nShowMillis) {
+			m_tState = BinaryState::TIME_WAITING;
+			break;
+		}
+
+		if (!Ensure(m_tFrame.nSize)) {
+			m_tState = BinaryState::FAILED;
+			return;
+		}
+
+		OutputFrame(false);
+	}
+
+	if (m_tState == BinaryState::SEEKING) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		if (m_pUniverses[i].nLength != 0) {
+			m_pShowFileProtocolHandler->DmxOut(m_pUniverses[i].nUniverse, m_pUniverses[i].data, m_pUniverses[i].nLength);
+		}
+	}
+
+	m_pShowFileProtocolHandler->DmxSync();
+}
+
+/*
+ * Reads at most nChunk bytes, only when there is room for a whole chunk.
+ * The unread data is moved to the start of the buffer when more than half of it has been consumed.
+ */
+bool BinaryShowFile::ReadAhead(uint32_t nChunk) {
+	if (m_bEndOfFile) {
+		return false;
+	}
+
+	if ((READ_AHEAD_SIZE - m_nTail) < nChunk) {
+		if (m_nHead < (READ_AHEAD_SIZE / 2)) {
+			return false;
+		}
+
+		memmove(m_pBuffer, &m_pBuffer[m_nHead], m_nTail - m_nHead);
+		m_nTail -= m_nHead;
+		m_nHead = 0;
+	}
+
+	const uint32_t nFree = READ_AHEAD_SIZE - m_nTail;
+	const uint32_t nRead = (nChunk < nFree) ? nChunk : nFree;
+
+	const size_t nBytes = fread(&m_pBuffer[m_nTail], 1, nRead, m_pShowFile);
+
+	m_nTail += static_cast<uint32_t>(nBytes);
+
+	if (nBytes < nRead) {
+		m_bEndOfFile = true;
+	}
+
+	return (nBytes != 0);
+}
+
+/*
+ * Blocking read, only needed when the read-ahead could not keep up
+ */
+bool BinaryShowFile::Ensure(uint32_t nBytes) {
+	assert(nBytes <= READ_AHEAD_SIZE);
+
+	while ((m_nTail - m_nHead) < nBytes) {
+		if (m_nHead != 0) {
+			memmove(m_pBuffer, &m_pBuffer[m_nHead], m_nTail - m_nHead);
+			m_nTail -= m_nHead;
+			m_nHead = 0;
+		}
+
+		if (!ReadAhead(READ_AHEAD_SIZE - m_nTail)) {
+			return false;
+		}
+	}
+
+	return true;
+}
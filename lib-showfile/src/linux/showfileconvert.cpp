@@ -0,0 +1,290 @@
+/**
+ * @file showfileconvert.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <cassert>
+
+#include "showfileconvert.h"
+#include "showfilebinary.h"
+
+#include "debug.h"
+
+namespace {
+
+/*
+ * A frame holding every universe seen so far is a key frame. Otherwise a frame
+ * starts with the full data of the tracked universes every KEYFRAME_INTERVAL_MILLIS.
+ */
+struct TUniverse {
+	uint16_t nUniverse;
+	uint16_t nLength;	///< 0 is not in use
+	uint8_t data[ShowFileBinary::DMX_MAX_LENGTH];
+};
+
+struct TUniverses {
+	uint32_t aFrame[65536];	///< Last frame number the universe was in, 0 is never
+	uint32_t nSeen;
+	uint32_t nInFrame;
+	TUniverse aTracked[ShowFileBinary::MAX_UNIVERSES];
+};
+
+TUniverses s_Universes;
+
+TUniverse *GetTracked(uint16_t nUniverse) {
+	for (uint32_t i = 0; i < ShowFileBinary::MAX_UNIVERSES; i++) {
+		TUniverse *pUniverse = &s_Universes.aTracked[i];
+
+		if (pUniverse->nLength == 0) {
+			pUniverse->nUniverse = nUniverse;
+			return pUniverse;
+		}
+
+		if (pUniverse->nUniverse == nUniverse) {
+			return pUniverse;
+		}
+	}
+
+	return 0;
+}
+
+bool WriteUniverse(FILE *pBinaryFile, struct TShowFileBinaryFrame& tFrame, const struct TShowFileBinaryUniverse& tUniverse, const uint8_t *pDmxData) {
+	if (fwrite(&tUniverse, sizeof(struct TShowFileBinaryUniverse), 1, pBinaryFile) != 1) {
+		return false;
+	}
+
+	if (fwrite(pDmxData, 1, tUniverse.nLength, pBinaryFile) != tUniverse.nLength) {
+		return false;
+	}
+
+	tFrame.nUniverses++;
+	tFrame.nSize += static_cast<uint32_t>(sizeof(struct TShowFileBinaryUniverse) + tUniverse.nLength);
+
+	return true;
+}
+
+bool AddKeyFrame(FILE *pBinaryFile, struct TShowFileBinaryFrame& tFrame, uint32_t nFrameNumber) {
+	for (uint32_t i = 0; i < ShowFileBinary::MAX_UNIVERSES; i++) {
+		const TUniverse *pUniverse = &s_Universes.aTracked[i];
+
+		if (pUniverse->nLength == 0) {
+			break;
+		}
+
+		struct TShowFileBinaryUniverse tUniverse;
+		tUniverse.nUniverse = pUniverse->nUniverse;
+		tUniverse.nLength = pUniverse->nLength;
+
+		if (!WriteUniverse(pBinaryFile, tFrame, tUniverse, pUniverse->data)) {
+			return false;
+		}
+
+		s_Universes.aFrame[pUniverse->nUniverse] = nFrameNumber;
+		s_Universes.nInFrame++;
+	}
+
+	tFrame.nFlags = ShowFileBinary::FRAME_KEY;
+	return true;
+}
+
+bool WriteFrameHeader(FILE *pBinaryFile, long nFramePosition, const struct TShowFileBinaryFrame& tFrame) {
+	const long nPosition = ftell(pBinaryFile);
+
+	if ((nPosition < 0) || (fseek(pBinaryFile, nFramePosition, SEEK_SET) != 0)) {
+		return false;
+	}
+
+	if (fwrite(&tFrame, sizeof(struct TShowFileBinaryFrame), 1, pBinaryFile) != 1) {
+		return false;
+	}
+
+	return (fseek(pBinaryFile, nPosition, SEEK_SET) == 0);
+}
+
+/*
+ * "<universe> <value>,<value>,..."
+ */
+bool ParseDmxLine(char *pLine, struct TShowFileBinaryUniverse& tUniverse, uint8_t *pDmxData) {
+	char *p;
+
+	const unsigned long nUniverse = strtoul(pLine, &p, 10);
+
+	if ((*p != ' ') || (nUniverse > UINT16_MAX)) {
+		return false;
+	}
+
+	tUniverse.nUniverse = static_cast<uint16_t>(nUniverse);
+	tUniverse.nLength = 0;
+
+	p++;
+
+	while (isdigit(*p)) {
+		const unsigned long nValue = strtoul(p, &p, 10);
+
+		if ((nValue > 255) || (tUniverse.nLength == ShowFileBinary::DMX_MAX_LENGTH)) {
+			return false;
+		}
+
+		pDmxData[tUniverse.nLength++] = static_cast<uint8_t>(nValue);
+
+		if (*p == ',') {
+			p++;
+		}
+	}
+
+	return true;
+}
+
+}  // namespace
+
+bool ShowFileConvert::OlaToBinary(FILE *pOlaFile, FILE *pBinaryFile) {
+	DEBUG_ENTRY
+	assert(pOlaFile != 0);
+	assert(pBinaryFile != 0);
+
+	struct TShowFileBinaryHeader tHeader;
+
+	memset(&tHeader, 0, sizeof(struct TShowFileBinaryHeader));
+	memcpy(tHeader.aMagic, SHOWFILE_BINARY_MAGIC, ShowFileBinary::MAGIC_LENGTH);
+	tHeader.nVersion = ShowFileBinary::VERSION;
+
+	if (fwrite(&tHeader, sizeof(struct TShowFileBinaryHeader), 1, pBinaryFile) != 1) {
+		DEBUG_EXIT
+		return false;
+	}
+
+	struct TShowFileBinaryFrame tFrame;
+	memset(&tFrame, 0, sizeof(struct TShowFileBinaryFrame));
+
+	long nFramePosition = -1;	// No frame open
+	uint32_t nFrameNumber = 0;
+	uint32_t nKeyFrameMillis = 0;
+
+	memset(&s_Universes, 0, sizeof(struct TUniverses));
+	char aLine[2048];
+	uint8_t aDmxData[ShowFileBinary::DMX_MAX_LENGTH];
+
+	while (fgets(aLine, sizeof(aLine), pOlaFile) == aLine) {
+		if (!isdigit(aLine[0])) {
+			continue;
+		}
+
+		if (strchr(aLine, ' ') == 0) {
+			// Delay line, follows every universe. A zero delay keeps the universes in the same frame.
+			const unsigned long nDelay = strtoul(aLine, 0, 10);
+
+			if (nDelay == 0) {
+				continue;
+			}
+
+			if (nFramePosition >= 0) {
+				if (s_Universes.nInFrame == s_Universes.nSeen) {
+					tFrame.nFlags = ShowFileBinary::FRAME_KEY;
+				}
+
+				if (tFrame.nFlags == ShowFileBinary::FRAME_KEY) {
+					nKeyFrameMillis = tFrame.nMillis;
+				}
+
+				if (!WriteFrameHeader(pBinaryFile, nFramePosition, tFrame)) {
+					DEBUG_EXIT
+					return false;
+				}
+				nFramePosition = -1;
+			}
+
+			tFrame.nMillis += static_cast<uint32_t>(nDelay);
+			continue;
+		}
+
+		struct TShowFileBinaryUniverse tUniverse;
+
+		if (!ParseDmxLine(aLine, tUniverse, aDmxData)) {
+			DEBUG_PRINTF("Invalid line [%s]", aLine);
+			DEBUG_EXIT
+			return false;
+		}
+
+		if (nFramePosition < 0) {
+			nFramePosition = ftell(pBinaryFile);
+			tFrame.nUniverses = 0;
+			tFrame.nFlags = 0;
+			tFrame.nSize = 0;
+
+			nFrameNumber++;
+			s_Universes.nInFrame = 0;
+
+			// Placeholder, written again when the frame is complete
+			if ((nFramePosition < 0) || (fwrite(&tFrame, sizeof(struct TShowFileBinaryFrame), 1, pBinaryFile) != 1)) {
+				DEBUG_EXIT
+				return false;
+			}
+
+			if ((nFrameNumber > 1) && ((tFrame.nMillis - nKeyFrameMillis) >= ShowFileBinary::KEYFRAME_INTERVAL_MILLIS)) {
+				if (!AddKeyFrame(pBinaryFile, tFrame, nFrameNumber)) {
+					DEBUG_EXIT
+					return false;
+				}
+			}
+		}
+
+		if (s_Universes.aFrame[tUniverse.nUniverse] != nFrameNumber) {
+			if (s_Universes.aFrame[tUniverse.nUniverse] == 0) {
+				s_Universes.nSeen++;
+			}
+			s_Universes.aFrame[tUniverse.nUniverse] = nFrameNumber;
+			s_Universes.nInFrame++;
+		}
+
+		if (!WriteUniverse(pBinaryFile, tFrame, tUniverse, aDmxData)) {
+			DEBUG_EXIT
+			return false;
+		}
+
+		TUniverse *pUniverse = GetTracked(tUniverse.nUniverse);
+
+		if ((pUniverse != 0) && (tUniverse.nLength != 0)) {
+			memcpy(pUniverse->data, aDmxData, tUniverse.nLength);
+			pUniverse->nLength = tUniverse.nLength;
+		}
+	}
+
+	if (nFramePosition >= 0) {
+		if (s_Universes.nInFrame == s_Universes.nSeen) {
+			tFrame.nFlags = ShowFileBinary::FRAME_KEY;
+		}
+
+		if (!WriteFrameHeader(pBinaryFile, nFramePosition, tFrame)) {
+			DEBUG_EXIT
+			return false;
+		}
+	}
+
+	DEBUG_EXIT
+	return (fflush(pBinaryFile) == 0);
+}
@@ -91,6 +91,8 @@ void OlaShowFile::ShowFileRun(void) {
 			}
 			m_tState = OlaState::TIME_WAITING;
 		} else if (m_tParseCode == OlaParseCode::EOFILE) {
+			m_pShowFileProtocolHandler->DmxSync();
+
 			if (m_bDoLoop) {
 				fseek(m_pShowFile, 0L, SEEK_SET);
 			} else {
@@ -112,7 +114,7 @@ OlaParseCode OlaShowFile::ParseDmxData(const char *pLine) {
 	int64_t k = 0;
 	uint32_t nLength = 0;
 
-	while (isdigit(*p) == 1) {
+	while (isdigit(*p) != 0) {
 		k = k * 10 + *p - '0';
 
 		if (k > 255) {
@@ -146,7 +148,7 @@ OlaParseCode OlaShowFile::ParseLine(const char *pLine) {
 	char *p = const_cast<char*>(pLine);
 	int32_t k = 0;
 
-	while (isdigit(*p) == 1) {
+	while (isdigit(*p) != 0) {
 		k = k * 10 + *p - '0';
 		p++;
 	}
@@ -52,6 +52,10 @@ void ShowFile::SetShowFile(uint8_t nShowFileNumber) {
 	DEBUG_PRINTF("nShowFileNumber=%u", nShowFileNumber);
 
 	if (nShowFileNumber <= ShowFileFile::MAX_NUMBER) {
+		if (m_tShowFileStatus == ShowFileStatus::RECORDING) {
+			StopRecording();
+		}
+
 		ShowFileStop();
 
 		if (m_pShowFile != 0) {
@@ -103,6 +107,11 @@ bool ShowFile::DeleteShowFile(uint8_t nShowFileNumber) {
 	if (ShowFileNameCopyTo(aFileName, sizeof(aFileName), nShowFileNumber)) {
 		const int nResult = unlink(aFileName);
 		DEBUG_PRINTF("nResult=%d", nResult);
+
+		if (IndexFileNameCopyTo(aFileName, sizeof(aFileName), nShowFileNumber)) {
+			unlink(aFileName);
+		}
+
 		DEBUG_EXIT
 		return (nResult == 0);
 	}
@@ -155,6 +164,10 @@ void ShowFile::Start(void) {
 
 	EnableTFTP(false);
 
+	if (m_tShowFileStatus == ShowFileStatus::RECORDING) {
+		Stop();
+	}
+
 	if (m_pShowFile != 0) {
 		ShowFileStart();
 		SetShowFileStatus(ShowFileStatus::RUNNING);
@@ -168,6 +181,13 @@ void ShowFile::Start(void) {
 void ShowFile::Stop(void) {
 	DEBUG_ENTRY
 
+	if (m_tShowFileStatus == ShowFileStatus::RECORDING) {
+		StopRecording();
+		SetShowFile(m_nShowFileNumber);
+		DEBUG_EXIT
+		return;
+	}
+
 	if (m_pShowFile != 0) {
 		ShowFileStop();
 		SetShowFileStatus(ShowFileStatus::STOPPED);
@@ -179,7 +199,7 @@ void ShowFile::Stop(void) {
 void ShowFile::Resume(void) {
 	DEBUG_ENTRY
 
-	if (m_pShowFile != 0) {
+	if ((m_pShowFile != 0) && (m_tShowFileStatus != ShowFileStatus::RECORDING)) {
 		ShowFileResume();
 		SetShowFileStatus(ShowFileStatus::RUNNING);
 	}
@@ -187,6 +207,145 @@ void ShowFile::Resume(void) {
 	DEBUG_EXIT
 }
 
+/*
+ * Records into a temporary file, which replaces the current showfile with a binary showfile when the recording stops
+ */
+void ShowFile::Record(void) {
+	DEBUG_ENTRY
+
+	if ((m_tShowFileStatus == ShowFileStatus::RECORDING) || (m_pShowFileProtocolHandler == 0)) {
+		DEBUG_EXIT
+		return;
+	}
+
+	// The player must be able to play the recording
+	if (ShowFileFormat() != ShowFileFormats::BINARY) {
+		puts("Recording needs the binary format");
+		DEBUG_EXIT
+		return;
+	}
+
+	char aRecordFileName[ShowFileFile::NAME_LENGTH + 1];
+
+	if (!ShowFileNameCopyTo(m_aShowFileName, sizeof(m_aShowFileName), m_nShowFileNumber)
+			|| !RecordFileNameCopyTo(aRecordFileName, sizeof(aRecordFileName), m_nShowFileNumber)) {
+		DEBUG_EXIT
+		return;
+	}
+
+	if (m_pShowFileRecorder == 0) {
+		m_pShowFileRecorder = new ShowFileRecorder;
+		assert(m_pShowFileRecorder != 0);
+	}
+
+	// Nothing is recorded until the recorder is started
+	if (!m_pShowFileProtocolHandler->SetRecorder(m_pShowFileRecorder)) {
+		puts("The protocol does not support recording");
+		DEBUG_EXIT
+		return;
+	}
+
+	EnableTFTP(false);
+	Stop();
+
+	if (m_pShowFile != 0) {
+		if (fclose(m_pShowFile) != 0) {
+			perror("fclose(m_pShowFile)");
+		}
+		m_pShowFile = 0;
+	}
+
+	m_pShowFile = fopen(aRecordFileName, "w+");
+
+	if (m_pShowFile == 0) {
+		perror(aRecordFileName);
+	} else if (m_pShowFileRecorder->Start(m_pShowFile)) {
+		SetShowFileStatus(ShowFileStatus::RECORDING);
+		DEBUG_EXIT
+		return;
+	} else {
+		m_pShowFileRecorder->Stop();
+		if (fclose(m_pShowFile) != 0) {
+			perror("fclose(m_pShowFile)");
+		}
+		m_pShowFile = 0;
+		unlink(aRecordFileName);
+	}
+
+	m_pShowFileProtocolHandler->SetRecorder(0);
+
+	SetShowFile(m_nShowFileNumber);
+	SetShowFileStatus(ShowFileStatus::STOPPED);
+
+	DEBUG_EXIT
+}
+
+/*
+ * Chase, nMillis is the incoming timecode relative to the start of the show.
+ * A stopped show stays stopped.
+ */
+void ShowFile::TimeCode(uint32_t nMillis) {
+	if (!m_bChase || (m_pShowFile == 0)) {
+		return;
+	}
+
+	switch (m_tShowFileStatus) {
+	case ShowFileStatus::IDLE:
+	case ShowFileStatus::ENDED:
+		ShowFileStart();
+		SetShowFileStatus(ShowFileStatus::RUNNING);
+		break;
+	case ShowFileStatus::RUNNING:
+		break;
+	default:
+		return;
+	}
+
+	ShowFileTimeCode(nMillis);
+}
+
+void ShowFile::StopRecording(void) {
+	DEBUG_ENTRY
+	assert(m_pShowFileRecorder != 0);
+
+	m_pShowFileProtocolHandler->SetRecorder(0);
+	m_pShowFileRecorder->Stop();
+	m_pShowFileRecorder->Print();
+
+	bool bIsRecorded = (m_pShowFile != 0);
+
+	if (m_pShowFile != 0) {
+		if (fclose(m_pShowFile) != 0) {
+			perror("fclose(m_pShowFile)");
+			bIsRecorded = false;
+		}
+		m_pShowFile = 0;
+	}
+
+	char aRecordFileName[ShowFileFile::NAME_LENGTH + 1];
+	char aShowFileName[ShowFileFile::NAME_LENGTH + 1];
+
+	if (RecordFileNameCopyTo(aRecordFileName, sizeof(aRecordFileName), m_nShowFileNumber)
+			&& ShowFileNameCopyTo(aShowFileName, sizeof(aShowFileName), m_nShowFileNumber)) {
+		if (bIsRecorded && (rename(aRecordFileName, aShowFileName) == 0)) {
+			char aIndexFileName[ShowFileFile::NAME_LENGTH + 1];
+
+			// The keyframe index of the previous show is stale
+			if (IndexFileNameCopyTo(aIndexFileName, sizeof(aIndexFileName), m_nShowFileNumber)) {
+				unlink(aIndexFileName);
+			}
+		} else {
+			// The current show is kept
+			perror(aRecordFileName);
+			unlink(aRecordFileName);
+		}
+	}
+
+	SetShowFileStatus(ShowFileStatus::STOPPED);
+
+	DEBUG_EXIT
+}
+
 void ShowFile::SetShowFileStatus(ShowFileStatus tShowFileStatus) {
 	DEBUG_ENTRY
 
@@ -211,6 +370,10 @@ void ShowFile::SetShowFileStatus(ShowFileStatus tShowFileStatus) {
 			m_pShowFileProtocolHandler->DoRunCleanupProcess(true);
 			LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
 			break;
+		case ShowFileStatus::RECORDING:
+			m_pShowFileProtocolHandler->DoRunCleanupProcess(true);
+			LedBlink::Get()->SetMode(LEDBLINK_MODE_DATA);
+			break;
 		default:
 			break;
 	}
@@ -226,6 +389,11 @@ void ShowFile::Run(void) {
 		return;
 	}
 
+	if (m_tShowFileStatus == ShowFileStatus::RECORDING) {
+		m_pShowFileRecorder->Run();
+		return;
+	}
+
 	if (m_pShowFileTFTP != 0) {
 		m_pShowFileTFTP->Run();
 	}
@@ -234,5 +402,6 @@ void ShowFile::Run(void) {
 void ShowFile::Print(void) {
 	printf("[%s]\n", m_aShowFileName);
 	printf("%s\n", m_bDoLoop ? "Looping" : "Not looping");
+	printf("%s\n", m_bChase ? "Chasing timecode" : "Not chasing timecode");
 	ShowFilePrint();
 }
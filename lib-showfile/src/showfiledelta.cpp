@@ -0,0 +1,120 @@
+/**
+ * @file showfiledelta.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "showfiledelta.h"
+
+uint32_t ShowFileDelta::Encode(uint8_t *pDelta, uint32_t nMaxSize, const uint8_t *pPrevious, const uint8_t *pData, uint32_t nLength) {
+	assert(pDelta != 0);
+	assert(pPrevious != 0);
+	assert(pData != 0);
+
+	uint32_t nSize = 0;
+	uint32_t i = 0;
+
+	while (i < nLength) {
+		const uint32_t nSkipStart = i;
+
+		while ((i < nLength) && (pData[i] == pPrevious[i])) {
+			i++;
+		}
+
+		if (i == nLength) {
+			break;
+		}
+
+		const uint32_t nStart = i;
+		uint32_t nEnd = i;
+
+		// Unchanged gaps shorter than a run header are cheaper to copy
+		while (i < nLength) {
+			if (pData[i] != pPrevious[i]) {
+				nEnd = ++i;
+				continue;
+			}
+
+			uint32_t j = i;
+
+			while ((j < nLength) && (pData[j] == pPrevious[j]) && ((j - i) < RUN_HEADER_SIZE)) {
+				j++;
+			}
+
+			if ((j == nLength) || ((j - i) == RUN_HEADER_SIZE)) {
+				break;
+			}
+
+			i = j;
+		}
+
+		const uint16_t nSkip = static_cast<uint16_t>(nStart - nSkipStart);
+		const uint16_t nCount = static_cast<uint16_t>(nEnd - nStart);
+
+		if ((nSize + RUN_HEADER_SIZE + nCount) >= nMaxSize) {
+			return 0;
+		}
+
+		memcpy(&pDelta[nSize], &nSkip, sizeof(uint16_t));
+		memcpy(&pDelta[nSize + 2], &nCount, sizeof(uint16_t));
+		memcpy(&pDelta[nSize + RUN_HEADER_SIZE], &pData[nStart], nCount);
+
+		nSize += RUN_HEADER_SIZE + nCount;
+		i = nEnd;
+	}
+
+	return nSize;
+}
+
+bool ShowFileDelta::Decode(uint8_t *pData, uint32_t nLength, const uint8_t *pDelta, uint32_t nDeltaSize) {
+	assert(pData != 0);
+	assert(pDelta != 0);
+
+	uint32_t nSlot = 0;
+	uint32_t nOffset = 0;
+
+	while ((nOffset + RUN_HEADER_SIZE) <= nDeltaSize) {
+		uint16_t nSkip;
+		uint16_t nCount;
+
+		memcpy(&nSkip, &pDelta[nOffset], sizeof(uint16_t));
+		memcpy(&nCount, &pDelta[nOffset + 2], sizeof(uint16_t));
+		nOffset += RUN_HEADER_SIZE;
+
+		nSlot += nSkip;
+
+		if (((nSlot + nCount) > nLength) || ((nOffset + nCount) > nDeltaSize)) {
+			return false;
+		}
+
+		memcpy(&pData[nSlot], &pDelta[nOffset], nCount);
+
+		nSlot += nCount;
+		nOffset += nCount;
+	}
+
+	return (nOffset == nDeltaSize);
+}
@@ -0,0 +1,202 @@
+/**
+ * @file showfileindex.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "showfileindex.h"
+#include "showfilebinary.h"
+
+#include "debug.h"
+
+ShowFileIndex::ShowFileIndex(void) {
+	DEBUG_ENTRY
+
+	m_pEntries = new TShowFileIndexEntry[MAX_ENTRIES];
+	assert(m_pEntries != 0);
+
+	DEBUG_EXIT
+}
+
+ShowFileIndex::~ShowFileIndex(void) {
+	DEBUG_ENTRY
+
+	delete[] m_pEntries;
+	m_pEntries = 0;
+
+	DEBUG_EXIT
+}
+
+/*
+ * Only the frame headers are read, the universe blocks are skipped with fseek
+ */
+bool ShowFileIndex::Build(FILE *pShowFile) {
+	DEBUG_ENTRY
+	assert(pShowFile != 0);
+
+	m_nEntries = 0;
+	m_nShowFileSize = 0;
+
+	uint32_t nShowFileSize;
+
+	if (!GetFileSize(pShowFile, nShowFileSize)) {
+		DEBUG_EXIT
+		return false;
+	}
+
+	uint32_t nOffset = static_cast<uint32_t>(sizeof(struct TShowFileBinaryHeader));
+
+	while ((nOffset + sizeof(struct TShowFileBinaryFrame)) <= nShowFileSize) {
+		struct TShowFileBinaryFrame tFrame;
+
+		if ((fseek(pShowFile, static_cast<long>(nOffset), SEEK_SET) != 0) || (fread(&tFrame, sizeof(struct TShowFileBinaryFrame), 1, pShowFile) != 1)) {
+			DEBUG_EXIT
+			return false;
+		}
+
+		if ((tFrame.nFlags & ShowFileBinary::FRAME_KEY) != 0) {
+			if ((m_nEntries == 0) || ((tFrame.nMillis - m_pEntries[m_nEntries - 1].nMillis) >= INTERVAL_MILLIS)) {
+				if (m_nEntries == MAX_ENTRIES) {
+					DEBUG_PUTS("Index is full");
+					break;
+				}
+
+				m_pEntries[m_nEntries].nMillis = tFrame.nMillis;
+				m_pEntries[m_nEntries].nOffset = nOffset;
+				m_nEntries++;
+			}
+		}
+
+		nOffset += static_cast<uint32_t>(sizeof(struct TShowFileBinaryFrame)) + tFrame.nSize;
+	}
+
+	m_nShowFileSize = nShowFileSize;
+
+	DEBUG_PRINTF("m_nEntries=%u", m_nEntries);
+	DEBUG_EXIT
+	return true;
+}
+
+bool ShowFileIndex::Load(FILE *pIndexFile, uint32_t nShowFileSize) {
+	DEBUG_ENTRY
+	assert(pIndexFile != 0);
+
+	m_nEntries = 0;
+	m_nShowFileSize = 0;
+
+	struct TShowFileIndexHeader tHeader;
+
+	if (fread(&tHeader, sizeof(struct TShowFileIndexHeader), 1, pIndexFile) != 1) {
+		DEBUG_EXIT
+		return false;
+	}
+
+	if ((memcmp(tHeader.aMagic, SHOWFILE_INDEX_MAGIC, sizeof(tHeader.aMagic)) != 0) || (tHeader.nShowFileSize != nShowFileSize) || (tHeader.nEntries > MAX_ENTRIES)) {
+		DEBUG_PUTS("Stale or invalid index");
+		DEBUG_EXIT
+		return false;
+	}
+
+	if (fread(m_pEntries, sizeof(struct TShowFileIndexEntry), tHeader.nEntries, pIndexFile) != tHeader.nEntries) {
+		DEBUG_EXIT
+		return false;
+	}
+
+	m_nEntries = tHeader.nEntries;
+	m_nShowFileSize = nShowFileSize;
+
+	DEBUG_PRINTF("m_nEntries=%u", m_nEntries);
+	DEBUG_EXIT
+	return true;
+}
+
+bool ShowFileIndex::Save(FILE *pIndexFile) {
+	DEBUG_ENTRY
+	assert(pIndexFile != 0);
+
+	struct TShowFileIndexHeader tHeader;
+
+	memcpy(tHeader.aMagic, SHOWFILE_INDEX_MAGIC, sizeof(tHeader.aMagic));
+	tHeader.nShowFileSize = m_nShowFileSize;
+	tHeader.nEntries = m_nEntries;
+
+	if (fwrite(&tHeader, sizeof(struct TShowFileIndexHeader), 1, pIndexFile) != 1) {
+		DEBUG_EXIT
+		return false;
+	}
+
+	const bool bResult = (fwrite(m_pEntries, sizeof(struct TShowFileIndexEntry), m_nEntries, pIndexFile) == m_nEntries);
+
+	DEBUG_EXIT
+	return bResult;
+}
+
+/*
+ * Returns the last entry at or before nMillis, or 0 when nMillis is before the first entry
+ */
+const TShowFileIndexEntry *ShowFileIndex::Find(uint32_t nMillis) const {
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_nEntries;
+
+	while (nLow < nHigh) {
+		const uint32_t nMiddle = nLow + (nHigh - nLow) / 2;
+
+		if (m_pEntries[nMiddle].nMillis <= nMillis) {
+			nLow = nMiddle + 1;
+		} else {
+			nHigh = nMiddle;
+		}
+	}
+
+	if (nLow == 0) {
+		return 0;
+	}
+
+	return &m_pEntries[nLow - 1];
+}
+
+/*
+ * The file position is restored
+ */
+bool ShowFileIndex::GetFileSize(FILE *pFile, uint32_t& nSize) {
+	assert(pFile != 0);
+
+	const long nPosition = ftell(pFile);
+
+	if ((nPosition < 0) || (fseek(pFile, 0L, SEEK_END) != 0)) {
+		return false;
+	}
+
+	const long nEnd = ftell(pFile);
+
+	if ((nEnd < 0) || (fseek(pFile, nPosition, SEEK_SET) != 0)) {
+		return false;
+	}
+
+	nSize = static_cast<uint32_t>(nEnd);
+	return true;
+}
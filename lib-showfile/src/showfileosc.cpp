@@ -49,8 +49,10 @@ namespace Cmd {
 	static constexpr char START[] = "start";
 	static constexpr char STOP[] = "stop";
 	static constexpr char RESUME[] = "resume";
+	static constexpr char RECORD[] = "record";
 	static constexpr char SHOW[] = "show";
 	static constexpr char LOOP[] = "loop";
+	static constexpr char CHASE[] = "chase";
 	static constexpr char BO[] = "blackout";
 	static constexpr char MASTER[] = "master";
 	static constexpr char TFTP[] = "tftp";
@@ -65,8 +67,10 @@ namespace Length {
 	static constexpr auto START = sizeof(Cmd::START) - 1;
 	static constexpr auto STOP = sizeof(Cmd::STOP) - 1;
 	static constexpr auto RESUME = sizeof(Cmd::RESUME) - 1;
+	static constexpr auto RECORD = sizeof(Cmd::RECORD) - 1;
 	static constexpr auto SHOW = sizeof(Cmd::SHOW) - 1;
 	static constexpr auto LOOP = sizeof(Cmd::LOOP) - 1;
+	static constexpr auto CHASE = sizeof(Cmd::CHASE) - 1;
 	static constexpr auto BO = sizeof(Cmd::BO) - 1;
 	static constexpr auto MASTER = sizeof(Cmd::MASTER) - 1;
 	static constexpr auto TFTP = sizeof(Cmd::TFTP) - 1;
@@ -147,6 +151,13 @@ void ShowFileOSC::Run(void) {
 			return;
 		}
 
+		if (memcmp(&m_pBuffer[Length::PATH], Cmd::RECORD, Length::RECORD) == 0) {
+			ShowFile::Get()->Record();
+			SendStatus();
+			DEBUG_PUTS("ActionRecord");
+			return;
+		}
+
 		if (memcmp(&m_pBuffer[Length::PATH], Cmd::SHOW, Length::SHOW) == 0) {
 			OSCMessage Msg(m_pBuffer, nBytesReceived);
 
@@ -174,6 +185,18 @@ void ShowFileOSC::Run(void) {
 			return;
 		}
 
+		if (memcmp(&m_pBuffer[Length::PATH], Cmd::CHASE, Length::CHASE) == 0) {
+			OSCMessage Msg(m_pBuffer, nBytesReceived);
+
+			const int nValue = Msg.GetInt(0);
+
+			ShowFile::Get()->SetChase(nValue != 0);
+			SendStatus();
+
+			DEBUG_PRINTF("Chase %d", nValue != 0);
+			return;
+		}
+
 		if (memcmp(&m_pBuffer[Length::PATH], Cmd::BO, Length::BO) == 0) {
 			ShowFile::Get()->BlackOut();
 			SendStatus();
@@ -244,6 +244,7 @@ void ShowFileParams::callbackFunction(const char *pLine) {
 	HandleOptions(pLine, ShowFileParamsConst::OPTION_AUTO_START, ShowFileOptions::AUTO_START);
 	HandleOptions(pLine, ShowFileParamsConst::OPTION_LOOP, ShowFileOptions::LOOP);
 	HandleOptions(pLine, ShowFileParamsConst::OPTION_DISABLE_SYNC, ShowFileOptions::DISABLE_SYNC);
+	HandleOptions(pLine, ShowFileParamsConst::OPTION_CHASE, ShowFileOptions::CHASE);
 }
 
 void ShowFileParams::Builder(const struct TShowFileParams *ptShowFileParamss, char *pBuffer, uint32_t nLength, uint32_t &nSize) {
@@ -275,6 +276,7 @@ void ShowFileParams::Builder(const struct TShowFileParams *ptShowFileParamss, ch
 	builder.Add(ShowFileParamsConst::OPTION_AUTO_START, isOptionSet(ShowFileOptions::AUTO_START), isOptionSet(ShowFileOptions::AUTO_START));
 	builder.Add(ShowFileParamsConst::OPTION_LOOP, isOptionSet(ShowFileOptions::LOOP), isOptionSet(ShowFileOptions::LOOP));
 	builder.Add(ShowFileParamsConst::OPTION_DISABLE_SYNC, isOptionSet(ShowFileOptions::DISABLE_SYNC), isOptionSet(ShowFileOptions::DISABLE_SYNC));
+	builder.Add(ShowFileParamsConst::OPTION_CHASE, isOptionSet(ShowFileOptions::CHASE), isOptionSet(ShowFileOptions::CHASE));
 
 	builder.AddComment("OSC Server");
 	builder.Add(OscParamsConst::INCOMING_PORT, static_cast<uint32_t>(m_tShowFileParams.nOscPortIncoming), isMaskSet(ShowFileParamsMask::OSC_PORT_INCOMING));
@@ -333,6 +335,10 @@ void ShowFileParams::Set(void) {
 		ShowFile::Get()->DoLoop(true);
 	}
 
+	if (isOptionSet(ShowFileOptions::CHASE)) {
+		ShowFile::Get()->SetChase(true);
+	}
+
 	if (isOptionSet(ShowFileOptions::DISABLE_SYNC)) {
 		if (E131Controller::Get() != 0) {
 			E131Controller::Get()->SetSynchronizationAddress(0);
@@ -388,6 +394,9 @@ void ShowFileParams::Dump(void) {
 		if (isOptionSet(ShowFileOptions::DISABLE_SYNC)) {
 			printf("  Synchronization is disabled\n");
 		}
+		if (isOptionSet(ShowFileOptions::CHASE)) {
+			printf("  Timecode chase is enabled\n");
+		}
 	}
 
 	if (isMaskSet(ShowFileParamsMask::OSC_PORT_INCOMING)) {
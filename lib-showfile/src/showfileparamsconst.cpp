@@ -35,6 +35,7 @@ const char ShowFileParamsConst::DMX_MASTER[] = "dmx_master";
 const char ShowFileParamsConst::OPTION_AUTO_START[] = "auto_start";
 const char ShowFileParamsConst::OPTION_LOOP[] = "loop";
 const char ShowFileParamsConst::OPTION_DISABLE_SYNC[] = "disable_sync";
+const char ShowFileParamsConst::OPTION_CHASE[] = "chase";
 
 const char ShowFileParamsConst::PROTOCOL[] = "protocol";
 const char ShowFileParamsConst::SACN_SYNC_UNIVERSE[] = "sync_universe";
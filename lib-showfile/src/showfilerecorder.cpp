@@ -0,0 +1,307 @@
+/**
+ * @file showfilerecorder.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "showfilerecorder.h"
+#include "showfilebinary.h"
+#include "showfiledelta.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+ShowFileRecorder::ShowFileRecorder(void) {
+	DEBUG_ENTRY
+
+	m_pUniverses = new TUniverse[MAX_UNIVERSES];
+	assert(m_pUniverses != 0);
+
+	m_pStaging = new uint8_t[STAGING_SIZE];
+	assert(m_pStaging != 0);
+
+	memset(&m_tFrame, 0, sizeof(struct TShowFileBinaryFrame));
+
+	DEBUG_EXIT
+}
+
+ShowFileRecorder::~ShowFileRecorder(void) {
+	DEBUG_ENTRY
+
+	delete[] m_pStaging;
+	m_pStaging = 0;
+
+	delete[] m_pUniverses;
+	m_pUniverses = 0;
+
+	DEBUG_EXIT
+}
+
+bool ShowFileRecorder::Start(FILE *pFile) {
+	DEBUG_ENTRY
+	assert(pFile != 0);
+
+	m_pFile = pFile;
+
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		m_pUniverses[i].nLength = 0;
+	}
+
+	struct TShowFileBinaryHeader tHeader;
+
+	memset(&tHeader, 0, sizeof(struct TShowFileBinaryHeader));
+	memcpy(tHeader.aMagic, SHOWFILE_BINARY_MAGIC, ShowFileBinary::MAGIC_LENGTH);
+	tHeader.nVersion = ShowFileBinary::VERSION;
+	tHeader.nFlags = ShowFileBinary::FLAG_DELTA;
+
+	memcpy(m_pStaging, &tHeader, sizeof(struct TShowFileBinaryHeader));
+	m_nStaged = sizeof(struct TShowFileBinaryHeader);
+	m_nFrameOffset = FRAME_NONE;
+
+	m_nKeyFrames = 0;
+	m_nRecorded = 0;
+	m_nUnchanged = 0;
+	m_nDropped = 0;
+	m_nUntracked = 0;
+	m_nBytesWritten = 0;
+	m_bWriteError = false;
+
+	m_nStartMillis = Hardware::Get()->Millis();
+
+	DEBUG_EXIT
+	return Flush();
+}
+
+void ShowFileRecorder::Stop(void) {
+	DEBUG_ENTRY
+
+	if (m_pFile != 0) {
+		CloseFrame();
+		Flush();
+		m_pFile = 0;
+	}
+
+	DEBUG_EXIT
+}
+
+void ShowFileRecorder::Run(void) {
+	if (m_nStaged >= FLUSH_SIZE) {
+		CloseFrame();
+		Flush();
+	}
+}
+
+void ShowFileRecorder::Record(uint16_t nUniverse, const uint8_t *pData, uint16_t nLength) {
+	if ((m_pFile == 0) || (nLength == 0) || (nLength > ShowFileBinary::DMX_MAX_LENGTH)) {
+		return;
+	}
+
+	TUniverse *pUniverse = GetUniverse(nUniverse);
+
+	// Without previous data an untracked universe is always recorded as a full block
+	const bool bIsNew = (pUniverse == 0) || (pUniverse->nLength != nLength);
+
+	// A static look costs nothing
+	if (!bIsNew && (memcmp(pUniverse->data, pData, nLength) == 0)) {
+		m_nUnchanged++;
+		return;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis() - m_nStartMillis;
+
+	if ((m_nFrameOffset != FRAME_NONE) && (m_tFrame.nMillis != nMillis)) {
+		CloseFrame();
+	}
+
+	bool bKeyFrame = (m_nFrameOffset == FRAME_NONE) && ((m_nKeyFrames == 0) || ((nMillis - m_nKeyFrameMillis) >= KEYFRAME_INTERVAL_MILLIS));
+
+	const uint32_t nMaxSize = sizeof(struct TShowFileBinaryFrame) + sizeof(struct TShowFileBinaryUniverse) + nLength;
+
+	// The key frame is postponed until Run() has made room
+	if (bKeyFrame && ((m_nStaged + nMaxSize + GetKeyFrameSize()) > STAGING_SIZE)) {
+		bKeyFrame = false;
+	}
+
+	// Run() normally flushes long before the staging buffer is full, Record() must not block
+	if ((m_nStaged + nMaxSize) > STAGING_SIZE) {
+		m_nDropped++;
+		return;
+	}
+
+	if (m_nFrameOffset == FRAME_NONE) {
+		m_nFrameOffset = m_nStaged;
+		m_nStaged += static_cast<uint32_t>(sizeof(struct TShowFileBinaryFrame));
+
+		m_tFrame.nMillis = nMillis;
+		m_tFrame.nUniverses = 0;
+		m_tFrame.nFlags = 0;
+		m_tFrame.nSize = 0;
+
+		if (bKeyFrame) {
+			AddKeyFrame();
+		}
+	}
+
+	struct TShowFileBinaryUniverse tUniverse;
+	tUniverse.nUniverse = nUniverse;
+
+	uint8_t *pBlock = &m_pStaging[m_nStaged + sizeof(struct TShowFileBinaryUniverse)];
+	uint32_t nSize = 0;
+
+	if (!bIsNew) {
+		nSize = ShowFileDelta::Encode(pBlock, nLength, pUniverse->data, pData, nLength);
+	}
+
+	if (nSize != 0) {
+		tUniverse.nLength = static_cast<uint16_t>(nSize | ShowFileBinary::LENGTH_DELTA);
+	} else {
+		memcpy(pBlock, pData, nLength);
+		nSize = nLength;
+		tUniverse.nLength = nLength;
+	}
+
+	memcpy(&m_pStaging[m_nStaged], &tUniverse, sizeof(struct TShowFileBinaryUniverse));
+
+	nSize += static_cast<uint32_t>(sizeof(struct TShowFileBinaryUniverse));
+	m_nStaged += nSize;
+
+	m_tFrame.nUniverses++;
+	m_tFrame.nSize += nSize;
+
+	if (pUniverse != 0) {
+		memcpy(pUniverse->data, pData, nLength);
+		pUniverse->nLength = nLength;
+	} else {
+		m_nUntracked++;
+	}
+
+	m_nRecorded++;
+}
+
+void ShowFileRecorder::Print(void) {
+	puts("ShowFileRecorder");
+	printf(" Key frames: %u\n", m_nKeyFrames);
+	printf(" Recorded  : %u\n", m_nRecorded);
+	printf(" Unchanged : %u\n", m_nUnchanged);
+	printf(" Untracked : %u\n", m_nUntracked);
+	printf(" Dropped   : %u\n", m_nDropped);
+	printf(" Written   : %u bytes%s\n", m_nBytesWritten, m_bWriteError ? " [Write error]" : "");
+}
+
+ShowFileRecorder::TUniverse *ShowFileRecorder::GetUniverse(uint16_t nUniverse) {
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		if (m_pUniverses[i].nLength == 0) {
+			m_pUniverses[i].nUniverse = nUniverse;
+			return &m_pUniverses[i];
+		}
+
+		if (m_pUniverses[i].nUniverse == nUniverse) {
+			return &m_pUniverses[i];
+		}
+	}
+
+	return 0;
+}
+
+uint32_t ShowFileRecorder::GetKeyFrameSize(void) const {
+	uint32_t nSize = 0;
+
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		if (m_pUniverses[i].nLength == 0) {
+			break;
+		}
+
+		nSize += static_cast<uint32_t>(sizeof(struct TShowFileBinaryUniverse)) + m_pUniverses[i].nLength;
+	}
+
+	return nSize;
+}
+
+/*
+ * The open frame starts with the full data of every universe recorded so far,
+ * chase playback can seek to it.
+ */
+void ShowFileRecorder::AddKeyFrame(void) {
+	assert(m_nFrameOffset != FRAME_NONE);
+
+	for (uint32_t i = 0; i < MAX_UNIVERSES; i++) {
+		const TUniverse *pUniverse = &m_pUniverses[i];
+
+		if (pUniverse->nLength == 0) {
+			continue;
+		}
+
+		struct TShowFileBinaryUniverse tUniverse;
+		tUniverse.nUniverse = pUniverse->nUniverse;
+		tUniverse.nLength = pUniverse->nLength;
+
+		memcpy(&m_pStaging[m_nStaged], &tUniverse, sizeof(struct TShowFileBinaryUniverse));
+		m_nStaged += static_cast<uint32_t>(sizeof(struct TShowFileBinaryUniverse));
+
+		memcpy(&m_pStaging[m_nStaged], pUniverse->data, pUniverse->nLength);
+		m_nStaged += pUniverse->nLength;
+
+		m_tFrame.nUniverses++;
+		m_tFrame.nSize += static_cast<uint32_t>(sizeof(struct TShowFileBinaryUniverse)) + pUniverse->nLength;
+	}
+
+	m_tFrame.nFlags = ShowFileBinary::FRAME_KEY;
+	m_nKeyFrameMillis = m_tFrame.nMillis;
+	m_nKeyFrames++;
+}
+
+void ShowFileRecorder::CloseFrame(void) {
+	if (m_nFrameOffset != FRAME_NONE) {
+		memcpy(&m_pStaging[m_nFrameOffset], &m_tFrame, sizeof(struct TShowFileBinaryFrame));
+		m_nFrameOffset = FRAME_NONE;
+	}
+}
+
+/*
+ * Only whole frames are written, the open frame header is patched in the staging buffer
+ */
+bool ShowFileRecorder::Flush(void) {
+	assert(m_nFrameOffset == FRAME_NONE);
+
+	if ((m_pFile == 0) || (m_nStaged == 0)) {
+		return true;
+	}
+
+	const size_t nWritten = fwrite(m_pStaging, 1, m_nStaged, m_pFile);
+
+	m_nBytesWritten += static_cast<uint32_t>(nWritten);
+
+	if (nWritten != m_nStaged) {
+		DEBUG_PRINTF("nWritten=%u, m_nStaged=%u", static_cast<uint32_t>(nWritten), m_nStaged);
+		m_bWriteError = true;
+	}
+
+	m_nStaged = 0;
+
+	return !m_bWriteError;
+}
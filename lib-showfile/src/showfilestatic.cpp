@@ -65,6 +65,40 @@ bool ShowFile::ShowFileNameCopyTo(char *pShowFileName, uint32_t nLength, uint8_t
 	return false;
 }
 
+bool ShowFile::IndexFileNameCopyTo(char *pIndexFileName, uint32_t nLength, uint8_t nShowFileNumber) {
+	assert(nLength == ShowFileFile::NAME_LENGTH + 1);
+
+	if (nShowFileNumber < ShowFileFile::MAX_NUMBER) {
+		snprintf(pIndexFileName, nLength, "show%.2d" SHOWFILE_INDEX_SUFFIX, nShowFileNumber);
+		return true;
+	}
+
+	return false;
+}
+
+bool ShowFile::RecordFileNameCopyTo(char *pRecordFileName, uint32_t nLength, uint8_t nShowFileNumber) {
+	assert(nLength == ShowFileFile::NAME_LENGTH + 1);
+
+	if (nShowFileNumber < ShowFileFile::MAX_NUMBER) {
+		snprintf(pRecordFileName, nLength, "show%.2d" SHOWFILE_RECORD_SUFFIX, nShowFileNumber);
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * nType : 0 = Film (24fps), 1 = EBU (25fps), 2 = DF (29.97fps), 3 = SMPTE (30fps)
+ * Drop frame is handled as 30fps, the error is 3.6 seconds per hour.
+ */
+uint32_t ShowFile::TimeCodeToMillis(uint8_t nHours, uint8_t nMinutes, uint8_t nSeconds, uint8_t nFrames, uint8_t nType) {
+	static constexpr uint32_t FPS[4] = { 24, 25, 30, 30 };
+
+	const uint32_t nFps = FPS[nType & 0x3];
+
+	return (((static_cast<uint32_t>(nHours) * 60U + nMinutes) * 60U + nSeconds) * 1000U) + ((static_cast<uint32_t>(nFrames) * 1000U) / nFps);
+}
+
 bool ShowFile::CheckShowFileName(const char *pShowFileName, uint8_t &nShowFileNumber) {
 	DEBUG_PRINTF("pShowFileName=[%s]", pShowFileName);
 
@@ -48,6 +48,7 @@ public:
 	void Stop(uint8_t nPort = 0);
 
 	void SetData(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength);
+	void SetData(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength, const struct TLightSetRange &tRange);
 
 	void Blackout(bool bBlackout);
 
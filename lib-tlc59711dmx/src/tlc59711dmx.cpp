@@ -116,6 +116,17 @@ void TLC59711Dmx::SetData(__attribute__((unused)) uint8_t nPort, const uint8_t*
 	}
 }
 
+void TLC59711Dmx::SetData(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength, const struct TLightSetRange &tRange) {
+	const uint32_t nFirst = static_cast<uint32_t>(m_nDmxStartAddress - 1);
+
+	// No SPI update when none of our slots has changed
+	if ((m_pTLC59711 != 0) && ((tRange.nLast < nFirst) || (tRange.nFirst >= (nFirst + m_nDmxFootprint)))) {
+		return;
+	}
+
+	SetData(nPort, pDmxData, nLength);
+}
+
 void TLC59711Dmx::SetLEDType(TTLC59711Type tTLC59711Type) {
 	m_LEDType = tTLC59711Type;
 	UpdateMembers();
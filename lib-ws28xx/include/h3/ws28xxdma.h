@@ -42,9 +42,23 @@ public:
 	void Update(void);
 	void Blackout(void);
 
-	bool IsUpdating (void) { // returns TRUE while DMA operation is active
-		return h3_spi_dma_tx_is_active();
+	/*
+	 * With double buffering SetLED writes into the back buffer, which is never transmitted.
+	 * Only the single buffer fallback has to wait for the DMA operation.
+	 */
+	bool IsUpdating (void) {
+		return (m_pFrontBuffer == m_pBuffer) && h3_spi_dma_tx_is_active();
 	}
+
+private:
+	void WaitForCompletion(void) {
+		while (h3_spi_dma_tx_is_active()) {
+			// wait for completion
+		}
+	}
+
+private:
+	uint8_t *m_pFrontBuffer;	///< Being transmitted, equals m_pBuffer when there is no room for a back buffer
 };
 
 #endif /* WS28XXDMA_H_ */
@@ -24,6 +24,8 @@
 #ifndef RGBMAPPING_H_
 #define RGBMAPPING_H_
 
+#include <stdint.h>
+
 enum TRGBMapping {
 	RGB_MAPPING_RGB,
 	RGB_MAPPING_RBG,
@@ -38,6 +40,10 @@ class RGBMapping {
 public:
 	static TRGBMapping FromString(const char *pString);
 	static const char *ToString(TRGBMapping tRGBMapping);
+	/**
+	 * Position (0, 1 or 2) of each colour on the wire, undefined is RGB
+	 */
+	static void ToPosition(TRGBMapping tRGBMapping, uint32_t &nRed, uint32_t &nGreen, uint32_t &nBlue);
 };
 
 #endif /* RGBMAPPING_H_ */
@@ -115,8 +115,8 @@ public:
 	static float ConvertTxH(uint8_t nCode);
 	static uint8_t ConvertTxH(float fTxH);
 
-private:
-	void SetColorWS28xx(uint32_t nOffset, uint8_t nValue);
+protected:
+	void InitializeEncoder(void);
 
 protected:
 	TWS28XXType m_tLEDType;
@@ -131,6 +131,9 @@ protected:
 
 	alignas(uintptr_t) uint8_t *m_pBuffer;
 	alignas(uintptr_t) uint8_t *m_pBlackoutBuffer;
+
+	uint64_t *m_pEncodeTable;		///< RTZ only: the 8 SPI bytes for each colour value
+	uint32_t m_aColourOffset[3];	///< Red, Green and Blue byte offset within a pixel
 };
 
 #endif /* WS28XX_H_ */
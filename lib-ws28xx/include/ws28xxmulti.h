@@ -27,6 +27,7 @@
 #define WS28XXMULTI_H_
 
 #include <stdint.h>
+#include <cassert>
 
 #include "ws28xx.h"
 
@@ -77,34 +78,39 @@ public:
 		return m_tBoard;
 	}
 
+	/*
+	 * The pixels are collected per port, Update() encodes the whole frame
+	 */
 	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
-			SetLED8x(nPort, nLedIndex, nRed, nGreen, nBlue);
-		} else {
-			SetLED4x(nPort, nLedIndex, nRed, nGreen, nBlue);
-		}
+		assert(nPort < 8);
+		assert(nLedIndex < m_nLedCount);
+
+		uint8_t *pPixel = &m_pPixels[(nLedIndex * SINGLE_RGB) + nPort];
+
+		pPixel[m_aColourOffset[0]] = nRed;
+		pPixel[m_aColourOffset[1]] = nGreen;
+		pPixel[m_aColourOffset[2]] = nBlue;
 	}
 	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
-		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
-			SetLED8x(nPort, nLedIndex, nRed, nGreen, nBlue, nWhite);
-		} else {
-			SetLED4x(nPort, nLedIndex, nRed, nGreen, nBlue, nWhite);
-		}
-	}
+		assert(nPort < 8);
+		assert(nLedIndex < m_nLedCount);
+		assert(m_tWS28xxType == SK6812W);
 
-#if defined (H3)
-	bool IsUpdating(void) {
-		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
-			return h3_spi_dma_tx_is_active();  // returns TRUE while DMA operation is active
-		} else {
-			return false;
-		}
+		// GRBW
+		uint8_t *pPixel = &m_pPixels[(nLedIndex * SINGLE_RGBW) + nPort];
+
+		pPixel[0] = nGreen;
+		pPixel[8] = nRed;
+		pPixel[16] = nBlue;
+		pPixel[24] = nWhite;
 	}
-#else
+
+	/*
+	 * SetLED only writes the pixel staging buffer, Update() waits for a transfer still in progress
+	 */
 	bool IsUpdating(void) {
 		return false;
 	}
-#endif
 
 	void Update(void);
 	void Blackout(void);
@@ -119,14 +125,12 @@ private:
 	void SetupGPIO(void);
 	void SetupBuffers4x(void);
 	void Generate800kHz(const uint32_t *pBuffer);
-	void SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
-	void SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	void Encode4x(void);
 // 8x
 	void SetupHC595(uint8_t nT0H, uint8_t nT1H);
 	void SetupSPI(void);
 	void SetupBuffers8x(void);
-	void SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
-	void SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	void Encode8x(void);
 
 private:
 	WS28xxMultiBoard m_tBoard;
@@ -136,10 +140,13 @@ private:
 	uint8_t m_nLowCode;
 	uint8_t m_nHighCode;
 	uint32_t m_nBufSize;
+	uint32_t m_aColourOffset[3];	///< Red, Green and Blue offset within a pixel in m_pPixels
+	uint8_t *m_pPixels;				///< [LED][colour byte][port], same layout as the 8x output
 	uint32_t *m_pBuffer4x;
 	uint32_t *m_pBlackoutBuffer4x;
 
-	alignas(uintptr_t) uint8_t *m_pBuffer8x;
+	alignas(uintptr_t) uint8_t *m_pBuffer8x;		///< Back buffer, Encode8x() target
+	alignas(uintptr_t) uint8_t *m_pFrontBuffer8x;	///< Being transmitted, equals m_pBuffer8x when there is no room for a back buffer
 	alignas(uintptr_t) uint8_t *m_pBlackoutBuffer8x;
 };
 
@@ -35,7 +35,8 @@
 #include "debug.h"
 
 WS28xxDMA::WS28xxDMA(TWS28XXType Type, uint16_t nLEDCount, TRGBMapping tRGBMapping, uint8_t nT0H, uint8_t nT1H, uint32_t nClockSpeed):
-	WS28xx(Type, nLEDCount, tRGBMapping, nT0H, nT1H, nClockSpeed)
+	WS28xx(Type, nLEDCount, tRGBMapping, nT0H, nT1H, nClockSpeed),
+	m_pFrontBuffer(0)
 {
 	DEBUG_ENTRY
 
@@ -44,10 +45,13 @@ WS28xxDMA::WS28xxDMA(TWS28XXType Type, uint16_t nLEDCount, TRGBMapping tRGBMappi
 
 WS28xxDMA::~WS28xxDMA(void) {
 	m_pBlackoutBuffer = 0;
+	m_pFrontBuffer = 0;
 	m_pBuffer = 0;
 }
 
 bool WS28xxDMA::Initialize(void) {
+	InitializeEncoder();
+
 	uint32_t nSize;
 
 	m_pBuffer = const_cast<uint8_t*>(h3_spi_dma_tx_prepare(&nSize));
@@ -60,7 +64,19 @@ bool WS28xxDMA::Initialize(void) {
 		return false;
 	}
 
-	m_pBlackoutBuffer = m_pBuffer + (nSizeHalf & static_cast<uint32_t>(~3));
+	/*
+	 * Front, back and blackout buffer when they fit in the DMA region,
+	 * otherwise a single buffer and the blackout buffer.
+	 */
+	const uint32_t nSizeThird = (nSize / 3) & static_cast<uint32_t>(~3);
+
+	if (m_nBufSize <= nSizeThird) {
+		m_pFrontBuffer = m_pBuffer + nSizeThird;
+		m_pBlackoutBuffer = m_pFrontBuffer + nSizeThird;
+	} else {
+		m_pFrontBuffer = m_pBuffer;
+		m_pBlackoutBuffer = m_pBuffer + (nSizeHalf & static_cast<uint32_t>(~3));
+	}
 
 	if (m_tLEDType == APA102) {
 		memset(m_pBuffer, 0, 4);
@@ -74,23 +90,44 @@ bool WS28xxDMA::Initialize(void) {
 
 	memcpy(m_pBlackoutBuffer, m_pBuffer, m_nBufSize);
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer, m_pBlackoutBuffer);
+	if (m_pFrontBuffer != m_pBuffer) {
+		memcpy(m_pFrontBuffer, m_pBuffer, m_nBufSize);
+	}
+
+	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pFrontBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer, m_pFrontBuffer, m_pBlackoutBuffer);
 
 	Blackout();
 
 	return true;
 }
 
+/*
+ * Only blocks when the previous frame is still being transmitted.
+ */
 void WS28xxDMA::Update(void) {
 	assert(m_pBuffer != 0);
-	assert(!IsUpdating());
 
-	h3_spi_dma_tx_start(m_pBuffer, m_nBufSize);
+	WaitForCompletion();
+
+	if (m_pFrontBuffer == m_pBuffer) {
+		h3_spi_dma_tx_start(m_pBuffer, m_nBufSize);
+		return;
+	}
+
+	uint8_t *pBuffer = m_pFrontBuffer;
+	m_pFrontBuffer = m_pBuffer;
+	m_pBuffer = pBuffer;
+
+	h3_spi_dma_tx_start(m_pFrontBuffer, m_nBufSize);
+
+	// SetLED may update a part of the frame only
+	memcpy(m_pBuffer, m_pFrontBuffer, m_nBufSize);
 }
 
 void WS28xxDMA::Blackout(void) {
 	assert(m_pBlackoutBuffer != 0);
-	assert(!IsUpdating());
+
+	WaitForCompletion();
 
 	h3_spi_dma_tx_start(m_pBlackoutBuffer, m_nBufSize);
 }
@@ -39,14 +39,37 @@ uint8_t WS28xxMulti::ReverseBits(uint8_t nBits) {
 	return static_cast<uint8_t>((output >> 24));
 }
 
+/*
+ * 8x: the frame is encoded into the back buffer while the previous frame is still being transmitted.
+ * Only blocks when that transfer has not completed yet.
+ */
 void WS28xxMulti::Update(void) {
 	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
 		assert(m_pBuffer8x != 0);
-		assert(!h3_spi_dma_tx_is_active());
 
-		h3_spi_dma_tx_start(m_pBuffer8x, m_nBufSize);
+		if (m_pFrontBuffer8x == m_pBuffer8x) {
+			while (h3_spi_dma_tx_is_active()) {
+				// wait for completion
+			}
+			Encode8x();
+			h3_spi_dma_tx_start(m_pBuffer8x, m_nBufSize);
+			return;
+		}
+
+		Encode8x();
+
+		while (h3_spi_dma_tx_is_active()) {
+			// wait for completion
+		}
+
+		uint8_t *pBuffer = m_pFrontBuffer8x;
+		m_pFrontBuffer8x = m_pBuffer8x;
+		m_pBuffer8x = pBuffer;
+
+		h3_spi_dma_tx_start(m_pFrontBuffer8x, m_nBufSize);
 	} else {
 		assert(m_pBuffer4x != 0);
+		Encode4x();
 		Generate800kHz(m_pBuffer4x);
 	}
 }
@@ -56,7 +79,10 @@ void WS28xxMulti::Blackout(void) {
 
 	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
 		assert(m_pBlackoutBuffer8x != 0);
-		assert(!h3_spi_dma_tx_is_active());
+
+		while (h3_spi_dma_tx_is_active()) {
+			// wait for completion
+		}
 
 		h3_spi_dma_tx_start(m_pBlackoutBuffer8x, m_nBufSize);
 	} else {
@@ -54,11 +54,27 @@ void WS28xxMulti::SetupBuffers8x(void) {
 		return;
 	}
 
-	m_pBlackoutBuffer8x = m_pBuffer8x + (nSizeHalf & static_cast<uint32_t>(~3));
+	/*
+	 * Front, back and blackout buffer when they fit in the DMA region,
+	 * otherwise a single buffer and the blackout buffer.
+	 */
+	const uint32_t nSizeThird = (nSize / 3) & static_cast<uint32_t>(~3);
+
+	if (m_nBufSize <= nSizeThird) {
+		m_pFrontBuffer8x = m_pBuffer8x + nSizeThird;
+		m_pBlackoutBuffer8x = m_pFrontBuffer8x + nSizeThird;
+	} else {
+		m_pFrontBuffer8x = m_pBuffer8x;
+		m_pBlackoutBuffer8x = m_pBuffer8x + (nSizeHalf & static_cast<uint32_t>(~3));
+	}
 
 	memset(m_pBuffer8x, 0, m_nBufSize);
 	memcpy(m_pBlackoutBuffer8x, m_pBuffer8x, m_nBufSize);
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer8x, m_pBlackoutBuffer8x);
+	if (m_pFrontBuffer8x != m_pBuffer8x) {
+		memcpy(m_pFrontBuffer8x, m_pBuffer8x, m_nBufSize);
+	}
+
+	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pFrontBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer8x, m_pFrontBuffer8x, m_pBlackoutBuffer8x);
 	DEBUG_EXIT
 }
@@ -52,6 +52,7 @@ void WS28xxMulti::SetupBuffers4x(void) {
 }
 
 void WS28xxMulti::Update(void) {
+	Encode4x();
 	Generate800kHz(m_pBuffer4x);
 }
 
@@ -29,6 +29,16 @@
 
 constexpr char aMapping[RGB_MAPPING_UNDEFINED][4] = { "RGB", "RBG", "GRB", "GBR", "BRG", "BGR"};
 
+constexpr uint8_t aPosition[RGB_MAPPING_UNDEFINED][3] = {
+//    R, G, B
+	{ 0, 1, 2 },	// RGB
+	{ 0, 2, 1 },	// RBG
+	{ 1, 0, 2 },	// GRB
+	{ 2, 0, 1 },	// GBR
+	{ 1, 2, 0 },	// BRG
+	{ 2, 1, 0 }		// BGR
+};
+
 TRGBMapping RGBMapping::FromString(const char *pString) {
 	assert(pString != 0);
 
@@ -48,3 +58,11 @@ const char *RGBMapping::ToString(TRGBMapping tRGBMapping) {
 
 	return "Undefined";
 }
+
+void RGBMapping::ToPosition(TRGBMapping tRGBMapping, uint32_t &nRed, uint32_t &nGreen, uint32_t &nBlue) {
+	const uint32_t nIndex = (tRGBMapping < RGB_MAPPING_UNDEFINED) ? static_cast<uint32_t>(tRGBMapping) : static_cast<uint32_t>(RGB_MAPPING_RGB);
+
+	nRed = aPosition[nIndex][0];
+	nGreen = aPosition[nIndex][1];
+	nBlue = aPosition[nIndex][2];
+}
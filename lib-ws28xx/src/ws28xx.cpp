@@ -31,6 +31,7 @@
 #include <cassert>
 
 #include "ws28xx.h"
+#include "ws28xx_internal.h"
 
 #include "rgbmapping.h"
 
@@ -48,7 +49,8 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 	m_nLowCode(nT0H),
 	m_nHighCode(nT1H),
 	m_pBuffer(0),
-	m_pBlackoutBuffer(0)
+	m_pBlackoutBuffer(0),
+	m_pEncodeTable(0)
 {
 	assert(m_nLedCount != 0);
 
@@ -132,6 +134,11 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 }
 
 WS28xx::~WS28xx(void) {
+	if (m_pEncodeTable != 0) {
+		delete [] m_pEncodeTable;
+		m_pEncodeTable = 0;
+	}
+
 	if (m_pBlackoutBuffer != 0) {
 		delete [] m_pBlackoutBuffer;
 		m_pBlackoutBuffer = 0;
@@ -144,6 +151,8 @@ WS28xx::~WS28xx(void) {
 }
 
 bool WS28xx::Initialize(void) {
+	InitializeEncoder();
+
 	assert(m_pBuffer == 0);
 	m_pBuffer = new uint8_t[m_nBufSize];
 	assert(m_pBuffer != 0);
@@ -175,6 +184,26 @@ bool WS28xx::Initialize(void) {
 	return true;
 }
 
+void WS28xx::InitializeEncoder(void) {
+	if (!m_bIsRTZProtocol) {
+		return;
+	}
+
+	if (m_pEncodeTable == 0) {
+		m_pEncodeTable = new uint64_t[256];
+		assert(m_pEncodeTable != 0);
+	}
+
+	rtz_encode_table(m_pEncodeTable, m_nLowCode, m_nHighCode);
+
+	// Resolve the RGB mapping once, SetLED only needs the byte offset of each colour
+	RGBMapping::ToPosition(m_tRGBMapping, m_aColourOffset[0], m_aColourOffset[1], m_aColourOffset[2]);
+
+	for (uint32_t i = 0; i < 3; i++) {
+		m_aColourOffset[i] *= 8;
+	}
+}
+
 void WS28xx::Update(void) {
 	assert (m_pBuffer != 0);
 	FUNC_PREFIX(spi_writenb(reinterpret_cast<char *>(m_pBuffer), m_nBufSize));
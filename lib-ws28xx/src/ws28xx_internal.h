@@ -0,0 +1,54 @@
+/**
+ * @file ws28xx_internal.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS28XX_INTERNAL_H_
+#define WS28XX_INTERNAL_H_
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * RTZ, the 8 SPI bytes for each colour value, MSB first
+ */
+inline static void rtz_encode_table(uint64_t *pTable, uint8_t nLowCode, uint8_t nHighCode) {
+	for (uint32_t nValue = 0; nValue < 256; nValue++) {
+		uint8_t *p = reinterpret_cast<uint8_t *>(&pTable[nValue]);
+
+		for (uint32_t nMask = 0x80; nMask != 0; nMask >>= 1) {
+			*p++ = (nValue & nMask) ? nHighCode : nLowCode;
+		}
+	}
+}
+
+/*
+ * pColourOffset is the Red, Green and Blue byte offset within the 24 pixel bytes
+ */
+inline static void rtz_encode(uint8_t *pPixel, const uint64_t *pTable, const uint32_t *pColourOffset, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	memcpy(&pPixel[pColourOffset[0]], &pTable[nRed], 8);
+	memcpy(&pPixel[pColourOffset[1]], &pTable[nGreen], 8);
+	memcpy(&pPixel[pColourOffset[2]], &pTable[nBlue], 8);
+}
+
+#endif /* WS28XX_INTERNAL_H_ */
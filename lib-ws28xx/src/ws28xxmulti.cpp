@@ -28,6 +28,7 @@
 #endif
 
 #include <stdint.h>
+#include <string.h>
 #include <cassert>
 
 #include "ws28xxmulti.h"
@@ -44,9 +45,11 @@ WS28xxMulti::WS28xxMulti(void):
 	m_nLowCode(0),
 	m_nHighCode(0),
 	m_nBufSize(0),
+	m_pPixels(0),
 	m_pBuffer4x(0),
 	m_pBlackoutBuffer4x(0),
 	m_pBuffer8x(0),
+	m_pFrontBuffer8x(0),
 	m_pBlackoutBuffer8x(0)
 {
 	DEBUG_ENTRY
@@ -58,6 +61,9 @@ WS28xxMulti::WS28xxMulti(void):
 }
 
 WS28xxMulti::~WS28xxMulti(void) {
+	delete[] m_pPixels;
+	m_pPixels = 0;
+
 	if (m_tBoard == WS28XXMULTI_BOARD_4X) {
 		delete[] m_pBlackoutBuffer4x;
 		m_pBlackoutBuffer4x = 0;
@@ -66,6 +72,7 @@ WS28xxMulti::~WS28xxMulti(void) {
 		m_pBuffer4x = 0;
 	} else {
 		m_pBlackoutBuffer8x = 0;
+		m_pFrontBuffer8x = 0;
 		m_pBuffer8x = 0;
 	}
 }
@@ -112,6 +119,18 @@ void WS28xxMulti::Initialize(TWS28XXType tWS28xxType, uint16_t nLedCount, __attr
 	DEBUG_PRINTF("m_tWS28xxType=%d (%s), m_nLedCount=%d, m_nBufSize=%d", m_tWS28xxType, WS28xx::GetLedTypeString(m_tWS28xxType), m_nLedCount, m_nBufSize);
 	DEBUG_PRINTF("m_tRGBMapping=%d (%s), m_nLowCode=0x%X, m_nHighCode=0x%X", m_tRGBMapping, RGBMapping::ToString(m_tRGBMapping), m_nLowCode, m_nHighCode);
 
+	RGBMapping::ToPosition(m_tRGBMapping, m_aColourOffset[0], m_aColourOffset[1], m_aColourOffset[2]);
+
+	for (uint32_t i = 0; i < 3; i++) {
+		m_aColourOffset[i] *= 8;
+	}
+
+	assert(m_pPixels == 0);
+	m_pPixels = new uint8_t[m_nBufSize];
+	assert(m_pPixels != 0);
+
+	memset(m_pPixels, 0, m_nBufSize);
+
 	if (m_tBoard == WS28XXMULTI_BOARD_4X) {
 		SetupMCP23017(ReverseBits(m_nLowCode), ReverseBits(m_nHighCode));
 		if (bUseSI5351A) {
@@ -28,6 +28,7 @@
 #include <cassert>
 
 #include "ws28xxmulti.h"
+#include "ws28xxmulti_internal.h"
 
 #include "si5351a.h"
 #include "mcp23017.h"
@@ -106,177 +107,9 @@ bool WS28xxMulti::SetupMCP23017(uint8_t nT0H, uint8_t nT1H) {
 	return true;
 }
 
-#define BIT_SET(a,b) 	((a) |= (1U<<(b)))
-#define BIT_CLEAR(a,b) 	((a) &= ~(1U<<(b)))
+void WS28xxMulti::Encode4x(void) {
+	assert(m_pPixels != 0);
+	assert(m_pBuffer4x != 0);
 
-void WS28xxMulti::SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-	assert(nPort < 4);
-	assert(nLedIndex < m_nLedCount);
-
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGB);
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_RBG:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GRB:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GBR:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BRG:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BGR:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			break;
-		default:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		}
-
-		j++;
-	}
-}
-
-void WS28xxMulti::SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
-	assert(nPort < 4);
-	assert(nLedIndex < m_nLedCount);
-	assert(m_tWS28xxType == SK6812W);
-
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGBW);
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		// GRBW
-		if (mask & nGreen) {
-			BIT_SET(m_pBuffer4x[k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-		}
-
-		if (mask & nRed) {
-			BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-		}
-
-		if (mask & nBlue) {
-			BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-		}
-
-		if (mask & nWhite) {
-			BIT_SET(m_pBuffer4x[24 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer4x[24 + k + j], nPort);
-		}
-
-		j++;
-	}
+	encode4x(m_pBuffer4x, m_pPixels, m_nBufSize);
 }
@@ -28,6 +28,7 @@
 #include <cassert>
 
 #include "ws28xxmulti.h"
+#include "ws28xxmulti_internal.h"
 
 #include "hal_gpio.h"
 #include "hal_spi.h"
@@ -68,177 +69,9 @@ void WS28xxMulti::SetupSPI(void) {
 	DEBUG_EXIT
 }
 
-#define BIT_SET(a,b) 	((a) |= (1<<(b)))
-#define BIT_CLEAR(a,b) 	((a) &= ~(1<<(b)))
-
-void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-	assert(nPort < 8);
-	assert(nLedIndex < m_nLedCount);
-
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGB);
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_RBG:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GRB:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GBR:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BRG:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BGR:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			break;
-		default:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		}
-
-		j++;
-	}
-}
+void WS28xxMulti::Encode8x(void) {
+	assert(m_pPixels != 0);
+	assert(m_pBuffer8x != 0);
 
-void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
-	assert(nPort < 8);
-	assert(nLedIndex < m_nLedCount);
-	assert(m_tWS28xxType == SK6812W);
-
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGBW);
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		// GRBW
-		if (mask & nGreen) {
-			BIT_SET(m_pBuffer8x[k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-		}
-
-		if (mask & nRed) {
-			BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-		}
-
-		if (mask & nBlue) {
-			BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-		}
-
-		if (mask & nWhite) {
-			BIT_SET(m_pBuffer8x[24 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[24 + k + j], nPort);
-		}
-
-		j++;
-	}
+	encode8x(m_pBuffer8x, m_pPixels, m_nBufSize);
 }
@@ -0,0 +1,78 @@
+/**
+ * @file ws28xxmulti_internal.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS28XXMULTI_INTERNAL_H_
+#define WS28XXMULTI_INTERNAL_H_
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * In : byte n is the colour byte for port n
+ * Out: byte n holds bit (7 - n) of all 8 ports, port n in bit n
+ */
+inline static uint64_t transpose8x8(uint64_t x) {
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
+	return __builtin_bswap64(x);
+}
+
+/*
+ * 8 ports, each output byte is one bit period of all ports
+ */
+inline static void encode8x(uint8_t *pOut, const uint8_t *pPixels, uint32_t nSize) {
+	for (uint32_t i = 0; i < nSize; i += 8) {
+		uint64_t nBits;
+
+		memcpy(&nBits, &pPixels[i], 8);
+		nBits = transpose8x8(nBits);
+		memcpy(&pOut[i], &nBits, 8);
+	}
+}
+
+/*
+ * 4 ports, port n is output bit n. The non data bits (PULSE) are kept.
+ */
+inline static void encode4x(uint32_t *pOut, const uint8_t *pPixels, uint32_t nSize) {
+	for (uint32_t i = 0; i < nSize; i += 8) {
+		uint64_t nBits;
+
+		memcpy(&nBits, &pPixels[i], 8);
+		nBits = transpose8x8(nBits);
+
+		for (uint32_t j = 0; j < 8; j++) {
+			pOut[i + j] = (pOut[i + j] & ~0x0FU) | (static_cast<uint32_t>(nBits >> (j * 8)) & 0x0FU);
+		}
+	}
+}
+
+#endif /* WS28XXMULTI_INTERNAL_H_ */
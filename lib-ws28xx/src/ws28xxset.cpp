@@ -24,9 +24,11 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <cassert>
 
 #include "ws28xx.h"
+#include "ws28xx_internal.h"
 #include "rgbmapping.h"
 
 void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
@@ -36,46 +38,10 @@ void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nB
 	assert(nLEDIndex < m_nLedCount);
 
 	if (__builtin_expect((m_bIsRTZProtocol), 1)) {
-		uint32_t nOffset = nLEDIndex * 3;
-		nOffset *= 8;
-
-		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
-		case RGB_MAPPING_RBG:
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nBlue);
-			SetColorWS28xx(nOffset + 16, nGreen);
-			break;
-		case RGB_MAPPING_GRB:
-			SetColorWS28xx(nOffset, nGreen);
-			SetColorWS28xx(nOffset + 8, nRed);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
-		case RGB_MAPPING_GBR:
-			SetColorWS28xx(nOffset, nGreen);
-			SetColorWS28xx(nOffset + 8, nBlue);
-			SetColorWS28xx(nOffset + 16, nRed);
-			break;
-		case RGB_MAPPING_BRG:
-			SetColorWS28xx(nOffset, nBlue);
-			SetColorWS28xx(nOffset + 8, nRed);
-			SetColorWS28xx(nOffset + 16, nGreen);
-			break;
-		case RGB_MAPPING_BGR:
-			SetColorWS28xx(nOffset, nBlue);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nRed);
-			break;
-		default:  // RGB
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
-		}
+		assert(m_pEncodeTable != 0);
+		assert((nLEDIndex * 24) + 23 < m_nBufSize);
+
+		rtz_encode(&m_pBuffer[nLEDIndex * 24], m_pEncodeTable, m_aColourOffset, nRed, nGreen, nBlue);
 
 		return;
 	}
@@ -125,30 +91,19 @@ void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nB
 	assert(nLEDIndex < m_nLedCount);
 	assert(m_tLEDType == SK6812W);
 
-	uint32_t nOffset = nLEDIndex * 4;
-
-	if (m_tLEDType == SK6812W) {
-		nOffset *= 8;
-
-		SetColorWS28xx(nOffset, nGreen);
-		SetColorWS28xx(nOffset + 8, nRed);
-		SetColorWS28xx(nOffset + 16, nBlue);
-		SetColorWS28xx(nOffset + 24, nWhite);
+	if (__builtin_expect((m_tLEDType != SK6812W), 0)) {
+		return;
 	}
-}
 
-void WS28xx::SetColorWS28xx(uint32_t nOffset, uint8_t nValue) {
-	assert(m_tLEDType != WS2801);
-	assert(nOffset + 7 < m_nBufSize);
+	assert(m_pEncodeTable != 0);
+	assert((nLEDIndex * 32) + 31 < m_nBufSize);
 
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		if (nValue & mask) {
-			m_pBuffer[nOffset] = m_nHighCode;
-		} else {
-			m_pBuffer[nOffset] = m_nLowCode;
-		}
-		nOffset++;
-	}
+	uint8_t *pPixel = &m_pBuffer[nLEDIndex * 32];
+
+	memcpy(&pPixel[0], &m_pEncodeTable[nGreen], 8);
+	memcpy(&pPixel[8], &m_pEncodeTable[nRed], 8);
+	memcpy(&pPixel[16], &m_pEncodeTable[nBlue], 8);
+	memcpy(&pPixel[24], &m_pEncodeTable[nWhite], 8);
 }
 
 void WS28xx::SetGlobalBrightness(uint8_t nGlobalBrightness) {
@@ -42,6 +42,7 @@ public:
 	void Stop(uint8_t nPort = 0);
 
 	virtual void SetData(uint8_t nPort, const uint8_t*, uint16_t);
+	virtual void SetData(uint8_t nPort, const uint8_t*, uint16_t, const struct TLightSetRange &);
 
 	void Blackout(bool bBlackout);
 
@@ -39,6 +39,9 @@ public:
 	void Start(uint8_t nPort = 0);
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLenght);
+	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLenght, __attribute__((unused)) const struct TLightSetRange &tRange) {
+		SetData(nPort, pData, nLenght);
+	}
 
 	void SetLEDType(TWS28XXType tLedType);
 	void SetLEDCount(uint16_t nLedCount);
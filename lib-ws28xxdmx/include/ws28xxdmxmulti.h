@@ -50,6 +50,7 @@ public:
 	void Stop(uint8_t nPort);
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength);
+	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength, const struct TLightSetRange &tRange);
 
 	void Blackout(bool bBlackout);
 
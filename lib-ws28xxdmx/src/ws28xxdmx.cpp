@@ -106,6 +106,11 @@ void WS28xxDmx::Stop(__attribute__((unused)) uint8_t nPort) {
 }
 
 void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
+	const struct TLightSetRange tRange = { 0, DMX_UNIVERSE_SIZE - 1 };
+	SetData(nPortId, pData, nLength, tRange);
+}
+
+void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, const struct TLightSetRange &tRange) {
 	assert(pData != 0);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
@@ -147,6 +152,19 @@ void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength)
 #endif
 #endif
 
+	// Only the pixels covering the changed slots are encoded again
+	if (tRange.nLast < i) {
+		endIndex = beginIndex;
+	} else {
+		endIndex = MIN(endIndex, beginIndex + ((tRange.nLast - i) / m_nChannelsPerLed) + 1);
+
+		if (tRange.nFirst > i) {
+			const uint32_t nSkip = (tRange.nFirst - i) / m_nChannelsPerLed;
+			beginIndex += nSkip;
+			i += nSkip * m_nChannelsPerLed;
+		}
+	}
+
 	while (m_pLEDStripe->IsUpdating()) {
 		// wait for completion
 	}
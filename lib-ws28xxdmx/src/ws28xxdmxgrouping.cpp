@@ -32,6 +32,7 @@
 #include "ws28xx.h"
 
 #include "lightset.h"
+#include "lightsetmerge.h"
 #include "lightsetdisplay.h"
 
 #include "debug.h"
@@ -65,13 +66,12 @@ void WS28xxDmxGrouping::SetData(__attribute__((unused)) uint8_t nPort, const uin
 		// wait for completion
 	}
 
+	const uint32_t nOffset = static_cast<uint32_t>(m_nDmxStartAddress - 1);
 	bool bIsChanged = false;
 
-	for (uint32_t i = static_cast<uint32_t>(m_nDmxStartAddress - 1), j = 0; (i < nLength) && (j < m_nDmxFootprint); i++, j++) {
-		if (pData[i] != m_pDmxData[j]) {
-			m_pDmxData[j] = pData[i];
-			bIsChanged = true;
-		}
+	if (nOffset < nLength) {
+		const uint32_t nSlots = nLength - nOffset;
+		bIsChanged = LightSetMerge::Copy(m_pDmxData, &pData[nOffset], nSlots < m_nDmxFootprint ? nSlots : m_nDmxFootprint);
 	}
 
 	if (bIsChanged) {
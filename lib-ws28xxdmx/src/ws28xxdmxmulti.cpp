@@ -122,6 +122,11 @@ void WS28xxDmxMulti::Stop(__attribute__((unused)) uint8_t nPort) {
 }
 
 void WS28xxDmxMulti::SetData(uint8_t nPortId, const uint8_t* pData, uint16_t nLength) {
+	const struct TLightSetRange tRange = { 0, DMX_UNIVERSE_SIZE - 1 };
+	SetData(nPortId, pData, nLength, tRange);
+}
+
+void WS28xxDmxMulti::SetData(uint8_t nPortId, const uint8_t* pData, uint16_t nLength, const struct TLightSetRange &tRange) {
 	assert(pData != 0);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 	assert(m_pLEDStripe != 0);
@@ -163,6 +168,15 @@ void WS28xxDmxMulti::SetData(uint8_t nPortId, const uint8_t* pData, uint16_t nLe
 			static_cast<int>(nPortId), static_cast<int>(nLength), static_cast<int>(nOutIndex),
 			static_cast<int>(nPortId) & ~m_nUniverses & 0x03, static_cast<int>(beginIndex), static_cast<int>(endIndex));
 
+	// Only the pixels covering the changed slots are encoded again
+	endIndex = MIN(endIndex, beginIndex + (tRange.nLast / m_nChannelsPerLed) + 1);
+
+	if (tRange.nFirst != 0) {
+		const uint32_t nSkip = tRange.nFirst / m_nChannelsPerLed;
+		beginIndex += nSkip;
+		i = nSkip * m_nChannelsPerLed;
+	}
+
 	while (m_pLEDStripe->IsUpdating()) {
 		// wait for completion
 	}
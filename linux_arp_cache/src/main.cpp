@@ -0,0 +1,392 @@
+/**
+ * @file main.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "net_packets.h"
+
+/*
+ * As in arp_cache.c
+ */
+static constexpr uint32_t ARP_RECORDS = 64;
+static constexpr uint32_t ARP_QUEUE_ENTRIES = 4;
+static constexpr uint32_t RETRY_TICKS = 5;
+static constexpr uint32_t MAX_RETRIES = 3;
+static constexpr uint32_t REFRESH_TICKS = 3000;
+
+static constexpr uint32_t FRAME_SIZE = 64;
+
+extern "C" {
+void arp_cache_init(void);
+void arp_cache_update(const uint8_t *, uint32_t);
+uint32_t arp_cache_lookup(uint32_t, uint8_t *);
+int arp_cache_send(void *, uint32_t, uint32_t);
+void arp_cache_timer(void);
+}
+
+static uint32_t s_nRequests;
+static uint32_t s_nRequestIp;
+static uint32_t s_nSent;
+static uint8_t s_aSentDst[ETH_ADDR_LEN];
+static uint32_t s_nSentSize;
+
+static uint32_t s_nChecks;
+static uint32_t s_nFailed;
+
+extern "C" {
+void arp_send_request(uint32_t nIp) {
+	s_nRequests++;
+	s_nRequestIp = nIp;
+}
+
+void emac_eth_send(void *pFrame, int nSize) {
+	s_nSent++;
+	memcpy(s_aSentDst, reinterpret_cast<struct ether_packet *>(pFrame)->dst, ETH_ADDR_LEN);
+	s_nSentSize = static_cast<uint32_t>(nSize);
+}
+}
+
+#define CHECK(c)	check((c), #c, __func__, __LINE__)
+
+static void check(bool bCondition, const char *pCondition, const char *pFunction, int nLine) {
+	s_nChecks++;
+
+	if (!bCondition) {
+		s_nFailed++;
+		printf("%s:%d: %s\n", pFunction, nLine, pCondition);
+	}
+}
+
+/*
+ * Network byte order, as in lib-h3/net
+ */
+static uint32_t ip(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+	return static_cast<uint32_t>(a) | static_cast<uint32_t>(b << 8) | static_cast<uint32_t>(c << 16) | static_cast<uint32_t>(d << 24);
+}
+
+static void mac(uint8_t *pMac, uint8_t nLast) {
+	const uint8_t aMac[ETH_ADDR_LEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, nLast };
+	memcpy(pMac, aMac, ETH_ADDR_LEN);
+}
+
+static void reset(void) {
+	arp_cache_init();
+
+	s_nRequests = 0;
+	s_nRequestIp = 0;
+	s_nSent = 0;
+	s_nSentSize = 0;
+	memset(s_aSentDst, 0, ETH_ADDR_LEN);
+}
+
+static int send(uint32_t nIp, uint32_t nSize = FRAME_SIZE) {
+	static uint8_t aFrame[sizeof(struct t_udp) + 1];
+	return arp_cache_send(aFrame, nSize, nIp);
+}
+
+static void ticks(uint32_t nTicks) {
+	for (uint32_t i = 0; i < nTicks; i++) {
+		arp_cache_timer();
+	}
+}
+
+static void test_resolve(void) {
+	reset();
+
+	const uint32_t nIp = ip(192, 168, 2, 10);
+	uint8_t aMac[ETH_ADDR_LEN];
+	uint8_t aLookup[ETH_ADDR_LEN];
+
+	mac(aMac, 10);
+
+	CHECK(arp_cache_lookup(nIp, aLookup) == 0);
+	CHECK(s_nRequests == 0);
+
+	CHECK(send(nIp) == 0);
+	CHECK(send(nIp) == 0);
+	CHECK(s_nRequests == 1);
+	CHECK(s_nRequestIp == nIp);
+	CHECK(s_nSent == 0);
+	CHECK(arp_cache_lookup(nIp, aLookup) == 0);
+
+	arp_cache_update(aMac, nIp);
+
+	CHECK(s_nSent == 2);
+	CHECK(s_nSentSize == FRAME_SIZE);
+	CHECK(memcmp(s_aSentDst, aMac, ETH_ADDR_LEN) == 0);
+	CHECK(arp_cache_lookup(nIp, aLookup) == nIp);
+	CHECK(memcmp(aLookup, aMac, ETH_ADDR_LEN) == 0);
+
+	/* Resolved, sent at once */
+	CHECK(send(nIp) == 0);
+	CHECK(s_nSent == 3);
+	CHECK(s_nRequests == 1);
+
+	/* A reply for an address that is not in the cache is stored */
+	mac(aMac, 11);
+	arp_cache_update(aMac, ip(192, 168, 2, 11));
+	CHECK(arp_cache_lookup(ip(192, 168, 2, 11), aLookup) == ip(192, 168, 2, 11));
+	CHECK(s_nSent == 3);
+}
+
+static void test_multicast(void) {
+	reset();
+
+	const uint32_t nIp = ip(239, 255, 0, 1);
+	const uint8_t aExpected[ETH_ADDR_LEN] = { 0x01, 0x00, 0x5E, 0x7F, 0x00, 0x01 };
+	uint8_t aLookup[ETH_ADDR_LEN];
+
+	CHECK(arp_cache_lookup(nIp, aLookup) == nIp);
+	CHECK(memcmp(aLookup, aExpected, ETH_ADDR_LEN) == 0);
+
+	CHECK(send(nIp) == 0);
+	CHECK(s_nSent == 1);
+	CHECK(s_nRequests == 0);
+}
+
+static void test_queue(void) {
+	reset();
+
+	for (uint32_t i = 0; i < ARP_QUEUE_ENTRIES; i++) {
+		CHECK(send(ip(10, 0, 0, static_cast<uint8_t>(i + 1))) == 0);
+	}
+
+	CHECK(s_nRequests == ARP_QUEUE_ENTRIES);
+	CHECK(send(ip(10, 0, 0, 1)) == -1);
+
+	/* The record is made, the frame is dropped */
+	CHECK(send(ip(10, 0, 0, 100)) == -1);
+	CHECK(s_nRequests == ARP_QUEUE_ENTRIES + 1);
+
+	uint8_t aMac[ETH_ADDR_LEN];
+	mac(aMac, 1);
+	arp_cache_update(aMac, ip(10, 0, 0, 1));
+	CHECK(s_nSent == 1);
+
+	/* There is room again, but not for a frame larger than the queue entry */
+	CHECK(send(ip(10, 0, 0, 100), sizeof(struct t_udp) + 1) == -1);
+	CHECK(send(ip(10, 0, 0, 100)) == 0);
+
+	mac(aMac, 100);
+	arp_cache_update(aMac, ip(10, 0, 0, 100));
+	CHECK(s_nSent == 2);
+	CHECK(memcmp(s_aSentDst, aMac, ETH_ADDR_LEN) == 0);
+}
+
+static void test_retry(void) {
+	reset();
+
+	const uint32_t nIp = ip(10, 0, 0, 1);
+	uint8_t aMac[ETH_ADDR_LEN];
+	uint8_t aLookup[ETH_ADDR_LEN];
+
+	mac(aMac, 1);
+
+	CHECK(send(nIp) == 0);
+	CHECK(s_nRequests == 1);
+
+	ticks(RETRY_TICKS - 1);
+	CHECK(s_nRequests == 1);
+
+	ticks(1);
+	CHECK(s_nRequests == 2);
+
+	ticks((RETRY_TICKS * MAX_RETRIES) - 1 - RETRY_TICKS);
+	CHECK(s_nRequests == 1 + MAX_RETRIES - 1);
+
+	/* A late reply still flushes the queue */
+	ticks(1);
+	CHECK(s_nRequests == 1 + MAX_RETRIES);
+	ticks(RETRY_TICKS - 1);
+
+	arp_cache_update(aMac, nIp);
+	CHECK(s_nSent == 1);
+
+	/* No reply at all, the record and the queued frame are dropped */
+	const uint32_t nIpNoReply = ip(10, 0, 0, 2);
+
+	CHECK(send(nIpNoReply) == 0);
+	ticks(RETRY_TICKS * (MAX_RETRIES + 1));
+	CHECK(s_nRequests == (1 + MAX_RETRIES) * 2);
+
+	ticks(RETRY_TICKS * 4);
+	CHECK(s_nRequests == (1 + MAX_RETRIES) * 2);
+
+	mac(aMac, 2);
+	arp_cache_update(aMac, nIpNoReply);
+	CHECK(s_nSent == 1);
+	CHECK(arp_cache_lookup(nIpNoReply, aLookup) == nIpNoReply);
+}
+
+static void test_aging(void) {
+	reset();
+
+	const uint32_t nIpUnused = ip(10, 0, 0, 1);
+	const uint32_t nIpUsed = ip(10, 0, 0, 2);
+	uint8_t aMac[ETH_ADDR_LEN];
+	uint8_t aLookup[ETH_ADDR_LEN];
+
+	mac(aMac, 1);
+	arp_cache_update(aMac, nIpUnused);
+	mac(aMac, 2);
+	arp_cache_update(aMac, nIpUsed);
+
+	/* Only one is used */
+	ticks(1);
+	CHECK(arp_cache_lookup(nIpUsed, aLookup) == nIpUsed);
+
+	ticks(REFRESH_TICKS - 2);
+	CHECK(s_nRequests == 0);
+
+	ticks(1);
+	CHECK(s_nRequests == 1);
+	CHECK(s_nRequestIp == nIpUsed);
+	CHECK(arp_cache_lookup(nIpUnused, aLookup) == 0);
+
+	/* Refreshing, still valid */
+	CHECK(arp_cache_lookup(nIpUsed, aLookup) == nIpUsed);
+	CHECK(send(nIpUsed) == 0);
+	CHECK(s_nSent == 1);
+
+	/* Confirmed */
+	arp_cache_update(aMac, nIpUsed);
+	ticks(RETRY_TICKS * (MAX_RETRIES + 1));
+	CHECK(s_nRequests == 1);
+	CHECK(arp_cache_lookup(nIpUsed, aLookup) == nIpUsed);
+
+	/* Refreshed again, no reply, freed */
+	ticks(REFRESH_TICKS - (RETRY_TICKS * (MAX_RETRIES + 1)));
+	CHECK(s_nRequests == 2);
+	ticks(RETRY_TICKS * MAX_RETRIES);
+	CHECK(s_nRequests == 2 + MAX_RETRIES);
+	CHECK(arp_cache_lookup(nIpUsed, aLookup) == nIpUsed);
+	ticks(RETRY_TICKS);
+	CHECK(arp_cache_lookup(nIpUsed, aLookup) == 0);
+}
+
+static void test_eviction(void) {
+	reset();
+
+	uint8_t aMac[ETH_ADDR_LEN];
+	uint8_t aLookup[ETH_ADDR_LEN];
+
+	for (uint32_t i = 0; i < ARP_RECORDS; i++) {
+		mac(aMac, static_cast<uint8_t>(i));
+		arp_cache_update(aMac, ip(10, 0, 1, static_cast<uint8_t>(i)));
+	}
+
+	/* All used, except for .5 */
+	ticks(1);
+
+	for (uint32_t i = 0; i < ARP_RECORDS; i++) {
+		if (i != 5) {
+			CHECK(arp_cache_lookup(ip(10, 0, 1, static_cast<uint8_t>(i)), aLookup) != 0);
+		}
+	}
+
+	mac(aMac, 0xFF);
+	arp_cache_update(aMac, ip(10, 0, 2, 1));
+
+	CHECK(arp_cache_lookup(ip(10, 0, 2, 1), aLookup) == ip(10, 0, 2, 1));
+	CHECK(arp_cache_lookup(ip(10, 0, 1, 5), aLookup) == 0);
+
+	uint32_t nFound = 0;
+
+	for (uint32_t i = 0; i < ARP_RECORDS; i++) {
+		if (arp_cache_lookup(ip(10, 0, 1, static_cast<uint8_t>(i)), aLookup) != 0) {
+			nFound++;
+		}
+	}
+
+	CHECK(nFound == ARP_RECORDS - 1);
+}
+
+static void test_eviction_pending(void) {
+	reset();
+
+	uint8_t aMac[ETH_ADDR_LEN];
+	uint8_t aLookup[ETH_ADDR_LEN];
+
+	/* The oldest record is pending, a valid record is replaced */
+	const uint32_t nIpPending = ip(10, 0, 3, 1);
+
+	CHECK(send(nIpPending) == 0);
+
+	ticks(1);
+
+	for (uint32_t i = 1; i < ARP_RECORDS; i++) {
+		mac(aMac, static_cast<uint8_t>(i));
+		arp_cache_update(aMac, ip(10, 0, 1, static_cast<uint8_t>(i)));
+	}
+
+	mac(aMac, 0xFF);
+	arp_cache_update(aMac, ip(10, 0, 2, 1));
+	CHECK(arp_cache_lookup(ip(10, 0, 1, 1), aLookup) == 0);
+
+	mac(aMac, 0xFE);
+	arp_cache_update(aMac, nIpPending);
+	CHECK(s_nSent == 1);
+	CHECK(memcmp(s_aSentDst, aMac, ETH_ADDR_LEN) == 0);
+
+	/* All pending, the oldest is replaced and its queued frame is dropped */
+	reset();
+
+	for (uint32_t i = 0; i < ARP_RECORDS; i++) {
+		send(ip(10, 0, 4, static_cast<uint8_t>(i)));
+	}
+
+	CHECK(s_nRequests == ARP_RECORDS);
+
+	CHECK(send(ip(10, 0, 5, 1)) == 0);
+	CHECK(s_nRequests == ARP_RECORDS + 1);
+
+	mac(aMac, 0xFF);
+	arp_cache_update(aMac, ip(10, 0, 5, 1));
+	CHECK(s_nSent == 1);
+
+	mac(aMac, 1);
+	arp_cache_update(aMac, ip(10, 0, 4, 1));
+	CHECK(s_nSent == 2);
+
+	mac(aMac, 0);
+	arp_cache_update(aMac, ip(10, 0, 4, 0));
+	CHECK(s_nSent == 2);
+}
+
+int main(void) {
+	test_resolve();
+	test_multicast();
+	test_queue();
+	test_retry();
+	test_aging();
+	test_eviction();
+	test_eviction_pending();
+
+	printf("%u checks, %u failed\n", s_nChecks, s_nFailed);
+
+	return s_nFailed == 0 ? 0 : 1;
+}
@@ -79,6 +79,8 @@ int main(int argc, char **argv) {
 		return -1;
 	}
 
+	nw.SetBatchMode();
+
 	SpiFlashStore spiFlashStore;
 	ArtNet4Params artnet4Params(spiFlashStore.GetStoreArtNet4());
 
@@ -180,6 +182,7 @@ int main(int argc, char **argv) {
 	node.Start();
 
 	for (;;) {
+		nw.Run();
 		node.Run();
 		identify.Run();
 		remoteConfig.Run();
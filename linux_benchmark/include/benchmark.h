@@ -0,0 +1,102 @@
+/**
+ * @file benchmark.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdint.h>
+
+/**
+ * Runs nIterations operations, pContext is the state prepared by the suite
+ */
+typedef void (*BenchmarkKernel)(void *pContext, uint32_t nIterations);
+
+struct BenchmarkConfig {
+	static constexpr uint32_t REPETITIONS_DEFAULT = 7;
+	static constexpr uint32_t REPETITIONS_MAX = 31;
+	static constexpr uint32_t RUN_MILLIS_DEFAULT = 20;
+};
+
+class Benchmark {
+public:
+	Benchmark(void);
+
+	void SetMachineReadable(bool bMachineReadable) {
+		m_bMachineReadable = bMachineReadable;
+	}
+
+	void SetRepetitions(uint32_t nRepetitions);
+
+	void SetRunMillis(uint32_t nRunMillis) {
+		m_nRunNanos = static_cast<uint64_t>(nRunMillis == 0 ? 1 : nRunMillis) * 1000000;
+	}
+
+	void SetFilter(const char *pFilter) {
+		m_pFilter = pFilter;
+	}
+
+	void PrintHeader(void);
+
+	/**
+	 * Calibrates the iteration count to the run time, then reports the best and the median of the repetitions
+	 * @param nBytesPerOp payload handled by one operation, 0 omits bytes/s
+	 */
+	void Run(const char *pSuite, const char *pName, BenchmarkKernel Kernel, void *pContext, uint32_t nBytesPerOp);
+
+	uint32_t GetCount(void) {
+		return m_nCount;
+	}
+
+	/**
+	 * Keeps the compiler from removing a result that is otherwise unused
+	 */
+	static void DoNotOptimize(const void *p) {
+		asm volatile("" : : "r"(p) : "memory");
+	}
+
+private:
+	uint64_t Measure(BenchmarkKernel Kernel, void *pContext, uint32_t nIterations);
+	uint32_t Calibrate(BenchmarkKernel Kernel, void *pContext);
+	bool IsSelected(const char *pSuite, const char *pName);
+
+private:
+	bool m_bMachineReadable;
+	uint32_t m_nRepetitions;
+	uint64_t m_nRunNanos;
+	const char *m_pFilter;
+	uint32_t m_nCount;
+};
+
+/*
+ * The suites, one per library
+ */
+void BenchArtNet(Benchmark& benchmark);
+void BenchE131(Benchmark& benchmark);
+void BenchShowFile(Benchmark& benchmark);
+void BenchOsc(Benchmark& benchmark);
+void BenchWS28xx(Benchmark& benchmark);
+void BenchRdm(Benchmark& benchmark);
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,59 @@
+/**
+ * @file lightsetbench.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETBENCH_H_
+#define LIGHTSETBENCH_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lightset.h"
+
+/**
+ * Output sink, copies the slots the way a DMX output does
+ */
+class LightSetBench: public LightSet {
+public:
+	void Start(__attribute__((unused)) uint8_t nPort) {
+	}
+
+	void Stop(__attribute__((unused)) uint8_t nPort) {
+	}
+
+	void SetData(__attribute__((unused)) uint8_t nPort, const uint8_t *pData, uint16_t nLength) {
+		memcpy(m_aData, pData, nLength <= sizeof(m_aData) ? nLength : sizeof(m_aData));
+		m_nUpdates++;
+	}
+
+	uint32_t GetUpdates(void) {
+		return m_nUpdates;
+	}
+
+private:
+	uint8_t m_aData[512];
+	uint32_t m_nUpdates = 0;
+};
+
+#endif /* LIGHTSETBENCH_H_ */
@@ -0,0 +1,124 @@
+/**
+ * @file networkbench.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORKBENCH_H_
+#define NETWORKBENCH_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "network.h"
+
+/**
+ * Loopback Network, RecvBorrow() returns the queued datagram once and SendTo() discards
+ */
+class NetworkBench: public Network {
+public:
+	NetworkBench(void) {
+		m_nLocalIp = 0x0100000A;	// 10.0.0.1
+		m_nNetmask = 0x000000FF;	// 255.0.0.0
+	}
+
+	void Queue(const void *pBuffer, uint16_t nLength, uint32_t nFromIp, uint16_t nFromPort) {
+		m_pQueued = const_cast<void *>(pBuffer);
+		m_nQueuedLength = nLength;
+		m_nQueuedFromIp = nFromIp;
+		m_nQueuedFromPort = nFromPort;
+	}
+
+	int32_t Begin(__attribute__((unused)) uint16_t nPort) {
+		return 0;
+	}
+
+	int32_t End(__attribute__((unused)) uint16_t nPort) {
+		return 0;
+	}
+
+	void MacAddressCopyTo(uint8_t *pMacAddress) {
+		memset(pMacAddress, 0, NETWORK_MAC_SIZE);
+	}
+
+	void JoinGroup(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nIp) {
+	}
+
+	void LeaveGroup(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nIp) {
+	}
+
+	uint16_t RecvFrom(__attribute__((unused)) int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort) {
+		void *pQueued = 0;
+		const uint16_t nBytes = RecvBorrow(0, &pQueued, pFromIp, pFromPort);
+
+		if (nBytes == 0) {
+			return 0;
+		}
+
+		const uint16_t nCopy = nBytes < nLength ? nBytes : nLength;
+		memcpy(pBuffer, pQueued, nCopy);
+		return nCopy;
+	}
+
+	uint16_t RecvBorrow(__attribute__((unused)) int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) {
+		const uint16_t nLength = m_nQueuedLength;
+
+		if (nLength != 0) {
+			*ppBuffer = m_pQueued;
+			*pFromIp = m_nQueuedFromIp;
+			*pFromPort = m_nQueuedFromPort;
+			m_nQueuedLength = 0;
+		}
+
+		return nLength;
+	}
+
+	void RecvRelease(__attribute__((unused)) int32_t nHandle) {
+	}
+
+	void SendTo(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) const void *pBuffer, __attribute__((unused)) uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) {
+	}
+
+	void SetIp(uint32_t nIp) {
+		m_nLocalIp = nIp;
+	}
+
+	void SetNetmask(uint32_t nNetmask) {
+		m_nNetmask = nNetmask;
+	}
+
+	bool SetZeroconf(void) {
+		return false;
+	}
+
+	bool EnableDhcp(void) {
+		return false;
+	}
+
+private:
+	void *m_pQueued = 0;
+	uint16_t m_nQueuedLength = 0;
+	uint32_t m_nQueuedFromIp = 0;
+	uint16_t m_nQueuedFromPort = 0;
+};
+
+#endif /* NETWORKBENCH_H_ */
@@ -0,0 +1,100 @@
+/**
+ * @file benchartnet.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "networkbench.h"
+#include "lightsetbench.h"
+
+#include "artnetnode.h"
+#include "artnet.h"
+#include "packets.h"
+
+struct ArtNetContext {
+	ArtNetNode *pNode;
+	NetworkBench *pNetwork;
+	struct TArtDmx aArtDmx[2];
+	uint32_t nSources;
+};
+
+static void dmx(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<ArtNetContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		const uint32_t nSource = i % p->nSources;
+		struct TArtDmx *pArtDmx = &p->aArtDmx[nSource];
+
+		pArtDmx->Data[0] = static_cast<uint8_t>(i);
+
+		p->pNetwork->Queue(pArtDmx, sizeof(struct TArtDmx), 0x0200000A + nSource, TArtNetConst::UDP_PORT);
+		p->pNode->Run();
+	}
+}
+
+static void run(Benchmark& benchmark, const char *pName, uint32_t nSources, ArtNetMerge tMergeMode) {
+	NetworkBench *pNetwork = static_cast<NetworkBench *>(Network::Get());
+	LightSetBench lightSet;
+
+	ArtNetNode *pNode = new ArtNetNode;
+
+	pNode->SetOutput(&lightSet);
+	pNode->SetUniverseSwitch(0, ARTNET_OUTPUT_PORT, 1);
+	pNode->SetMergeMode(0, tMergeMode);
+	pNode->Start();
+
+	ArtNetContext context;
+	memset(&context, 0, sizeof(struct ArtNetContext));
+
+	for (uint32_t i = 0; i < 2; i++) {
+		struct TArtDmx *pArtDmx = &context.aArtDmx[i];
+
+		memcpy(pArtDmx->Id, NODE_ID, sizeof(pArtDmx->Id));
+		pArtDmx->OpCode = OP_DMX;
+		pArtDmx->ProtVerLo = TArtNetConst::PROTOCOL_REVISION;
+		pArtDmx->PortAddress = 1;
+		pArtDmx->LengthHi = TArtNetConst::DMX_LENGTH >> 8;
+		pArtDmx->Length = TArtNetConst::DMX_LENGTH & 0xFF;
+
+		for (uint32_t j = 0; j < TArtNetConst::DMX_LENGTH; j++) {
+			pArtDmx->Data[j] = static_cast<uint8_t>((j * (i + 1)) & 0xFF);
+		}
+	}
+
+	context.pNode = pNode;
+	context.pNetwork = pNetwork;
+	context.nSources = nSources;
+
+	benchmark.Run("artnet", pName, dmx, &context, TArtNetConst::DMX_LENGTH);
+
+	delete pNode;
+}
+
+void BenchArtNet(Benchmark& benchmark) {
+	run(benchmark, "dmx_single_source", 1, ArtNetMerge::HTP);
+	run(benchmark, "dmx_merge_htp", 2, ArtNetMerge::HTP);
+	run(benchmark, "dmx_merge_ltp", 2, ArtNetMerge::LTP);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file benche131.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "networkbench.h"
+#include "lightsetbench.h"
+
+#include "e131bridge.h"
+#include "e131.h"
+#include "e131packets.h"
+#include "e117const.h"
+
+struct E131Context {
+	E131Bridge *pBridge;
+	NetworkBench *pNetwork;
+	struct TE131DataPacket aDataPacket[2];
+	uint32_t nSources;
+};
+
+static void dmx(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<E131Context *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		const uint32_t nSource = i % p->nSources;
+		struct TE131DataPacket *pDataPacket = &p->aDataPacket[nSource];
+
+		pDataPacket->FrameLayer.SequenceNumber++;
+		pDataPacket->DMPLayer.PropertyValues[1] = static_cast<uint8_t>(i);
+
+		p->pNetwork->Queue(pDataPacket, sizeof(struct TE131DataPacket), 0x0200000A + nSource, E131_DEFAULT_PORT);
+		p->pBridge->Run();
+	}
+}
+
+static void run(Benchmark& benchmark, const char *pName, uint32_t nSources, E131Merge tMergeMode, bool bValid = true) {
+	NetworkBench *pNetwork = static_cast<NetworkBench *>(Network::Get());
+	LightSetBench lightSet;
+
+	E131Bridge *pBridge = new E131Bridge;
+
+	pBridge->SetOutput(&lightSet);
+	pBridge->SetUniverse(0, E131_OUTPUT_PORT, 1);
+	pBridge->SetMergeMode(0, tMergeMode);
+	pBridge->Start();
+
+	E131Context context;
+	memset(&context, 0, sizeof(struct E131Context));
+
+	for (uint32_t i = 0; i < 2; i++) {
+		struct TE131DataPacket *pDataPacket = &context.aDataPacket[i];
+
+		memcpy(pDataPacket->RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH);
+		pDataPacket->RootLayer.Vector = __builtin_bswap32(E131_VECTOR_ROOT_DATA);
+		memset(pDataPacket->RootLayer.Cid, static_cast<int>(i + 1), E131_CID_LENGTH);
+
+		pDataPacket->FrameLayer.Vector = __builtin_bswap32(E131_VECTOR_DATA_PACKET);
+		pDataPacket->FrameLayer.Priority = E131_PRIORITY_DEFAULT;
+		pDataPacket->FrameLayer.Universe = __builtin_bswap16(1);
+
+		pDataPacket->DMPLayer.Vector = bValid ? E131_VECTOR_DMP_SET_PROPERTY : 0;
+		pDataPacket->DMPLayer.Type = 0xa1;
+		pDataPacket->DMPLayer.AddressIncrement = __builtin_bswap16(1);
+		pDataPacket->DMPLayer.PropertyValueCount = __builtin_bswap16(E131_DMX_LENGTH + 1);
+
+		for (uint32_t j = 1; j <= E131_DMX_LENGTH; j++) {
+			pDataPacket->DMPLayer.PropertyValues[j] = static_cast<uint8_t>((j * (i + 1)) & 0xFF);
+		}
+	}
+
+	context.pBridge = pBridge;
+	context.pNetwork = pNetwork;
+	context.nSources = nSources;
+
+	benchmark.Run("e131", pName, dmx, &context, E131_DMX_LENGTH);
+
+	delete pBridge;
+}
+
+void BenchE131(Benchmark& benchmark) {
+	run(benchmark, "dmx_single_source", 1, E131Merge::HTP);
+	run(benchmark, "dmx_merge_htp", 2, E131Merge::HTP);
+	run(benchmark, "dmx_merge_ltp", 2, E131Merge::LTP);
+	run(benchmark, "dmx_invalid_discarded", 1, E131Merge::HTP, false);
+}
@@ -0,0 +1,143 @@
+/**
+ * @file benchmark.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <cassert>
+
+#include "benchmark.h"
+
+static uint64_t nanos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+Benchmark::Benchmark(void) :
+	m_bMachineReadable(false),
+	m_nRepetitions(BenchmarkConfig::REPETITIONS_DEFAULT),
+	m_nRunNanos(static_cast<uint64_t>(BenchmarkConfig::RUN_MILLIS_DEFAULT) * 1000000),
+	m_pFilter(0),
+	m_nCount(0)
+{
+}
+
+void Benchmark::SetRepetitions(uint32_t nRepetitions) {
+	if (nRepetitions == 0) {
+		m_nRepetitions = 1;
+	} else if (nRepetitions > BenchmarkConfig::REPETITIONS_MAX) {
+		m_nRepetitions = BenchmarkConfig::REPETITIONS_MAX;
+	} else {
+		m_nRepetitions = nRepetitions;
+	}
+}
+
+void Benchmark::PrintHeader(void) {
+	if (m_bMachineReadable) {
+		puts("suite,name,iterations,ns_per_op,ns_per_op_median,bytes_per_op,bytes_per_second");
+	} else {
+		printf("%-10s %-28s %10s %12s %12s %12s\n", "suite", "name", "iterations", "ns/op", "median", "MB/s");
+	}
+}
+
+bool Benchmark::IsSelected(const char *pSuite, const char *pName) {
+	if (m_pFilter == 0) {
+		return true;
+	}
+
+	return (strstr(pSuite, m_pFilter) != 0) || (strstr(pName, m_pFilter) != 0);
+}
+
+uint64_t Benchmark::Measure(BenchmarkKernel Kernel, void *pContext, uint32_t nIterations) {
+	const uint64_t nStart = nanos();
+	Kernel(pContext, nIterations);
+	return nanos() - nStart;
+}
+
+uint32_t Benchmark::Calibrate(BenchmarkKernel Kernel, void *pContext) {
+	uint32_t nIterations = 1;
+
+	// Also warms up the caches and the branch predictors
+	for (;;) {
+		const uint64_t nElapsed = Measure(Kernel, pContext, nIterations);
+
+		if ((nElapsed >= m_nRunNanos) || (nIterations >= (1U << 30))) {
+			return nIterations;
+		}
+
+		if (nElapsed < (m_nRunNanos / 100)) {
+			nIterations *= 10;
+		} else {
+			const uint64_t nScaled = (static_cast<uint64_t>(nIterations) * m_nRunNanos) / nElapsed + 1;
+			nIterations = nScaled > (1U << 30) ? (1U << 30) : static_cast<uint32_t>(nScaled);
+		}
+	}
+}
+
+void Benchmark::Run(const char *pSuite, const char *pName, BenchmarkKernel Kernel, void *pContext, uint32_t nBytesPerOp) {
+	assert(Kernel != 0);
+
+	if (!IsSelected(pSuite, pName)) {
+		return;
+	}
+
+	const uint32_t nIterations = Calibrate(Kernel, pContext);
+
+	double aNsPerOp[BenchmarkConfig::REPETITIONS_MAX];
+
+	for (uint32_t i = 0; i < m_nRepetitions; i++) {
+		const double fNsPerOp = static_cast<double>(Measure(Kernel, pContext, nIterations)) / nIterations;
+
+		// Insertion sort, the best run ends up first
+		uint32_t j = i;
+
+		while ((j > 0) && (aNsPerOp[j - 1] > fNsPerOp)) {
+			aNsPerOp[j] = aNsPerOp[j - 1];
+			j--;
+		}
+
+		aNsPerOp[j] = fNsPerOp;
+	}
+
+	const double fBest = aNsPerOp[0];
+	const double fMedian = aNsPerOp[m_nRepetitions / 2];
+	const double fBytesPerSecond = (nBytesPerOp == 0 || fBest == 0) ? 0 : (nBytesPerOp * 1e9) / fBest;
+
+	if (m_bMachineReadable) {
+		printf("%s,%s,%u,%.3f,%.3f,%u,%.0f\n", pSuite, pName, nIterations, fBest, fMedian, nBytesPerOp, fBytesPerSecond);
+	} else {
+		if (nBytesPerOp == 0) {
+			printf("%-10s %-28s %10u %12.1f %12.1f %12s\n", pSuite, pName, nIterations, fBest, fMedian, "-");
+		} else {
+			printf("%-10s %-28s %10u %12.1f %12.1f %12.1f\n", pSuite, pName, nIterations, fBest, fMedian, fBytesPerSecond / 1e6);
+		}
+	}
+
+	fflush(stdout);
+
+	m_nCount++;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file benchosc.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+#include "oscmessage.h"
+
+struct OscContext {
+	uint8_t aMessage[600];
+	uint32_t nLength;
+	uint32_t nErrors;
+};
+
+static void parse(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<OscContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		OSCMessage msg(p->aMessage, p->nLength);
+
+		if (msg.GetResult() != OscMessageDeserialise::OK) {
+			p->nErrors++;
+		}
+
+		Benchmark::DoNotOptimize(msg.GetTypes());
+	}
+}
+
+/*
+ * OSC-string, null terminated and padded to a multiple of 4
+ */
+static uint32_t add_string(uint8_t *pBuffer, const char *pString) {
+	const uint32_t nLength = static_cast<uint32_t>(strlen(pString));
+	const uint32_t nSize = (nLength + 4) & ~3U;
+
+	memset(pBuffer, 0, nSize);
+	memcpy(pBuffer, pString, nLength);
+
+	return nSize;
+}
+
+static uint32_t add_int32(uint8_t *pBuffer, uint32_t nValue) {
+	const uint32_t nNetwork = __builtin_bswap32(nValue);
+	memcpy(pBuffer, &nNetwork, 4);
+	return 4;
+}
+
+void BenchOsc(Benchmark& benchmark) {
+	OscContext context;
+
+	memset(&context, 0, sizeof(struct OscContext));
+
+	uint8_t *p = context.aMessage;
+	p += add_string(p, "/dmx1/1");
+	p += add_string(p, ",f");
+	const float f = 0.5f;
+	uint32_t nFloat;
+	memcpy(&nFloat, &f, 4);
+	p += add_int32(p, nFloat);
+	context.nLength = static_cast<uint32_t>(p - context.aMessage);
+
+	benchmark.Run("osc", "parse_float", parse, &context, context.nLength);
+
+	p = context.aMessage;
+	p += add_string(p, "/dmx1/rgb");
+	p += add_string(p, ",iii");
+	p += add_int32(p, 255);
+	p += add_int32(p, 128);
+	p += add_int32(p, 0);
+	context.nLength = static_cast<uint32_t>(p - context.aMessage);
+
+	benchmark.Run("osc", "parse_int32_x3", parse, &context, context.nLength);
+
+	p = context.aMessage;
+	p += add_string(p, "/dmx1/blob");
+	p += add_string(p, ",b");
+	p += add_int32(p, 512);
+	for (uint32_t i = 0; i < 512; i++) {
+		*p++ = static_cast<uint8_t>(i);
+	}
+	context.nLength = static_cast<uint32_t>(p - context.aMessage);
+
+	benchmark.Run("osc", "parse_blob_512", parse, &context, context.nLength);
+
+	if (context.nErrors != 0) {
+		fprintf(stderr, "osc: %u messages not parsed\n", context.nErrors);
+	}
+}
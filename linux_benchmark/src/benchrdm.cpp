@@ -0,0 +1,89 @@
+/**
+ * @file benchrdm.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+#include "rdmdiscoveryresponse.h"
+
+struct RdmContext {
+	uint8_t aResponse[24];
+	uint8_t aUid[6];
+};
+
+/*
+ * The encoded UID and checksum, each byte is sent as (byte | 0xAA) and (byte | 0x55)
+ */
+static void encode(uint8_t *pResponse, const uint8_t *pUid) {
+	memset(pResponse, 0xFE, 7);
+	pResponse[7] = 0xAA;
+
+	uint16_t nChecksum = 6 * 0xFF;
+
+	for (uint32_t i = 0; i < 6; i++) {
+		pResponse[8 + (i * 2)] = pUid[i] | 0xAA;
+		pResponse[9 + (i * 2)] = pUid[i] | 0x55;
+		nChecksum = static_cast<uint16_t>(nChecksum + pUid[i]);
+	}
+
+	pResponse[20] = static_cast<uint8_t>((nChecksum >> 8) | 0xAA);
+	pResponse[21] = static_cast<uint8_t>((nChecksum >> 8) | 0x55);
+	pResponse[22] = static_cast<uint8_t>((nChecksum & 0xFF) | 0xAA);
+	pResponse[23] = static_cast<uint8_t>((nChecksum & 0xFF) | 0x55);
+}
+
+static void decode(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<RdmContext *>(pContext);
+	uint32_t nValid = 0;
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		Benchmark::DoNotOptimize(p->aResponse);
+		nValid += RDMDiscoveryResponse::Decode(p->aResponse, p->aUid) ? 1U : 0U;
+	}
+
+	Benchmark::DoNotOptimize(&nValid);
+}
+
+void BenchRdm(Benchmark& benchmark) {
+	static const uint8_t aUid[6] = { 0x7F, 0xF0, 0x01, 0x02, 0x03, 0x04 };
+	RdmContext context;
+
+	encode(context.aResponse, aUid);
+
+	if (!RDMDiscoveryResponse::Decode(context.aResponse, context.aUid) || (memcmp(context.aUid, aUid, sizeof(aUid)) != 0)) {
+		fputs("rdm: the encoded response does not decode, skipped\n", stderr);
+		return;
+	}
+
+	benchmark.Run("rdm", "discovery_response", decode, &context, sizeof(context.aResponse));
+
+	/* A collision, the checksum does not match */
+	context.aResponse[9] = static_cast<uint8_t>(context.aResponse[9] ^ 0x01);
+
+	benchmark.Run("rdm", "discovery_response_collision", decode, &context, sizeof(context.aResponse));
+}
@@ -0,0 +1,178 @@
+/**
+ * @file benchshowfile.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+
+#include "olashowfile.h"
+#include "showfileprotocolhandler.h"
+
+class ShowFileProtocolBench: public ShowFileProtocolHandler {
+public:
+	void DmxOut(__attribute__((unused)) uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength) {
+		Benchmark::DoNotOptimize(pDmxData);
+		m_nSlots += nLength;
+	}
+
+	void DmxSync(void) {
+	}
+
+	void DmxBlackout(void) {
+	}
+
+	void DmxMaster(__attribute__((unused)) uint32_t nMaster) {
+	}
+
+	void DoRunCleanupProcess(__attribute__((unused)) bool bDoRun) {
+	}
+
+	void Start(void) {
+	}
+
+	void Stop(void) {
+	}
+
+	void Run(void) {
+	}
+
+	bool IsSyncDisabled(void) {
+		return false;
+	}
+
+	bool SetRecorder(__attribute__((unused)) LightSetRecorder *pRecorder) {
+		return false;
+	}
+
+	void Print(void) {
+	}
+
+	uint32_t GetSlots(void) {
+		return m_nSlots;
+	}
+
+private:
+	uint32_t m_nSlots = 0;
+};
+
+static void run(void *pContext, uint32_t nIterations) {
+	auto *pShowFile = static_cast<OlaShowFile *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		pShowFile->Run();
+	}
+}
+
+/*
+ * A show file with DMX lines only, without delays every Run() parses one line
+ */
+static uint32_t write_show(const char *pFileName, uint32_t nSlots) {
+	FILE *pFile = fopen(pFileName, "w");
+
+	if (pFile == 0) {
+		perror(pFileName);
+		return 0;
+	}
+
+	uint32_t nLineLength = 0;
+
+	for (uint32_t nLine = 0; nLine < 64; nLine++) {
+		nLineLength = static_cast<uint32_t>(fprintf(pFile, "1 "));
+
+		for (uint32_t i = 0; i < nSlots; i++) {
+			nLineLength += static_cast<uint32_t>(fprintf(pFile, (i == 0) ? "%u" : ",%u", (nLine + i * 7) & 0xFF));
+		}
+
+		nLineLength += static_cast<uint32_t>(fprintf(pFile, "\n"));
+	}
+
+	fclose(pFile);
+
+	return nLineLength;
+}
+
+void BenchShowFile(Benchmark& benchmark) {
+	char aDirectory[] = "/tmp/linux_benchmark.XXXXXX";
+
+	if (mkdtemp(aDirectory) == 0) {
+		perror("mkdtemp");
+		return;
+	}
+
+	char aCurrentDirectory[256];
+
+	if ((getcwd(aCurrentDirectory, sizeof(aCurrentDirectory)) == 0) || (chdir(aDirectory) != 0)) {
+		perror(aDirectory);
+		rmdir(aDirectory);
+		return;
+	}
+
+	const uint8_t nShowFileNumber = ShowFileFile::MAX_NUMBER - 1;
+	char aShowFileName[ShowFileFile::NAME_LENGTH + 1];
+	ShowFile::ShowFileNameCopyTo(aShowFileName, sizeof(aShowFileName), nShowFileNumber);
+
+	ShowFileProtocolBench protocolHandler;
+	OlaShowFile showFile;
+
+	showFile.SetProtocolHandler(&protocolHandler);
+	showFile.DoLoop(true);
+
+	const struct {
+		const char *pName;
+		uint32_t nSlots;
+	} aScenarios[] = {
+		{ "ola_dmx_line_24", 24 },
+		{ "ola_dmx_line_512", 512 }
+	};
+
+	for (uint32_t i = 0; i < sizeof(aScenarios) / sizeof(aScenarios[0]); i++) {
+		const uint32_t nLineLength = write_show(aShowFileName, aScenarios[i].nSlots);
+
+		if (nLineLength != 0) {
+			showFile.SetShowFile(nShowFileNumber);
+			showFile.Start();
+
+			benchmark.Run("showfile", aScenarios[i].pName, run, &showFile, nLineLength);
+
+			showFile.Stop();
+		}
+
+		unlink(aShowFileName);
+	}
+
+	if (protocolHandler.GetSlots() == 0) {
+		fputs("showfile: no DMX data parsed\n", stderr);
+	}
+
+	if (chdir(aCurrentDirectory) != 0) {
+		perror(aCurrentDirectory);
+	}
+
+	rmdir(aDirectory);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file benchws28xx.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "benchmark.h"
+
+#include "ws28xx_internal.h"
+#include "ws28xxmulti_internal.h"
+
+/*
+ * The encoders, 170 RGB LEDs is one universe
+ */
+static constexpr uint32_t LED_COUNT = 170;
+static constexpr uint32_t PIXELS_SIZE = LED_COUNT * 24;
+
+struct EncodeContext {
+	uint64_t aTable[256];
+	uint32_t aColourOffset[3];
+	uint8_t aPixels[PIXELS_SIZE];
+	uint8_t aBuffer8x[PIXELS_SIZE];
+	uint32_t aBuffer4x[PIXELS_SIZE];
+};
+
+static void rtz_set_led(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<EncodeContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		const uint8_t nValue = static_cast<uint8_t>(i);
+
+		for (uint32_t nLed = 0; nLed < LED_COUNT; nLed++) {
+			rtz_encode(&p->aPixels[nLed * 24], p->aTable, p->aColourOffset, nValue, static_cast<uint8_t>(nLed), static_cast<uint8_t>(nValue ^ nLed));
+		}
+
+		Benchmark::DoNotOptimize(p->aPixels);
+	}
+}
+
+static void transpose(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<EncodeContext *>(pContext);
+	uint64_t nBits = 0x0123456789ABCDEFULL;
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		nBits = transpose8x8(nBits ^ i);
+	}
+
+	p->aTable[0] = nBits;
+	Benchmark::DoNotOptimize(p->aTable);
+}
+
+static void multi_encode8x(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<EncodeContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		p->aPixels[i % PIXELS_SIZE] = static_cast<uint8_t>(i);
+		encode8x(p->aBuffer8x, p->aPixels, PIXELS_SIZE);
+		Benchmark::DoNotOptimize(p->aBuffer8x);
+	}
+}
+
+static void multi_encode4x(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<EncodeContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		p->aPixels[i % PIXELS_SIZE] = static_cast<uint8_t>(i);
+		encode4x(p->aBuffer4x, p->aPixels, PIXELS_SIZE);
+		Benchmark::DoNotOptimize(p->aBuffer4x);
+	}
+}
+
+static void run_encoders(Benchmark& benchmark) {
+	static EncodeContext context;
+
+	rtz_encode_table(context.aTable, 0xC0, 0xF8);
+
+	/* GRB, the WS2812B order */
+	context.aColourOffset[0] = 8;
+	context.aColourOffset[1] = 0;
+	context.aColourOffset[2] = 16;
+
+	for (uint32_t i = 0; i < PIXELS_SIZE; i++) {
+		context.aPixels[i] = static_cast<uint8_t>(i * 7);
+		context.aBuffer4x[i] = 0xF0;
+	}
+
+	benchmark.Run("ws28xx", "rtz_set_led", rtz_set_led, &context, LED_COUNT * 3);
+	benchmark.Run("ws28xx", "transpose8x8", transpose, &context, 8);
+	benchmark.Run("ws28xx", "encode8x", multi_encode8x, &context, PIXELS_SIZE);
+	benchmark.Run("ws28xx", "encode4x", multi_encode4x, &context, PIXELS_SIZE);
+}
+
+#if defined (RASPPI)
+# include "bcm2835.h"
+
+# include "ws28xx.h"
+# include "rgbmapping.h"
+
+struct WS28xxContext {
+	WS28xx *pWS28xx;
+	uint32_t nLedCount;
+};
+
+static void set_led_rgb(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<WS28xxContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		const uint8_t nValue = static_cast<uint8_t>(i);
+
+		for (uint32_t nLed = 0; nLed < p->nLedCount; nLed++) {
+			p->pWS28xx->SetLED(nLed, nValue, static_cast<uint8_t>(nLed), static_cast<uint8_t>(nValue ^ nLed));
+		}
+	}
+}
+
+static void set_led_rgbw(void *pContext, uint32_t nIterations) {
+	auto *p = static_cast<WS28xxContext *>(pContext);
+
+	for (uint32_t i = 0; i < nIterations; i++) {
+		const uint8_t nValue = static_cast<uint8_t>(i);
+
+		for (uint32_t nLed = 0; nLed < p->nLedCount; nLed++) {
+			p->pWS28xx->SetLED(nLed, nValue, static_cast<uint8_t>(nLed), static_cast<uint8_t>(nValue ^ nLed), 0x7F);
+		}
+	}
+}
+
+static void run(Benchmark& benchmark, TWS28XXType tType, TRGBMapping tRGBMapping) {
+	const bool bIsRGBW = (tType == SK6812W);
+	const uint16_t nLedCount = bIsRGBW ? 128 : 170;
+
+	WS28xx ws28xx(tType, nLedCount, tRGBMapping);
+	ws28xx.Initialize();
+
+	WS28xxContext context;
+	context.pWS28xx = &ws28xx;
+	context.nLedCount = nLedCount;
+
+	char aName[32];
+
+	if (ws28xx.GetRgbMapping() == RGB_MAPPING_UNDEFINED) {
+		snprintf(aName, sizeof(aName), "set_led_%s", WS28xx::GetLedTypeString(tType));
+	} else {
+		snprintf(aName, sizeof(aName), "set_led_%s_%s", WS28xx::GetLedTypeString(tType), RGBMapping::ToString(ws28xx.GetRgbMapping()));
+	}
+
+	benchmark.Run("ws28xx", aName, bIsRGBW ? set_led_rgbw : set_led_rgb, &context, nLedCount * (bIsRGBW ? 4U : 3U));
+}
+#endif
+
+void BenchWS28xx(Benchmark& benchmark) {
+	run_encoders(benchmark);
+
+#if defined (RASPPI)
+	if (bcm2835_init() == 0) {
+		fputs("ws28xx: bcm2835_init() failed, skipped\n", stderr);
+		return;
+	}
+
+	const TWS28XXType aTypes[] = { WS2801, WS2812B, SK6812, APA102, P9813 };
+
+	for (uint32_t i = 0; i < sizeof(aTypes) / sizeof(aTypes[0]); i++) {
+		run(benchmark, aTypes[i], RGB_MAPPING_UNDEFINED);
+	}
+
+	// The RTZ encoder with every colour order
+	for (uint32_t i = 0; i < RGB_MAPPING_UNDEFINED; i++) {
+		run(benchmark, WS2812B, static_cast<TRGBMapping>(i));
+	}
+
+	run(benchmark, SK6812W, RGB_MAPPING_UNDEFINED);
+#else
+	fputs("ws28xx: set_led needs the Raspberry Pi build (RASPPI), skipped\n", stderr);
+#endif
+}
@@ -0,0 +1,90 @@
+/**
+ * @file main.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "hardware.h"
+#include "ledblink.h"
+
+#include "networkbench.h"
+
+#include "benchmark.h"
+
+static void usage(const char *pProgram) {
+	fprintf(stderr, "Usage: %s [-c] [-f filter] [-r repetitions] [-t milliseconds]\n", pProgram);
+	fprintf(stderr, "  -c  machine-readable output (CSV)\n");
+	fprintf(stderr, "  -f  run the benchmarks where the suite or the name contains filter\n");
+	fprintf(stderr, "  -r  timed runs per benchmark, the best and the median are reported (default %u)\n", BenchmarkConfig::REPETITIONS_DEFAULT);
+	fprintf(stderr, "  -t  minimum duration of a single timed run (default %u)\n", BenchmarkConfig::RUN_MILLIS_DEFAULT);
+}
+
+int main(int argc, char **argv) {
+	Hardware hw;
+	NetworkBench nw;
+	LedBlink lb;
+
+	Benchmark benchmark;
+
+	int nOption;
+
+	while ((nOption = getopt(argc, argv, "cf:r:t:h")) != -1) {
+		switch (nOption) {
+		case 'c':
+			benchmark.SetMachineReadable(true);
+			break;
+		case 'f':
+			benchmark.SetFilter(optarg);
+			break;
+		case 'r':
+			benchmark.SetRepetitions(static_cast<uint32_t>(atoi(optarg)));
+			break;
+		case 't':
+			benchmark.SetRunMillis(static_cast<uint32_t>(atoi(optarg)));
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	benchmark.PrintHeader();
+
+	BenchArtNet(benchmark);
+	BenchE131(benchmark);
+	BenchShowFile(benchmark);
+	BenchOsc(benchmark);
+	BenchWS28xx(benchmark);
+	BenchRdm(benchmark);
+
+	if (benchmark.GetCount() == 0) {
+		fprintf(stderr, "No benchmark selected\n");
+		return -1;
+	}
+
+	return 0;
+}
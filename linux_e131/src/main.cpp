@@ -69,6 +69,8 @@ int main(int argc, char **argv) {
 		return -1;
 	}
 
+	nw.SetBatchMode();
+
 	SpiFlashStore spiFlashStore;
 
 	E131Params e131Params(new StoreE131);
@@ -130,6 +132,7 @@ int main(int argc, char **argv) {
 	bridge.Start();
 
 	for (;;) {
+		nw.Run();
 		bridge.Run();
 		remoteConfig.Run();
 		spiFlashStore.Flash();
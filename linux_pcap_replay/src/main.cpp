@@ -0,0 +1,261 @@
+/**
+ * @file main.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hardware.h"
+#include "networkpcap.h"
+#include "ledblink.h"
+
+#include "lightsetchecksum.h"
+
+#include "artnetnode.h"
+#include "artnet.h"
+#include "packets.h"
+
+#include "e131bridge.h"
+#include "e131.h"
+#include "e131packets.h"
+
+static constexpr uint32_t MAX_ARTNET_PORTS = TArtNetConst::MAX_PORTS;
+static constexpr uint32_t MAX_E131_PORTS = LIGHTSET_CHECKSUM_PORTS;
+
+static uint64_t monotonic_micros(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + static_cast<uint64_t>(ts.tv_nsec / 1000);
+}
+
+static bool add_unique(uint16_t *pList, uint32_t& nCount, uint32_t nMax, uint16_t nValue) {
+	for (uint32_t i = 0; i < nCount; i++) {
+		if (pList[i] == nValue) {
+			return true;
+		}
+	}
+
+	if (nCount == nMax) {
+		return false;
+	}
+
+	pList[nCount++] = nValue;
+	return true;
+}
+
+/*
+ * The Port-Addresses and universes with DMX data in the capture, in order of appearance
+ */
+static void scan(const NetworkPcap& nw, uint16_t *pPortAddresses, uint32_t& nPortAddresses, uint16_t *pUniverses, uint32_t& nUniverses) {
+	for (uint32_t i = 0; i < nw.GetPackets(); i++) {
+		const struct TPcapPacket *pPacket = nw.GetPacket(i);
+		const uint8_t *pPayload = nw.GetPayload(pPacket);
+
+		if ((pPacket->nToPort == TArtNetConst::UDP_PORT) && (pPacket->nLength >= sizeof(struct TArtDmx) - TArtNetConst::DMX_LENGTH)) {
+			const auto *pArtDmx = reinterpret_cast<const struct TArtDmx *>(pPayload);
+
+			if ((memcmp(pArtDmx->Id, NODE_ID, 8) == 0) && (pArtDmx->OpCode == OP_DMX)) {
+				// The node has a single Net and Sub-Net, as the first Port-Address seen
+				if ((nPortAddresses == 0) || ((pArtDmx->PortAddress & 0x7FF0) == (pPortAddresses[0] & 0x7FF0))) {
+					add_unique(pPortAddresses, nPortAddresses, MAX_ARTNET_PORTS, pArtDmx->PortAddress & 0x7FFF);
+				}
+			}
+		} else if ((pPacket->nToPort == E131_DEFAULT_PORT) && (pPacket->nLength >= sizeof(struct TE131DataPacket) - E131_DMX_LENGTH)) {
+			const auto *pDataPacket = reinterpret_cast<const struct TE131DataPacket *>(pPayload);
+
+			if ((pDataPacket->RootLayer.Vector == __builtin_bswap32(E131_VECTOR_ROOT_DATA)) && (pDataPacket->FrameLayer.Vector == __builtin_bswap32(E131_VECTOR_DATA_PACKET))) {
+				add_unique(pUniverses, nUniverses, MAX_E131_PORTS, __builtin_bswap16(pDataPacket->FrameLayer.Universe));
+			}
+		}
+	}
+}
+
+static void usage(const char *pProgram) {
+	fprintf(stderr, "Usage: %s [-r] [-a port_address] [-u universe] [-x hash] capture.pcap\n", pProgram);
+	fprintf(stderr, "  -r  replay at the recorded timing, default is as fast as possible\n");
+	fprintf(stderr, "  -a  Art-Net output Port-Address, up to %u, same Net and Sub-Net\n", MAX_ARTNET_PORTS);
+	fprintf(stderr, "  -u  sACN E1.31 output universe, up to %u\n", MAX_E131_PORTS);
+	fprintf(stderr, "  -x  expected output hash, the exit code is 1 when it does not match\n");
+	fprintf(stderr, "Without -a and -u the outputs are the ones with DMX data in the capture.\n");
+}
+
+int main(int argc, char **argv) {
+	Hardware hw;
+	NetworkPcap nw;
+	LedBlink lb;
+
+	uint16_t aPortAddresses[MAX_ARTNET_PORTS];
+	uint32_t nPortAddresses = 0;
+	uint16_t aUniverses[MAX_E131_PORTS];
+	uint32_t nUniverses = 0;
+	bool bRealTime = false;
+	bool bCheckHash = false;
+	uint32_t nExpectedHash = 0;
+
+	int nOption;
+
+	while ((nOption = getopt(argc, argv, "ra:u:x:h")) != -1) {
+		switch (nOption) {
+		case 'r':
+			bRealTime = true;
+			break;
+		case 'a':
+			if (!add_unique(aPortAddresses, nPortAddresses, MAX_ARTNET_PORTS, static_cast<uint16_t>(strtoul(optarg, 0, 0) & 0x7FFF))) {
+				fprintf(stderr, "Too many Art-Net ports\n");
+				return -1;
+			}
+			break;
+		case 'u':
+			if (!add_unique(aUniverses, nUniverses, MAX_E131_PORTS, static_cast<uint16_t>(strtoul(optarg, 0, 0)))) {
+				fprintf(stderr, "Too many sACN E1.31 universes\n");
+				return -1;
+			}
+			break;
+		case 'x':
+			bCheckHash = true;
+			nExpectedHash = static_cast<uint32_t>(strtoul(optarg, 0, 16));
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	nw.SetRealTime(bRealTime);
+
+	if (!nw.Open(argv[optind])) {
+		return -1;
+	}
+
+	if ((nPortAddresses == 0) && (nUniverses == 0)) {
+		scan(nw, aPortAddresses, nPortAddresses, aUniverses, nUniverses);
+	}
+
+	printf("Capture: %s, %u UDP datagrams (%u records skipped), %.3f s\n", argv[optind], nw.GetPackets(), nw.GetSkipped(), static_cast<double>(nw.GetDurationMicros()) / 1e6);
+
+	LightSetChecksum artnetOutput;
+	LightSetChecksum e131Output;
+	ArtNetNode *pNode = 0;
+	E131Bridge *pBridge = 0;
+
+	if (nPortAddresses != 0) {
+		pNode = new ArtNetNode;
+
+		pNode->SetOutput(&artnetOutput);
+		pNode->SetNetSwitch(static_cast<uint8_t>((aPortAddresses[0] >> 8) & 0x7F));
+		pNode->SetSubnetSwitch(static_cast<uint8_t>((aPortAddresses[0] >> 4) & 0x0F));
+
+		for (uint32_t i = 0; i < nPortAddresses; i++) {
+			if ((aPortAddresses[i] & 0x7FF0) != (aPortAddresses[0] & 0x7FF0)) {
+				fprintf(stderr, "Port-Address %u is not in Net/Sub-Net of %u, skipped\n", aPortAddresses[i], aPortAddresses[0]);
+				continue;
+			}
+
+			pNode->SetUniverseSwitch(static_cast<uint8_t>(i), ARTNET_OUTPUT_PORT, static_cast<uint8_t>(aPortAddresses[i] & 0x0F));
+		}
+
+		pNode->Start();
+	}
+
+	if (nUniverses != 0) {
+		pBridge = new E131Bridge;
+
+		pBridge->SetOutput(&e131Output);
+
+		for (uint32_t i = 0; i < nUniverses; i++) {
+			pBridge->SetUniverse(static_cast<uint8_t>(i), E131_OUTPUT_PORT, aUniverses[i]);
+		}
+
+		pBridge->Start();
+	}
+
+	const uint64_t nStart = monotonic_micros();
+
+	while (nw.Run()) {
+		if (pNode != 0) {
+			pNode->Run();
+		}
+		if (pBridge != 0) {
+			pBridge->Run();
+		}
+	}
+
+	const uint64_t nElapsed = monotonic_micros() - nStart;
+	const double fSeconds = nElapsed == 0 ? 1e-6 : static_cast<double>(nElapsed) / 1e6;
+	const uint32_t nFrames = artnetOutput.GetFrames() + e131Output.GetFrames();
+
+	printf("Replay: %s, %.3f s\n", bRealTime ? "recorded timing" : "as fast as possible", fSeconds);
+	printf(" Packets: %u received, %u not bound, %.0f packets/s\n", nw.GetServed(), nw.GetRxUnbound(), nw.GetServed() / fSeconds);
+	printf(" Universes: %u output frames, %.0f universes/s\n", nFrames, nFrames / fSeconds);
+
+	if (pNode != 0) {
+		const struct TArtNetNodeStats& tStats = pNode->GetStats();
+
+		printf("Art-Net:");
+		for (uint32_t i = 0; i < nPortAddresses; i++) {
+			printf(" %u", aPortAddresses[i]);
+		}
+		printf("\n parse errors=%u, merge discards=%u, sequence gaps=%u\n", tStats.nParseErrors, tStats.nMergeDiscards, tStats.nSequenceGaps);
+		artnetOutput.Print();
+	}
+
+	if (pBridge != 0) {
+		const struct TE131BridgeStats& tStats = pBridge->GetStats();
+
+		printf("sACN E1.31:");
+		for (uint32_t i = 0; i < nUniverses; i++) {
+			printf(" %u", aUniverses[i]);
+		}
+		printf("\n parse errors=%u, merge discards=%u, sequence gaps=%u\n", tStats.nParseErrors, tStats.nMergeDiscards, tStats.nSequenceGaps);
+		e131Output.Print();
+	}
+
+	const uint32_t nArtNetHash = artnetOutput.GetHash();
+	const uint32_t nE131Hash = e131Output.GetHash();
+	const uint8_t aHashes[] = {
+			static_cast<uint8_t>(nArtNetHash >> 24), static_cast<uint8_t>(nArtNetHash >> 16), static_cast<uint8_t>(nArtNetHash >> 8), static_cast<uint8_t>(nArtNetHash),
+			static_cast<uint8_t>(nE131Hash >> 24), static_cast<uint8_t>(nE131Hash >> 16), static_cast<uint8_t>(nE131Hash >> 8), static_cast<uint8_t>(nE131Hash) };
+	const uint32_t nHash = LightSetChecksum::Hash(aHashes, sizeof(aHashes));
+
+	printf("Hash: %.8x\n", nHash);
+
+	delete pBridge;
+	delete pNode;
+
+	if (bCheckHash && (nHash != nExpectedHash)) {
+		fprintf(stderr, "Hash mismatch, expected %.8x\n", nExpectedHash);
+		return 1;
+	}
+
+	return 0;
+}
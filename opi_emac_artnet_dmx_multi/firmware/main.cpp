@@ -221,9 +221,15 @@ void notmain(void) {
 				for (uint32_t i = 0; i < TArtNetConst::MAX_PORTS; i++) {
 					uint8_t nAddress;
 					if (node.GetUniverseSwitch(i, nAddress)) {
-						pDiscovery->Full(i);
+						pDiscovery->Start(i);
 					}
 				}
+
+				// All ports concurrently
+				while (pDiscovery->IsRunning()) {
+					hw.WatchdogFeed();
+					pDiscovery->Run();
+				}
 			}
 
 			node.SetRdmHandler(pDiscovery);
@@ -49,6 +49,7 @@
 #include "rdmdeviceresponder.h"
 #include "rdmpersonality.h"
 #include "rdmdeviceparams.h"
+#include "rdmsensors.h"
 
 #include "artnetrdmresponder.h"
 
@@ -299,6 +300,7 @@ void notmain(void) {
 		hw.WatchdogFeed();
 		nw.Run();
 		node.Run();
+		RDMSensors::Get()->Run();
 		identify.Run();
 #if defined (ORANGE_PI)
 		remoteConfig.Run();
@@ -65,6 +65,7 @@
 
 // Format handlers
 #include "olashowfile.h"
+#include "binaryshowfile.h"
 
 // Protocol handlers
 #include "showfileprotocole131.h"
@@ -104,8 +105,9 @@ void notmain(void) {
 	ShowFile *pShowFile = 0;
 
 	switch (showFileParams.GetFormat()) {
-//		case SHOWFILE_FORMAT_:
-//			break;
+		case ShowFileFormats::BINARY:
+			pShowFile = new BinaryShowFile;
+			break;
 		default:
 			pShowFile = new OlaShowFile;
 			break;
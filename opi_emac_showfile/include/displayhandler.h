@@ -66,6 +66,9 @@ public:
 			case ShowFileStatus::ENDED:
 				Display::Get()->PutString("Ended    ");
 				break;
+			case ShowFileStatus::RECORDING:
+				Display::Get()->PutString("Recording");
+				break;
 			case ShowFileStatus::UNDEFINED:
 			default:
 				Display::Get()->PutString("No Status");